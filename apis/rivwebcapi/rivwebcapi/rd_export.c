@@ -255,6 +255,10 @@ int RD_ExportCart( const char hostname[],
   curl_easy_setopt(curl,CURLOPT_VERBOSE,0);
   curl_easy_setopt(curl,CURLOPT_ERRORBUFFER,errbuf);
 
+  /*
+   * A transfer that fails part way (as when the export fails after
+   * audio has been sent) leaves a truncated file, so remove it
+   */
   res = curl_easy_perform(curl);
   if(res != CURLE_OK) {
     #ifdef RIVC_DEBUG_OUT
@@ -266,8 +270,10 @@ int RD_ExportCart( const char hostname[],
         else
             fprintf(stderr, "%s\n", curl_easy_strerror(res));
     #endif
+    curl_formfree(first);
     curl_easy_cleanup(curl);
     fclose(fp);
+    remove(checked_fname);
     return -1;
   }
 /* The response OK - so figure out if we got what we wanted.. */
@@ -275,6 +281,10 @@ int RD_ExportCart( const char hostname[],
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
   curl_formfree(first);
   curl_easy_cleanup(curl);
+  if (fclose(fp) != 0) {
+    remove(checked_fname);
+    return -1;
+  }
   
   if (response_code > 199 && response_code < 300) {  //Success
     return 0;
@@ -28,12 +28,16 @@
 #include "rd_common.h"
 #include "rd_getuseragent.h"
 #include "rd_listcarts.h"
+#include "rd_session.h"
 
 struct xml_data {
   unsigned carts_quan;
   char elem_name[256];
   char strbuf[1024];
   struct rd_cart *carts;
+  struct rd_cart cart;
+  void (*callback)(const struct rd_cart *,void *);
+  void *priv;
 };
 
 
@@ -42,8 +46,13 @@ static void XMLCALL __ListCartsElementStart(void *data, const char *el,
 {
   struct xml_data *xml_data=(struct xml_data *)data;
   if(strcasecmp(el,"cart")==0) {    // Allocate a new cart entry
-    xml_data->carts=realloc(xml_data->carts,
-			   (xml_data->carts_quan+1)*sizeof(struct rd_cart));
+    if(xml_data->callback==NULL) {
+      xml_data->carts=realloc(xml_data->carts,
+			      (xml_data->carts_quan+1)*sizeof(struct rd_cart));
+    }
+    else {
+      memset(&xml_data->cart,0,sizeof(struct rd_cart));
+    }
     (xml_data->carts_quan)++;
   }
   strlcpy(xml_data->elem_name,el,256);
@@ -66,6 +75,14 @@ static void XMLCALL __ListCartsElementEnd(void *data, const char *el)
   struct rd_cart *carts=xml_data->carts+(xml_data->carts_quan-1);
   char hold_datetime[25];
 
+  if(xml_data->callback!=NULL) {
+    carts=&xml_data->cart;
+    if(strcasecmp(el,"cart")==0) {
+      xml_data->callback(carts,xml_data->priv);
+      return;
+    }
+  }
+
   if(strcasecmp(el,"number")==0) {
     sscanf(xml_data->strbuf,"%u",&carts->cart_number);
   }
@@ -321,3 +338,55 @@ int RD_ListCarts(struct rd_cart *carts[],
     return (int)response_code;
   }
 }
+
+
+int RD_ListCartsStream(struct rd_session *session,
+		       const char group_name[],
+		       const char filter[],
+		       const char type[],
+		       void (*callback)(const struct rd_cart *cart,void *priv),
+		       void *priv,
+		       unsigned *numrecs)
+{
+  XML_Parser parser;
+  struct xml_data xml_data;
+  long response_code;
+  const char *fields[]={"GROUP_NAME",group_name,
+			"FILTER",filter,
+			"TYPE",type,
+			NULL};
+
+  /*  Set number of recs so if fail already set */
+  *numrecs = 0;
+
+  /*
+   * Each cart is handed to the callback as soon as it has been parsed,
+   * so the list is never held in memory
+   */
+  memset(&xml_data,0,sizeof(xml_data));
+  xml_data.callback=callback;
+  xml_data.priv=priv;
+  parser=XML_ParserCreate(NULL);
+  XML_SetUserData(parser,&xml_data);
+  XML_SetElementHandler(parser,__ListCartsElementStart,
+			__ListCartsElementEnd);
+  XML_SetCharacterDataHandler(parser,__ListCartsElementData);
+
+  if(RD_SessionPost(session,"6",fields,__ListCartsCallback,parser,
+		    &response_code)!=0) {
+    XML_ParserFree(parser);
+    return -1;
+  }
+  XML_ParserFree(parser);
+
+  if (response_code > 199 && response_code < 300) {
+    *numrecs = xml_data.carts_quan;
+    return 0;
+  }
+  else {
+    #ifdef RIVC_DEBUG_OUT
+        fprintf(stderr," rd_listcarts Call Returned Error: %s\n",xml_data.strbuf);
+    #endif
+    return (int)response_code;
+  }
+}
@@ -26,6 +26,7 @@
 _MYRIVLIB_INIT_DECL
 
 #include <rivwebcapi/rd_cart.h>
+#include <rivwebcapi/rd_session.h>
 
 int RD_ListCarts(struct rd_cart *carts[],
 		 const char hostname[],
@@ -38,6 +39,14 @@ int RD_ListCarts(struct rd_cart *carts[],
 		 const char user_agent[],
 		 unsigned *numrecs);
 
+int RD_ListCartsStream(struct rd_session *session,
+		       const char group_name[],
+		       const char filter[],
+		       const char type[],
+		       void (*callback)(const struct rd_cart *cart,void *priv),
+		       void *priv,
+		       unsigned *numrecs);
+
 _MYRIVLIB_FINI_DECL
 
 
@@ -28,6 +28,7 @@
 #include "rd_common.h"
 #include "rd_getuseragent.h"
 #include "rd_listlog.h"
+#include "rd_session.h"
 
 struct xml_data {
   unsigned logline_quan;
@@ -36,6 +37,9 @@ struct xml_data {
   char attribute_value[256];
   char strbuf[1024];
   struct rd_logline *logline;
+  struct rd_logline line;
+  void (*callback)(const struct rd_logline *,void *);
+  void *priv;
 };
 
 
@@ -44,8 +48,13 @@ static void XMLCALL __ListLogElementStart(void *data, const char *el,
 {
   struct xml_data *xml_data=(struct xml_data *)data;
   if(strcasecmp(el,"logLine")==0) {    // Allocate a new logline entry
-    xml_data->logline=realloc(xml_data->logline, 
+    if(xml_data->callback==NULL) {
+      xml_data->logline=realloc(xml_data->logline, 
             (xml_data->logline_quan+1)*sizeof(struct rd_logline));
+    }
+    else {
+      memset(&xml_data->line,0,sizeof(struct rd_logline));
+    }
     (xml_data->logline_quan)++;
   }
 
@@ -73,6 +82,14 @@ static void XMLCALL __ListLogElementEnd(void *data, const char *el)
   struct rd_logline *logline=xml_data->logline+(xml_data->logline_quan-1);
   char hold_datetime[26];
 
+  if(xml_data->callback!=NULL) {
+    logline=&xml_data->line;
+    if(strcasecmp(el,"logLine")==0) {
+      xml_data->callback(logline,xml_data->priv);
+      return;
+    }
+  }
+
   if(strcasecmp(el,"line")==0) {
     sscanf(xml_data->strbuf,"%d",&logline->logline_line);
   }
@@ -546,3 +563,55 @@ int RD_ListLog(struct rd_logline *logline[],
     return (int)response_code;
   }
 }
+
+
+int RD_ListLogStream(struct rd_session *session,
+		     const char logname[],
+		     void (*callback)(const struct rd_logline *logline,
+				      void *priv),
+		     void *priv,
+		     unsigned *numrecs)
+{
+  XML_Parser parser;
+  struct xml_data xml_data;
+  long response_code;
+  const char *fields[]={"NAME",logname,NULL};
+
+  /*  Set number of recs so if fail already set */
+  *numrecs = 0;
+
+  if (strlen(logname)==0)  {
+    return 400;        /* Log Name Missing */
+  }
+
+  /*
+   * Each line is handed to the callback as soon as it has been parsed,
+   * so the log is never held in memory
+   */
+  memset(&xml_data,0,sizeof(xml_data));
+  xml_data.callback=callback;
+  xml_data.priv=priv;
+  parser=XML_ParserCreate(NULL);
+  XML_SetUserData(parser,&xml_data);
+  XML_SetElementHandler(parser,__ListLogElementStart,
+			__ListLogElementEnd);
+  XML_SetCharacterDataHandler(parser,__ListLogElementData);
+
+  if(RD_SessionPost(session,"22",fields,__ListLogCallback,parser,
+		    &response_code)!=0) {
+    XML_ParserFree(parser);
+    return -1;
+  }
+  XML_ParserFree(parser);
+
+  if (response_code > 199 && response_code < 300) {
+    *numrecs = xml_data.logline_quan;
+    return 0;
+  }
+  else {
+    #ifdef RIVC_DEBUG_OUT
+        fprintf(stderr," rd_listlog Call Returned Error: %s\n",xml_data.strbuf);
+    #endif
+    return (int)response_code;
+  }
+}
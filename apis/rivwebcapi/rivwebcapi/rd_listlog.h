@@ -22,6 +22,7 @@
 #define RD_LISTLOG_H
 
 #include <rivwebcapi/rd_common.h>
+#include <rivwebcapi/rd_session.h>
 
 _MYRIVLIB_INIT_DECL
 
@@ -105,6 +106,13 @@ int RD_ListLog(struct rd_logline *logline[],
 	       const char user_agent[],
 	       unsigned *numrecs);
 
+int RD_ListLogStream(struct rd_session *session,
+		     const char logname[],
+		     void (*callback)(const struct rd_logline *logline,
+				      void *priv),
+		     void *priv,
+		     unsigned *numrecs);
+
 _MYRIVLIB_FINI_DECL
 
 
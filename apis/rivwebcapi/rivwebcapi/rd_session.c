@@ -0,0 +1,145 @@
+/* rd_session.c
+ *
+ * Implementation of the Session Rivendell Access Library
+ *
+ * (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+#include "rd_common.h"
+#include "rd_getuseragent.h"
+#include "rd_session.h"
+
+struct rd_session {
+  CURL *curl;
+  char url[1500];
+  char username[256];
+  char passwd[256];
+  char ticket[256];
+  char user_agent[256];
+};
+
+
+struct rd_session *RD_CreateSession(const char hostname[],
+				    const char username[],
+				    const char passwd[],
+				    const char ticket[],
+				    const char user_agent[])
+{
+  struct rd_session *session=NULL;
+
+  if((session=malloc(sizeof(struct rd_session)))==NULL) {
+    return NULL;
+  }
+  memset(session,0,sizeof(struct rd_session));
+  if((session->curl=curl_easy_init())==NULL) {
+    free(session);
+    return NULL;
+  }
+  snprintf(session->url,1500,"http://%s/rd-bin/rdxport.cgi",hostname);
+  strlcpy(session->username,username,256);
+  strlcpy(session->passwd,passwd,256);
+  strlcpy(session->ticket,ticket,256);
+
+  // Check if User Agent Present otherwise set to default
+  if(strlen(user_agent)>0) {
+    strlcpy(session->user_agent,user_agent,256);
+  }
+  else {
+    snprintf(session->user_agent,256,"%s%s",RD_GetUserAgent(),VERSION);
+  }
+
+  return session;
+}
+
+
+void RD_FreeSession(struct rd_session *session)
+{
+  if(session!=NULL) {
+    curl_easy_cleanup(session->curl);
+    free(session);
+  }
+}
+
+
+int RD_SessionPost(struct rd_session *session,
+		   const char command[],
+		   const char *fields[],
+		   size_t (*callback)(void *ptr,size_t size,size_t nmemb,
+				      void *userdata),
+		   void *userdata,
+		   long *response_code)
+{
+  CURL *curl=session->curl;
+  char errbuf[CURL_ERROR_SIZE];
+  CURLcode res;
+  struct curl_httppost *first=NULL;
+  struct curl_httppost *last=NULL;
+  int i;
+
+  *response_code=0;
+
+  /*
+   * Resetting the options leaves the connection to the server open, so
+   * each call after the first skips the connection setup
+   */
+  curl_easy_reset(curl);
+
+  curl_formadd(&first,&last,CURLFORM_PTRNAME,"COMMAND",
+	       CURLFORM_COPYCONTENTS,command,CURLFORM_END);
+  curl_formadd(&first,&last,CURLFORM_PTRNAME,"LOGIN_NAME",
+	       CURLFORM_COPYCONTENTS,session->username,CURLFORM_END);
+  curl_formadd(&first,&last,CURLFORM_PTRNAME,"PASSWORD",
+	       CURLFORM_COPYCONTENTS,session->passwd,CURLFORM_END);
+  curl_formadd(&first,&last,CURLFORM_PTRNAME,"TICKET",
+	       CURLFORM_COPYCONTENTS,session->ticket,CURLFORM_END);
+  for(i=0;(fields!=NULL)&&(fields[i]!=NULL);i+=2) {
+    curl_formadd(&first,&last,CURLFORM_PTRNAME,fields[i],
+		 CURLFORM_COPYCONTENTS,fields[i+1],CURLFORM_END);
+  }
+
+  curl_easy_setopt(curl,CURLOPT_USERAGENT,session->user_agent);
+  curl_easy_setopt(curl,CURLOPT_WRITEDATA,userdata);
+  curl_easy_setopt(curl,CURLOPT_WRITEFUNCTION,callback);
+  curl_easy_setopt(curl,CURLOPT_URL,session->url);
+  curl_easy_setopt(curl,CURLOPT_POST,1);
+  curl_easy_setopt(curl,CURLOPT_HTTPPOST,first);
+  curl_easy_setopt(curl,CURLOPT_NOPROGRESS,1);
+  curl_easy_setopt(curl,CURLOPT_ERRORBUFFER,errbuf);
+  curl_easy_setopt(curl,CURLOPT_ACCEPT_ENCODING,"");
+
+  res=curl_easy_perform(curl);
+  curl_formfree(first);
+  if(res!=CURLE_OK) {
+    #ifdef RIVC_DEBUG_OUT
+        size_t len = strlen(errbuf);
+        fprintf(stderr, "\nlibcurl error: (%d)", res);
+        if (len)
+            fprintf(stderr, "%s%s", errbuf,
+                ((errbuf[len-1] != '\n') ? "\n" : ""));
+        else
+            fprintf(stderr, "%s\n", curl_easy_strerror(res));
+    #endif
+    return -1;
+  }
+  curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,response_code);
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+/* rd_session.h
+ *
+ * Header for the Session Rivendell Access Library
+ *
+ * (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef RD_SESSION_H
+#define RD_SESSION_H
+
+#include <rivwebcapi/rd_common.h>
+
+_MYRIVLIB_INIT_DECL
+
+/*
+ * A session holds one connection to the Web API open across calls. It
+ * must not be used by more than one thread at a time.
+ */
+struct rd_session;
+
+struct rd_session *RD_CreateSession(const char hostname[],
+				    const char username[],
+				    const char passwd[],
+				    const char ticket[],
+				    const char user_agent[]);
+
+void RD_FreeSession(struct rd_session *session);
+
+int RD_SessionPost(struct rd_session *session,
+		   const char command[],
+		   const char *fields[],
+		   size_t (*callback)(void *ptr,size_t size,size_t nmemb,
+				      void *userdata),
+		   void *userdata,
+		   long *response_code);
+
+_MYRIVLIB_FINI_DECL
+
+
+#endif  // RD_SESSION_H
@@ -0,0 +1,123 @@
+/* listcartsstream_test.c
+ *
+ * Test the streaming listcarts library.
+ *
+ * (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rivwebcapi/rd_listcarts.h>
+#include <rivwebcapi/rd_getuseragent.h>
+#include <rivwebcapi/rd_getversion.h>
+#include <rivwebcapi/rd_session.h>
+
+void PrintCart(const struct rd_cart *cart,void *priv)
+{
+  (*(unsigned *)priv)++;
+  printf("              Cart Number: %d\n",cart->cart_number);
+  printf("               Group Name: %s\n",cart->cart_grp_name);
+  printf("               Cart Title: %s\n",cart->cart_title);
+  printf("              Cart Artist: %s\n",cart->cart_artist);
+  printf("      Cart Average Length: %d\n",cart->cart_average_length);
+  printf("        Cart Cut Quantity: %u\n",cart->cart_cut_quantity);
+  printf("\n");
+}
+
+
+int main(int argc,char *argv[])
+{
+  int i;
+  unsigned numrecs;
+  unsigned seen;
+  char *host;
+  char *user;
+  char *passwd;
+  char user_agent[255]={0};
+  struct rd_session *session=NULL;
+  int result;
+
+  /*      Get the Rivendell Host, User and Password if set in env */
+  if (getenv("RIVHOST")!=NULL) {
+    host = getenv("RIVHOST");
+  }
+  else {
+    host="localhost";
+  }
+
+  if (getenv("RIVUSER")!=NULL) {
+    user = getenv("RIVUSER");
+  }
+  else {
+    user="USER";
+  }
+
+  if (getenv("RIVPASS")!=NULL) {
+    passwd = getenv("RIVPASS");
+  }
+  else {
+    passwd = "";
+  } 
+
+  // Add the User Agent and Version
+  strcat(user_agent,RD_GetUserAgent());
+  strcat(user_agent,RD_GetVersion());
+  strcat(user_agent," (Test Suite)");
+
+  if((session=RD_CreateSession(host,user,passwd,"",user_agent))==NULL) {
+    fprintf(stderr,"Error: unable to create session!\n");
+    exit(256);
+  }
+
+  //
+  // Call the function twice, the second time over the same connection
+  //
+  for(i=0;i<2;i++) {
+    seen=0;
+    result=RD_ListCartsStream(session,"","","Audio",PrintCart,&seen,&numrecs);
+    if(result<0) {
+      fprintf(stderr,"Error: Web function Failure!\n");
+      exit(256);
+    }
+    if ((result< 200 || result > 299) &&
+	(result != 0))
+    {
+      switch(result) {
+        case 403:
+          fprintf(stderr,"ERROR:  Invalid User Authentification \n");
+          break;
+        case 404:
+          fprintf(stderr,"ERROR:  No Such Group Exists! \n");
+          break;
+        default:
+          fprintf(stderr, "Unknown Error occurred ==> %d\n",result);
+      }
+      exit(256);
+    }
+    if(seen!=numrecs) {
+      fprintf(stderr,"ERROR:  callback saw %u carts, numrecs is %u\n",
+	      seen,numrecs);
+      exit(256);
+    }
+    printf("Pass %d: %u carts\n\n",i+1,numrecs);
+  }
+
+  RD_FreeSession(session);
+
+  exit(0);
+}
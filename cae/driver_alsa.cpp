@@ -754,7 +754,8 @@ bool DriverAlsa::loadPlayback(int card,QString wavename,int *stream)
     return false;
   }
   alsa_play_wave[card][*stream]=new RDWaveFile(wavename);
-  if(!alsa_play_wave[card][*stream]->openWave()) {
+  if(!alsa_play_wave[card][*stream]->
+     openWave(NULL,RDWaveFile::PlaybackOpen)) {
     rda->syslog(LOG_DEBUG,"alsaLoadPlayback(%s) openWave() failed to open file",
 		wavename.toUtf8().constData());
     delete alsa_play_wave[card][*stream];
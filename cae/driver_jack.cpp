@@ -728,7 +728,7 @@ bool DriverJack::loadPlayback(int card,QString wavename,int *stream)
     return false;
   }
   jack_play_wave[*stream]=new RDWaveFile(wavename);
-  if(!jack_play_wave[*stream]->openWave()) {
+  if(!jack_play_wave[*stream]->openWave(NULL,RDWaveFile::PlaybackOpen)) {
     rda->syslog(LOG_DEBUG,"jackLoadPlayback(%s) openWave() failed to open file",
 		wavename.toUtf8().constData());
     delete jack_play_wave[*stream];
@@ -43,8 +43,10 @@ SOURCES += rdairplay_conf.cpp
 SOURCES += rdapplication.cpp
 SOURCES += rdaudio_exists.cpp
 SOURCES += rdaudio_port.cpp
+SOURCES += rdaudiodedup.cpp
 SOURCES += rdaudiosettings.cpp
 SOURCES += rdbipushbutton.cpp
+SOURCES += rdbufferedreader.cpp
 SOURCES += rdbusybar.cpp
 SOURCES += rdbusydialog.cpp
 SOURCES += rdbutton_dialog.cpp
@@ -73,6 +75,7 @@ SOURCES += rdcoreapplication.cpp
 SOURCES += rdcsv.cpp
 SOURCES += rdcueedit.cpp
 SOURCES += rdcueeditdialog.cpp
+SOURCES += rdcurlpool.cpp
 SOURCES += rdcut.cpp
 SOURCES += rdcut_path.cpp
 SOURCES += rdcut_dialog.cpp
@@ -117,6 +120,7 @@ SOURCES += rdgroup.cpp
 SOURCES += rdgroup_list.cpp
 SOURCES += rdgrouplistmodel.cpp
 SOURCES += rdhash.cpp
+SOURCES += rdhashengine.cpp
 SOURCES += rdhostvarlistmodel.cpp
 SOURCES += rdidvalidator.cpp
 SOURCES += rdiconengine.cpp
@@ -132,6 +136,7 @@ SOURCES += rdlineedit.cpp
 SOURCES += rdlist_logs.cpp
 SOURCES += rdlist_groups.cpp
 SOURCES += rdlistselector.cpp
+SOURCES += rdlocalxport.cpp
 SOURCES += rdlog.cpp
 SOURCES += rdlog_line.cpp
 SOURCES += rdlogedit_conf.cpp
@@ -178,6 +183,7 @@ SOURCES += rdreplicatorlistmodel.cpp
 SOURCES += rdreport.cpp
 SOURCES += rdresourcelistmodel.cpp
 SOURCES += rdripc.cpp
+SOURCES += rdrowsnapshot.cpp
 SOURCES += rdrssschemas.cpp
 SOURCES += rdrsscategorybox.cpp
 SOURCES += rdschedcode.cpp
@@ -192,6 +198,8 @@ SOURCES += rdslotbutton.cpp
 SOURCES += rdsocket.cpp
 SOURCES += rdsocketstrings.cpp
 SOURCES += rdsound_panel.cpp
+SOURCES += rdsqlprofiler.cpp
+SOURCES += rdsqltransaction.cpp
 SOURCES += rdstation.cpp
 SOURCES += rdstationlistmodel.cpp
 SOURCES += rdstatus.cpp
@@ -209,6 +217,7 @@ SOURCES += rdtrackereditdialog.cpp
 SOURCES += rdtrackermodel.cpp
 SOURCES += rdtrackertableview.cpp
 SOURCES += rdtrackerwidget.cpp
+SOURCES += rdtranscodecache.cpp
 SOURCES += rdtranslator.cpp
 SOURCES += rdtransportbutton.cpp
 SOURCES += rdtreeview.cpp
@@ -234,8 +243,10 @@ HEADERS += rdairplay_conf.h
 HEADERS += rdapplication.h
 HEADERS += rdaudio_exists.h
 HEADERS += rdaudio_port.h
+HEADERS += rdaudiodedup.h
 HEADERS += rdaudiosettings.h
 HEADERS += rdbipushbutton.h
+HEADERS += rdbufferedreader.h
 HEADERS += rdbusybar.h
 HEADERS += rdbusydialog.h
 HEADERS += rdbutton_dialog.h
@@ -263,6 +274,7 @@ HEADERS += rdcoreapplication.h
 HEADERS += rdcsv.h
 HEADERS += rdcueedit.h
 HEADERS += rdcueeditdialog.h
+HEADERS += rdcurlpool.h
 HEADERS += rdcut_dialog.h
 HEADERS += rdcut_path.h
 HEADERS += rdcut.h
@@ -309,6 +321,7 @@ HEADERS += rdgroup_list.h
 HEADERS += rdgroup.h
 HEADERS += rdgrouplistmodel.h
 HEADERS += rdhash.h
+HEADERS += rdhashengine.h
 HEADERS += rdhostvarlistmodel.h
 HEADERS += rdiconengine.h
 HEADERS += rdidvalidator.h
@@ -324,6 +337,7 @@ HEADERS += rdlineedit.h
 HEADERS += rdlist_groups.h
 HEADERS += rdlist_logs.h
 HEADERS += rdlistselector.h
+HEADERS += rdlocalxport.h
 HEADERS += rdlog.h
 HEADERS += rdlog_line.h
 HEADERS += rdlogedit_conf.h
@@ -371,6 +385,7 @@ HEADERS += rdreplicatorlistmodel.h
 HEADERS += rdreport.h
 HEADERS += rdresourcelistmodel.h
 HEADERS += rdripc.h
+HEADERS += rdrowsnapshot.h
 HEADERS += rdrssschemas.h
 HEADERS += rdrsscategorybox.h
 HEADERS += rdschedcode.h
@@ -385,6 +400,8 @@ HEADERS += rdslotbutton.h
 HEADERS += rdsocket.h
 HEADERS += rdsocketstrings.h
 HEADERS += rdsound_panel.h
+HEADERS += rdsqlprofiler.h
+HEADERS += rdsqltransaction.h
 HEADERS += rdstation.h
 HEADERS += rdstationlistmodel.h
 HEADERS += rdstatus.h
@@ -403,6 +420,7 @@ HEADERS += rdtrackereditdialog.h
 HEADERS += rdtrackermodel.h
 HEADERS += rdtrackertableview.h
 HEADERS += rdtrackerwidget.h
+HEADERS += rdtranscodecache.h
 HEADERS += rdtranslator.h
 HEADERS += rdtransportbutton.h
 HEADERS += rdtreeview.h
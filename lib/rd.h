@@ -76,6 +76,7 @@
 #define DEFAULT_MYSQL_ENGINE "MyISAM"
 #define DEFAULT_MYSQL_CHARSET "utf8mb4"
 #define DEFAULT_MYSQL_COLLATION "utf8mb4_general_ci"
+#define DEFAULT_MYSQL_REPLICA_STICKINESS 10
 
 /*
  * Maximum Length of Rivendell User Passwords
@@ -638,6 +639,36 @@
  */
 #define RD_DEFAULT_SERVICE_STARTUP_DELAY 5
 
+/*
+ * Default 'AudioReadBlockSize=' value in rd.conf(5) [bytes]
+ */
+#define RD_DEFAULT_AUDIO_READ_BLOCK_SIZE 65536
+
+/*
+ * Default 'TranscodeCacheSize=' value in rd.conf(5) [megabytes]
+ */
+#define RD_DEFAULT_TRANSCODE_CACHE_SIZE 1024
+
+/*
+ * Default 'WebServiceWorkers=' value in rd.conf(5)
+ */
+#define RD_DEFAULT_WEB_SERVICE_WORKERS 4
+
+/*
+ * Default 'WebServiceMaxRequests=' value in rd.conf(5)
+ */
+#define RD_DEFAULT_WEB_SERVICE_MAX_REQUESTS 1000
+
+/*
+ * Default 'RehashWorkers=' value in rd.conf(5)
+ */
+#define RD_DEFAULT_REHASH_WORKERS 4
+
+/*
+ * Default 'ProfileSqlRepeatLimit=' value in rd.conf(5)
+ */
+#define RD_DEFAULT_PROFILE_SQL_REPEAT_LIMIT 20
+
 /*
  * File Extension for RSS XML Feed Files
  */
@@ -50,6 +50,14 @@ RDAirPlayConf::RDAirPlayConf(const QString &station,const QString &tablename)
   }
   air_id=q->value(0).toUInt();
   delete q;
+  air_snapshot=new RDRowSnapshot(air_tablename,"ID");
+  air_snapshot->setFollowsWrites(false);
+}
+
+
+RDAirPlayConf::~RDAirPlayConf()
+{
+  delete air_snapshot;
 }
 
 
@@ -59,6 +67,18 @@ QString RDAirPlayConf::station() const
 }
 
 
+bool RDAirPlayConf::snapshotEnabled() const
+{
+  return air_snapshot->isEnabled();
+}
+
+
+void RDAirPlayConf::setSnapshotEnabled(bool state)
+{
+  air_snapshot->setEnabled(state);
+}
+
+
 int RDAirPlayConf::card(RDAirPlayConf::Channel chan) const
 {
   return GetChannelValue("CARD",chan).toInt();
@@ -327,7 +347,7 @@ void RDAirPlayConf::setStopGpoLine(RDAirPlayConf::Channel chan,int line) const
 
 int RDAirPlayConf::segueLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"SEGUE_LENGTH").toInt();
+  return air_snapshot->value(air_id,"SEGUE_LENGTH").toInt();
 }
 
 
@@ -339,7 +359,7 @@ void RDAirPlayConf::setSegueLength(int len) const
 
 int RDAirPlayConf::transLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"TRANS_LENGTH").toInt();
+  return air_snapshot->value(air_id,"TRANS_LENGTH").toInt();
 }
 
 
@@ -352,7 +372,7 @@ void RDAirPlayConf::setTransLength(int len) const
 RDAirPlayConf::OpModeStyle RDAirPlayConf::opModeStyle() const
 {
   return (RDAirPlayConf::OpModeStyle)
-    RDGetSqlValue(air_tablename,"ID",air_id,"LOG_MODE_STYLE").toInt();
+    air_snapshot->value(air_id,"LOG_MODE_STYLE").toInt();
 }
 
 
@@ -388,7 +408,7 @@ void RDAirPlayConf::setLogStartMode(int mach,RDAirPlayConf::OpMode mode) const
 
 int RDAirPlayConf::pieCountLength() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"PIE_COUNT_LENGTH").toInt();
+  return air_snapshot->value(air_id,"PIE_COUNT_LENGTH").toInt();
 }
 
 
@@ -401,7 +421,7 @@ void RDAirPlayConf::setPieCountLength(int len) const
 RDAirPlayConf::PieEndPoint RDAirPlayConf::pieEndPoint() const
 {
   return (RDAirPlayConf::PieEndPoint)
-    RDGetSqlValue(air_tablename,"ID",air_id,"PIE_COUNT_ENDPOINT").toInt();
+    air_snapshot->value(air_id,"PIE_COUNT_ENDPOINT").toInt();
 }
 
 
@@ -413,8 +433,7 @@ void RDAirPlayConf::setPieEndPoint(RDAirPlayConf::PieEndPoint point) const
 
 bool RDAirPlayConf::checkTimesync() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,
-			    "CHECK_TIMESYNC").toString());
+  return RDBool(air_snapshot->value(air_id,"CHECK_TIMESYNC").toString());
 }
 
 
@@ -428,10 +447,10 @@ int RDAirPlayConf::panels(RDAirPlayConf::PanelType type) const
 {
   switch(type) {
       case RDAirPlayConf::StationPanel:
-	return RDGetSqlValue(air_tablename,"ID",air_id,"STATION_PANELS").toInt();
+	return air_snapshot->value(air_id,"STATION_PANELS").toInt();
 
       case RDAirPlayConf::UserPanel:
-	return RDGetSqlValue(air_tablename,"ID",air_id,"USER_PANELS").toInt();
+	return air_snapshot->value(air_id,"USER_PANELS").toInt();
   }
   return 0;
 }
@@ -453,8 +472,8 @@ void RDAirPlayConf::setPanels(RDAirPlayConf::PanelType type,int quan) const
 
 bool RDAirPlayConf::showAuxButton(int auxbutton) const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",
-	    air_id,QString::asprintf("SHOW_AUX_%d",auxbutton+1)).toString());
+  return RDBool(air_snapshot->value(air_id,
+		QString::asprintf("SHOW_AUX_%d",auxbutton+1)).toString());
 }
 
 
@@ -467,7 +486,7 @@ void RDAirPlayConf::setShowAuxButton(int auxbutton,bool state) const
 bool RDAirPlayConf::clearFilter() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"CLEAR_FILTER").toString());
+    RDBool(air_snapshot->value(air_id,"CLEAR_FILTER").toString());
 }
 
 
@@ -480,7 +499,7 @@ void RDAirPlayConf::setClearFilter(bool state) const
 RDLogLine::TransType RDAirPlayConf::defaultTransType() const
 {
   return (RDLogLine::TransType)
-    RDGetSqlValue(air_tablename,"ID",air_id,"DEFAULT_TRANS_TYPE").toInt();
+    air_snapshot->value(air_id,"DEFAULT_TRANS_TYPE").toInt();
 }
 
 
@@ -493,7 +512,7 @@ void RDAirPlayConf::setDefaultTransType(RDLogLine::TransType type) const
 RDAirPlayConf::BarAction RDAirPlayConf::barAction() const
 {
   return (RDAirPlayConf::BarAction)
-    RDGetSqlValue(air_tablename,"ID",air_id,"BAR_ACTION").toUInt();
+    air_snapshot->value(air_id,"BAR_ACTION").toUInt();
 }
 
 
@@ -506,7 +525,7 @@ void RDAirPlayConf::setBarAction(RDAirPlayConf::BarAction action) const
 bool RDAirPlayConf::flashPanel() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"FLASH_PANEL").toString());
+    RDBool(air_snapshot->value(air_id,"FLASH_PANEL").toString());
 }
 
 
@@ -518,7 +537,7 @@ void RDAirPlayConf::setFlashPanel(bool state) const
 
 bool RDAirPlayConf::panelPauseEnabled() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"PANEL_PAUSE_ENABLED").
+  return RDBool(air_snapshot->value(air_id,"PANEL_PAUSE_ENABLED").
 	       toString());
 }
 
@@ -531,7 +550,7 @@ void RDAirPlayConf::setPanelPauseEnabled(bool state) const
 
 QString RDAirPlayConf::buttonLabelTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"BUTTON_LABEL_TEMPLATE").
+  return air_snapshot->value(air_id,"BUTTON_LABEL_TEMPLATE").
     toString();
 }
 
@@ -545,7 +564,7 @@ void RDAirPlayConf::setButtonLabelTemplate(const QString &str) const
 bool RDAirPlayConf::pauseEnabled() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"PAUSE_ENABLED").toString());
+    RDBool(air_snapshot->value(air_id,"PAUSE_ENABLED").toString());
 }
 
 
@@ -557,7 +576,7 @@ void RDAirPlayConf::setPauseEnabled(bool state) const
 
 QString RDAirPlayConf::defaultSvc() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"DEFAULT_SERVICE").toString();
+  return air_snapshot->value(air_id,"DEFAULT_SERVICE").toString();
 }
 
 
@@ -570,7 +589,7 @@ void RDAirPlayConf::setDefaultSvc(const QString &svcname) const
 bool RDAirPlayConf::hourSelectorEnabled() const
 {
   return 
-    RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"HOUR_SELECTOR_ENABLED").
+    RDBool(air_snapshot->value(air_id,"HOUR_SELECTOR_ENABLED").
 	   toString());
 }
 
@@ -583,7 +602,7 @@ void RDAirPlayConf::setHourSelectorEnabled(bool state) const
 
 QString RDAirPlayConf::titleTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"TITLE_TEMPLATE").
+  return air_snapshot->value(air_id,"TITLE_TEMPLATE").
     toString();
 }
 
@@ -596,7 +615,7 @@ void RDAirPlayConf::setTitleTemplate(const QString &str)
 
 QString RDAirPlayConf::artistTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"ARTIST_TEMPLATE").
+  return air_snapshot->value(air_id,"ARTIST_TEMPLATE").
     toString();
 }
 
@@ -609,7 +628,7 @@ void RDAirPlayConf::setArtistTemplate(const QString &str)
 
 QString RDAirPlayConf::outcueTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"OUTCUE_TEMPLATE").
+  return air_snapshot->value(air_id,"OUTCUE_TEMPLATE").
     toString();
 }
 
@@ -622,7 +641,7 @@ void RDAirPlayConf::setOutcueTemplate(const QString &str)
 
 QString RDAirPlayConf::descriptionTemplate() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"DESCRIPTION_TEMPLATE").
+  return air_snapshot->value(air_id,"DESCRIPTION_TEMPLATE").
     toString();
 }
 
@@ -636,7 +655,7 @@ void RDAirPlayConf::setDescriptionTemplate(const QString &str)
 RDAirPlayConf::ExitCode RDAirPlayConf::exitCode() const
 {
   return (RDAirPlayConf::ExitCode)
-    RDGetSqlValue(air_tablename,"ID",air_id,"EXIT_CODE").toInt();
+    air_snapshot->value(air_id,"EXIT_CODE").toInt();
 }
 
 
@@ -649,7 +668,7 @@ void RDAirPlayConf::setExitCode(RDAirPlayConf::ExitCode code) const
 RDAirPlayConf::ExitCode RDAirPlayConf::virtualExitCode() const
 {
   return (RDAirPlayConf::ExitCode)
-    RDGetSqlValue(air_tablename,"ID",air_id,"VIRTUAL_EXIT_CODE").toInt();
+    air_snapshot->value(air_id,"VIRTUAL_EXIT_CODE").toInt();
 }
 
 
@@ -697,12 +716,13 @@ void RDAirPlayConf::setExitPassword(const QString &passwd) const
       "`STATION`='"+RDEscapeString(air_station)+"'";
   }
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged(air_tablename);
 }
 
 
 QString RDAirPlayConf::skinPath() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"SKIN_PATH").toString();
+  return air_snapshot->value(air_id,"SKIN_PATH").toString();
 }
 
 
@@ -714,7 +734,7 @@ void RDAirPlayConf::setSkinPath(const QString &path) const
 
 QString RDAirPlayConf::logoPath() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"LOGO_PATH").toString();
+  return air_snapshot->value(air_id,"LOGO_PATH").toString();
 }
   
 
@@ -726,7 +746,7 @@ void RDAirPlayConf::setLogoPath(const QString &path) const
 
 bool RDAirPlayConf::showCounters() const
 {
-  return RDBool(RDGetSqlValue(air_tablename,"ID",air_id,"SHOW_COUNTERS").
+  return RDBool(air_snapshot->value(air_id,"SHOW_COUNTERS").
 		toString());
 }
 
@@ -739,7 +759,7 @@ void RDAirPlayConf::setShowCounters(bool state) const
 
 int RDAirPlayConf::auditionPreroll() const
 {
-  return RDGetSqlValue(air_tablename,"ID",air_id,"AUDITION_PREROLL").toInt();
+  return air_snapshot->value(air_id,"AUDITION_PREROLL").toInt();
 }
 
 
@@ -1182,6 +1202,7 @@ void RDAirPlayConf::SetRow(const QString &param,int value) const
     "`STATION`='"+RDEscapeString(air_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged(air_tablename);
 }
 
 
@@ -1195,6 +1216,7 @@ void RDAirPlayConf::SetRow(const QString &param,unsigned value) const
     "`STATION`='"+RDEscapeString(air_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged(air_tablename);
 }
 
 
@@ -1208,4 +1230,5 @@ void RDAirPlayConf::SetRow(const QString &param,const QString &value) const
     "`STATION`='"+RDEscapeString(air_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged(air_tablename);
 }
@@ -25,6 +25,7 @@
 #include <qhostaddress.h>
 
 #include <rdlog_line.h>         
+#include <rdrowsnapshot.h>
 
 class RDAirPlayConf
 {
@@ -47,7 +48,10 @@ class RDAirPlayConf
 		SoundPanel4Channel=8,SoundPanel5Channel=9,LastChannel=10};
   enum GpioType {EdgeGpio=0,LevelGpio=1};
   RDAirPlayConf(const QString &station,const QString &tablename);
+  ~RDAirPlayConf();
   QString station() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   int card(Channel chan) const;
   void setCard(Channel chan,int card) const;
   int port(Channel chan) const;
@@ -179,6 +183,7 @@ class RDAirPlayConf
   QString air_station;
   unsigned air_id;
   QString air_tablename;
+  RDRowSnapshot *air_snapshot;
 };
 
 
@@ -21,6 +21,7 @@
 #include <rddb.h>
 #include <rdaudio_port.h>
 #include <rdescape_string.h>
+#include <rdrowsnapshot.h>
 
 //
 // Global Classes
@@ -239,6 +240,7 @@ void RDAudioPort::setOutputPortLabel(int port,const QString &str)
     QString::asprintf("`CARD_NUMBER`=%d && ",port_card)+
     QString::asprintf("`PORT_NUMBER`=%d",port);
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("AUDIO_OUTPUTS");
 }
 
 
@@ -30,12 +30,14 @@
 #include <dlfcn.h>
 #include <errno.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include <rdapplication.h>
 #include <rdaudioconvert.h>
 #include <rdcart.h>
 #include <rdconf.h>
 #include <rd.h>
+#include <rdhash.h>
 #include <rdtempdirectory.h>
 
 #include <sndfile.h>
@@ -61,17 +63,184 @@
 
 #define STAGE2_XFER_SIZE 2048
 #define STAGE2_BUFFER_SIZE 49152
+#define STAGE2_UNBOUNDED_FRAMES ((sf_count_t)1<<40)
+#define STAGE1_PIPE_SIZE 1048576
+
+static void __RDAudioConvert_PutWord(uint8_t *buf,uint16_t value)
+{
+  buf[0]=0xFF&value;
+  buf[1]=0xFF&(value>>8);
+}
+
+
+static void __RDAudioConvert_PutDword(uint8_t *buf,uint32_t value)
+{
+  buf[0]=0xFF&value;
+  buf[1]=0xFF&(value>>8);
+  buf[2]=0xFF&(value>>16);
+  buf[3]=0xFF&(value>>24);
+}
+
+
+#ifdef HAVE_FLAC
+//
+// FLAC encoder that hands its output to the stream destination
+//
+class RDFlacStreamEncoder : public FLAC::Encoder::Stream
+{
+ public:
+  RDFlacStreamEncoder(RDAudioConvert *conv,int fd);
+  bool writeFailed() const;
+
+ protected:
+  ::FLAC__StreamEncoderWriteStatus
+    write_callback(const FLAC__byte buffer[],size_t bytes,unsigned samples,
+		   unsigned current_frame);
+
+ private:
+  RDAudioConvert *flac_conv;
+  int flac_fd;
+  bool flac_write_failed;
+};
+
+
+RDFlacStreamEncoder::RDFlacStreamEncoder(RDAudioConvert *conv,int fd)
+  : FLAC::Encoder::Stream()
+{
+  flac_conv=conv;
+  flac_fd=fd;
+  flac_write_failed=false;
+}
+
+
+bool RDFlacStreamEncoder::writeFailed() const
+{
+  return flac_write_failed;
+}
+
+
+::FLAC__StreamEncoderWriteStatus 
+RDFlacStreamEncoder::write_callback(const FLAC__byte buffer[],size_t bytes,
+				    unsigned samples,unsigned current_frame)
+{
+  if(flac_conv->WriteDestination(flac_fd,buffer,bytes)!=(ssize_t)bytes) {
+    flac_write_failed=true;
+    return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+  }
+  return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+}
+#endif  // HAVE_FLAC
+
+
+//
+// Hands Stage One's output to Stage Two in memory.  Stage One runs in a
+// thread of its own, writing to a raw float SNDFILE whose data is queued
+// here (up to STAGE1_PIPE_SIZE bytes) until Stage Two reads it.
+//
+class RDStage1Pipe
+{
+ public:
+  RDStage1Pipe(RDAudioConvert *conv,const QString &srcfile,sf_count_t frames);
+  ~RDStage1Pipe();
+  bool start();
+  SNDFILE *openWriter(SF_INFO *info);
+  RDAudioConvert::ErrorCode waitForFormat(SF_INFO *info);
+  sf_count_t read(float *pcm,sf_count_t frames);
+  RDAudioConvert::ErrorCode error();
+
+ private:
+  static void *ThreadCallback(void *priv);
+  static sf_count_t GetFilelenCallback(void *priv);
+  static sf_count_t SeekCallback(sf_count_t offset,int whence,void *priv);
+  static sf_count_t ReadCallback(void *ptr,sf_count_t count,void *priv);
+  static sf_count_t WriteCallback(const void *ptr,sf_count_t count,
+				  void *priv);
+  static sf_count_t TellCallback(void *priv);
+  RDAudioConvert *pipe_conv;
+  QString pipe_srcfile;
+  sf_count_t pipe_frames;
+  pthread_t pipe_thread;
+  pthread_mutex_t pipe_mutex;
+  pthread_cond_t pipe_cond;
+  bool pipe_running;
+  QByteArray pipe_buffer;
+  int pipe_buffer_ptr;
+  sf_count_t pipe_written;
+  int pipe_channels;
+  int pipe_samplerate;
+  bool pipe_format_ready;
+  bool pipe_finished;
+  bool pipe_cancelled;
+  RDAudioConvert::ErrorCode pipe_error;
+};
+
+
+//
+// Runs Stage Two a block at a time as Stage Three reads from it, so that
+// the converted audio never has to be written out to a file.  Stage Three
+// sees it as a raw 32 bit PCM SNDFILE.  Where a WAV header has to be sent
+// before the data, the length is worked out up front from the source
+// length and the rate and speed ratios and the output padded or trimmed
+// to match; otherwise it is as long as it comes out.
+//
+class RDStage2Reader
+{
+ public:
+  RDStage2Reader(RDAudioConvert *conv);
+  ~RDStage2Reader();
+  RDAudioConvert::ErrorCode open(const QString &srcfile,bool fixed_length);
+  SNDFILE *sndfile() const;
+  SF_INFO *sfInfo();
+  RDAudioConvert::ErrorCode error() const;
+
+ private:
+  sf_count_t ReadSource(float *pcm,sf_count_t frames);
+  bool Process();
+  void Append(const float *pcm,sf_count_t frames);
+  static sf_count_t GetFilelenCallback(void *priv);
+  static sf_count_t SeekCallback(sf_count_t offset,int whence,void *priv);
+  static sf_count_t ReadCallback(void *ptr,sf_count_t count,void *priv);
+  static sf_count_t TellCallback(void *priv);
+  RDAudioConvert *reader_conv;
+  SNDFILE *reader_src_sf;
+  SF_INFO reader_src_info;
+  SNDFILE *reader_sf;
+  SF_INFO reader_info;
+  SRC_STATE *reader_src_state;
+  SRC_DATA reader_src_data;
+  soundtouch::SoundTouch *reader_st_conv;
+  float *reader_pcm[3];
+  bool reader_free_pcm[3];
+  float reader_ratio;
+  QByteArray reader_pending;
+  int reader_pending_ptr;
+  sf_count_t reader_length;
+  sf_count_t reader_position;
+  bool reader_fixed_length;
+  bool reader_eof;
+  RDAudioConvert::ErrorCode reader_error;
+};
+
 
 RDAudioConvert::RDAudioConvert(QObject *parent)
   : QObject(parent)
 {
+  conv_dst_stream=-1;
+  conv_dst_tee=-1;
+  conv_stream_bytes=0;
+  conv_dst_first=0;
+  conv_dst_last=-1;
+  conv_skip_frames=0;
+  conv_skipped_frames=0;
   conv_start_point=-1;
   conv_end_point=-1;
   conv_speed_ratio=1.0;
   conv_peak_sample=0.0;
+  conv_stage1_pipe=NULL;
   conv_settings=NULL;
   conv_src_wavedata=new RDWaveData();
   conv_dst_wavedata=NULL;
+  conv_dst_hashing=false;
   conv_src_converter=rda->libraryConf()->srcConverter();
   conv_transcoding_delay=rda->config()->transcodingDelay();
 
@@ -102,6 +271,72 @@ void RDAudioConvert::setDestinationFile(const QString &filename)
 }
 
 
+void RDAudioConvert::setDestinationStream(int fd,const QByteArray &preamble)
+{
+  //
+  // If a destination file is also set, it receives a copy of the stream
+  //
+  conv_dst_stream=fd;
+  conv_dst_preamble=preamble;
+  conv_stream_bytes=0;
+}
+
+
+uint64_t RDAudioConvert::streamBytesWritten() const
+{
+  return conv_stream_bytes;
+}
+
+
+void RDAudioConvert::setDestinationByteRange(int64_t first,int64_t last)
+{
+  //
+  // Only bytes 'first' through 'last' of streamed PCM output are written.
+  // Other formats ignore this.
+  //
+  conv_dst_first=first;
+  conv_dst_last=last;
+}
+
+
+int64_t RDAudioConvert::streamLength()
+{
+  //
+  // The size of the streamed PCM that convert() will put out, or -1 if
+  // that can't be known beforehand
+  //
+  int bytes=0;
+  int rate=0;
+  sf_count_t frames;
+  int64_t data_len;
+
+  if((conv_settings==NULL)||(conv_dst_wavedata!=NULL)||
+     (!conv_dst_rdxl.isEmpty())||(conv_settings->normalizationLevel()!=0)) {
+    return -1;
+  }
+  switch(conv_settings->format()) {
+  case RDSettings::Pcm16:
+    bytes=2;
+    break;
+
+  case RDSettings::Pcm24:
+    bytes=3;
+    break;
+
+  default:
+    return -1;
+  }
+  if(((frames=Stage1Frames(&rate))<0)||(rate<=0)) {
+    return -1;
+  }
+  data_len=(int64_t)Stage2Frames(frames,rate,conv_settings->sampleRate(),
+				  conv_speed_ratio)*
+    conv_settings->channels()*bytes;
+
+  return 44+data_len+(data_len%2);
+}
+
+
 void RDAudioConvert::setDestinationSettings(RDSettings *settings)
 {
   conv_settings=settings;
@@ -132,6 +367,18 @@ void RDAudioConvert::setDestinationRdxl(const QString &xml)
 }
 
 
+void RDAudioConvert::setDestinationHashing(bool state)
+{
+  conv_dst_hashing=state;
+}
+
+
+QString RDAudioConvert::destinationSha1Hash() const
+{
+  return conv_dst_sha1_hash;
+}
+
+
 void RDAudioConvert::setRange(int start_pt,int end_pt)
 {
   conv_start_point=start_pt;
@@ -149,9 +396,11 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
 {
   RDAudioConvert::ErrorCode err;
   QString tmpfile1;
-  QString tmpfile2;
+  QString dstfile=conv_dst_filename;
   RDTempDirectory *temp_dir=NULL;
 
+  conv_dst_sha1_hash="";
+
   //
   // Make sure we're all set to go...
   //
@@ -166,7 +415,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
   if(stat((const char *)conv_src_filename.toUtf8(),&stats)!=0) {
     return RDAudioConvert::ErrorNoSource;
   }
-  if(conv_dst_filename.isEmpty()) {
+  if(conv_dst_filename.isEmpty()&&(conv_dst_stream<0)) {
     return RDAudioConvert::ErrorNoDestination;
   }
   if((conv_speed_ratio<RD_TIMESCALE_MIN)||(conv_speed_ratio>RD_TIMESCALE_MAX)) {
@@ -185,34 +434,104 @@ RDAudioConvert::ErrorCode RDAudioConvert::convert()
     return RDAudioConvert::ErrorInternal;
   }
   tmpfile1=QString(temp_dir->path())+"/signed32_1.wav";
-  tmpfile2=QString(temp_dir->path())+"/signed32_2.wav";
 
   //
-  // Stage One -- Convert Source Format to Signed 32 Bit Integer
+  // When streaming, encoders that can write to a pipe do so directly
+  // (signaled by an empty destination name), the rest go to a file that
+  // is copied out afterwards. If a destination file was given as well,
+  // it gets a copy of the stream.
   //
-  if((err=Stage1Convert(conv_src_filename,tmpfile1))!=
-     RDAudioConvert::ErrorOk) {
-    delete temp_dir;
-    return err;
+  // Streamed PCM gets a bare RIFF header, so PCM carrying cart or rdxl
+  // metadata is laid out by RDWaveFile in a file instead.
+  //
+  if(conv_dst_stream>=0) {
+    bool pcm=(conv_settings->format()==RDSettings::Pcm16)||
+      (conv_settings->format()==RDSettings::Pcm24);
+    if(RDAudioConvert::streamable(conv_settings->format())&&
+       ((!pcm)||((conv_dst_wavedata==NULL)&&conv_dst_rdxl.isEmpty()))) {
+      dstfile=QString();
+    }
+    else {
+      if(conv_dst_filename.isEmpty()) {
+	dstfile=QString(temp_dir->path())+"/destination";
+      }
+    }
   }
 
   //
-  // Stage Two -- Convert Levels, Sample Rate, Channelization, Speed
+  // Stage One -- Convert Source Format to Signed 32 Bit Integer
   //
-  if((err=Stage2Convert(tmpfile1,tmpfile2))!=
-     RDAudioConvert::ErrorOk) {
-    delete temp_dir;
-    return err;
+  // Normalization needs the peak level of the whole of Stage One's output
+  // before Stage Two can begin, so that goes to a file.  Otherwise Stage
+  // One runs alongside Stage Two in a thread, unless the output is
+  // streamed PCM and the source doesn't say how long it is (as the
+  // WAV header goes out first).
+  //
+  bool fixed_length=dstfile.isEmpty()&&
+    ((conv_settings->format()==RDSettings::Pcm16)||
+     (conv_settings->format()==RDSettings::Pcm24));
+  conv_skip_frames=0;
+  conv_skipped_frames=0;
+  if(fixed_length&&(conv_dst_first>44)&&(conv_speed_ratio==1.0)) {
+    //
+    // Frames wholly before the requested byte range, which Stage One may
+    // be able to seek past (see Stage1SndFile())
+    //
+    conv_skip_frames=(conv_dst_first-44)/(conv_settings->channels()*
+      (conv_settings->format()==RDSettings::Pcm24?3:2));
+  }
+  if(conv_settings->normalizationLevel()==0) {
+    sf_count_t frames=Stage1Frames();
+    if((!fixed_length)||(frames>=0)) {
+      conv_stage1_pipe=new RDStage1Pipe(this,conv_src_filename,frames);
+      if(!conv_stage1_pipe->start()) {
+	delete conv_stage1_pipe;
+	conv_stage1_pipe=NULL;
+      }
+    }
+  }
+  if(conv_stage1_pipe==NULL) {
+    if((err=Stage1Convert(conv_src_filename,tmpfile1))!=
+       RDAudioConvert::ErrorOk) {
+      delete temp_dir;
+      return err;
+    }
   }
 
   //
+  // Stage Two -- Convert Levels, Sample Rate, Channelization, Speed
   // Stage Three -- Write Out Destination Format
   //
-  if((err=Stage3Convert(tmpfile2,conv_dst_filename))!=
-     RDAudioConvert::ErrorOk) {
+  // Stage Three is fed from Stage Two a block at a time.
+  //
+  if(dstfile.isEmpty()&&(!conv_dst_filename.isEmpty())) {
+    unlink(conv_dst_filename.toUtf8());
+    conv_dst_tee=open(conv_dst_filename.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
+		      S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+  }
+  err=Stage3Convert(tmpfile1,dstfile,fixed_length);
+  if(conv_stage1_pipe!=NULL) {
+    delete conv_stage1_pipe;
+    conv_stage1_pipe=NULL;
+  }
+  if(conv_dst_tee>=0) {
+    ::close(conv_dst_tee);
+    conv_dst_tee=-1;
+  }
+  if(err!=RDAudioConvert::ErrorOk) {
     delete temp_dir;
     return err;
   }
+  if((conv_dst_stream>=0)&&(!dstfile.isEmpty())) {
+    if((err=CopyToStream(dstfile))!=RDAudioConvert::ErrorOk) {
+      delete temp_dir;
+      return err;
+    }
+  }
+  if(conv_dst_hashing&&conv_dst_sha1_hash.isEmpty()&&
+     (!conv_dst_filename.isEmpty())) {
+    conv_dst_sha1_hash=RDSha1HashFile(conv_dst_filename);
+  }
 
   //
   // Clean Up
@@ -229,6 +548,30 @@ bool RDAudioConvert::settingsValid(RDSettings *settings)
 }
 
 
+bool RDAudioConvert::streamable(RDSettings::Format fmt)
+{
+  //
+  // WAV containers need their chunk sizes fixed up after the fact, so
+  // can't be written to a pipe, save for PCM, whose length is known up
+  // front.
+  //
+  switch(fmt) {
+  case RDSettings::MpegL2:
+  case RDSettings::MpegL3:
+  case RDSettings::OggVorbis:
+  case RDSettings::Flac:
+  case RDSettings::Pcm16:
+  case RDSettings::Pcm24:
+    return true;
+
+  case RDSettings::MpegL1:
+  case RDSettings::MpegL2Wav:
+    break;
+  }
+  return false;
+}
+
+
 QString RDAudioConvert::errorText(RDAudioConvert::ErrorCode err)
 {
   QString ret=QString::asprintf("Unknown RDAudioConvert Error [%u]",err);
@@ -367,7 +710,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Flac(const QString &dstfile,
   sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
   sf_dst_info.channels=wave->getChannels();
   sf_dst_info.samplerate=wave->getSamplesPerSec();
-  if((sf_dst=sf_open(dstfile.toUtf8(),SFM_WRITE,&sf_dst_info))==NULL) {
+  if((sf_dst=OpenStage1Destination(dstfile,&sf_dst_info))==NULL) {
     return RDAudioConvert::ErrorNoDestination;
   }
 
@@ -422,7 +765,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Vorbis(const QString &dstfile,
   sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
   sf_dst_info.channels=wave->getChannels();
   sf_dst_info.samplerate=wave->getSamplesPerSec();
-  if((sf_dst=sf_open(dstfile.toUtf8(),SFM_WRITE,&sf_dst_info))==NULL) {
+  if((sf_dst=OpenStage1Destination(dstfile,&sf_dst_info))==NULL) {
     return RDAudioConvert::ErrorNoDestination;
   }
 
@@ -577,7 +920,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1Mpeg(const QString &dstfile,
   sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
   sf_dst_info.channels=wave->getChannels();
   sf_dst_info.samplerate=wave->getSamplesPerSec();
-  if((sf_dst=sf_open(dstfile.toUtf8(),SFM_WRITE,&sf_dst_info))==NULL) {
+  if((sf_dst=OpenStage1Destination(dstfile,&sf_dst_info))==NULL) {
     return RDAudioConvert::ErrorNoDestination;
   }
   sf_command(sf_dst,SFC_SET_NORM_DOUBLE,NULL,SF_FALSE);
@@ -775,7 +1118,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1M4A(const QString &dstfile,
   sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
   sf_dst_info.channels=wave->getChannels();
   sf_dst_info.samplerate=wave->getSamplesPerSec();
-  if((sf_dst=sf_open(dstfile.toUtf8(),SFM_WRITE,&sf_dst_info))==NULL) {
+  if((sf_dst=OpenStage1Destination(dstfile,&sf_dst_info))==NULL) {
     ret = RDAudioConvert::ErrorNoDestination;
     goto out_mp4_configbuf;
   }
@@ -866,32 +1209,61 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1SndFile(const QString &dstfile,
   SF_INFO sf_dst_info;
   sf_count_t start=0;
   sf_count_t end=sf_src_info->frames;
+  sf_count_t skip=0;
+  sf_count_t buffer_size=2048/sf_src_info->channels;
+
+  //
+  // Find Start and End
+  //
+  if(conv_start_point>0) {
+    start=sf_seek(sf_src,(double)conv_start_point*
+		  (double)sf_src_info->samplerate/1000.0,SEEK_SET);
+  }
+  if(conv_end_point>=0) {
+    end=(double)conv_end_point*(double)sf_src_info->samplerate/1000.0;
+  }
+
+  //
+  // When Stage Two passes samples through one for one, frames ahead of
+  // a requested byte range need not be read at all.  This has to be
+  // settled before the destination is opened, as that is what releases
+  // Stage Two to start reading.
+  //
+  if((conv_stage1_pipe!=NULL)&&(conv_skip_frames>0)&&
+     (sf_src_info->samplerate==(int)conv_settings->sampleRate())) {
+    skip=conv_skip_frames;
+    if(skip>(end-start)) {
+      skip=end-start;
+    }
+    if((skip>0)&&(sf_seek(sf_src,start+skip,SEEK_SET)==(start+skip))) {
+      start+=skip;
+      conv_skipped_frames=skip;
+    }
+  }
+  if((end-start)<buffer_size) {
+    buffer_size=end-start;
+  }
 
   //
   // Open Destination
   //
   sf_dst_info=*sf_src_info;
   sf_dst_info.format=SF_FORMAT_WAV|SF_FORMAT_FLOAT;
-  if((sf_dst=sf_open(dstfile.toUtf8(),SFM_WRITE,&sf_dst_info))==NULL) {
+  if((sf_dst=OpenStage1Destination(dstfile,&sf_dst_info))==NULL) {
     return RDAudioConvert::ErrorNoDestination;
   }
 
   //
   // Transfer Data
   //
-  sf_count_t buffer_size=2048/sf_src_info->channels;
   float *buffer=new float[2048];
   sf_count_t n=0;
-  if(conv_start_point>0) {
-    start=sf_seek(sf_src,(double)conv_start_point*
-		  (double)sf_src_info->samplerate/1000.0,SEEK_SET);
-  }
-  if(conv_end_point>=0) {
-    end=(double)conv_end_point*(double)sf_src_info->samplerate/1000.0;
-  }
-  while((n=sf_readf_float(sf_src,buffer,buffer_size))>0) {
+  while((buffer_size>0)&&
+	((n=sf_readf_float(sf_src,buffer,buffer_size))>0)) {
     UpdatePeak(buffer,n*sf_src_info->channels);
-    sf_writef_float(sf_dst,buffer,n);
+    if(sf_writef_float(sf_dst,buffer,n)!=n) {
+      break;  // Stage Two has stopped reading
+    }
     start+=n;
     if((end-start)<buffer_size) {
       buffer_size=end-start;
@@ -905,279 +1277,757 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage1SndFile(const QString &dstfile,
 }
 
 
-RDAudioConvert::ErrorCode RDAudioConvert::Stage2Convert(const QString &srcfile,
-							const QString &dstfile)
+SNDFILE *RDAudioConvert::OpenStage1Destination(const QString &dstfile,
+					       SF_INFO *info)
 {
-  soundtouch::SoundTouch *st_conv=NULL;
-  SNDFILE *src_sf=NULL;
-  SNDFILE *dst_sf=NULL;
-  SF_INFO src_info;
-  SF_INFO dst_info;
-  SRC_STATE *src_state=NULL;
-  SRC_DATA src_data;
-  float *pcm[3]={NULL,NULL,NULL};
-  bool free_pcm[3]={false,false,false};
-  int err;
-  sf_count_t n;
-  float ratio=1.0;
-
-  //
-  // Open Files
-  //
-  memset(&src_info,0,sizeof(src_info));
-  if((src_sf=sf_open(srcfile.toUtf8(),SFM_READ,&src_info))==NULL) {
-    rda->syslog(LOG_WARNING,"Could not open %s",(const char *)srcfile.toUtf8());
-    return RDAudioConvert::ErrorInternal;
-  }
-  sf_command(src_sf,SFC_SET_NORM_FLOAT,NULL,SF_FALSE);
-  sf_command(dst_sf,SFC_SET_CLIPPING,NULL,SF_TRUE);
-  memset(&dst_info,0,sizeof(dst_info));
-  dst_info.format=SF_FORMAT_WAV|SF_FORMAT_PCM_32;
-  dst_info.channels=conv_settings->channels();
-  dst_info.samplerate=conv_settings->sampleRate();
-  if((dst_sf=sf_open(dstfile.toUtf8(),SFM_WRITE,&dst_info))==NULL) {
-    sf_close(src_sf);
-    rda->syslog(LOG_WARNING,"Could not open %s",(const char *)dstfile.toUtf8());
-    return RDAudioConvert::ErrorInternal;
+  if(conv_stage1_pipe!=NULL) {
+    return conv_stage1_pipe->openWriter(info);
   }
+  return sf_open(dstfile.toUtf8(),SFM_WRITE,info);
+}
 
+
+sf_count_t RDAudioConvert::Stage1Frames(int *samplerate)
+{
   //
-  // Allocate Buffers
+  // The number of frames Stage One will put out, or -1 if that can't be
+  // had from the source header
   //
-  pcm[0]=new float[STAGE2_BUFFER_SIZE];
-  free_pcm[0]=true;
-  if(dst_info.samplerate!=src_info.samplerate) {
-    pcm[1]=new float[STAGE2_BUFFER_SIZE];
-    free_pcm[1]=true;
-    if(dst_info.channels!=src_info.channels) {
-      pcm[2]=new float[STAGE2_BUFFER_SIZE];
-      free_pcm[2]=true;
-    }
-    else {
-      pcm[2]=pcm[1];
+  RDWaveFile *wave=new RDWaveFile(conv_src_filename);
+  sf_count_t start=0;
+  sf_count_t end=-1;
+  double rate;
+
+  if(wave->openWave()) {
+    rate=(double)wave->getSamplesPerSec();
+    if((rate>0.0)&&(wave->getSampleLength()>0)) {
+      end=wave->getSampleLength();
+      if((conv_end_point>=0)&&
+	 ((sf_count_t)((double)conv_end_point*rate/1000.0)<end)) {
+	end=(double)conv_end_point*rate/1000.0;
+      }
+      if(conv_start_point>0) {
+	start=(double)conv_start_point*rate/1000.0;
+      }
+      if(start>end) {
+	start=end;
+      }
+      if(samplerate!=NULL) {
+	*samplerate=wave->getSamplesPerSec();
+      }
     }
+    wave->closeWave();
   }
-  else {
-    pcm[1]=pcm[0];
-    if(dst_info.channels!=src_info.channels) {
-      pcm[2]=new float[STAGE2_BUFFER_SIZE];
-      free_pcm[2]=true;
-    }
-    else {
-      pcm[2]=pcm[0];
-    }
-  }  
+  delete wave;
+  if(end<0) {
+    return -1;
+  }
+  return end-start;
+}
 
 
+sf_count_t RDAudioConvert::Stage2Frames(sf_count_t frames,int src_rate,
+					int dst_rate,float speed)
+{
   //
-  // Initialize Rate Converter
+  // The number of frames Stage Two makes of 'frames' Stage One frames
   //
-  if(dst_info.samplerate!=src_info.samplerate) {
-    if((src_state=src_new(conv_src_converter,src_info.channels,&err))==NULL) {
-      sf_close(src_sf);
-      sf_close(dst_sf);
-      rda->syslog(LOG_WARNING,"%s",src_strerror(err));
-      return RDAudioConvert::ErrorInternal;
-    }
-    memset(&src_data,0,sizeof(src_data));
-    src_data.src_ratio=(double)dst_info.samplerate/(double)src_info.samplerate;
-    src_data.data_in=pcm[0];
-    src_data.data_out=pcm[1];
-    src_data.output_frames=STAGE2_XFER_SIZE*dst_info.samplerate/
-      src_info.samplerate+src_info.channels;
-  }
+  double ret=(double)frames*(double)dst_rate/(double)src_rate;
 
-  //
-  // Initialize Speed Converter
-  //
-  if(conv_speed_ratio!=1.0) {
-    st_conv=new soundtouch::SoundTouch();
-    st_conv->setTempo(conv_speed_ratio);
-    st_conv->setSampleRate(dst_info.samplerate);
-    st_conv->setChannels(dst_info.channels);
-  }
+  ret/=speed;
+  return (sf_count_t)(ret+0.5);
+}
 
-  //
-  // Calculate Gain Ratio
-  //
-  if(conv_settings->normalizationLevel()!=0) {
-    float gain=
-      (float)conv_settings->normalizationLevel()-20.0*log10f(conv_peak_sample);
-    ratio=exp10f(gain/20.0);
-  }
 
-  //
-  // Convert
-  //
-  while((n=sf_readf_float(src_sf,pcm[0],STAGE2_XFER_SIZE))>0) {
+RDStage1Pipe::RDStage1Pipe(RDAudioConvert *conv,const QString &srcfile,
+			   sf_count_t frames)
+{
+  pipe_conv=conv;
+  pipe_srcfile=srcfile;
+  pipe_frames=frames;
+  pipe_running=false;
+  pipe_buffer_ptr=0;
+  pipe_written=0;
+  pipe_channels=0;
+  pipe_samplerate=0;
+  pipe_format_ready=false;
+  pipe_finished=false;
+  pipe_cancelled=false;
+  pipe_error=RDAudioConvert::ErrorOk;
+  pthread_mutex_init(&pipe_mutex,NULL);
+  pthread_cond_init(&pipe_cond,NULL);
+}
 
-    //
-    // Levels
-    //
-    if(ratio!=1.0) {
-      for(unsigned i=0;i<(n*src_info.channels);i++) {
-	pcm[0][i]=ratio*pcm[0][i];
-      }
-    }
 
-    //
-    // Sample Rate
-    //
-    if(src_state!=NULL) {
-      src_data.input_frames=n;
-      if((err=src_process(src_state,&src_data))!=0) {
-        fprintf(stderr,"SRC Error: %s\n",src_strerror(err));
-        rda->syslog(LOG_WARNING,"%s",src_strerror(err));
-        return RDAudioConvert::ErrorInternal;
-      }
-      n=src_data.output_frames_gen;
-    }
+RDStage1Pipe::~RDStage1Pipe()
+{
+  if(pipe_running) {
+    pthread_mutex_lock(&pipe_mutex);
+    pipe_cancelled=true;
+    pthread_cond_broadcast(&pipe_cond);
+    pthread_mutex_unlock(&pipe_mutex);
+    pthread_join(pipe_thread,NULL);
+  }
+  pthread_cond_destroy(&pipe_cond);
+  pthread_mutex_destroy(&pipe_mutex);
+}
 
-    //
-    // Channelization
-    //
-    switch(src_info.channels) {
-    case 1:
-      switch(dst_info.channels) {
-      case 1:  // Nothing to do
-	break;
 
-      case 2:
-	for(unsigned i=0;i<n;i++) {
-	  pcm[2][2*i]=pcm[1][i];
-	  pcm[2][2*i+1]=pcm[1][i];
-	}
-	break;
-      }
-      break;
+bool RDStage1Pipe::start()
+{
+  pipe_running=
+    pthread_create(&pipe_thread,NULL,RDStage1Pipe::ThreadCallback,this)==0;
+  return pipe_running;
+}
 
-    case 2:
-      switch(dst_info.channels) {
-      case 1:
-	for(unsigned i=0;i<n;i++) {
-	  pcm[2][i]=(pcm[1][2*i]+pcm[1][2*i+1])/2;
-	}
-	break;
 
-      case 2:  // Nothing to do
-	break;
-      }
-      break;
-    }
+SNDFILE *RDStage1Pipe::openWriter(SF_INFO *info)
+{
+  SF_VIRTUAL_IO vio;
+  SNDFILE *sf=NULL;
+
+  info->format=SF_FORMAT_RAW|SF_FORMAT_FLOAT|SF_ENDIAN_CPU;
+  memset(&vio,0,sizeof(vio));
+  vio.get_filelen=RDStage1Pipe::GetFilelenCallback;
+  vio.seek=RDStage1Pipe::SeekCallback;
+  vio.read=RDStage1Pipe::ReadCallback;
+  vio.write=RDStage1Pipe::WriteCallback;
+  vio.tell=RDStage1Pipe::TellCallback;
+  if((sf=sf_open_virtual(&vio,SFM_WRITE,info,this))!=NULL) {
+    pthread_mutex_lock(&pipe_mutex);
+    pipe_channels=info->channels;
+    pipe_samplerate=info->samplerate;
+    pipe_format_ready=true;
+    pthread_cond_broadcast(&pipe_cond);
+    pthread_mutex_unlock(&pipe_mutex);
+  }
+  return sf;
+}
 
-    //
-    // Speed
-    //
-    if(st_conv!=NULL) {
-      st_conv->putSamples((soundtouch::SAMPLETYPE *)pcm[2],n);
-      n=st_conv->receiveSamples((soundtouch::SAMPLETYPE *)pcm[2],STAGE2_BUFFER_SIZE/dst_info.channels);
-    }
 
-    //
-    // Write Output
-    //
-    if(sf_writef_float(dst_sf,pcm[2],n)!=n) {
-      for(unsigned i=0;i<3;i++) {
-	if(free_pcm[i]) {
-	  delete pcm[i];
-	}
-      }
-      if(src_state!=NULL) {
-	src_delete(src_state);
-      }
-      sf_close(src_sf);
-      sf_close(dst_sf);
-      return RDAudioConvert::ErrorNoSpace;
+RDAudioConvert::ErrorCode RDStage1Pipe::waitForFormat(SF_INFO *info)
+{
+  RDAudioConvert::ErrorCode ret=RDAudioConvert::ErrorOk;
+
+  pthread_mutex_lock(&pipe_mutex);
+  while((!pipe_format_ready)&&(!pipe_finished)) {
+    pthread_cond_wait(&pipe_cond,&pipe_mutex);
+  }
+  if(pipe_format_ready) {
+    memset(info,0,sizeof(SF_INFO));
+    info->channels=pipe_channels;
+    info->samplerate=pipe_samplerate;
+    if(pipe_frames>0) {
+      info->frames=pipe_frames;
     }
-    usleep(conv_transcoding_delay);
   }
-
-  //
-  // Finish Up Speed Conversion
-  //
-  if(st_conv!=NULL) {
-    st_conv->flush();
-    while((n=st_conv->
-	   receiveSamples((soundtouch::SAMPLETYPE *)pcm[2],
-			  STAGE2_BUFFER_SIZE/dst_info.channels))>0) {
-      if(sf_writef_float(dst_sf,pcm[2],n)!=n) {
-	for(unsigned i=0;i<3;i++) {
-	  if(free_pcm[i]) {
-	    delete pcm[i];
-	  }
-	}
-	if(src_state!=NULL) {
-	  src_delete(src_state);
-	}
-	sf_close(src_sf);
-	sf_close(dst_sf);
-	return RDAudioConvert::ErrorNoSpace;
-      }
-      usleep(conv_transcoding_delay);
+  else {
+    ret=pipe_error;
+    if(ret==RDAudioConvert::ErrorOk) {
+      ret=RDAudioConvert::ErrorInvalidSource;
     }
-    delete st_conv;
   }
+  pthread_mutex_unlock(&pipe_mutex);
 
+  return ret;
+}
+
+
+sf_count_t RDStage1Pipe::read(float *pcm,sf_count_t frames)
+{
+  int frame_size=pipe_channels*sizeof(float);
+  sf_count_t n=0;
+
+  pthread_mutex_lock(&pipe_mutex);
+  while((!pipe_finished)&&
+	((pipe_buffer.size()-pipe_buffer_ptr)<frame_size)) {
+    pthread_cond_wait(&pipe_cond,&pipe_mutex);
+  }
+  n=(pipe_buffer.size()-pipe_buffer_ptr)/frame_size;
+  if(n>frames) {
+    n=frames;
+  }
+  memcpy(pcm,pipe_buffer.constData()+pipe_buffer_ptr,n*frame_size);
+  pipe_buffer_ptr+=n*frame_size;
+  pthread_cond_broadcast(&pipe_cond);
+  pthread_mutex_unlock(&pipe_mutex);
+
+  return n;
+}
+
+
+RDAudioConvert::ErrorCode RDStage1Pipe::error()
+{
+  RDAudioConvert::ErrorCode ret;
+
+  pthread_mutex_lock(&pipe_mutex);
+  ret=pipe_error;
+  pthread_mutex_unlock(&pipe_mutex);
+
+  return ret;
+}
+
+
+void *RDStage1Pipe::ThreadCallback(void *priv)
+{
+  RDStage1Pipe *pipe=static_cast<RDStage1Pipe *>(priv);
+  RDAudioConvert::ErrorCode err;
+
+  err=pipe->pipe_conv->Stage1Convert(pipe->pipe_srcfile,QString());
+  pthread_mutex_lock(&pipe->pipe_mutex);
+  pipe->pipe_error=err;
+  pipe->pipe_finished=true;
+  pthread_cond_broadcast(&pipe->pipe_cond);
+  pthread_mutex_unlock(&pipe->pipe_mutex);
+
+  return NULL;
+}
+
+
+sf_count_t RDStage1Pipe::GetFilelenCallback(void *priv)
+{
+  return static_cast<RDStage1Pipe *>(priv)->pipe_written;
+}
+
+
+sf_count_t RDStage1Pipe::SeekCallback(sf_count_t offset,int whence,void *priv)
+{
+  RDStage1Pipe *pipe=static_cast<RDStage1Pipe *>(priv);
+  sf_count_t pos=offset;
+
+  if(whence!=SEEK_SET) {
+    pos=pipe->pipe_written+offset;
+  }
+
+  //
+  // Nowhere to go but where we are
+  //
+  if(pos!=pipe->pipe_written) {
+    return -1;
+  }
+  return pos;
+}
+
+
+sf_count_t RDStage1Pipe::ReadCallback(void *ptr,sf_count_t count,void *priv)
+{
+  return 0;
+}
+
+
+sf_count_t RDStage1Pipe::WriteCallback(const void *ptr,sf_count_t count,
+				       void *priv)
+{
+  RDStage1Pipe *pipe=static_cast<RDStage1Pipe *>(priv);
+
+  pthread_mutex_lock(&pipe->pipe_mutex);
+  while((!pipe->pipe_cancelled)&&
+	((pipe->pipe_buffer.size()-pipe->pipe_buffer_ptr)>=STAGE1_PIPE_SIZE)) {
+    pthread_cond_wait(&pipe->pipe_cond,&pipe->pipe_mutex);
+  }
+  if(pipe->pipe_cancelled) {
+    pthread_mutex_unlock(&pipe->pipe_mutex);
+    return 0;
+  }
+  if(pipe->pipe_buffer_ptr==pipe->pipe_buffer.size()) {
+    pipe->pipe_buffer.clear();
+    pipe->pipe_buffer_ptr=0;
+  }
+  if(pipe->pipe_buffer_ptr>=STAGE1_PIPE_SIZE) {
+    pipe->pipe_buffer.remove(0,pipe->pipe_buffer_ptr);
+    pipe->pipe_buffer_ptr=0;
+  }
+  pipe->pipe_buffer.append((const char *)ptr,count);
+  pipe->pipe_written+=count;
+  pthread_cond_broadcast(&pipe->pipe_cond);
+  pthread_mutex_unlock(&pipe->pipe_mutex);
+
+  return count;
+}
+
+
+sf_count_t RDStage1Pipe::TellCallback(void *priv)
+{
+  return static_cast<RDStage1Pipe *>(priv)->pipe_written;
+}
+
+
+RDStage2Reader::RDStage2Reader(RDAudioConvert *conv)
+{
+  reader_conv=conv;
+  reader_src_sf=NULL;
+  reader_sf=NULL;
+  reader_src_state=NULL;
+  reader_st_conv=NULL;
+  for(int i=0;i<3;i++) {
+    reader_pcm[i]=NULL;
+    reader_free_pcm[i]=false;
+  }
+  reader_ratio=1.0;
+  reader_pending_ptr=0;
+  reader_length=0;
+  reader_position=0;
+  reader_fixed_length=false;
+  reader_eof=false;
+  reader_error=RDAudioConvert::ErrorOk;
+}
+
+
+RDStage2Reader::~RDStage2Reader()
+{
+  if(reader_sf!=NULL) {
+    sf_close(reader_sf);
+  }
+  if(reader_st_conv!=NULL) {
+    delete reader_st_conv;
+  }
+  if(reader_src_state!=NULL) {
+    src_delete(reader_src_state);
+  }
+  for(int i=0;i<3;i++) {
+    if(reader_free_pcm[i]) {
+      delete[] reader_pcm[i];
+    }
+  }
+  if(reader_src_sf!=NULL) {
+    sf_close(reader_src_sf);
+  }
+}
+
+
+RDAudioConvert::ErrorCode RDStage2Reader::open(const QString &srcfile,
+						bool fixed_length)
+{
+  RDSettings *settings=reader_conv->conv_settings;
+  SF_VIRTUAL_IO vio;
+  RDAudioConvert::ErrorCode ret;
+  int err;
+  sf_count_t frames;
+
+  //
+  // Open Source
+  //
+  reader_fixed_length=fixed_length;
+  memset(&reader_src_info,0,sizeof(reader_src_info));
+  if(reader_conv->conv_stage1_pipe!=NULL) {
+    if((ret=reader_conv->conv_stage1_pipe->waitForFormat(&reader_src_info))!=
+       RDAudioConvert::ErrorOk) {
+      return ret;
+    }
+    reader_src_info.frames-=reader_conv->conv_skipped_frames;
+    if(reader_src_info.frames<0) {
+      reader_src_info.frames=0;
+    }
+  }
+  else {
+    if((reader_src_sf=sf_open(srcfile.toUtf8(),SFM_READ,&reader_src_info))==
+       NULL) {
+      rda->syslog(LOG_WARNING,"Could not open %s",
+		  (const char *)srcfile.toUtf8());
+      return RDAudioConvert::ErrorInternal;
+    }
+    sf_command(reader_src_sf,SFC_SET_NORM_FLOAT,NULL,SF_FALSE);
+  }
+  memset(&reader_info,0,sizeof(reader_info));
+  reader_info.format=SF_FORMAT_RAW|SF_FORMAT_PCM_32|SF_ENDIAN_CPU;
+  reader_info.channels=settings->channels();
+  reader_info.samplerate=settings->sampleRate();
+
+  //
+  // Allocate Buffers
+  //
+  reader_pcm[0]=new float[STAGE2_BUFFER_SIZE];
+  reader_free_pcm[0]=true;
+  if(reader_info.samplerate!=reader_src_info.samplerate) {
+    reader_pcm[1]=new float[STAGE2_BUFFER_SIZE];
+    reader_free_pcm[1]=true;
+    if(reader_info.channels!=reader_src_info.channels) {
+      reader_pcm[2]=new float[STAGE2_BUFFER_SIZE];
+      reader_free_pcm[2]=true;
+    }
+    else {
+      reader_pcm[2]=reader_pcm[1];
+    }
+  }
+  else {
+    reader_pcm[1]=reader_pcm[0];
+    if(reader_info.channels!=reader_src_info.channels) {
+      reader_pcm[2]=new float[STAGE2_BUFFER_SIZE];
+      reader_free_pcm[2]=true;
+    }
+    else {
+      reader_pcm[2]=reader_pcm[0];
+    }
+  }
+
+  //
+  // Initialize Rate Converter
   //
-  // Clean Up
-  //
-  for(unsigned i=0;i<3;i++) {
-    if(free_pcm[i]) {
-      delete pcm[i];
+  if(reader_info.samplerate!=reader_src_info.samplerate) {
+    if((reader_src_state=src_new(reader_conv->conv_src_converter,
+				 reader_src_info.channels,&err))==NULL) {
+      rda->syslog(LOG_WARNING,"%s",src_strerror(err));
+      return RDAudioConvert::ErrorInternal;
     }
+    memset(&reader_src_data,0,sizeof(reader_src_data));
+    reader_src_data.src_ratio=
+      (double)reader_info.samplerate/(double)reader_src_info.samplerate;
+    reader_src_data.data_in=reader_pcm[0];
+    reader_src_data.data_out=reader_pcm[1];
+    reader_src_data.output_frames=STAGE2_XFER_SIZE*reader_info.samplerate/
+      reader_src_info.samplerate+reader_src_info.channels;
   }
-  if(src_state!=NULL) {
-    src_delete(src_state);
+
+  //
+  // Initialize Speed Converter
+  //
+  if(reader_conv->conv_speed_ratio!=1.0) {
+    reader_st_conv=new soundtouch::SoundTouch();
+    reader_st_conv->setTempo(reader_conv->conv_speed_ratio);
+    reader_st_conv->setSampleRate(reader_info.samplerate);
+    reader_st_conv->setChannels(reader_info.channels);
+  }
+
+  //
+  // Calculate Gain Ratio
+  //
+  if(settings->normalizationLevel()!=0) {
+    float gain=(float)settings->normalizationLevel()-
+      20.0*log10f(reader_conv->conv_peak_sample);
+    reader_ratio=exp10f(gain/20.0);
   }
-  sf_close(src_sf);
-  sf_close(dst_sf);
+
+  //
+  // Calculate Output Length
+  //
+  frames=RDAudioConvert::Stage2Frames(reader_src_info.frames,
+				     reader_src_info.samplerate,
+				     reader_info.samplerate,
+				     reader_conv->conv_speed_ratio);
+  if(reader_fixed_length) {
+    reader_length=frames*reader_info.channels*sizeof(int32_t);
+  }
+  else {
+    reader_length=
+      STAGE2_UNBOUNDED_FRAMES*reader_info.channels*sizeof(int32_t);
+  }
+
+  //
+  // Open Output
+  //
+  memset(&vio,0,sizeof(vio));
+  vio.get_filelen=RDStage2Reader::GetFilelenCallback;
+  vio.seek=RDStage2Reader::SeekCallback;
+  vio.read=RDStage2Reader::ReadCallback;
+  vio.tell=RDStage2Reader::TellCallback;
+  if((reader_sf=sf_open_virtual(&vio,SFM_READ,&reader_info,this))==NULL) {
+    rda->syslog(LOG_WARNING,"%s",sf_strerror(NULL));
+    return RDAudioConvert::ErrorInternal;
+  }
+
+  //
+  // Until the end is reached, the best guess at the length
+  //
+  reader_info.frames=frames;
 
   return RDAudioConvert::ErrorOk;
 }
 
 
+SNDFILE *RDStage2Reader::sndfile() const
+{
+  return reader_sf;
+}
+
+
+SF_INFO *RDStage2Reader::sfInfo()
+{
+  return &reader_info;
+}
+
+
+RDAudioConvert::ErrorCode RDStage2Reader::error() const
+{
+  return reader_error;
+}
+
+
+sf_count_t RDStage2Reader::ReadSource(float *pcm,sf_count_t frames)
+{
+  if(reader_conv->conv_stage1_pipe!=NULL) {
+    return reader_conv->conv_stage1_pipe->read(pcm,frames);
+  }
+  return sf_readf_float(reader_src_sf,pcm,frames);
+}
+
+
+bool RDStage2Reader::Process()
+{
+  sf_count_t n;
+  int err;
+
+  if(reader_eof) {
+    return false;
+  }
+  if((n=ReadSource(reader_pcm[0],STAGE2_XFER_SIZE))<=0) {
+    reader_eof=true;
+    if((reader_conv->conv_stage1_pipe!=NULL)&&
+       ((reader_error=reader_conv->conv_stage1_pipe->error())!=
+	RDAudioConvert::ErrorOk)) {
+      return false;
+    }
+
+    //
+    // Finish Up Speed Conversion
+    //
+    if(reader_st_conv!=NULL) {
+      reader_st_conv->flush();
+      while((n=reader_st_conv->
+	     receiveSamples((soundtouch::SAMPLETYPE *)reader_pcm[2],
+			    STAGE2_BUFFER_SIZE/reader_info.channels))>0) {
+	Append(reader_pcm[2],n);
+      }
+    }
+    return reader_pending.size()>0;
+  }
+
+  //
+  // Levels
+  //
+  if(reader_ratio!=1.0) {
+    for(unsigned i=0;i<(n*reader_src_info.channels);i++) {
+      reader_pcm[0][i]=reader_ratio*reader_pcm[0][i];
+    }
+  }
+
+  //
+  // Sample Rate
+  //
+  if(reader_src_state!=NULL) {
+    reader_src_data.input_frames=n;
+    if((err=src_process(reader_src_state,&reader_src_data))!=0) {
+      fprintf(stderr,"SRC Error: %s\n",src_strerror(err));
+      rda->syslog(LOG_WARNING,"%s",src_strerror(err));
+      reader_error=RDAudioConvert::ErrorInternal;
+      reader_eof=true;
+      return false;
+    }
+    n=reader_src_data.output_frames_gen;
+  }
+
+  //
+  // Channelization
+  //
+  switch(reader_src_info.channels) {
+  case 1:
+    switch(reader_info.channels) {
+    case 1:  // Nothing to do
+      break;
+
+    case 2:
+      for(unsigned i=0;i<n;i++) {
+	reader_pcm[2][2*i]=reader_pcm[1][i];
+	reader_pcm[2][2*i+1]=reader_pcm[1][i];
+      }
+      break;
+    }
+    break;
+
+  case 2:
+    switch(reader_info.channels) {
+    case 1:
+      for(unsigned i=0;i<n;i++) {
+	reader_pcm[2][i]=(reader_pcm[1][2*i]+reader_pcm[1][2*i+1])/2;
+      }
+      break;
+
+    case 2:  // Nothing to do
+      break;
+    }
+    break;
+  }
+
+  //
+  // Speed
+  //
+  if(reader_st_conv!=NULL) {
+    reader_st_conv->putSamples((soundtouch::SAMPLETYPE *)reader_pcm[2],n);
+    n=reader_st_conv->receiveSamples((soundtouch::SAMPLETYPE *)reader_pcm[2],
+				     STAGE2_BUFFER_SIZE/reader_info.channels);
+  }
+
+  Append(reader_pcm[2],n);
+  usleep(reader_conv->conv_transcoding_delay);
+
+  return true;
+}
+
+
+void RDStage2Reader::Append(const float *pcm,sf_count_t frames)
+{
+  int offset=reader_pending.size();
+  sf_count_t samples=frames*reader_info.channels;
+  int32_t *data=NULL;
+  double v;
+
+  reader_pending.resize(offset+samples*sizeof(int32_t));
+  data=(int32_t *)(reader_pending.data()+offset);
+  for(sf_count_t i=0;i<samples;i++) {
+    v=2147483648.0*(double)pcm[i];
+    if(v>=2147483647.0) {
+      data[i]=INT32_MAX;
+    }
+    else {
+      if(v<=-2147483648.0) {
+	data[i]=INT32_MIN;
+      }
+      else {
+	data[i]=(int32_t)lrint(v);
+      }
+    }
+  }
+}
+
+
+sf_count_t RDStage2Reader::GetFilelenCallback(void *priv)
+{
+  return static_cast<RDStage2Reader *>(priv)->reader_length;
+}
+
+
+sf_count_t RDStage2Reader::SeekCallback(sf_count_t offset,int whence,
+					void *priv)
+{
+  RDStage2Reader *reader=static_cast<RDStage2Reader *>(priv);
+  sf_count_t pos=offset;
+  char data[4096];
+
+  switch(whence) {
+  case SEEK_CUR:
+    pos=reader->reader_position+offset;
+    break;
+
+  case SEEK_END:
+    pos=reader->reader_length+offset;
+    break;
+  }
+
+  //
+  // Only forward, as what has been read is gone
+  //
+  while(reader->reader_position<pos) {
+    sf_count_t n=pos-reader->reader_position;
+    if(n>(sf_count_t)sizeof(data)) {
+      n=sizeof(data);
+    }
+    if(ReadCallback(data,n,priv)<=0) {
+      break;
+    }
+  }
+  if(reader->reader_position!=pos) {
+    return -1;
+  }
+  return pos;
+}
+
+
+sf_count_t RDStage2Reader::ReadCallback(void *ptr,sf_count_t count,void *priv)
+{
+  RDStage2Reader *reader=static_cast<RDStage2Reader *>(priv);
+  sf_count_t done=0;
+  sf_count_t n;
+
+  if(count>(reader->reader_length-reader->reader_position)) {
+    count=reader->reader_length-reader->reader_position;
+  }
+  while(done<count) {
+    if(reader->reader_pending_ptr>=reader->reader_pending.size()) {
+      reader->reader_pending.clear();
+      reader->reader_pending_ptr=0;
+      if(!reader->Process()) {
+	if(reader->reader_fixed_length&&
+	   (reader->reader_error==RDAudioConvert::ErrorOk)) {
+	  //
+	  // Pad out to the promised length
+	  //
+	  memset((char *)ptr+done,0,count-done);
+	  done=count;
+	}
+	break;
+      }
+      continue;
+    }
+    n=reader->reader_pending.size()-reader->reader_pending_ptr;
+    if(n>(count-done)) {
+      n=count-done;
+    }
+    memcpy((char *)ptr+done,
+	   reader->reader_pending.constData()+reader->reader_pending_ptr,n);
+    reader->reader_pending_ptr+=n;
+    done+=n;
+  }
+  reader->reader_position+=done;
+  if((done<count)&&(!reader->reader_fixed_length)) {
+    reader->reader_info.frames=reader->reader_position/
+      (reader->reader_info.channels*sizeof(int32_t));
+  }
+
+  return done;
+}
+
+
+sf_count_t RDStage2Reader::TellCallback(void *priv)
+{
+  return static_cast<RDStage2Reader *>(priv)->reader_position;
+}
+
+
 RDAudioConvert::ErrorCode RDAudioConvert::Stage3Convert(const QString &srcfile,
-							const QString &dstfile)
+							const QString &dstfile,
+							bool fixed_length)
 {
+  RDStage2Reader *reader=new RDStage2Reader(this);
   SNDFILE *src_sf=NULL;
-  SF_INFO src_sf_info;
+  SF_INFO *src_sf_info=NULL;
   RDAudioConvert::ErrorCode ret;
 
   //
-  // Open Source File
+  // Stage Two runs as we read from it
   //
-  if((src_sf=sf_open(srcfile.toUtf8(),SFM_READ,&src_sf_info))==NULL) {
-    rda->syslog(LOG_WARNING,"%s",sf_strerror(NULL));
-    return RDAudioConvert::ErrorInternal;
+  if((ret=reader->open(srcfile,fixed_length))!=RDAudioConvert::ErrorOk) {
+    delete reader;
+    return ret;
   }
+  src_sf=reader->sndfile();
+  src_sf_info=reader->sfInfo();
 
   switch(conv_settings->format()) {
   case RDSettings::Pcm16:
-    ret=Stage3Pcm16(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Pcm16(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::Pcm24:
-    ret=Stage3Pcm24(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Pcm24(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::MpegL2:
-    ret=Stage3Layer2(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Layer2(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::MpegL2Wav:
-    ret=Stage3Layer2Wav(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Layer2Wav(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::MpegL3:
-    ret=Stage3Layer3(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Layer3(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::Flac:
-    ret=Stage3Flac(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Flac(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::OggVorbis:
-    ret=Stage3Vorbis(src_sf,&src_sf_info,dstfile);
+    ret=Stage3Vorbis(src_sf,src_sf_info,dstfile);
     break;
 
   case RDSettings::MpegL1:
@@ -1185,7 +2035,10 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Convert(const QString &srcfile,
     ret=RDAudioConvert::ErrorInvalidSettings;
   }
 
-  sf_close(src_sf);
+  if(ret==RDAudioConvert::ErrorOk) {
+    ret=reader->error();
+  }
+  delete reader;
   return ret;
 }
 
@@ -1197,17 +2050,28 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Flac(SNDFILE *src_sf,
 #ifdef HAVE_FLAC
   sf_count_t n;
   int32_t *pcm;
+  RDFlacStreamEncoder *stream=NULL;
+  FLAC::Encoder::Stream *flac=NULL;
+  ::FLAC__StreamEncoderInitStatus status;
 
   //
   // Initialize Encoder
   //
-  FLAC::Encoder::File *flac=new FLAC::Encoder::File();
+  if(dstfile.isEmpty()) {
+    stream=new RDFlacStreamEncoder(this,conv_dst_stream);
+    flac=stream;
+  }
+  else {
+    flac=new FLAC::Encoder::File();
+  }
   flac->set_channels(src_sf_info->channels);
   flac->set_bits_per_sample(16);  // FIXME: Should vary by input file
   flac->set_sample_rate(src_sf_info->samplerate);
   //flac->set_compression_level(8);
   flac->set_blocksize(0);
-  unlink(dstfile.toUtf8());
+  if(stream==NULL) {
+    unlink(dstfile.toUtf8());
+  }
   /*
    * FLAC <1.2.x
    *
@@ -1225,7 +2089,13 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Flac(SNDFILE *src_sf,
   /*
    * FLAC 1.2.x
    */
-  switch(flac->init(dstfile.toUtf8())) {
+  if(stream==NULL) {
+    status=((FLAC::Encoder::File *)flac)->init(dstfile.toUtf8());
+  }
+  else {
+    status=stream->init();
+  }
+  switch(status) {
   case FLAC__STREAM_ENCODER_INIT_STATUS_OK:
     break;
 
@@ -1257,9 +2127,16 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Flac(SNDFILE *src_sf,
     for(unsigned i=0;i<(n*src_sf_info->channels);i++) {
       pcm[i]=pcm[i]>>16;
     }
-    flac->process_interleaved(pcm,n);
+    if(!flac->process_interleaved(pcm,n)) {
+      break;
+    }
   }
   flac->finish();
+  if((stream!=NULL)&&stream->writeFailed()) {
+    delete pcm;
+    delete flac;
+    return RDAudioConvert::ErrorNoSpace;
+  }
 
   //
   // Clean Up
@@ -1297,9 +2174,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
   //
   // Open Destination File
   //
-  unlink(dstfile.toUtf8());
-  if((dst_fd=open(dstfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
-		  S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+  if((dst_fd=OpenDestination(dstfile))<0) {
     return RDAudioConvert::ErrorNoDestination;
   } 
 
@@ -1349,18 +2224,18 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
       vorbis_analysis(&vorbis_block,&ogg_packet);
       ogg_stream_packetin(&ogg_stream,&ogg_packet);
       while(ogg_stream_pageout(&ogg_stream,&ogg_page)!=0) {
-	if(write(dst_fd,ogg_page.header,ogg_page.header_len)!=
+	if(WriteDestination(dst_fd,ogg_page.header,ogg_page.header_len)!=
 	   ogg_page.header_len) {
-	  ::close(dst_fd);
+	  CloseDestination(dst_fd);
 	  delete pcm;
 	  ogg_stream_clear(&ogg_stream);
 	  vorbis_comment_clear(&vorbis_comment);
 	  vorbis_info_clear(&vorbis_info);
 	  return RDAudioConvert::ErrorNoSpace; 
 	}
-	if(write(dst_fd,ogg_page.body,ogg_page.body_len)!=
+	if(WriteDestination(dst_fd,ogg_page.body,ogg_page.body_len)!=
 	   ogg_page.body_len) {
-	  ::close(dst_fd);
+	  CloseDestination(dst_fd);
 	  delete pcm;
 	  ogg_stream_clear(&ogg_stream);
 	  vorbis_comment_clear(&vorbis_comment);
@@ -1370,9 +2245,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
       }
     }
     while(ogg_stream_flush(&ogg_stream,&ogg_page)!=0) {
-      if(write(dst_fd,ogg_page.header,ogg_page.header_len)!=
+      if(WriteDestination(dst_fd,ogg_page.header,ogg_page.header_len)!=
 	 ogg_page.header_len) {
-	  ::close(dst_fd);
+	  CloseDestination(dst_fd);
 	  delete pcm;
 	  ogg_stream_clear(&ogg_stream);
 	  vorbis_comment_clear(&vorbis_comment);
@@ -1380,9 +2255,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
 	  return RDAudioConvert::ErrorNoSpace; 
 	}
       }
-    if(write(dst_fd,ogg_page.body,ogg_page.body_len)!=
+    if(WriteDestination(dst_fd,ogg_page.body,ogg_page.body_len)!=
        ogg_page.body_len) {
-      ::close(dst_fd);
+      CloseDestination(dst_fd);
       delete pcm;
       ogg_stream_clear(&ogg_stream);
       vorbis_comment_clear(&vorbis_comment);
@@ -1396,18 +2271,18 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
     vorbis_analysis(&vorbis_block,&ogg_packet);
     ogg_stream_packetin(&ogg_stream,&ogg_packet);
     while(ogg_stream_pageout(&ogg_stream,&ogg_page)!=0) {
-      if(write(dst_fd,ogg_page.header,ogg_page.header_len)!=
+      if(WriteDestination(dst_fd,ogg_page.header,ogg_page.header_len)!=
 	 ogg_page.header_len) {
-	::close(dst_fd);
+	CloseDestination(dst_fd);
 	delete pcm;
 	ogg_stream_clear(&ogg_stream);
 	vorbis_comment_clear(&vorbis_comment);
 	vorbis_info_clear(&vorbis_info);
 	return RDAudioConvert::ErrorNoSpace; 
       }
-      if(write(dst_fd,ogg_page.body,ogg_page.body_len)!=
+      if(WriteDestination(dst_fd,ogg_page.body,ogg_page.body_len)!=
 	 ogg_page.body_len) {
-	::close(dst_fd);
+	CloseDestination(dst_fd);
 	delete pcm;
 	ogg_stream_clear(&ogg_stream);
 	vorbis_comment_clear(&vorbis_comment);
@@ -1417,18 +2292,18 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
     }
   }
   while(ogg_stream_flush(&ogg_stream,&ogg_page)!=0) {
-    if(write(dst_fd,ogg_page.header,ogg_page.header_len)!=
+    if(WriteDestination(dst_fd,ogg_page.header,ogg_page.header_len)!=
        ogg_page.header_len) {
-      ::close(dst_fd);
+      CloseDestination(dst_fd);
       delete pcm;
       ogg_stream_clear(&ogg_stream);
       vorbis_comment_clear(&vorbis_comment);
       vorbis_info_clear(&vorbis_info);
       return RDAudioConvert::ErrorNoSpace; 
     }
-    if(write(dst_fd,ogg_page.body,ogg_page.body_len)!=
+    if(WriteDestination(dst_fd,ogg_page.body,ogg_page.body_len)!=
        ogg_page.body_len) {
-      ::close(dst_fd);
+      CloseDestination(dst_fd);
       delete pcm;
       ogg_stream_clear(&ogg_stream);
       vorbis_comment_clear(&vorbis_comment);
@@ -1440,7 +2315,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Vorbis(SNDFILE *src_sf,
   //
   // Clean Up
   //
-  ::close(dst_fd);
+  CloseDestination(dst_fd);
   delete pcm;
   ogg_stream_clear(&ogg_stream);
   vorbis_comment_clear(&vorbis_comment);
@@ -1492,18 +2367,26 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
   //
   // Open Destination File
   //
-  unlink(dstfile.toUtf8());
-  if((dst_fd=open(dstfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
-		  S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+  if((dst_fd=OpenDestination(dstfile))<0) {
     return RDAudioConvert::ErrorNoDestination;
   } 
 
+  //
+  // A stream can't be tagged after the fact, so lead with the tag
+  //
+  if((conv_dst_wavedata!=NULL)&&dstfile.isEmpty()) {
+    if(!WriteId3Tag(dst_fd,conv_dst_wavedata)) {
+      CloseDestination(dst_fd);
+      return RDAudioConvert::ErrorNoSpace;
+    }
+  }
+
   //
   // Initialize Encoder
   //
   if((lameopts=lame_init())==NULL) {
     lame_close(lameopts);
-    ::close(dst_fd);
+    CloseDestination(dst_fd);
     rda->syslog(LOG_WARNING,"lame_init() failure");
     return RDAudioConvert::ErrorInternal;
   }
@@ -1515,7 +2398,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
   lame_set_bWriteVbrTag(lameopts,0);
   if(lame_init_params(lameopts)!=0) {
     lame_close(lameopts);
-    ::close(dst_fd);
+    CloseDestination(dst_fd);
     return RDAudioConvert::ErrorInvalidSettings;
   }
 
@@ -1525,9 +2408,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
   if(src_sf_info->channels==2) {
     while((n=sf_readf_short(src_sf,pcm,1152))>0) {
       if((s=lame_encode_buffer_interleaved(lameopts,pcm,n,mpeg,2048))>=0) {
-	if(write(dst_fd,mpeg,s)!=s) {
+	if(WriteDestination(dst_fd,mpeg,s)!=s) {
 	  lame_close(lameopts);
-	  ::close(dst_fd);
+	  CloseDestination(dst_fd);
 	  return RDAudioConvert::ErrorNoSpace;
 	}
       }
@@ -1537,9 +2420,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
   else {
     while((n=sf_readf_short(src_sf,pcm,1152))>0) {
       if((s=lame_encode_buffer(lameopts,pcm,NULL,n,mpeg,2048))>=0) {
-	if(write(dst_fd,mpeg,s)!=s) {
+	if(WriteDestination(dst_fd,mpeg,s)!=s) {
 	  lame_close(lameopts);
-	  ::close(dst_fd);
+	  CloseDestination(dst_fd);
 	  return RDAudioConvert::ErrorNoSpace;
 	}
 	usleep(conv_transcoding_delay);
@@ -1547,9 +2430,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
     }
   }
   if((s=lame_encode_flush(lameopts,mpeg,2048))>=0) {
-    if(write(dst_fd,mpeg,s)!=s) {
+    if(WriteDestination(dst_fd,mpeg,s)!=s) {
       lame_close(lameopts);
-      ::close(dst_fd);
+      CloseDestination(dst_fd);
       return RDAudioConvert::ErrorNoSpace;
     }
   }
@@ -1558,12 +2441,12 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer3(SNDFILE *src_sf,
   // Clean Up
   //
   lame_close(lameopts);
-  ::close(dst_fd);
+  CloseDestination(dst_fd);
 
   //
   // Apply Metadata
   //
-  if(conv_dst_wavedata!=NULL) {
+  if((conv_dst_wavedata!=NULL)&&(!dstfile.isEmpty())) {
     ApplyId3Tag(dstfile,conv_dst_wavedata);
   }
 
@@ -1737,17 +2620,25 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2(SNDFILE *src_sf,
   //
   // Open Destination File
   //
-  unlink(dstfile.toUtf8());
-  if((dst_fd=open(dstfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
-		  S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+  if((dst_fd=OpenDestination(dstfile))<0) {
     return RDAudioConvert::ErrorNoDestination;
   } 
 
+  //
+  // A stream can't be tagged after the fact, so lead with the tag
+  //
+  if((conv_dst_wavedata!=NULL)&&dstfile.isEmpty()) {
+    if(!WriteId3Tag(dst_fd,conv_dst_wavedata)) {
+      CloseDestination(dst_fd);
+      return RDAudioConvert::ErrorNoSpace;
+    }
+  }
+
   //
   // Initialize Encoder
   //
   if((lameopts=twolame_init())==NULL) {
-    ::close(dst_fd);
+    CloseDestination(dst_fd);
     rda->syslog(LOG_WARNING,"twolame_init() failure");
     return RDAudioConvert::ErrorInternal;
   }
@@ -1758,7 +2649,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2(SNDFILE *src_sf,
   twolame_set_bitrate(lameopts,conv_settings->bitRate()/1000);
   if(twolame_init_params(lameopts)!=0) {
     twolame_close(&lameopts);
-    ::close(dst_fd);
+    CloseDestination(dst_fd);
     return RDAudioConvert::ErrorInvalidSettings;
   }
 
@@ -1768,9 +2659,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2(SNDFILE *src_sf,
   while((n=sf_readf_float(src_sf,pcm,1152))>0) {
     if((s=twolame_encode_buffer_float32_interleaved(lameopts,
 						    pcm,n,mpeg,2048))>=0) {
-      if(write(dst_fd,mpeg,s)!=s) {
+      if(WriteDestination(dst_fd,mpeg,s)!=s) {
 	twolame_close(&lameopts);
-	::close(dst_fd);
+	CloseDestination(dst_fd);
 	return RDAudioConvert::ErrorNoSpace;
       }
     }
@@ -1780,9 +2671,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2(SNDFILE *src_sf,
     usleep(conv_transcoding_delay);
   }
   if((s=twolame_encode_flush(lameopts,mpeg,2048))>=0) {
-    if(write(dst_fd,mpeg,s)!=s) {
+    if(WriteDestination(dst_fd,mpeg,s)!=s) {
       twolame_close(&lameopts);
-      ::close(dst_fd);
+      CloseDestination(dst_fd);
       return RDAudioConvert::ErrorNoSpace;
     }
   }
@@ -1794,12 +2685,12 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Layer2(SNDFILE *src_sf,
   // Clean Up
   //
   twolame_close(&lameopts);
-  ::close(dst_fd);
+  CloseDestination(dst_fd);
 
   //
   // Apply Metadata
   //
-  if(conv_dst_wavedata!=NULL) {
+  if((conv_dst_wavedata!=NULL)&&(!dstfile.isEmpty())) {
     ApplyId3Tag(dstfile,conv_dst_wavedata);
   }
 
@@ -1817,6 +2708,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm16(SNDFILE *src_sf,
   short *sf_buffer=NULL;
   ssize_t n;
 
+  if(dstfile.isEmpty()) {
+    return Stage3PcmStream(src_sf,src_sf_info,16);
+  }
   RDWaveFile *wave=new RDWaveFile(dstfile);
   wave->setFormatTag(WAVE_FORMAT_PCM);
   wave->setChannels(src_sf_info->channels);
@@ -1830,6 +2724,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm16(SNDFILE *src_sf,
 	      exp10((double)conv_settings->normalizationLevel()/20.0));
   }
   wave->setLevlChunk(true);
+  if(conv_dst_hashing&&(dstfile==conv_dst_filename)) {
+    wave->setHashing(true,src_sf_info->frames*src_sf_info->channels*2);
+  }
   sf_buffer=new int16_t[2048*src_sf_info->channels];
   unlink(dstfile.toUtf8());
   if(!wave->createWave(conv_dst_wavedata,conv_start_point)) {
@@ -1848,6 +2745,7 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm16(SNDFILE *src_sf,
   }
   delete sf_buffer;
   wave->closeWave();
+  conv_dst_sha1_hash=wave->sha1Hash();
   delete wave;
   return RDAudioConvert::ErrorOk;
 }
@@ -1861,6 +2759,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm24(SNDFILE *src_sf,
   uint8_t *pcm24=NULL;
   ssize_t n;
 
+  if(dstfile.isEmpty()) {
+    return Stage3PcmStream(src_sf,src_sf_info,24);
+  }
   RDWaveFile *wave=new RDWaveFile(dstfile);
   wave->setFormatTag(WAVE_FORMAT_PCM);
   wave->setChannels(src_sf_info->channels);
@@ -1874,6 +2775,9 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm24(SNDFILE *src_sf,
 	      exp10((double)conv_settings->normalizationLevel()/20.0));
   }
   wave->setLevlChunk(true);
+  if(conv_dst_hashing&&(dstfile==conv_dst_filename)) {
+    wave->setHashing(true,src_sf_info->frames*src_sf_info->channels*3);
+  }
   sf_buffer=new int[2048*src_sf_info->channels];
   pcm24=new uint8_t[2048*src_sf_info->channels*sizeof(int)];
   unlink(dstfile.toUtf8());
@@ -1899,16 +2803,218 @@ RDAudioConvert::ErrorCode RDAudioConvert::Stage3Pcm24(SNDFILE *src_sf,
   delete sf_buffer;
   delete pcm24;
   wave->closeWave();
+  conv_dst_sha1_hash=wave->sha1Hash();
   delete wave;
   return RDAudioConvert::ErrorOk;
 }
 
 
+RDAudioConvert::ErrorCode RDAudioConvert::Stage3PcmStream(SNDFILE *src_sf,
+							  SF_INFO *src_sf_info,
+							  int bits)
+{
+  int bytes=bits/8;
+  int chans=src_sf_info->channels;
+  uint64_t data_len=
+    (uint64_t)(src_sf_info->frames+conv_skipped_frames)*chans*bytes;
+  uint8_t hdr[44];
+  int *sf_buffer=NULL;
+  uint8_t *pcm=NULL;
+  sf_count_t n;
+  int64_t offset=0;
+
+  //
+  // The length is known before we start, so the header goes out first
+  // rather than being fixed up afterwards.  Data chunks are padded to an
+  // even length.  Output with cart or rdxl metadata never gets here (see
+  // convert()).
+  //
+  // Frames skipped by Stage One (see Stage1SndFile()) still count toward
+  // the header and the byte offsets, so a byte range comes out the same as
+  // the corresponding part of the whole.
+  //
+  if((36+data_len+(data_len%2))>0xFFFFFFFF) {
+    return RDAudioConvert::ErrorFormatError;
+  }
+  memcpy(hdr,"RIFF",4);
+  __RDAudioConvert_PutDword(hdr+4,36+data_len+(data_len%2));
+  memcpy(hdr+8,"WAVEfmt ",8);
+  __RDAudioConvert_PutDword(hdr+16,16);
+  __RDAudioConvert_PutWord(hdr+20,WAVE_FORMAT_PCM);
+  __RDAudioConvert_PutWord(hdr+22,chans);
+  __RDAudioConvert_PutDword(hdr+24,src_sf_info->samplerate);
+  __RDAudioConvert_PutDword(hdr+28,src_sf_info->samplerate*chans*bytes);
+  __RDAudioConvert_PutWord(hdr+32,chans*bytes);
+  __RDAudioConvert_PutWord(hdr+34,bits);
+  memcpy(hdr+36,"data",4);
+  __RDAudioConvert_PutDword(hdr+40,data_len);
+  if(!WriteStreamRange(hdr,44,&offset)) {
+    return RDAudioConvert::ErrorNoSpace;
+  }
+  offset+=(int64_t)conv_skipped_frames*chans*bytes;
+
+  sf_buffer=new int[2048*chans];
+  pcm=new uint8_t[2048*chans*bytes];
+  while(((conv_dst_last<0)||(offset<=conv_dst_last))&&
+	((n=sf_readf_int(src_sf,sf_buffer,2048))>0)) {
+    for(sf_count_t i=0;i<(n*chans);i++) {
+      for(int j=0;j<bytes;j++) {
+	pcm[bytes*i+j]=0xFF&(sf_buffer[i]>>(8*(4-bytes+j)));
+      }
+    }
+    if(!WriteStreamRange(pcm,n*chans*bytes,&offset)) {
+      delete[] sf_buffer;
+      delete[] pcm;
+      return RDAudioConvert::ErrorNoSpace;
+    }
+  }
+  delete[] sf_buffer;
+  if(data_len%2) {
+    pcm[0]=0;
+    if(!WriteStreamRange(pcm,1,&offset)) {
+      delete[] pcm;
+      return RDAudioConvert::ErrorNoSpace;
+    }
+  }
+  delete[] pcm;
+
+  return RDAudioConvert::ErrorOk;
+}
+
+
+bool RDAudioConvert::WriteStreamRange(const uint8_t *data,int64_t len,
+				      int64_t *offset)
+{
+  //
+  // Write out the part of 'len' bytes at stream position 'offset' that
+  // falls within the destination byte range
+  //
+  int64_t first=0;
+  int64_t last=len;
+
+  if(conv_dst_first>*offset) {
+    first=conv_dst_first-*offset;
+  }
+  if((conv_dst_last>=0)&&((conv_dst_last+1-*offset)<last)) {
+    last=conv_dst_last+1-*offset;
+  }
+  *offset+=len;
+  if(first>=last) {
+    return true;
+  }
+  return WriteDestination(conv_dst_stream,data+first,last-first)==
+    (last-first);
+}
+
+
+int RDAudioConvert::OpenDestination(const QString &dstfile)
+{
+  if(dstfile.isEmpty()) {
+    return conv_dst_stream;
+  }
+  unlink(dstfile.toUtf8());
+  return open(dstfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
+	      S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+}
+
+
+ssize_t RDAudioConvert::WriteDestination(int fd,const void *data,size_t len)
+{
+  ssize_t n;
+  size_t done=0;
+
+  if(fd!=conv_dst_stream) {
+    return write(fd,data,len);
+  }
+
+  //
+  // Nothing goes out until we have real data, so that early failures can
+  // still be reported normally by the caller.
+  //
+  if((len>0)&&(conv_stream_bytes==0)&&(conv_dst_preamble.size()>0)) {
+    if(write(fd,conv_dst_preamble.constData(),conv_dst_preamble.size())!=
+       (ssize_t)conv_dst_preamble.size()) {
+      return -1;
+    }
+  }
+  while(done<len) {
+    if((n=write(fd,(const char *)data+done,len-done))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      return -1;
+    }
+    done+=n;
+  }
+  conv_stream_bytes+=done;
+
+  //
+  // Losing the copy is not fatal to the stream
+  //
+  if((conv_dst_tee>=0)&&(write(conv_dst_tee,data,len)!=(ssize_t)len)) {
+    ::close(conv_dst_tee);
+    conv_dst_tee=-1;
+    unlink(conv_dst_filename.toUtf8());
+  }
+
+  return done;
+}
+
+
+void RDAudioConvert::CloseDestination(int fd)
+{
+  if(fd!=conv_dst_stream) {
+    ::close(fd);
+  }
+}
+
+
+RDAudioConvert::ErrorCode RDAudioConvert::CopyToStream(const QString &filename)
+{
+  int fd=-1;
+  ssize_t n;
+  char data[STAGE2_BUFFER_SIZE];
+
+  if((fd=open(filename.toUtf8(),O_RDONLY))<0) {
+    return RDAudioConvert::ErrorInternal;
+  }
+  while((n=read(fd,data,STAGE2_BUFFER_SIZE))>0) {
+    if(WriteDestination(conv_dst_stream,data,n)!=n) {
+      ::close(fd);
+      return RDAudioConvert::ErrorNoSpace;
+    }
+  }
+  ::close(fd);
+
+  return RDAudioConvert::ErrorOk;
+}
+
+
+bool RDAudioConvert::WriteId3Tag(int fd,RDWaveData *wavedata)
+{
+  TagLib::ID3v2::Tag *tag=new TagLib::ID3v2::Tag();
+
+  RenderId3Tag(tag,wavedata);
+  TagLib::ByteVector data=tag->render();
+  delete tag;
+
+  return WriteDestination(fd,data.data(),data.size())==(ssize_t)data.size();
+}
+
+
 void RDAudioConvert::ApplyId3Tag(const QString &filename,RDWaveData *wavedata)
 {
   TagLib::MPEG::File *file=new TagLib::MPEG::File(filename.toUtf8(),false);
+
+  RenderId3Tag(file->ID3v2Tag(),wavedata);
+  file->save();
+  delete file;
+}
+
+
+void RDAudioConvert::RenderId3Tag(TagLib::ID3v2::Tag *tag,RDWaveData *wavedata)
+{
   TagLib::PropertyMap *map=new TagLib::PropertyMap();
-  TagLib::ID3v2::Tag *tag=file->ID3v2Tag();
 
   AddId3Property(map,"TITLE",wavedata->title());
   if(!wavedata->artist().isEmpty()) {
@@ -1956,10 +3062,7 @@ void RDAudioConvert::ApplyId3Tag(const QString &filename,RDWaveData *wavedata)
     tag->addFrame(frame);
   }
   delete cart;
-
-  file->save();
   delete map;
-  delete file;
 }
 
 
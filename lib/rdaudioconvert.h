@@ -24,6 +24,7 @@
 #include <sndfile.h>
 #include <taglib/taglib.h>
 #include <taglib/tpropertymap.h>
+#include <taglib/id3v2tag.h>
 #ifdef HAVE_TWOLAME
 #include <twolame.h>
 #endif  // HAVE_TWOLAME
@@ -36,6 +37,7 @@
 
 #include <rdmp4.h>
 
+#include <qbytearray.h>
 #include <qobject.h>
 
 #include "rdconfig.h"
@@ -43,9 +45,16 @@
 #include "rdwavedata.h"
 #include "rdwavefile.h"
 
+class RDStage1Pipe;
+
 class RDAudioConvert : public QObject
 {
-  Q_OBJECT;
+  Q_OBJECT
+#ifdef HAVE_FLAC
+  friend class RDFlacStreamEncoder;
+#endif  // HAVE_FLAC
+  friend class RDStage1Pipe;
+  friend class RDStage2Reader;
  public:
   enum ErrorCode {ErrorOk=0,ErrorInvalidSettings=1,ErrorNoSource=2,
 		  ErrorNoDestination=3,ErrorInvalidSource=4,ErrorInternal=5,
@@ -55,15 +64,22 @@ class RDAudioConvert : public QObject
   ~RDAudioConvert();
   void setSourceFile(const QString &filename);
   void setDestinationFile(const QString &filename);
+  void setDestinationStream(int fd,const QByteArray &preamble=QByteArray());
+  uint64_t streamBytesWritten() const;
+  void setDestinationByteRange(int64_t first,int64_t last);
+  int64_t streamLength();
   void setDestinationSettings(RDSettings *settings);
   RDWaveData *sourceWaveData() const;
   QString sourceRdxl() const;
   void setDestinationWaveData(RDWaveData *wavedata);
   void setDestinationRdxl(const QString &xml);
+  void setDestinationHashing(bool state);
+  QString destinationSha1Hash() const;
   void setRange(int start_pt,int end_pt);
   void setSpeedRatio(float ratio);
   RDAudioConvert::ErrorCode convert();
   static bool settingsValid(RDSettings *settings);
+  static bool streamable(RDSettings::Format fmt);
   static QString errorText(RDAudioConvert::ErrorCode err);
 
  private:
@@ -80,10 +96,13 @@ class RDAudioConvert : public QObject
   RDAudioConvert::ErrorCode Stage1SndFile(const QString &dstfile,
 					  SNDFILE *sf_src,
 					  SF_INFO *sf_src_info);
-  RDAudioConvert::ErrorCode Stage2Convert(const QString &srcfile,
-					  const QString &dstfile);
+  SNDFILE *OpenStage1Destination(const QString &dstfile,SF_INFO *info);
+  sf_count_t Stage1Frames(int *samplerate=NULL);
+  static sf_count_t Stage2Frames(sf_count_t frames,int src_rate,int dst_rate,
+				 float speed);
   RDAudioConvert::ErrorCode Stage3Convert(const QString &srcfile,
-					  const QString &dstfile);
+					  const QString &dstfile,
+					  bool fixed_length);
   RDAudioConvert::ErrorCode Stage3Flac(SNDFILE *src_sf,SF_INFO *src_sf_info,
 				       const QString &dstfile);
   RDAudioConvert::ErrorCode Stage3Vorbis(SNDFILE *src_sf,SF_INFO *src_sf_info,
@@ -99,7 +118,16 @@ class RDAudioConvert : public QObject
 					const QString &dstfile);
   RDAudioConvert::ErrorCode Stage3Pcm24(SNDFILE *src_sf,SF_INFO *src_sf_info,
 					const QString &dstfile);
+  RDAudioConvert::ErrorCode Stage3PcmStream(SNDFILE *src_sf,
+					    SF_INFO *src_sf_info,int bits);
+  bool WriteStreamRange(const uint8_t *data,int64_t len,int64_t *offset);
+  int OpenDestination(const QString &dstfile);
+  ssize_t WriteDestination(int fd,const void *data,size_t len);
+  void CloseDestination(int fd);
+  RDAudioConvert::ErrorCode CopyToStream(const QString &filename);
+  bool WriteId3Tag(int fd,RDWaveData *wavedata);
   void ApplyId3Tag(const QString &filename,RDWaveData *wavedata);
+  void RenderId3Tag(TagLib::ID3v2::Tag *tag,RDWaveData *wavedata);
   void AddId3Property(TagLib::PropertyMap *map,
 		      const QString &key,const QString &value) const;
   void UpdatePeak(const float data[],ssize_t len);
@@ -109,6 +137,14 @@ class RDAudioConvert : public QObject
   bool LoadLame();
   QString conv_src_filename;
   QString conv_dst_filename;
+  int conv_dst_stream;
+  int conv_dst_tee;
+  QByteArray conv_dst_preamble;
+  uint64_t conv_stream_bytes;
+  int64_t conv_dst_first;
+  int64_t conv_dst_last;
+  sf_count_t conv_skip_frames;
+  sf_count_t conv_skipped_frames;
   int conv_start_point;
   int conv_end_point;
   float conv_speed_ratio;
@@ -118,7 +154,10 @@ class RDAudioConvert : public QObject
   RDWaveData *conv_dst_wavedata;
   QString conv_src_rdxl;
   QString conv_dst_rdxl;
+  bool conv_dst_hashing;
+  QString conv_dst_sha1_hash;
   float conv_peak_sample;
+  RDStage1Pipe *conv_stage1_pipe;
   int conv_src_converter;
   void *conv_mad_handle;
   void *conv_lame_handle;
@@ -0,0 +1,240 @@
+// rdaudiodedup.cpp
+//
+// Share storage between cuts with identical audio.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <linux/fs.h>
+
+#include "rdaudiodedup.h"
+#include "rdcut.h"
+#include "rddb.h"
+#include "rdescape_string.h"
+#include "rdtranscodecache.h"
+
+RDAudioDedup::RDAudioDedup(RDConfig *config)
+{
+  dedup_config=config;
+}
+
+
+bool RDAudioDedup::isEnabled() const
+{
+  return dedup_config->dedupAudio();
+}
+
+
+RDAudioDedup::Method RDAudioDedup::dedup(const QString &cutname,
+					 const QString &hash,
+					 uint64_t *saved) const
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QString dstfile=RDCut::pathName(cutname);
+  QString srcfile;
+  struct stat dst_st;
+  struct stat src_st;
+  Method ret=RDAudioDedup::None;
+
+  if(saved!=NULL) {
+    *saved=0;
+  }
+  if(hash.isEmpty()||(stat(dstfile.toUtf8(),&dst_st)!=0)) {
+    return RDAudioDedup::None;
+  }
+  sql=QString("select `CUT_NAME` from `CUTS` where ")+
+    "`SHA1_HASH`='"+RDEscapeString(hash)+"' && "+
+    "`CUT_NAME`!='"+RDEscapeString(cutname)+"' "+
+    "order by `CUT_NAME`";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    srcfile=RDCut::pathName(q->value(0).toString());
+    if(stat(srcfile.toUtf8(),&src_st)!=0) {
+      continue;
+    }
+    if((src_st.st_dev==dst_st.st_dev)&&(src_st.st_ino==dst_st.st_ino)) {
+      break;  // Already sharing
+    }
+    if((src_st.st_dev!=dst_st.st_dev)||(src_st.st_size!=dst_st.st_size)) {
+      continue;
+    }
+
+    //
+    // The stored hash isn't updated by every path that can write audio,
+    // so never trust it alone to decide that two files are the same.
+    //
+    if(!SameContents(srcfile,dstfile)) {
+      continue;
+    }
+    if(Share(srcfile,dstfile,&ret)) {
+      if((saved!=NULL)&&(dst_st.st_nlink==1)) {
+	*saved=dst_st.st_size;
+      }
+      RDTranscodeCache *cache=new RDTranscodeCache(dedup_config);
+      cache->invalidate(RDCut::cartNumber(cutname),
+			RDCut::cutNumber(cutname));
+      delete cache;
+    }
+    break;
+  }
+  delete q;
+
+  return ret;
+}
+
+
+bool RDAudioDedup::unshare(const QString &filename)
+{
+  struct stat st;
+
+  //
+  // For use just before a file is rewritten from scratch; writing through
+  // a hard link would change the audio of every cut that shares it.
+  //
+  if((stat(filename.toUtf8(),&st)==0)&&(st.st_nlink>1)) {
+    return unlink(filename.toUtf8())==0;
+  }
+
+  return true;
+}
+
+
+bool RDAudioDedup::reflink(const QString &srcfile,const QString &dstfile,
+			   mode_t mode)
+{
+  bool ret=false;
+#ifdef FICLONE
+  int src_fd=-1;
+  int dst_fd=-1;
+
+  if((src_fd=open(srcfile.toUtf8(),O_RDONLY))<0) {
+    return false;
+  }
+  if((dst_fd=open(dstfile.toUtf8(),O_WRONLY|O_CREAT|O_EXCL,mode))<0) {
+    close(src_fd);
+    return false;
+  }
+  ret=ioctl(dst_fd,FICLONE,src_fd)==0;
+  close(dst_fd);
+  close(src_fd);
+  if(!ret) {
+    unlink(dstfile.toUtf8());
+  }
+#endif  // FICLONE
+
+  return ret;
+}
+
+
+bool RDAudioDedup::Share(const QString &srcfile,const QString &dstfile,
+			 Method *method) const
+{
+  QString tmpfile=dstfile+QString::asprintf(".%d.dedup",getpid());
+  struct stat dst_st;
+
+  *method=RDAudioDedup::None;
+  if(stat(dstfile.toUtf8(),&dst_st)!=0) {
+    return false;
+  }
+  unlink(tmpfile.toUtf8());
+
+  //
+  // A reflink leaves each cut with its own inode, so nothing can write
+  // through from one cut to another
+  //
+  if(RDAudioDedup::reflink(srcfile,tmpfile,dst_st.st_mode&07777)) {
+    if(chown(tmpfile.toUtf8(),dst_st.st_uid,dst_st.st_gid)!=0) {
+      // Not fatal; the group permissions still apply
+    }
+    *method=RDAudioDedup::Reflink;
+  }
+
+  //
+  // Otherwise, a hard link
+  //
+  if(*method==RDAudioDedup::None) {
+    if(link(srcfile.toUtf8(),tmpfile.toUtf8())!=0) {
+      return false;
+    }
+    *method=RDAudioDedup::Hardlink;
+  }
+
+  //
+  // Swap it into place in one step, so that readers see either the old
+  // file or the new one
+  //
+  if(rename(tmpfile.toUtf8(),dstfile.toUtf8())!=0) {
+    unlink(tmpfile.toUtf8());
+    *method=RDAudioDedup::None;
+    return false;
+  }
+
+  return true;
+}
+
+
+bool RDAudioDedup::SameContents(const QString &file1,
+				const QString &file2) const
+{
+  int fd1=-1;
+  int fd2=-1;
+  char *data1=NULL;
+  char *data2=NULL;
+  ssize_t n1;
+  ssize_t n2;
+  bool ret=false;
+
+  if((fd1=open(file1.toUtf8(),O_RDONLY))<0) {
+    return false;
+  }
+  if((fd2=open(file2.toUtf8(),O_RDONLY))<0) {
+    close(fd1);
+    return false;
+  }
+  posix_fadvise(fd1,0,0,POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(fd2,0,0,POSIX_FADV_SEQUENTIAL);
+  data1=new char[RDAUDIODEDUP_BLOCK_SIZE];
+  data2=new char[RDAUDIODEDUP_BLOCK_SIZE];
+  while(true) {
+    n1=read(fd1,data1,RDAUDIODEDUP_BLOCK_SIZE);
+    n2=read(fd2,data2,RDAUDIODEDUP_BLOCK_SIZE);
+    if((n1<0)||(n1!=n2)) {
+      break;
+    }
+    if(n1==0) {
+      ret=true;
+      break;
+    }
+    if(memcmp(data1,data2,n1)!=0) {
+      break;
+    }
+  }
+  delete[] data2;
+  delete[] data1;
+  close(fd2);
+  close(fd1);
+
+  return ret;
+}
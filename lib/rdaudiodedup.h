@@ -0,0 +1,56 @@
+// rdaudiodedup.h
+//
+// Share storage between cuts with identical audio.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDAUDIODEDUP_H
+#define RDAUDIODEDUP_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <QString>
+
+#include <rdconfig.h>
+
+//
+// Size of each read when comparing audio files [bytes]
+//
+#define RDAUDIODEDUP_BLOCK_SIZE 1048576
+
+class RDAudioDedup
+{
+ public:
+  enum Method {None=0,Reflink=1,Hardlink=2};
+  RDAudioDedup(RDConfig *config);
+  bool isEnabled() const;
+  Method dedup(const QString &cutname,const QString &hash,
+	       uint64_t *saved=NULL) const;
+  static bool unshare(const QString &filename);
+  static bool reflink(const QString &srcfile,const QString &dstfile,
+		      mode_t mode);
+
+ private:
+  bool Share(const QString &srcfile,const QString &dstfile,
+	     Method *method) const;
+  bool SameContents(const QString &file1,const QString &file2) const;
+  RDConfig *dedup_config;
+};
+
+
+#endif  // RDAUDIODEDUP_H
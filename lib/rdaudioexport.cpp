@@ -20,6 +20,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -31,9 +32,11 @@
 #include <qapplication.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdapplication.h>
 #include <rdxport_interface.h>
 #include <rdformpost.h>
+#include <rdlocalxport.h>
 #include <rdaudioexport.h>
 #include <rdwebresult.h>
 
@@ -138,6 +141,11 @@ RDAudioExport::ErrorCode RDAudioExport::runExport(const QString &username,
   RDAudioExport::ErrorCode ret;
   RDWebResult web_result;
 
+  if(RDLocalXport::isAvailable(rda->station(),rda->config(),
+			       conv_cart_number,conv_cut_number)) {
+    return RunLocal(username,conv_err);
+  }
+
   //
   // Generate POST Data
   //
@@ -195,12 +203,12 @@ RDAudioExport::ErrorCode RDAudioExport::runExport(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_enable_metadata).
 	       toUtf8().constData(),CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDAudioExport::ErrorInternal;
   }
   if((f=fopen(conv_dst_filename.toUtf8(),"w"))==NULL) {
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioExport::ErrorNoDestination;
   }
@@ -220,13 +228,14 @@ RDAudioExport::ErrorCode RDAudioExport::runExport(const QString &username,
   curl_easy_setopt(curl,CURLOPT_PROGRESSDATA,this);
   curl_easy_setopt(curl,CURLOPT_NOPROGRESS,0);
 
-  switch(curl_easy_perform(curl)) {
+  switch(RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
   case CURLE_ABORTED_BY_CALLBACK:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
+    fclose(f);
     unlink(conv_dst_filename.toUtf8());
     return RDAudioExport::ErrorAborted;
 
@@ -240,20 +249,28 @@ RDAudioExport::ErrorCode RDAudioExport::runExport(const QString &username,
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
   default:
-    curl_easy_cleanup(curl);
+    //
+    // Includes an export that failed after audio was sent, which arrives
+    // as a truncated transfer
+    //
+    RDCurlPool::release(curl);
     curl_formfree(first);
+    fclose(f);
+    unlink(conv_dst_filename.toUtf8());
     return RDAudioExport::ErrorInternal;
 
   case CURLE_URL_MALFORMAT:
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:  // CURLE_REMOTE_ACCESS_DENIED:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
+    fclose(f);
+    unlink(conv_dst_filename.toUtf8());
     return RDAudioExport::ErrorUrlInvalid;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
   fclose(f);
 
@@ -284,6 +301,45 @@ RDAudioExport::ErrorCode RDAudioExport::runExport(const QString &username,
 }
 
 
+RDAudioExport::ErrorCode RDAudioExport::RunLocal(const QString &username,
+					 RDAudioConvert::ErrorCode *conv_err)
+{
+  RDWaveData *wavedata=NULL;
+  QString rdxl;
+  float speed_ratio=1.0;
+  RDAudioExport::ErrorCode ret=RDAudioExport::ErrorOk;
+
+  *conv_err=RDAudioConvert::ErrorOk;
+  if(!RDLocalXport::authenticate(username)) {
+    return RDAudioExport::ErrorInvalidUser;
+  }
+  if(!RDLocalXport::cartAuthorized(username,conv_cart_number)) {
+    return RDAudioExport::ErrorNoSource;
+  }
+  RDAudioConvert *conv=
+    RDLocalXport::exportConverter(conv_cart_number,conv_cut_number,
+				  conv_settings,conv_start_point,
+				  conv_end_point,conv_enable_metadata,
+				  &wavedata,&rdxl,&speed_ratio);
+  conv->setDestinationFile(conv_dst_filename);
+  if((*conv_err=conv->convert())!=RDAudioConvert::ErrorOk) {
+    if(*conv_err==RDAudioConvert::ErrorNoSource) {
+      ret=RDAudioExport::ErrorNoSource;
+    }
+    else {
+      ret=RDAudioExport::ErrorConverter;
+    }
+    unlink(conv_dst_filename.toUtf8());
+  }
+  delete conv;
+  if(wavedata!=NULL) {
+    delete wavedata;
+  }
+
+  return ret;
+}
+
+
 bool RDAudioExport::aborting() const
 {
   return conv_aborting;
@@ -59,6 +59,8 @@ class RDAudioExport : public QObject
   void strobe();
 
  private:
+  RDAudioExport::ErrorCode RunLocal(const QString &username,
+				    RDAudioConvert::ErrorCode *conv_err);
   unsigned conv_cart_number;
   unsigned conv_cut_number;
   QString conv_dst_filename;
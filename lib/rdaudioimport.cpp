@@ -30,11 +30,15 @@
 #include <curl/curl.h>
 
 #include <qapplication.h>
+#include <qfileinfo.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdapplication.h>
 #include <rdaudioimport.h>
 #include <rdformpost.h>
+#include <rdlocalxport.h>
+#include <rduser.h>
 #include <rdwebresult.h>
 #include <rdxport_interface.h>
 
@@ -70,6 +74,7 @@ RDAudioImport::RDAudioImport(QObject *parent)
   conv_cut_number=0;
   conv_settings=NULL;
   conv_use_metadata=false;
+  conv_move_source=false;
   conv_aborting=false;
 }
 
@@ -98,6 +103,12 @@ void RDAudioImport::setUseMetadata(bool state)
 }
 
 
+void RDAudioImport::setMoveSource(bool state)
+{
+  conv_move_source=state;
+}
+
+
 void RDAudioImport::setDestinationSettings(RDSettings *settings)
 {
   conv_settings=settings;
@@ -108,7 +119,97 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
 						  const QString &password,
 					  RDAudioConvert::ErrorCode *conv_err)
 {
-  long response_code;
+  RDAudioImport::ErrorCode ret;
+  long response_code=0;
+
+  //
+  // When the Web API is served by this host, there's no need to upload
+  // the file at all. Either do the import here or, failing that, tell
+  // the web service where to find the file.
+  //
+  if(RDLocalXport::isImportAvailable(rda->station(),rda->config(),
+				     conv_cart_number,conv_cut_number)) {
+    return RunLocal(username,conv_err);
+  }
+  if(RDLocalXport::isLocalService(rda->station(),rda->config())) {
+    ret=RunRemote(username,password,conv_err,true,&response_code);
+    if(response_code!=403) {
+      return ret;
+    }
+  }
+
+  return RunRemote(username,password,conv_err,false,&response_code);
+}
+
+
+bool RDAudioImport::aborting() const
+{
+  return conv_aborting;
+}
+
+
+RDAudioImport::ErrorCode RDAudioImport::RunLocal(const QString &username,
+					 RDAudioConvert::ErrorCode *conv_err)
+{
+  RDWaveData wavedata;
+  RDAudioImport::ErrorCode ret=RDAudioImport::ErrorOk;
+
+  *conv_err=RDAudioConvert::ErrorOk;
+  if(!RDLocalXport::authenticate(username)) {
+    return RDAudioImport::ErrorInvalidUser;
+  }
+  RDUser *user=new RDUser(username);
+  bool ok=user->cartAuthorized(conv_cart_number)&&user->editAudio();
+  delete user;
+  if((!ok)||(!RDCut::exists(conv_cart_number,conv_cut_number))) {
+    return RDAudioImport::ErrorNoDestination;
+  }
+  RDWaveFile *wave=new RDWaveFile(conv_src_filename);
+  if(!wave->openWave(&wavedata)) {
+    delete wave;
+    *conv_err=RDAudioConvert::ErrorFormatNotSupported;
+    return RDAudioImport::ErrorConverter;
+  }
+  delete wave;
+  if(conv_use_metadata&&
+     (!rda->system()->allowDuplicateCartTitles())&&
+     (!rda->system()->fixDuplicateCartTitles())&&
+     (!RDCart::titleIsUnique(conv_cart_number,wavedata.title()))) {
+    return RDAudioImport::ErrorNoDestination;
+  }
+
+  RDSettings *settings=
+    RDLocalXport::importSettings(conv_settings->channels(),
+				 conv_settings->normalizationLevel());
+  RDCart *cart=new RDCart(conv_cart_number);
+  RDCut *cut=new RDCut(conv_cart_number,conv_cut_number);
+  *conv_err=RDLocalXport::importAudio(conv_src_filename,cart,cut,settings,
+				      conv_use_metadata,
+				      conv_settings->autotrimLevel(),
+				      username,rda->config()->stationName(),
+				      conv_move_source);
+  if(*conv_err==RDAudioConvert::ErrorOk) {
+    rda->ripc()->sendNotification(RDNotification::CartType,
+				  RDNotification::ModifyAction,
+				  QVariant(conv_cart_number));
+  }
+  else {
+    ret=RDAudioImport::ErrorConverter;
+  }
+  delete cut;
+  delete cart;
+  delete settings;
+
+  return ret;
+}
+
+
+RDAudioImport::ErrorCode RDAudioImport::RunRemote(const QString &username,
+						  const QString &password,
+					  RDAudioConvert::ErrorCode *conv_err,
+						  bool by_path,
+						  long *response_code)
+{
   CURL *curl=NULL;
   CURLcode curl_err;
   struct curl_httppost *first=NULL;
@@ -116,6 +217,8 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
   QString xml;
   RDWebResult web_result;
 
+  *response_code=0;
+
   //
   // Generate POST Data
   //
@@ -157,14 +260,22 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_use_metadata).toUtf8().constData(),
 	       CURLFORM_END);
-  curl_formadd(&first,&last,CURLFORM_PTRNAME,"FILENAME",
-	       CURLFORM_FILE,conv_src_filename.toUtf8().constData(),
-	       CURLFORM_END);
+  if(by_path) {
+    curl_formadd(&first,&last,CURLFORM_PTRNAME,"SOURCE_PATH",
+		 CURLFORM_COPYCONTENTS,
+		 QFileInfo(conv_src_filename).absoluteFilePath().
+		 toUtf8().constData(),CURLFORM_END);
+  }
+  else {
+    curl_formadd(&first,&last,CURLFORM_PTRNAME,"FILENAME",
+		 CURLFORM_FILE,conv_src_filename.toUtf8().constData(),
+		 CURLFORM_END);
+  }
 
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDAudioImport::ErrorInternal;
   }
@@ -184,12 +295,12 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
   //
   // Send it
   //
-  switch(curl_err=curl_easy_perform(curl)) {
+  switch(curl_err=RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
   case CURLE_ABORTED_BY_CALLBACK:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioImport::ErrorAborted;
 
@@ -203,7 +314,7 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioImport::ErrorInternal;
 
@@ -211,7 +322,7 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioImport::ErrorUrlInvalid;
   }
@@ -223,8 +334,8 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
   //
   // Clean up
   //
-  curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,response_code);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -237,7 +348,7 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
     *conv_err=RDAudioConvert::ErrorOk;
   }
   //printf("resp code: %d\n",response_code);
-  switch(response_code) {
+  switch(*response_code) {
   case 200:
     break;
     
@@ -257,12 +368,6 @@ RDAudioImport::ErrorCode RDAudioImport::runImport(const QString &username,
 }
 
 
-bool RDAudioImport::aborting() const
-{
-  return conv_aborting;
-}
-
-
 QString RDAudioImport::errorText(RDAudioImport::ErrorCode err,
 				 RDAudioConvert::ErrorCode conv_err)
 {
@@ -39,6 +39,7 @@ class RDAudioImport : public QObject
   void setCutNumber(unsigned cutnum);
   void setSourceFile(const QString &filename);
   void setUseMetadata(bool state);
+  void setMoveSource(bool state);
   void setDestinationSettings(RDSettings *settings);
   RDAudioImport::ErrorCode runImport(const QString &username,
 				     const QString &password,
@@ -51,11 +52,18 @@ class RDAudioImport : public QObject
   void abort();
 
  private:
+  RDAudioImport::ErrorCode RunLocal(const QString &username,
+				    RDAudioConvert::ErrorCode *conv_err);
+  RDAudioImport::ErrorCode RunRemote(const QString &username,
+				     const QString &password,
+				     RDAudioConvert::ErrorCode *conv_err,
+				     bool by_path,long *response_code);
   unsigned conv_cart_number;
   unsigned conv_cut_number;
   QString conv_src_filename;
   RDSettings *conv_settings;
   bool conv_use_metadata;
+  bool conv_move_source;
   bool conv_aborting;
 };
 
@@ -31,6 +31,7 @@
 #include <qstringlist.h>
 
 #include "rd.h"
+#include "rdcurlpool.h"
 #include "rdapplication.h"
 #include "rdxport_interface.h"
 #include "rdformpost.h"
@@ -139,7 +140,7 @@ RDAudioInfo::ErrorCode RDAudioInfo::runInfo(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_cut_number).toUtf8().constData(),
 	       CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDAudioInfo::ErrorInternal;
   }
@@ -157,7 +158,7 @@ RDAudioInfo::ErrorCode RDAudioInfo::runInfo(const QString &username,
 		   rda->config()->userAgent().toUtf8().constData());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
 
-  switch(curl_err=curl_easy_perform(curl)) {
+  switch(curl_err=RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
@@ -170,7 +171,7 @@ RDAudioInfo::ErrorCode RDAudioInfo::runInfo(const QString &username,
   case CURLE_OUT_OF_MEMORY:
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     fprintf(stderr,"curl error: %d\n",curl_err);
     return RDAudioInfo::ErrorInternal;
@@ -179,17 +180,17 @@ RDAudioInfo::ErrorCode RDAudioInfo::runInfo(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioInfo::ErrorUrlInvalid;
 
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioInfo::ErrorService;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   switch(response_code) {
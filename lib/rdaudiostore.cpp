@@ -31,6 +31,7 @@
 #include <qstringlist.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdxport_interface.h>
 #include <rdformpost.h>
 #include <rdaudiostore.h>
@@ -87,7 +88,7 @@ RDAudioStore::ErrorCode RDAudioStore::runStore(const QString &username,
 	       CURLFORM_COPYCONTENTS,username.toUtf8().constData(),CURLFORM_END);
   curl_formadd(&first,&last,CURLFORM_PTRNAME,"PASSWORD",
 	       CURLFORM_COPYCONTENTS,(const char *)password.toUtf8(),CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDAudioStore::ErrorInternal;
   }
@@ -101,7 +102,7 @@ RDAudioStore::ErrorCode RDAudioStore::runStore(const QString &username,
 		   toUtf8().constData());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
 
-  switch(curl_err=curl_easy_perform(curl)) {
+  switch(curl_err=RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
@@ -114,7 +115,7 @@ RDAudioStore::ErrorCode RDAudioStore::runStore(const QString &username,
   case CURLE_OUT_OF_MEMORY:
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     fprintf(stderr,"curl error: %d\n",curl_err);
     return RDAudioStore::ErrorInternal;
@@ -123,17 +124,17 @@ RDAudioStore::ErrorCode RDAudioStore::runStore(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioStore::ErrorUrlInvalid;
 
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDAudioStore::ErrorService;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   switch(response_code) {
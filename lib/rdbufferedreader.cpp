@@ -0,0 +1,334 @@
+// rdbufferedreader.cpp
+//
+// Block-buffered, read-ahead reader for audio files.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rdbufferedreader.h"
+
+RDBufferedReader::RDBufferedReader(int fd,size_t block_size,bool read_ahead)
+{
+  reader_fd=fd;
+  reader_block_size=block_size;
+  if(reader_block_size<RDBUFFEREDREADER_MINIMUM_BLOCK_SIZE) {
+    reader_block_size=RDBUFFEREDREADER_MINIMUM_BLOCK_SIZE;
+  }
+  reader_pos=lseek(fd,0,SEEK_CUR);
+  if(reader_pos<0) {
+    reader_pos=0;
+  }
+  reader_buffer=(char *)malloc(reader_block_size);
+  reader_buffer_offset=0;
+  reader_buffer_length=0;
+  reader_read_ahead=read_ahead;
+  reader_ahead_buffer=NULL;
+  reader_ahead_offset=0;
+  reader_ahead_length=0;
+  reader_ahead_state=RDBufferedReader::Idle;
+  reader_exiting=false;
+  reader_physical_reads=0;
+  reader_read_ahead_hits=0;
+
+  //
+  // Let the kernel (and NFS client) know we intend to stream
+  //
+  posix_fadvise(reader_fd,0,0,POSIX_FADV_SEQUENTIAL);
+
+  if(reader_read_ahead) {
+    reader_ahead_buffer=(char *)malloc(reader_block_size);
+    pthread_mutex_init(&reader_mutex,NULL);
+    pthread_cond_init(&reader_cond,NULL);
+    if(pthread_create(&reader_thread,NULL,ReadAheadCallback,this)!=0) {
+      pthread_cond_destroy(&reader_cond);
+      pthread_mutex_destroy(&reader_mutex);
+      free(reader_ahead_buffer);
+      reader_ahead_buffer=NULL;
+      reader_read_ahead=false;
+    }
+  }
+}
+
+
+RDBufferedReader::~RDBufferedReader()
+{
+  if(reader_read_ahead) {
+    pthread_mutex_lock(&reader_mutex);
+    reader_exiting=true;
+    pthread_cond_broadcast(&reader_cond);
+    pthread_mutex_unlock(&reader_mutex);
+    pthread_join(reader_thread,NULL);
+    pthread_cond_destroy(&reader_cond);
+    pthread_mutex_destroy(&reader_mutex);
+    free(reader_ahead_buffer);
+  }
+  free(reader_buffer);
+}
+
+
+int RDBufferedReader::fd() const
+{
+  return reader_fd;
+}
+
+
+size_t RDBufferedReader::blockSize() const
+{
+  return reader_block_size;
+}
+
+
+bool RDBufferedReader::readAhead() const
+{
+  return reader_read_ahead;
+}
+
+
+ssize_t RDBufferedReader::read(void *data,size_t len)
+{
+  size_t done=0;
+  ssize_t n;
+  off_t end;
+
+  while(done<len) {
+    end=reader_buffer_offset+reader_buffer_length;
+    if((reader_pos<reader_buffer_offset)||(reader_pos>=end)) {
+      //
+      // Large requests gain nothing from the buffer, so read them directly
+      //
+      if((len-done)>=reader_block_size) {
+	if((n=PRead((char *)data+done,len-done,reader_pos))<0) {
+	  return done>0?(ssize_t)done:-1;
+	}
+	if(n==0) {
+	  return done;
+	}
+	done+=n;
+	reader_pos+=n;
+	StartReadAhead(reader_pos);
+	continue;
+      }
+      if((n=Fill(reader_pos))<0) {
+	return done>0?(ssize_t)done:-1;
+      }
+      end=reader_buffer_offset+reader_buffer_length;
+      if(reader_pos>=end) {  // EOF
+	return done;
+      }
+    }
+    n=end-reader_pos;
+    if((size_t)n>(len-done)) {
+      n=len-done;
+    }
+    memcpy((char *)data+done,reader_buffer+(reader_pos-reader_buffer_offset),n);
+    done+=n;
+    reader_pos+=n;
+  }
+
+  return done;
+}
+
+
+off_t RDBufferedReader::seek(off_t offset,int whence)
+{
+  struct stat st;
+  off_t pos=-1;
+
+  switch(whence) {
+  case SEEK_SET:
+    pos=offset;
+    break;
+
+  case SEEK_CUR:
+    pos=reader_pos+offset;
+    break;
+
+  case SEEK_END:
+    if(fstat(reader_fd,&st)!=0) {
+      return -1;
+    }
+    pos=st.st_size+offset;
+    break;
+
+  default:
+    errno=EINVAL;
+    return -1;
+  }
+  if(pos<0) {
+    errno=EINVAL;
+    return -1;
+  }
+  reader_pos=pos;
+
+  return reader_pos;
+}
+
+
+off_t RDBufferedReader::pos() const
+{
+  return reader_pos;
+}
+
+
+void RDBufferedReader::invalidate()
+{
+  WaitReadAhead();
+  if(reader_read_ahead) {
+    reader_ahead_state=RDBufferedReader::Idle;
+  }
+  reader_buffer_offset=0;
+  reader_buffer_length=0;
+}
+
+
+unsigned long long RDBufferedReader::physicalReads() const
+{
+  return reader_physical_reads;
+}
+
+
+unsigned long long RDBufferedReader::readAheadHits() const
+{
+  return reader_read_ahead_hits;
+}
+
+
+ssize_t RDBufferedReader::Fill(off_t offset)
+{
+  off_t start=offset-(offset%reader_block_size);
+  char *swap=NULL;
+  ssize_t n;
+
+  //
+  // Use the read-ahead block if it's the one we want
+  //
+  if(reader_read_ahead) {
+    WaitReadAhead();
+    if((reader_ahead_state==RDBufferedReader::Ready)&&
+       (reader_ahead_offset<=offset)&&(reader_ahead_length>0)&&
+       (offset<(reader_ahead_offset+reader_ahead_length))) {
+      swap=reader_buffer;
+      reader_buffer=reader_ahead_buffer;
+      reader_ahead_buffer=swap;
+      reader_buffer_offset=reader_ahead_offset;
+      reader_buffer_length=reader_ahead_length;
+      reader_ahead_state=RDBufferedReader::Idle;
+      reader_read_ahead_hits++;
+      StartReadAhead(reader_buffer_offset+reader_buffer_length);
+      return reader_buffer_length;
+    }
+    reader_ahead_state=RDBufferedReader::Idle;
+  }
+
+  if((n=PRead(reader_buffer,reader_block_size,start))<0) {
+    reader_buffer_offset=0;
+    reader_buffer_length=0;
+    return -1;
+  }
+  reader_buffer_offset=start;
+  reader_buffer_length=n;
+  if(n==(ssize_t)reader_block_size) {
+    StartReadAhead(start+n);
+  }
+
+  return n;
+}
+
+
+ssize_t RDBufferedReader::PRead(char *data,size_t len,off_t offset)
+{
+  ssize_t n;
+
+  while(((n=pread(reader_fd,data,len,offset))<0)&&(errno==EINTR));
+  if(reader_read_ahead) {
+    pthread_mutex_lock(&reader_mutex);
+    reader_physical_reads++;
+    pthread_mutex_unlock(&reader_mutex);
+  }
+  else {
+    reader_physical_reads++;
+  }
+
+  return n;
+}
+
+
+void RDBufferedReader::StartReadAhead(off_t offset)
+{
+  if(!reader_read_ahead) {
+    return;
+  }
+  pthread_mutex_lock(&reader_mutex);
+  if((reader_ahead_state==RDBufferedReader::Idle)||
+     (reader_ahead_state==RDBufferedReader::Ready)) {
+    reader_ahead_offset=offset;
+    reader_ahead_length=0;
+    reader_ahead_state=RDBufferedReader::Requested;
+    pthread_cond_broadcast(&reader_cond);
+  }
+  pthread_mutex_unlock(&reader_mutex);
+}
+
+
+void RDBufferedReader::WaitReadAhead()
+{
+  if(!reader_read_ahead) {
+    return;
+  }
+  pthread_mutex_lock(&reader_mutex);
+  while((reader_ahead_state==RDBufferedReader::Requested)||
+	(reader_ahead_state==RDBufferedReader::Busy)) {
+    pthread_cond_wait(&reader_cond,&reader_mutex);
+  }
+  pthread_mutex_unlock(&reader_mutex);
+}
+
+
+void *RDBufferedReader::ReadAheadCallback(void *priv)
+{
+  RDBufferedReader *reader=(RDBufferedReader *)priv;
+  off_t offset;
+  ssize_t n;
+
+  pthread_mutex_lock(&reader->reader_mutex);
+  while(!reader->reader_exiting) {
+    if(reader->reader_ahead_state==RDBufferedReader::Requested) {
+      reader->reader_ahead_state=RDBufferedReader::Busy;
+      offset=reader->reader_ahead_offset;
+      pthread_mutex_unlock(&reader->reader_mutex);
+      while(((n=pread(reader->reader_fd,reader->reader_ahead_buffer,
+		      reader->reader_block_size,offset))<0)&&(errno==EINTR));
+      pthread_mutex_lock(&reader->reader_mutex);
+      reader->reader_physical_reads++;
+      reader->reader_ahead_length=n;
+      reader->reader_ahead_state=RDBufferedReader::Ready;
+      pthread_cond_broadcast(&reader->reader_cond);
+    }
+    else {
+      pthread_cond_wait(&reader->reader_cond,&reader->reader_mutex);
+    }
+  }
+  pthread_mutex_unlock(&reader->reader_mutex);
+
+  return NULL;
+}
@@ -0,0 +1,80 @@
+// rdbufferedreader.h
+//
+// Block-buffered, read-ahead reader for audio files.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDBUFFEREDREADER_H
+#define RDBUFFEREDREADER_H
+
+#include <pthread.h>
+#include <sys/types.h>
+
+//
+// Default size of a buffer block, in bytes
+//
+#define RDBUFFEREDREADER_DEFAULT_BLOCK_SIZE 65536
+
+//
+// Smallest block size we will accept
+//
+#define RDBUFFEREDREADER_MINIMUM_BLOCK_SIZE 512
+
+class RDBufferedReader
+{
+ public:
+  RDBufferedReader(int fd,size_t block_size=RDBUFFEREDREADER_DEFAULT_BLOCK_SIZE,
+		   bool read_ahead=false);
+  ~RDBufferedReader();
+  int fd() const;
+  size_t blockSize() const;
+  bool readAhead() const;
+  ssize_t read(void *data,size_t len);
+  off_t seek(off_t offset,int whence);
+  off_t pos() const;
+  void invalidate();
+  unsigned long long physicalReads() const;
+  unsigned long long readAheadHits() const;
+
+ private:
+  ssize_t Fill(off_t offset);
+  ssize_t PRead(char *data,size_t len,off_t offset);
+  void StartReadAhead(off_t offset);
+  void WaitReadAhead();
+  static void *ReadAheadCallback(void *priv);
+  enum AheadState {Idle=0,Requested=1,Busy=2,Ready=3};
+  int reader_fd;
+  size_t reader_block_size;
+  off_t reader_pos;
+  char *reader_buffer;
+  off_t reader_buffer_offset;
+  ssize_t reader_buffer_length;
+  bool reader_read_ahead;
+  pthread_t reader_thread;
+  pthread_mutex_t reader_mutex;
+  pthread_cond_t reader_cond;
+  char *reader_ahead_buffer;
+  off_t reader_ahead_offset;
+  ssize_t reader_ahead_length;
+  AheadState reader_ahead_state;
+  bool reader_exiting;
+  unsigned long long reader_physical_reads;
+  unsigned long long reader_read_ahead_hits;
+};
+
+
+#endif  // RDBUFFEREDREADER_H
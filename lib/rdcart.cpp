@@ -32,6 +32,7 @@
 #include <rdapplication.h>
 #include <rdconf.h>
 #include <rdconfig.h>
+#include <rdcurlpool.h>
 #include <rdcart.h>
 #include <rdcut.h>
 #include <rdescape_string.h>
@@ -43,6 +44,92 @@
 #include <rdxport_interface.h>
 #include <rdweb.h>
 
+//
+// Columns of RDCart::xmlSql(), with the XML field that needs each one.
+// NULL is needed by every field, an empty name by none.
+//
+#define RDCART_XML_CART_COLUMNS 31
+#define RDCART_XML_COLUMNS 76
+static const char *__rdcart_xml_columns[RDCART_XML_COLUMNS][2]={
+  {"`CART`.`NUMBER`",NULL},                               // 00
+  {"`CART`.`TYPE`",NULL},                                 // 01
+  {"`CART`.`GROUP_NAME`","groupName"},                    // 02
+  {"`CART`.`TITLE`","title"},                             // 03
+  {"`CART`.`ARTIST`","artist"},                           // 04
+  {"`CART`.`ALBUM`","album"},                             // 05
+  {"`CART`.`YEAR`","year"},                               // 06
+  {"`CART`.`LABEL`","label"},                             // 07
+  {"`CART`.`CLIENT`","client"},                           // 08
+  {"`CART`.`AGENCY`","agency"},                           // 09
+  {"`CART`.`PUBLISHER`","publisher"},                     // 10
+  {"`CART`.`COMPOSER`","composer"},                       // 11
+  {"`CART`.`USER_DEFINED`","userDefined"},                // 12
+  {"`CART`.`USAGE_CODE`","usageCode"},                    // 13
+  {"`CART`.`FORCED_LENGTH`","forcedLength"},              // 14
+  {"`CART`.`AVERAGE_LENGTH`","averageLength"},            // 15
+  {"`CART`.`LENGTH_DEVIATION`","lengthDeviation"},        // 16
+  {"`CART`.`AVERAGE_SEGUE_LENGTH`","averageSegueLength"}, // 17
+  {"`CART`.`AVERAGE_HOOK_LENGTH`","averageHookLength"},   // 18
+  {"`CART`.`MINIMUM_TALK_LENGTH`","minimumTalkLength"},   // 19
+  {"`CART`.`MAXIMUM_TALK_LENGTH`","maximumTalkLength"},   // 20
+  {"`CART`.`CUT_QUANTITY`","cutQuantity"},                // 21
+  {"`CART`.`LAST_CUT_PLAYED`","lastCutPlayed"},           // 22
+  {"`CART`.`VALIDITY`",""},                               // 23
+  {"`CART`.`ENFORCE_LENGTH`","enforceLength"},            // 24
+  {"`CART`.`ASYNCRONOUS`","asyncronous"},                 // 25
+  {"`CART`.`OWNER`",NULL},                                // 26
+  {"`CART`.`METADATA_DATETIME`","metadataDatetime"},      // 27
+  {"`CART`.`CONDUCTOR`",""},                              // 28
+  {"`CART`.`MACROS`",NULL},                               // 29
+  {"`CART`.`SONG_ID`","songId"},                          // 30
+  {"`CUTS`.`CUT_NAME`",NULL},                             // 31
+  {"`CUTS`.`EVERGREEN`","evergreen"},                     // 32
+  {"`CUTS`.`DESCRIPTION`","description"},                 // 33
+  {"`CUTS`.`OUTCUE`","outcue"},                           // 34
+  {"`CUTS`.`ISRC`","isrc"},                               // 35
+  {"`CUTS`.`ISCI`","isci"},                               // 36
+  {"`CUTS`.`LENGTH`","length"},                           // 37
+  {"`CUTS`.`ORIGIN_DATETIME`","originDatetime"},          // 38
+  {"`CUTS`.`START_DATETIME`","startDatetime"},            // 39
+  {"`CUTS`.`END_DATETIME`","endDatetime"},                // 40
+  {"`CUTS`.`SUN`","sun"},                                 // 41
+  {"`CUTS`.`MON`","mon"},                                 // 42
+  {"`CUTS`.`TUE`","tue"},                                 // 43
+  {"`CUTS`.`WED`","wed"},                                 // 44
+  {"`CUTS`.`THU`","thu"},                                 // 45
+  {"`CUTS`.`FRI`","fri"},                                 // 46
+  {"`CUTS`.`SAT`","sat"},                                 // 47
+  {"`CUTS`.`START_DAYPART`","startDaypart"},              // 48
+  {"`CUTS`.`END_DAYPART`","endDaypart"},                  // 49
+  {"`CUTS`.`ORIGIN_NAME`","originName"},                  // 50
+  {"`CUTS`.`ORIGIN_LOGIN_NAME`","originLoginName"},       // 51
+  {"`CUTS`.`SOURCE_HOSTNAME`","sourceHostname"},          // 52
+  {"`CUTS`.`WEIGHT`","weight"},                           // 53
+  {"`CUTS`.`LAST_PLAY_DATETIME`","lastPlayDatetime"},     // 54
+  {"`CUTS`.`PLAY_COUNTER`","playCounter"},                // 55
+  {"`CUTS`.`LOCAL_COUNTER`",""},                          // 56
+  {"`CUTS`.`VALIDITY`",""},                               // 57
+  {"`CUTS`.`CODING_FORMAT`","codingFormat"},              // 58
+  {"`CUTS`.`SAMPLE_RATE`","sampleRate"},                  // 59
+  {"`CUTS`.`BIT_RATE`","bitRate"},                        // 60
+  {"`CUTS`.`CHANNELS`",NULL},                             // 61
+  {"`CUTS`.`PLAY_GAIN`","playGain"},                      // 62
+  {"`CUTS`.`START_POINT`",NULL},                          // 63
+  {"`CUTS`.`END_POINT`","endPoint"},                      // 64
+  {"`CUTS`.`FADEUP_POINT`","fadeupPoint"},                // 65
+  {"`CUTS`.`FADEDOWN_POINT`","fadedownPoint"},            // 66
+  {"`CUTS`.`SEGUE_START_POINT`",NULL},                    // 67
+  {"`CUTS`.`SEGUE_END_POINT`","segueEndPoint"},           // 68
+  {"`CUTS`.`SEGUE_GAIN`","segueGain"},                    // 69
+  {"`CUTS`.`HOOK_START_POINT`",NULL},                     // 70
+  {"`CUTS`.`HOOK_END_POINT`","hookEndPoint"},             // 71
+  {"`CUTS`.`TALK_START_POINT`","talkStartPoint"},         // 72
+  {"`CUTS`.`TALK_END_POINT`","talkEndPoint"},             // 73
+  {"`CUTS`.`RECORDING_MBID`","recordingMbId"},            // 74
+  {"`CUTS`.`RELEASE_MBID`","releaseMbId"}                 // 75
+};
+
+
 //
 // CURL Callbacks
 //
@@ -60,6 +147,7 @@ RDCart::RDCart(unsigned number)
 {
   cart_number=number;
   metadata_changed=false;
+  cart_snapshot=new RDRowSnapshot("CART","NUMBER");
 }
 
 
@@ -68,6 +156,7 @@ RDCart::~RDCart()
   if(metadata_changed) {
     writeTimestamp();
   }
+  delete cart_snapshot;
 }
 
 
@@ -77,6 +166,18 @@ bool RDCart::exists() const
 }
 
 
+bool RDCart::snapshotEnabled() const
+{
+  return cart_snapshot->isEnabled();
+}
+
+
+void RDCart::setSnapshotEnabled(bool state)
+{
+  cart_snapshot->setEnabled(state);
+}
+
+
 bool RDCart::selectCut(QString *cut) const
 {
   return selectCut(cut,QTime::currentTime());
@@ -117,14 +218,14 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
       "`LOCAL_COUNTER`,"+       // 03
       "`LAST_PLAY_DATETIME` "+  // 04
       "from `CUTS`  where ("+
-      "((`START_DATETIME`<='"+datetime_str+"')&&"+
-      "(`END_DATETIME`>='"+datetime_str+"'))||"+
+      "((`START_DATETIME`<=?)&&"+
+      "(`END_DATETIME`>=?))||"+
       "(`START_DATETIME` is null))&&"+
-      "(((`START_DAYPART`<='"+time_str+"')&&"+
-      "(`END_DAYPART`>='"+time_str+"')||"+
+      "(((`START_DAYPART`<=?)&&"+
+      "(`END_DAYPART`>=?)||"+
       "`START_DAYPART` is null))&&"+
       "("+RDGetShortDayNameEN(current_date.dayOfWeek()).toUpper()+"='Y')&&"+
-      QString::asprintf("(`CART_NUMBER`=%u)&&(`EVERGREEN`='N')&&",cart_number)+
+      "(`CART_NUMBER`=?)&&(`EVERGREEN`='N')&&"+
       "(`LENGTH`>0)";
     if(useWeighting()) {
       sql+=" order by `LOCAL_COUNTER` ASC, ISNULL(`END_DATETIME`), `END_DATETIME` ASC, `LAST_PLAY_DATETIME` ASC";
@@ -132,7 +233,8 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
     else {
       sql+=" order by `LAST_PLAY_DATETIME` desc, `PLAY_ORDER` desc";
     }
-    q=new RDSqlQuery(sql);
+    q=new RDSqlQuery(sql,QVariantList()<<datetime_str<<datetime_str<<
+		     time_str<<time_str<<cart_number);
     cutname=GetNextCut(q);
     delete q;
     break;
@@ -149,7 +251,7 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
       "`LOCAL_COUNTER` "+
       "`LAST_PLAY_DATETIME` "+
       "from `CUTS` where "+
-      QString::asprintf("(`CART_NUMBER`=%u)&&",cart_number)+
+      "(`CART_NUMBER`=?)&&"+
       "(`EVERGREEN`='Y')&&"+
       "(`LENGTH`>0)";
     if(useWeighting()) {
@@ -158,7 +260,7 @@ bool RDCart::selectCut(QString *cut,const QTime &time) const
     else {
       sql+=" order by `LAST_PLAY_DATETIME` desc";
     }
-    q=new RDSqlQuery(sql);
+    q=new RDSqlQuery(sql,QVariantList()<<cart_number);
     cutname=GetNextCut(q);
     delete q;
   }
@@ -177,7 +279,7 @@ unsigned RDCart::number() const
 
 QString RDCart::groupName() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"GROUP_NAME").
+  return cart_snapshot->value(cart_number,"GROUP_NAME").
     toString();
 }
 
@@ -191,7 +293,7 @@ void RDCart::setGroupName(const QString &name)
 
 RDCart::Type RDCart::type() const
 {
-  return (RDCart::Type)RDGetSqlValue("CART","NUMBER",cart_number,
+  return (RDCart::Type)cart_snapshot->value(cart_number,
 				    "TYPE").toUInt();
 }
 
@@ -205,7 +307,7 @@ void RDCart::setType(RDCart::Type type)
 
 QString RDCart::title() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"TITLE").toString();
+  return cart_snapshot->value(cart_number,"TITLE").toString();
 }
 
 
@@ -218,7 +320,7 @@ void RDCart::setTitle(const QString &title)
 
 QString RDCart::artist() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"ARTIST").toString();
+  return cart_snapshot->value(cart_number,"ARTIST").toString();
 }
 
 
@@ -231,7 +333,7 @@ void RDCart::setArtist(const QString &artist)
 
 QString RDCart::album() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"ALBUM").toString();
+  return cart_snapshot->value(cart_number,"ALBUM").toString();
 }
 
 
@@ -245,7 +347,7 @@ void RDCart::setAlbum(const QString &album)
 int RDCart::year() const
 {
   QStringList f0=
-    RDGetSqlValue("CART","NUMBER",cart_number,"YEAR").toString().split("-");
+    cart_snapshot->value(cart_number,"YEAR").toString().split("-");
   return f0[0].toInt();
 }
 
@@ -391,7 +493,7 @@ void RDCart::updateSchedCodes(const QString &add_codes,const QString &remove_cod
 
 QString RDCart::label() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"LABEL").toString();
+  return cart_snapshot->value(cart_number,"LABEL").toString();
 }
 
 
@@ -404,7 +506,7 @@ void RDCart::setLabel(const QString &label)
 
 QString RDCart::conductor() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"CONDUCTOR").toString();
+  return cart_snapshot->value(cart_number,"CONDUCTOR").toString();
 }
 
 
@@ -417,7 +519,7 @@ void RDCart::setConductor(const QString &cond)
 
 QString RDCart::client() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"CLIENT").toString();
+  return cart_snapshot->value(cart_number,"CLIENT").toString();
 }
 
 
@@ -430,7 +532,7 @@ void RDCart::setClient(const QString &client)
 
 QString RDCart::agency() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"AGENCY").toString();
+  return cart_snapshot->value(cart_number,"AGENCY").toString();
 }
 
 
@@ -443,7 +545,7 @@ void RDCart::setAgency(const QString &agency)
 
 QString RDCart::publisher() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "PUBLISHER").toString();
 }
 
@@ -457,7 +559,7 @@ void RDCart::setPublisher(const QString &publisher)
 
 QString RDCart::composer() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "COMPOSER").toString();
 }
 
@@ -471,7 +573,7 @@ void RDCart::setComposer(const QString &composer)
 
 QString RDCart::userDefined() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "USER_DEFINED").toString();
 }
 
@@ -485,7 +587,7 @@ void RDCart::setUserDefined(const QString &string)
 
 QString RDCart::songId() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"SONG_ID").toString();
+  return cart_snapshot->value(cart_number,"SONG_ID").toString();
 }
 
 
@@ -498,7 +600,7 @@ void RDCart::setSongId(const QString &id)
 
 unsigned RDCart::beatsPerMinute() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"BPM").toUInt();
+  return cart_snapshot->value(cart_number,"BPM").toUInt();
 }
 
 
@@ -511,7 +613,7 @@ void RDCart::setBeatsPerMinute(unsigned bpm)
 
 RDCart::UsageCode RDCart::usageCode() const
 {
-  return (RDCart::UsageCode) RDGetSqlValue("CART","NUMBER",cart_number,
+  return (RDCart::UsageCode) cart_snapshot->value(cart_number,
 		      "USAGE_CODE").toInt();
 }
 
@@ -525,7 +627,7 @@ void RDCart::setUsageCode(RDCart::UsageCode code)
 
 QString RDCart::notes() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"NOTES").toString();
+  return cart_snapshot->value(cart_number,"NOTES").toString();
 }
 
 
@@ -538,7 +640,7 @@ void RDCart::setNotes(const QString &notes)
 
 unsigned RDCart::forcedLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "FORCED_LENGTH").toUInt();
 }
 
@@ -552,7 +654,7 @@ void RDCart::setForcedLength(unsigned length)
 
 unsigned RDCart::lengthDeviation() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "LENGTH_DEVIATION").toUInt();
 }
 
@@ -630,7 +732,7 @@ unsigned RDCart::calculateAverageLength(unsigned *max_dev) const
 
 unsigned RDCart::averageLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "AVERAGE_LENGTH").toUInt();
 }
 
@@ -643,7 +745,7 @@ void RDCart::setAverageLength(unsigned length) const
 
 unsigned RDCart::minimumTalkLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "MINIMUM_TALK_LENGTH").toUInt();
 }
 
@@ -656,7 +758,7 @@ void RDCart::setMinimumTalkLength(unsigned length) const
 
 unsigned RDCart::maximumTalkLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "MAXIMUM_TALK_LENGTH").toUInt();
 }
 
@@ -669,7 +771,7 @@ void RDCart::setMaximumTalkLength(unsigned length) const
 
 unsigned RDCart::averageSegueLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "AVERAGE_SEGUE_LENGTH").toUInt();
 }
 
@@ -682,7 +784,7 @@ void RDCart::setAverageSegueLength(unsigned length) const
 
 unsigned RDCart::averageHookLength() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "AVERAGE_HOOK_LENGTH").toUInt();
 }
 
@@ -695,7 +797,7 @@ void RDCart::setAverageHookLength(unsigned length) const
 
 unsigned RDCart::cutQuantity() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "CUT_QUANTITY").toUInt();
 }
 
@@ -708,7 +810,7 @@ void RDCart::setCutQuantity(unsigned quan) const
 
 unsigned RDCart::lastCutPlayed() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,
+  return cart_snapshot->value(cart_number,
 		      "LAST_CUT_PLAYED").toUInt();
 }
 
@@ -721,7 +823,7 @@ void RDCart::setLastCutPlayed(unsigned cut) const
 
 RDCart::PlayOrder RDCart::playOrder() const
 {
-  return (RDCart::PlayOrder)RDGetSqlValue("CART","NUMBER",cart_number,
+  return (RDCart::PlayOrder)cart_snapshot->value(cart_number,
 					 "PLAY_ORDER").toUInt();
 }
 
@@ -734,7 +836,7 @@ void RDCart::setPlayOrder(RDCart::PlayOrder order) const
 
 RDCart::Validity RDCart::validity() const
 {
-  return (RDCart::Validity)RDGetSqlValue("CART","NUMBER",cart_number,
+  return (RDCart::Validity)cart_snapshot->value(cart_number,
 					 "VALIDITY").toUInt();
 }
 
@@ -748,7 +850,7 @@ void RDCart::setValidity(RDCart::Validity state)
 QDateTime RDCart::startDateTime() const
 {
   QDateTime value;
-  value=RDGetSqlValue("CART","NUMBER",cart_number,
+  value=cart_snapshot->value(cart_number,
 		     "START_DATETIME").toDateTime();
   if(value.isValid()) {
     return value;
@@ -774,7 +876,7 @@ void RDCart::setStartDateTime()
 QDateTime RDCart::endDateTime() const
 {
   QDateTime value;
-  value=RDGetSqlValue("CART","NUMBER",cart_number,
+  value=cart_snapshot->value(cart_number,
 		     "END_DATETIME").toDateTime();
   if(value.isValid()) {
     return value;
@@ -799,7 +901,7 @@ void RDCart::setEndDateTime()
 
 bool RDCart::enforceLength() const
 {
-  return RDBool(RDGetSqlValue("CART","NUMBER",cart_number,
+  return RDBool(cart_snapshot->value(cart_number,
 			    "ENFORCE_LENGTH").toString());
 }
 
@@ -813,7 +915,7 @@ void RDCart::setEnforceLength(bool state)
 
 bool RDCart::useWeighting() const
 {
-  return RDBool(RDGetSqlValue("CART","NUMBER",cart_number,
+  return RDBool(cart_snapshot->value(cart_number,
 			    "USE_WEIGHTING").toString());
 }
 
@@ -827,7 +929,7 @@ void RDCart::setUseWeighting(bool state)
 
 bool RDCart::preservePitch() const
 {
-  return RDBool(RDGetSqlValue("CART","NUMBER",cart_number,
+  return RDBool(cart_snapshot->value(cart_number,
 			    "PRESERVE_PITCH").toString());
 }
 
@@ -840,7 +942,7 @@ void RDCart::setPreservePitch(bool state) const
 
 bool RDCart::asyncronous() const
 {
-  return RDBool(RDGetSqlValue("CART","NUMBER",cart_number,
+  return RDBool(cart_snapshot->value(cart_number,
 			      "ASYNCRONOUS").toString());
 }
 
@@ -853,7 +955,7 @@ void RDCart::setAsyncronous(bool state) const
 
 QString RDCart::owner() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"OWNER").toString();
+  return cart_snapshot->value(cart_number,"OWNER").toString();
 }
 
 
@@ -865,7 +967,7 @@ void RDCart::setOwner(const QString &owner) const
 
 bool RDCart::useEventLength() const
 {
-  return RDBool(RDGetSqlValue("CART","NUMBER",cart_number,
+  return RDBool(cart_snapshot->value(cart_number,
 			      "USE_EVENT_LENGTH").toString());
 }
 
@@ -906,7 +1008,7 @@ void RDCart::clearPending() const
 
 QString RDCart::macros() const
 {
-  return RDGetSqlValue("CART","NUMBER",cart_number,"MACROS").toString();
+  return cart_snapshot->value(cart_number,"MACROS").toString();
 }
 
 
@@ -1417,89 +1519,29 @@ unsigned RDCart::create(const QString &groupname,RDCart::Type type,
 }
 
 
-QString RDCart::xmlSql(bool include_cuts)
+QString RDCart::xmlSql(bool include_cuts,const QStringList &fields)
 {
-  QString sql=QString("select ")+
-    "`CART`.`NUMBER`,"+                // 00
-    "`CART`.`TYPE`,"+                  // 01
-    "`CART`.`GROUP_NAME`,"+            // 02
-    "`CART`.`TITLE`,"+                 // 03
-    "`CART`.`ARTIST`,"+                // 04
-    "`CART`.`ALBUM`,"+                 // 05
-    "`CART`.`YEAR`,"+                  // 06
-    "`CART`.`LABEL`,"+                 // 07
-    "`CART`.`CLIENT`,"+                // 08
-    "`CART`.`AGENCY`,"+                // 09
-    "`CART`.`PUBLISHER`,"+             // 10
-    "`CART`.`COMPOSER`,"+              // 11
-    "`CART`.`USER_DEFINED`,"+          // 12
-    "`CART`.`USAGE_CODE`,"+            // 13
-    "`CART`.`FORCED_LENGTH`,"+         // 14
-    "`CART`.`AVERAGE_LENGTH`,"+        // 15
-    "`CART`.`LENGTH_DEVIATION`,"+      // 16
-    "`CART`.`AVERAGE_SEGUE_LENGTH`,"+  // 17
-    "`CART`.`AVERAGE_HOOK_LENGTH`,"+   // 18
-    "`CART`.`MINIMUM_TALK_LENGTH`,"+   // 19
-    "`CART`.`MAXIMUM_TALK_LENGTH`,"+   // 20
-    "`CART`.`CUT_QUANTITY`,"+          // 21
-    "`CART`.`LAST_CUT_PLAYED`,"+       // 22
-    "`CART`.`VALIDITY`,"+              // 23
-    "`CART`.`ENFORCE_LENGTH`,"+        // 24
-    "`CART`.`ASYNCRONOUS`,"+           // 25
-    "`CART`.`OWNER`,"+                 // 26
-    "`CART`.`METADATA_DATETIME`,"+     // 27
-    "`CART`.`CONDUCTOR`,"+             // 28
-    "`CART`.`MACROS`,"+                // 29
-    "`CART`.`SONG_ID` ";               // 30
+  //
+  // Columns not needed for 'fields' are selected as NULL, so that the
+  // remaining ones keep their positions
+  //
+  QString sql="select ";
+  int cols=include_cuts?RDCART_XML_COLUMNS:RDCART_XML_CART_COLUMNS;
+
+  for(int i=0;i<cols;i++) {
+    if(i>0) {
+      sql+=",";
+    }
+    if((__rdcart_xml_columns[i][1]==NULL)||
+       RDXmlSelected(fields,__rdcart_xml_columns[i][1])) {
+      sql+=__rdcart_xml_columns[i][0];
+    }
+    else {
+      sql+="NULL";
+    }
+  }
   if(include_cuts) {
-    sql+=QString(",")+
-      "`CUTS`.`CUT_NAME`,"+            // 31
-      "`CUTS`.`EVERGREEN`,"+           // 32
-      "`CUTS`.`DESCRIPTION`,"+         // 33
-      "`CUTS`.`OUTCUE`,"+              // 34
-      "`CUTS`.`ISRC`,"+                // 35
-      "`CUTS`.`ISCI`,"+                // 36
-      "`CUTS`.`LENGTH`,"+              // 37
-      "`CUTS`.`ORIGIN_DATETIME`,"+     // 38
-      "`CUTS`.`START_DATETIME`,"+      // 39
-      "`CUTS`.`END_DATETIME`,"+        // 40
-      "`CUTS`.`SUN`,"+                 // 41
-      "`CUTS`.`MON`,"+                 // 42
-      "`CUTS`.`TUE`,"+                 // 43
-      "`CUTS`.`WED`,"+                 // 44
-      "`CUTS`.`THU`,"+                 // 45
-      "`CUTS`.`FRI`,"+                 // 46
-      "`CUTS`.`SAT`,"+                 // 47
-      "`CUTS`.`START_DAYPART`,"+       // 48
-      "`CUTS`.`END_DAYPART`,"+         // 49
-      "`CUTS`.`ORIGIN_NAME`,"+         // 50
-      "`CUTS`.`ORIGIN_LOGIN_NAME`,"+   // 51
-      "`CUTS`.`SOURCE_HOSTNAME`,"+     // 52
-      "`CUTS`.`WEIGHT`,"+              // 53
-      "`CUTS`.`LAST_PLAY_DATETIME`,"+  // 54
-      "`CUTS`.`PLAY_COUNTER`,"+        // 55
-      "`CUTS`.`LOCAL_COUNTER`,"+       // 56
-      "`CUTS`.`VALIDITY`,"+            // 57
-      "`CUTS`.`CODING_FORMAT`,"+       // 58
-      "`CUTS`.`SAMPLE_RATE`,"+         // 59
-      "`CUTS`.`BIT_RATE`,"+            // 60
-      "`CUTS`.`CHANNELS`,"+            // 61
-      "`CUTS`.`PLAY_GAIN`,"+           // 62
-      "`CUTS`.`START_POINT`,"+         // 63
-      "`CUTS`.`END_POINT`,"+           // 64
-      "`CUTS`.`FADEUP_POINT`,"+        // 65
-      "`CUTS`.`FADEDOWN_POINT`,"+      // 66
-      "`CUTS`.`SEGUE_START_POINT`,"+   // 67
-      "`CUTS`.`SEGUE_END_POINT`,"+     // 68
-      "`CUTS`.`SEGUE_GAIN`,"+          // 69
-      "`CUTS`.`HOOK_START_POINT`,"+    // 70
-      "`CUTS`.`HOOK_END_POINT`,"+      // 71
-      "`CUTS`.`TALK_START_POINT`,"+    // 72
-      "`CUTS`.`TALK_END_POINT`,"+      // 73
-      "`CUTS`.`RECORDING_MBID`,"+      // 74
-      "`CUTS`.`RELEASE_MBID` "+        // 75
-
-      "from `CART` left join `CUTS` "+
+    sql+=QString(" from `CART` left join `CUTS` ")+
       "on `CART`.`NUMBER`=`CUTS`.`CART_NUMBER` ";
   }
   else {
@@ -1512,13 +1554,33 @@ QString RDCart::xmlSql(bool include_cuts)
 QString RDCart::xml(RDSqlQuery *q,bool include_cuts,
 		    bool absolute,RDSettings *settings,int cutnum)
 {
+  QString xml="";
+
+  while(q->next()) {
+    xml+=RDCart::xmlRow(q,include_cuts,absolute,settings);
+  }
+
+  return xml;
+}
+
+
+QString RDCart::xmlRow(RDSqlQuery *q,bool include_cuts,bool absolute,
+		       RDSettings *settings,const QStringList &fields)
+{
+  //
+  // Render the cart at the current row of 'q', leaving 'q' on the last
+  // row that belongs to it.  If 'fields' is not empty, only the fields
+  // it names are included.
+  //
   QStringList mlist;
   unsigned cartnum;
   QString xml="";
 
-  while(q->next()) {
-    xml+="<cart>\n";
+  xml+="<cart>\n";
+  if(RDXmlSelected(fields,"number")) {
     xml+="  "+RDXmlField("number",q->value(0).toUInt());
+  }
+  if(RDXmlSelected(fields,"type")) {
     switch((RDCart::Type)q->value(1).toUInt()) {
     case RDCart::Audio:
       xml+="  "+RDXmlField("type","audio");
@@ -1531,83 +1593,137 @@ QString RDCart::xml(RDSqlQuery *q,bool include_cuts,
     case RDCart::All:
       break;
     }
+  }
+  if(RDXmlSelected(fields,"groupName")) {
     xml+="  "+RDXmlField("groupName",q->value(2).toString());
+  }
+  if(RDXmlSelected(fields,"title")) {
     xml+="  "+RDXmlField("title",q->value(3).toString());
+  }
+  if(RDXmlSelected(fields,"artist")) {
     xml+="  "+RDXmlField("artist",q->value(4).toString());
+  }
+  if(RDXmlSelected(fields,"album")) {
     xml+="  "+RDXmlField("album",q->value(5).toString());
+  }
+  if(RDXmlSelected(fields,"year")) {
     xml+="  "+RDXmlField("year",q->value(6).toDate().toString("yyyy"));
+  }
+  if(RDXmlSelected(fields,"label")) {
     xml+="  "+RDXmlField("label",q->value(7).toString());
+  }
+  if(RDXmlSelected(fields,"client")) {
     xml+="  "+RDXmlField("client",q->value(8).toString());
+  }
+  if(RDXmlSelected(fields,"agency")) {
     xml+="  "+RDXmlField("agency",q->value(9).toString());
+  }
+  if(RDXmlSelected(fields,"publisher")) {
     xml+="  "+RDXmlField("publisher",q->value(10).toString());
+  }
+  if(RDXmlSelected(fields,"composer")) {
     xml+="  "+RDXmlField("composer",q->value(11).toString());
+  }
+  if(RDXmlSelected(fields,"conductor")) {
     xml+="  "+RDXmlField("conductor",q->value(26).toString());
+  }
+  if(RDXmlSelected(fields,"userDefined")) {
     xml+="  "+RDXmlField("userDefined",q->value(12).toString());
+  }
+  if(RDXmlSelected(fields,"usageCode")) {
     xml+="  "+RDXmlField("usageCode",q->value(13).toInt());
+  }
+  if(RDXmlSelected(fields,"forcedLength")) {
     xml+="  "+RDXmlField("forcedLength",
-			 "0"+RDGetTimeLength(q->value(14).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(14).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"averageLength")) {
     xml+="  "+RDXmlField("averageLength",
-			 "0"+RDGetTimeLength(q->value(15).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(15).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"lengthDeviation")) {
     xml+="  "+RDXmlField("lengthDeviation",
-			 "0"+RDGetTimeLength(q->value(16).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(16).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"averageSegueLength")) {
     xml+="  "+RDXmlField("averageSegueLength",
-			 "0"+RDGetTimeLength(q->value(17).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(17).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"averageHookLength")) {
     xml+="  "+RDXmlField("averageHookLength",
-			 "0"+RDGetTimeLength(q->value(18).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(18).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"minimumTalkLength")) {
     xml+="  "+RDXmlField("minimumTalkLength",
-			 "0"+RDGetTimeLength(q->value(19).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(19).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"maximumTalkLength")) {
     xml+="  "+RDXmlField("maximumTalkLength",
-			 "0"+RDGetTimeLength(q->value(20).toUInt(),true));
+		         "0"+RDGetTimeLength(q->value(20).toUInt(),true));
+  }
+  if(RDXmlSelected(fields,"cutQuantity")) {
     xml+="  "+RDXmlField("cutQuantity",q->value(21).toUInt());
+  }
+  if(RDXmlSelected(fields,"lastCutPlayed")) {
     xml+="  "+RDXmlField("lastCutPlayed",q->value(22).toUInt());
+  }
+  if(RDXmlSelected(fields,"enforceLength")) {
     xml+="  "+RDXmlField("enforceLength",RDBool(q->value(24).toString()));
+  }
+  if(RDXmlSelected(fields,"asyncronous")) {
     xml+="  "+RDXmlField("asyncronous",RDBool(q->value(25).toString()));
+  }
+  if(RDXmlSelected(fields,"owner")) {
     xml+="  "+RDXmlField("owner",q->value(26).toString());
+  }
+  if(RDXmlSelected(fields,"metadataDatetime")) {
     xml+="  "+RDXmlField("metadataDatetime",q->value(27).toDateTime());
+  }
+  if(RDXmlSelected(fields,"songId")) {
     xml+="  "+RDXmlField("songId",q->value(30).toString());
-    switch((RDCart::Type)q->value(1).toInt()) {
-    case RDCart::Audio:
-      if(include_cuts) {
-	cartnum=q->value(0).toUInt();
-	if(q->value(31).toString().isEmpty()) {
-	  xml+="  <cutList/>\n";
-	}
-	else {
-	  xml+="  <cutList>\n";
-	  xml+="  "+RDCut::xml(q,absolute,settings);
-	  while(q->next()) {
-	    if(q->value(0).toUInt()==cartnum) {
-	      xml+="  "+RDCut::xml(q,absolute,settings);
-	    }
-	    else {
-	      q->previous();
-	      break;
-	    }
+  }
+  switch((RDCart::Type)q->value(1).toInt()) {
+  case RDCart::Audio:
+    if(include_cuts) {
+      cartnum=q->value(0).toUInt();
+      if(q->value(31).toString().isEmpty()) {
+	xml+="  <cutList/>\n";
+      }
+      else {
+	xml+="  <cutList>\n";
+	xml+="  "+RDCut::xml(q,absolute,settings,fields);
+	while(q->next()) {
+	  if(q->value(0).toUInt()==cartnum) {
+	    xml+="  "+RDCut::xml(q,absolute,settings,fields);
+	  }
+	  else {
+	    q->previous();
+	    break;
 	  }
-	  xml+="  </cutList>\n";
 	}
+	xml+="  </cutList>\n";
       }
-      break;
+    }
+    break;
 
-    case RDCart::Macro:
-      mlist=q->value(29).toString().split("!");
-      if(mlist.size()==0) {
-	xml+="  <macroList/>\n";
-      }
-      else {
-	xml+="  <macroList>\n";
-	for(int i=0;i<mlist.size();i++) {
-	  xml+="    "+RDXmlField(QString::asprintf("macro%d",i),mlist[i]+"!");
-	}
-	xml+="  </macroList>\n";
+  case RDCart::Macro:
+    mlist=q->value(29).toString().split("!");
+    if(mlist.size()==0) {
+      xml+="  <macroList/>\n";
+    }
+    else {
+      xml+="  <macroList>\n";
+      for(int i=0;i<mlist.size();i++) {
+	xml+="    "+RDXmlField(QString::asprintf("macro%d",i),mlist[i]+"!");
       }
-      break;
-	
-    case RDCart::All:
-      break;
+      xml+="  </macroList>\n";
     }
-    xml+="</cart>\n";
+    break;
+      
+  case RDCart::All:
+    break;
   }
+  xml+="</cart>\n";
 
   return xml;
 }
@@ -1756,6 +1872,7 @@ bool RDCart::removeCutAudio(RDStation *station,RDUser *user,unsigned cart_num,
   RDSqlQuery *q;
 
   if(user==NULL) { 
+    // Cuts sharing this file (see RDAudioDedup) keep their own links to it
     unlink(RDCut::pathName(cutname).toUtf8());
     unlink((RDCut::pathName(cutname)+".energy").toUtf8());
     sql=QString("delete from `CUT_EVENTS` where ")+
@@ -1785,7 +1902,7 @@ bool RDCart::removeCutAudio(RDStation *station,RDUser *user,unsigned cart_num,
 		 CURLFORM_COPYCONTENTS,
 		 QString::asprintf("%u",RDCut::cutNumber(cutname)).
 		 toUtf8().constData(),CURLFORM_END);
-    if((curl=curl_easy_init())==NULL) {
+    if((curl=RDCurlPool::acquire())==NULL) {
       curl_formfree(first);
       return false;
     }
@@ -1797,10 +1914,10 @@ bool RDCart::removeCutAudio(RDStation *station,RDUser *user,unsigned cart_num,
     curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
     curl_easy_setopt(curl,CURLOPT_WRITEFUNCTION,CartWriteCallback);
     curl_easy_setopt(curl,CURLOPT_WRITEDATA,&xml);
-    ret&=curl_easy_perform(curl)==0;
+    ret&=RDCurlPool::perform(curl)==0;
     curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
     ret&=response_code==200;
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
   }
   return ret;
@@ -2238,6 +2355,43 @@ QString RDCart::prettyText(unsigned cartnum)
 }
 
 
+void RDCart::loadSnapshots(const QList<RDCart *> &carts)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QStringList nums;
+  unsigned cartnum;
+
+  //
+  // Fill the snapshots of a batch of carts with one query, for callers
+  // that are about to read the metadata of all of them
+  //
+  for(int i=0;i<carts.size();i++) {
+    carts.at(i)->cart_snapshot->setEnabled(true);
+    carts.at(i)->cart_snapshot->
+      setRecord(QString::asprintf("%u",carts.at(i)->cart_number),
+		QSqlRecord());
+    nums.push_back(QString::asprintf("%u",carts.at(i)->cart_number));
+  }
+  if(nums.size()==0) {
+    return;
+  }
+  sql=QString("select * from `CART` where ")+
+    "`NUMBER` in ("+nums.join(",")+")";
+  q=new RDSqlQuery(sql);
+  while(q->next()) {
+    cartnum=q->record().value("NUMBER").toUInt();
+    for(int i=0;i<carts.size();i++) {
+      if(carts.at(i)->cart_number==cartnum) {
+	carts.at(i)->cart_snapshot->
+	  setRecord(QString::asprintf("%u",cartnum),q->record());
+      }
+    }
+  }
+  delete q;
+}
+
+
 QVariant RDCart::GetXmlValue(const QString &tag,const QString &line)
 {
   bool ok=false;
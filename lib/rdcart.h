@@ -23,6 +23,7 @@
 #include <qvariant.h>
 
 #include <rdconfig.h>
+#include <rdrowsnapshot.h>
 #include <rdwavedata.h>
 
 #include <rdcut.h>
@@ -47,6 +48,8 @@ class RDCart
   RDCart(unsigned number);
   ~RDCart();
   bool exists() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   bool selectCut(QString *cut) const;
   bool selectCut(QString *cut,const QTime &time) const;
   RDCart::Type type() const;
@@ -156,9 +159,13 @@ class RDCart
   bool remove(RDStation *station,RDUser *user,RDConfig *config) const;
   static unsigned create(const QString &groupname,RDCart::Type type,
 			 QString *err_msg,unsigned cartnum=0);
-  static QString xmlSql(bool include_cuts);
+  static QString xmlSql(bool include_cuts,
+			const QStringList &fields=QStringList());
   static QString xml(RDSqlQuery *q,bool include_cuts,bool absolute,
 		     RDSettings *settings=NULL,int cutnum=-1);
+  static QString xmlRow(RDSqlQuery *q,bool include_cuts,bool absolute,
+			RDSettings *settings=NULL,
+			const QStringList &fields=QStringList());
   static QString cutXml(unsigned cartnum,int cutnum,bool absolute,
 			RDSettings *settings=NULL);
   static bool exists(unsigned cartnum);
@@ -176,6 +183,7 @@ class RDCart
   static QString ensureTitleIsUnique(unsigned except_cartnum,
 				     const QString &str);
   static QString prettyText(unsigned cartnum);
+  static void loadSnapshots(const QList<RDCart *> &carts);
   
  private:
   static QVariant GetXmlValue(const QString &tag,const QString &line);
@@ -191,6 +199,7 @@ class RDCart
   void SetRow(const QString &param) const;
   unsigned cart_number;
   bool metadata_changed;
+  RDRowSnapshot *cart_snapshot;
 };
 
 
@@ -394,9 +394,8 @@ bool RDDoesRowExist(const QString &table,const QString &name,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+name+"` from `"+table+"` where `"+name+"`="+
-    "\""+RDEscapeString(test)+"\"";
-  q=new RDSqlQuery(sql);
+  sql="select `"+name+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QVariantList()<<test);
   if(q->first()) {
     delete q;
     return true;
@@ -412,9 +411,8 @@ bool RDDoesRowExist(const QString &table,const QString &name,unsigned test,
   RDSqlQuery *q;
   QString sql;
 
-  sql="select `"+name+"` from `"+table+"` where `"+name+"`="+
-    QString::asprintf("%d",test);
-  q=new RDSqlQuery(sql);
+  sql="select `"+name+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QVariantList()<<test);
   if(q->size()>0) {
     delete q;
     return true;
@@ -432,9 +430,8 @@ QVariant RDGetSqlValue(const QString &table,const QString &name,
   QString sql;
   QVariant v;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    "\""+RDEscapeString(test)+"\"";
-  q=new RDSqlQuery(sql);
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QVariantList()<<test);
   if(q->isActive()) {
     q->first();
     v=q->value(0);
@@ -506,9 +503,8 @@ QVariant RDGetSqlValue(const QString &table,const QString &name,unsigned test,
   QString sql;
   QVariant v;
 
-  sql="select `"+param+"` from `"+table+"` where `"+name+"`="+
-    QString::asprintf("%u",test);
-  q=new RDSqlQuery(sql);
+  sql="select `"+param+"` from `"+table+"` where `"+name+"`=?";
+  q=new RDSqlQuery(sql,QVariantList()<<test);
   if(q->first()) {
     v=q->value(0);
     if(valid!=NULL) {
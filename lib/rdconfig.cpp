@@ -223,6 +223,30 @@ QString RDConfig::mysqlCollation() const
 }
 
 
+int RDConfig::mysqlReplicas() const
+{
+  return conf_mysql_replica_hostnames.size();
+}
+
+
+QString RDConfig::mysqlReplicaHostname(int n) const
+{
+  return conf_mysql_replica_hostnames.at(n);
+}
+
+
+int RDConfig::mysqlReplicaPort(int n) const
+{
+  return conf_mysql_replica_ports.at(n);
+}
+
+
+int RDConfig::mysqlReplicaStickiness() const
+{
+  return conf_mysql_replica_stickiness;
+}
+
+
 QString RDConfig::createTablePostfix() const
 {
   return conf_create_table_postfix;
@@ -441,6 +465,24 @@ int RDConfig::logSqlQueriesLevel() const
 }
 
 
+bool RDConfig::profileSqlQueries() const
+{
+  return conf_profile_sql_queries;
+}
+
+
+int RDConfig::profileSqlQueriesLevel() const
+{
+  return conf_profile_sql_queries_level;
+}
+
+
+int RDConfig::profileSqlRepeatLimit() const
+{
+  return conf_profile_sql_repeat_limit;
+}
+
+
 int RDConfig::meterBasePort() const
 {
   return conf_meter_base_port;
@@ -519,6 +561,72 @@ int RDConfig::transcodingDelay() const
 }
 
 
+int RDConfig::audioReadBlockSize() const
+{
+  return conf_audio_read_block_size;
+}
+
+
+bool RDConfig::audioReadAhead() const
+{
+  return conf_audio_read_ahead;
+}
+
+
+QString RDConfig::transcodeCacheDirectory() const
+{
+  return conf_transcode_cache_directory;
+}
+
+
+int RDConfig::transcodeCacheSize() const
+{
+  return conf_transcode_cache_size;
+}
+
+
+int RDConfig::webServicePort() const
+{
+  return conf_web_service_port;
+}
+
+
+int RDConfig::webServiceWorkers() const
+{
+  return conf_web_service_workers;
+}
+
+
+int RDConfig::webServiceMaxRequests() const
+{
+  return conf_web_service_max_requests;
+}
+
+
+bool RDConfig::inProcessWebApi() const
+{
+  return conf_in_process_web_api;
+}
+
+
+int RDConfig::rehashWorkers() const
+{
+  return conf_rehash_workers;
+}
+
+
+unsigned RDConfig::rehashRateLimit() const
+{
+  return conf_rehash_rate_limit;
+}
+
+
+bool RDConfig::dedupAudio() const
+{
+  return conf_dedup_audio;
+}
+
+
 int RDConfig::serviceTimeout() const
 {
   return conf_service_timeout;
@@ -660,6 +768,18 @@ bool RDConfig::load()
     profile->stringValue("mySQL","Engine",DEFAULT_MYSQL_ENGINE);
   conf_mysql_collation=
     profile->stringValue("mySQL","Collation",DEFAULT_MYSQL_COLLATION);
+  int r=1;
+  QString replica=profile->stringValue("mySQL","Replica1","");
+  while(!replica.isEmpty()) {
+    QStringList f0=replica.split(":");
+    conf_mysql_replica_hostnames.push_back(f0.at(0));
+    conf_mysql_replica_ports.push_back(f0.size()>1?f0.at(1).toInt():0);
+    replica=
+      profile->stringValue("mySQL",QString::asprintf("Replica%d",++r),"");
+  }
+  conf_mysql_replica_stickiness=
+    profile->intValue("mySQL","ReplicaStickiness",
+		      DEFAULT_MYSQL_REPLICA_STICKINESS);
   conf_create_table_postfix=
     RDConfig::createTablePostfix(conf_mysql_engine);
 
@@ -690,6 +810,12 @@ bool RDConfig::load()
   conf_log_sql_queries_level=
     SyslogPriorityLevel(profile->stringValue("Debugging","LogSqlQueries",""),
 			&conf_log_sql_queries);
+  conf_profile_sql_queries_level=SyslogPriorityLevel(profile->
+		    stringValue("Debugging","ProfileSqlQueries",""),
+						     &conf_profile_sql_queries);
+  conf_profile_sql_repeat_limit=
+    profile->intValue("Debugging","ProfileSqlRepeatLimit",
+		      RD_DEFAULT_PROFILE_SQL_REPEAT_LIMIT);
   conf_meter_base_port=
     profile->intValue("Hacks","MeterPortBaseNumber",RD_DEFAULT_METER_SOCKET_BASE_UDP_PORT);
   conf_meter_port_range=
@@ -724,6 +850,30 @@ bool RDConfig::load()
   conf_use_realtime=profile->boolValue("Tuning","UseRealtime",false);
   conf_realtime_priority=profile->intValue("Tuning","RealtimePriority",9);
   conf_transcoding_delay=profile->intValue("Tuning","TranscodingDelay");
+  conf_audio_read_block_size=profile->intValue("Tuning","AudioReadBlockSize",
+					       RD_DEFAULT_AUDIO_READ_BLOCK_SIZE);
+  conf_audio_read_ahead=profile->boolValue("Tuning","AudioReadAhead",false);
+  conf_transcode_cache_directory=
+    profile->stringValue("Tuning","TranscodeCacheDirectory","");
+  conf_transcode_cache_size=
+    profile->intValue("Tuning","TranscodeCacheSize",
+		      RD_DEFAULT_TRANSCODE_CACHE_SIZE);
+  conf_web_service_port=profile->intValue("Tuning","WebServicePort",0);
+  conf_web_service_workers=
+    profile->intValue("Tuning","WebServiceWorkers",
+		      RD_DEFAULT_WEB_SERVICE_WORKERS);
+  conf_web_service_max_requests=
+    profile->intValue("Tuning","WebServiceMaxRequests",
+		      RD_DEFAULT_WEB_SERVICE_MAX_REQUESTS);
+  conf_in_process_web_api=
+    profile->boolValue("Tuning","InProcessWebApi",true);
+  conf_rehash_workers=
+    profile->intValue("Tuning","RehashWorkers",RD_DEFAULT_REHASH_WORKERS);
+  if(conf_rehash_workers<1) {
+    conf_rehash_workers=1;
+  }
+  conf_rehash_rate_limit=profile->intValue("Tuning","RehashRateLimit",0);
+  conf_dedup_audio=profile->boolValue("Tuning","DedupAudio",false);
   conf_service_timeout=
     profile->intValue("Tuning","ServiceTimeout",RD_DEFAULT_SERVICE_TIMEOUT);
   conf_temp_directory=profile->stringValue("Tuning","TempDirectory","");
@@ -783,6 +933,9 @@ void RDConfig::clear()
   conf_mysql_heartbeat_interval=DEFAULT_MYSQL_HEARTBEAT_INTERVAL;
   conf_mysql_engine=DEFAULT_MYSQL_ENGINE;
   conf_mysql_collation=DEFAULT_MYSQL_COLLATION;
+  conf_mysql_replica_hostnames.clear();
+  conf_mysql_replica_ports.clear();
+  conf_mysql_replica_stickiness=DEFAULT_MYSQL_REPLICA_STICKINESS;
   conf_create_table_postfix="";
   conf_log_xload_debug_data=false;
   conf_provisioning_create_host=false;
@@ -829,6 +982,9 @@ void RDConfig::clear()
   conf_log_log_refresh_level=LOG_DEBUG;
   conf_log_sql_queries=false;
   conf_log_sql_queries_level=LOG_DEBUG;
+  conf_profile_sql_queries=false;
+  conf_profile_sql_queries_level=LOG_DEBUG;
+  conf_profile_sql_repeat_limit=RD_DEFAULT_PROFILE_SQL_REPEAT_LIMIT;
   conf_lock_rdairplay_memory=false;
   conf_meter_base_port=RD_DEFAULT_METER_SOCKET_BASE_UDP_PORT;
   conf_meter_port_range=RD_METER_SOCKET_PORT_RANGE;
@@ -843,6 +999,17 @@ void RDConfig::clear()
   conf_use_realtime=false;
   conf_realtime_priority=9;
   conf_transcoding_delay=0;
+  conf_audio_read_block_size=RD_DEFAULT_AUDIO_READ_BLOCK_SIZE;
+  conf_audio_read_ahead=false;
+  conf_transcode_cache_directory="";
+  conf_transcode_cache_size=RD_DEFAULT_TRANSCODE_CACHE_SIZE;
+  conf_web_service_port=0;
+  conf_web_service_workers=RD_DEFAULT_WEB_SERVICE_WORKERS;
+  conf_web_service_max_requests=RD_DEFAULT_WEB_SERVICE_MAX_REQUESTS;
+  conf_in_process_web_api=true;
+  conf_rehash_workers=RD_DEFAULT_REHASH_WORKERS;
+  conf_rehash_rate_limit=0;
+  conf_dedup_audio=false;
   conf_service_timeout=RD_DEFAULT_SERVICE_TIMEOUT;
   conf_temp_directory="";
   conf_service_startup_delay=RD_DEFAULT_SERVICE_STARTUP_DELAY;
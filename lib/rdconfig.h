@@ -26,7 +26,9 @@
 #include <vector>
 
 #include <QHostAddress>
+#include <QList>
 #include <QString>
+#include <QStringList>
 
 #include <rd.h>
 
@@ -63,6 +65,10 @@ class RDConfig
   int mysqlHeartbeatInterval() const;
   QString mysqlEngine() const;
   QString mysqlCollation() const;
+  int mysqlReplicas() const;
+  QString mysqlReplicaHostname(int n) const;
+  int mysqlReplicaPort(int n) const;
+  int mysqlReplicaStickiness() const;
   QString createTablePostfix() const;
   bool logXloadDebugData() const;
   bool provisioningCreateHost() const;
@@ -112,6 +118,9 @@ class RDConfig
   int logLogRefreshLevel() const;
   bool logSqlQueries() const;
   int logSqlQueriesLevel() const;
+  bool profileSqlQueries() const;
+  int profileSqlQueriesLevel() const;
+  int profileSqlRepeatLimit() const;
   bool enableMixerLogging() const;
   bool testOutputStreams() const;
   uid_t uid() const;
@@ -123,6 +132,17 @@ class RDConfig
   bool useRealtime();
   int realtimePriority();
   int transcodingDelay() const;
+  int audioReadBlockSize() const;
+  bool audioReadAhead() const;
+  QString transcodeCacheDirectory() const;
+  int transcodeCacheSize() const;
+  int webServicePort() const;
+  int webServiceWorkers() const;
+  int webServiceMaxRequests() const;
+  bool inProcessWebApi() const;
+  int rehashWorkers() const;
+  unsigned rehashRateLimit() const;
+  bool dedupAudio() const;
   int serviceTimeout() const;
   QString tempDirectory();
   int serviceStartupDelay() const;
@@ -151,6 +171,9 @@ class RDConfig
   QString conf_mysql_collation;
   QString conf_create_table_postfix;
   int conf_mysql_heartbeat_interval;
+  QStringList conf_mysql_replica_hostnames;
+  QList<int> conf_mysql_replica_ports;
+  int conf_mysql_replica_stickiness;
   bool conf_provisioning_create_host;
   QString conf_provisioning_host_template;
   QHostAddress conf_provisioning_host_ip_address;
@@ -193,6 +216,9 @@ class RDConfig
   int conf_log_log_refresh_level;
   bool conf_log_sql_queries;
   int conf_log_sql_queries_level;
+  bool conf_profile_sql_queries;
+  int conf_profile_sql_queries_level;
+  int conf_profile_sql_repeat_limit;
   bool conf_lock_rdairplay_memory;
   QString conf_save_webget_files_directory;
   bool conf_suppress_rdcatch_meter_updates;
@@ -210,6 +236,17 @@ class RDConfig
   bool conf_test_output_streams;
   bool conf_use_realtime;
   int conf_transcoding_delay;
+  int conf_audio_read_block_size;
+  bool conf_audio_read_ahead;
+  QString conf_transcode_cache_directory;
+  int conf_transcode_cache_size;
+  int conf_web_service_port;
+  int conf_web_service_workers;
+  int conf_web_service_max_requests;
+  bool conf_in_process_web_api;
+  int conf_rehash_workers;
+  unsigned conf_rehash_rate_limit;
+  bool conf_dedup_audio;
   int conf_realtime_priority;
   int conf_service_timeout;
   QString conf_temp_directory;
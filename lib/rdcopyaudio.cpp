@@ -32,6 +32,7 @@
 #include <qobject.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdxport_interface.h>
 #include <rdformpost.h>
 #include <rdcopyaudio.h>
@@ -113,7 +114,7 @@ RDCopyAudio::ErrorCode RDCopyAudio::runCopy(const QString &username,
 	       QString::asprintf("%u",conv_destination_cut_number).
 	       toUtf8().constData(),
 	       CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDCopyAudio::ErrorInternal;
   }
@@ -125,7 +126,7 @@ RDCopyAudio::ErrorCode RDCopyAudio::runCopy(const QString &username,
 		   conv_config->userAgent().toUtf8().constData());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
 
-  switch(curl_easy_perform(curl)) {
+  switch(RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
@@ -139,7 +140,7 @@ RDCopyAudio::ErrorCode RDCopyAudio::runCopy(const QString &username,
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDCopyAudio::ErrorInternal;
 
@@ -147,12 +148,12 @@ RDCopyAudio::ErrorCode RDCopyAudio::runCopy(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDCopyAudio::ErrorUrlInvalid;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   switch(response_code) {
@@ -24,6 +24,7 @@
 #include <QApplication>
 #include <QDir>
 #include <QFile>
+#include <QMutexLocker>
 #include <QIODevice>
 #include <QProcess>
 #include <QStyleFactory>
@@ -33,6 +34,7 @@
 #include "rdapplication.h"
 #include "rdcmd_switch.h"
 #include "rdescape_string.h"
+#include "rdrowsnapshot.h"
 #include "rdtranslator.h"
 
 RDCoreApplication *rdc=NULL;
@@ -50,7 +52,7 @@ RDCoreApplication::RDCoreApplication(const QString &module_name,
 				     const QString &cmdname,
 				     const QString &usage,bool use_translations,
 				     QObject *parent)
-  : QObject(parent)
+  : QObject(parent),app_accessor_mutex(QMutex::Recursive)
 {
   app_module_name=module_name;
   app_command_name=cmdname;
@@ -75,9 +77,11 @@ RDCoreApplication::RDCoreApplication(const QString &module_name,
   app_panel_conf=NULL;
   app_port_names=NULL;
   app_ripc=NULL;
+  app_schemas=NULL;
   app_station=NULL;
   app_system=NULL;
   app_user=NULL;
+  app_startup_probe=NULL;
   app_long_date_format=RD_DEFAULT_LONG_DATE_FORMAT;
   app_short_date_format=RD_DEFAULT_SHORT_DATE_FORMAT;
   app_show_twelve_hour_time=false;
@@ -132,6 +136,12 @@ RDCoreApplication::~RDCoreApplication()
   if(app_ripc!=NULL) {
     delete app_ripc;
   }
+  if(app_schemas!=NULL) {
+    delete app_schemas;
+  }
+  if(app_startup_probe!=NULL) {
+    delete app_startup_probe;
+  }
 }
 
 
@@ -188,7 +198,12 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
       check_svc=false;
       app_cmd_switch->setProcessed(i,true);
     }
+    if(app_cmd_switch->key(i)=="--profile-startup") {
+      app_startup_probe=new RDTimeProbe();
+      app_cmd_switch->setProcessed(i,true);
+    }
   }
+  StartupWaypoint("read command switches");
 
   //
   // Process Uniqueness Check
@@ -207,6 +222,7 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
   app_config=new RDConfig();
   app_config->load();
   app_config->setModuleName(app_module_name);
+  StartupWaypoint("loaded rd.conf(5)");
 
   //
   // Initialize Logging
@@ -228,6 +244,7 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
       }
       return false;
     }
+    StartupWaypoint("checked service status");
   }
 
   //
@@ -248,23 +265,13 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
     return false;
   }
   app_heartbeat=new RDDbHeartbeat(app_config->mysqlHeartbeatInterval(),this);
+  StartupWaypoint("opened database");
 
   //
-  // Open Accessors
+  // The remaining accessors are created the first time that they are
+  // asked for, so that short-lived processes (CGIs, rdimport, rmlsend
+  // and the like) pay only for what they actually use.
   //
-  app_station=new RDStation(app_config->stationName());
-  app_system=new RDSystem();
-  app_schemas=new RDRssSchemas();
-  app_library_conf=new RDLibraryConf(app_config->stationName());
-  app_logedit_conf=new RDLogeditConf(app_config->stationName());
-  app_airplay_conf=new RDAirPlayConf(app_config->stationName(),"RDAIRPLAY");
-  app_panel_conf=new RDAirPlayConf(app_config->stationName(),"RDPANEL");
-  app_port_names=new RDPortNames(app_config->stationName());
-  app_user=new RDUser();
-  app_cae=new RDCae(app_station,app_config,this);
-  app_ripc=new RDRipc(app_station,app_config,this);
-  connect(app_ripc,SIGNAL(userChanged()),this,SLOT(userChangedData()));
-
   //
   // Get Date/Time Formats
   //
@@ -283,8 +290,9 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
     syslog(LOG_WARNING,"unable to load date/time formats");
   }
   delete q;
+  StartupWaypoint("loaded date/time formats");
 
-  if(!app_station->exists()) {
+  if(!station()->exists()) {
     if(err_type!=NULL) {
       *err_type=RDCoreApplication::ErrorNoHostEntry;
     }
@@ -293,6 +301,7 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
       QObject::tr("Open RDAdmin->ManageHosts->Add to create one.");
     return false;
   }
+  StartupWaypoint("checked host entry");
 
   return true; 
 }
@@ -300,12 +309,26 @@ bool RDCoreApplication::open(QString *err_msg,ErrorType *err_type,
 
 RDAirPlayConf *RDCoreApplication::airplayConf()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_airplay_conf==NULL) {
+    app_airplay_conf=
+      new RDAirPlayConf(app_config->stationName(),"RDAIRPLAY");
+    app_airplay_conf->setSnapshotEnabled(true);
+    StartupWaypoint("created RDAirPlayConf (RDAIRPLAY)");
+  }
   return app_airplay_conf;
 }
 
 
 RDCae *RDCoreApplication::cae()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_cae==NULL) {
+    app_cae=new RDCae(station(),app_config,this);
+    StartupWaypoint("created RDCae");
+  }
   return app_cae;
 }
 
@@ -324,54 +347,122 @@ RDConfig *RDCoreApplication::config()
 
 RDLibraryConf *RDCoreApplication::libraryConf()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_library_conf==NULL) {
+    app_library_conf=new RDLibraryConf(app_config->stationName());
+    app_library_conf->setSnapshotEnabled(true);
+    StartupWaypoint("created RDLibraryConf");
+  }
   return app_library_conf;
 }
 
 
 RDLogeditConf *RDCoreApplication::logeditConf()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_logedit_conf==NULL) {
+    app_logedit_conf=new RDLogeditConf(app_config->stationName());
+    app_logedit_conf->setSnapshotEnabled(true);
+    StartupWaypoint("created RDLogeditConf");
+  }
   return app_logedit_conf;
 }
 
 
 RDAirPlayConf *RDCoreApplication::panelConf()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_panel_conf==NULL) {
+    app_panel_conf=new RDAirPlayConf(app_config->stationName(),"RDPANEL");
+    app_panel_conf->setSnapshotEnabled(true);
+    StartupWaypoint("created RDAirPlayConf (RDPANEL)");
+  }
   return app_panel_conf;
 }
 
 
 RDPortNames *RDCoreApplication::portNames()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_port_names==NULL) {
+    app_port_names=new RDPortNames(app_config->stationName());
+    StartupWaypoint("created RDPortNames");
+  }
   return app_port_names;
 }
 
 
 RDRipc *RDCoreApplication::ripc()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_ripc==NULL) {
+    app_ripc=new RDRipc(station(),app_config,this);
+    connect(app_ripc,SIGNAL(userChanged()),this,SLOT(userChangedData()));
+    connect(app_ripc,SIGNAL(notificationReceived(RDNotification *)),
+	    this,SLOT(notificationReceivedData(RDNotification *)));
+    StartupWaypoint("created RDRipc");
+  }
   return app_ripc;
 }
 
 
+bool RDCoreApplication::hasRipc() const
+{
+  return app_ripc!=NULL;
+}
+
+
 RDRssSchemas *RDCoreApplication::rssSchemas()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_schemas==NULL) {
+    app_schemas=new RDRssSchemas();
+    StartupWaypoint("created RDRssSchemas");
+  }
   return app_schemas;
 }
 
 
 RDStation *RDCoreApplication::station()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_station==NULL) {
+    app_station=new RDStation(app_config->stationName());
+    app_station->setSnapshotEnabled(true);
+    StartupWaypoint("created RDStation");
+  }
   return app_station;
 }
 
 
 RDSystem *RDCoreApplication::system()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_system==NULL) {
+    app_system=new RDSystem();
+    app_system->setSnapshotEnabled(true);
+    StartupWaypoint("created RDSystem");
+  }
   return app_system;
 }
 
 
 RDUser *RDCoreApplication::user()
 {
+  QMutexLocker locker(&app_accessor_mutex);
+
+  if(app_user==NULL) {
+    app_user=new RDUser();
+    StartupWaypoint("created RDUser");
+  }
   return app_user;
 }
 
@@ -692,13 +783,24 @@ bool RDCoreApplication::isUniqueProcess(const QString &cmdname)
 }
 
 
+void RDCoreApplication::notificationReceivedData(RDNotification *notify)
+{
+  if(notify->type()==RDNotification::ConfigType) {
+    RDRowSnapshot::invalidateTable(notify->id().toString());
+    if((notify->id().toString()=="AUDIO_OUTPUTS")&&(app_port_names!=NULL)) {
+      app_port_names->reload();
+    }
+  }
+}
+
+
 void RDCoreApplication::userChangedData()
 {
   QString sql;
   RDSqlQuery *q=NULL;
 
   if(app_ticket.isEmpty()) {
-    app_user->setName(app_ripc->user());
+    user()->setName(app_ripc->user());
     emit userChanged();
     return;
   }
@@ -712,7 +814,7 @@ void RDCoreApplication::userChangedData()
       "`EXPIRATION_DATETIME`>now()";
     q=new RDSqlQuery(sql);
     if(q->first()) {
-      app_user->setName(q->value(0).toString());
+      user()->setName(q->value(0).toString());
       emit userChanged();
       delete q;
       return;
@@ -739,7 +841,15 @@ QString RDCoreApplication::commandName() const
 }
 
 
- bool RDCoreApplication::CheckService(QString *err_msg)
+ void RDCoreApplication::StartupWaypoint(const QString &label)
+{
+  if(app_startup_probe!=NULL) {
+    app_startup_probe->printWaypoint(label);
+  }
+}
+
+
+bool RDCoreApplication::CheckService(QString *err_msg)
 {
   bool ret=false;
   int trial=config()->serviceTimeout();
@@ -24,6 +24,7 @@
 #include <stdarg.h>
 #include <syslog.h>
 
+#include <QMutex>
 #include <QObject>
 #include <QStringList>
 
@@ -40,6 +41,7 @@
 #include <rdrssschemas.h>
 #include <rdstation.h>
 #include <rdsystem.h>
+#include <rdtimeprobe.h>
 #include <rduser.h>
 
 class RDCoreApplication : public QObject
@@ -70,6 +72,7 @@ class RDCoreApplication : public QObject
   RDAirPlayConf *panelConf();
   RDPortNames *portNames();
   RDRipc *ripc();
+  bool hasRipc() const;
   RDRssSchemas *rssSchemas();
   RDStation *station();
   RDSystem *system();
@@ -95,6 +98,7 @@ class RDCoreApplication : public QObject
 
  private slots:
   void userChangedData();
+  void notificationReceivedData(RDNotification *notify);
 
  signals:
   void userChanged();
@@ -104,6 +108,7 @@ class RDCoreApplication : public QObject
   QString commandName() const;
 
  private:
+  void StartupWaypoint(const QString &label);
   bool CheckService(QString *err_msg);
   RDAirPlayConf *app_airplay_conf;
   RDAirPlayConf *app_panel_conf;
@@ -119,6 +124,8 @@ class RDCoreApplication : public QObject
   RDSystem *app_system;
   RDUser *app_user;
   RDDbHeartbeat *app_heartbeat;
+  RDTimeProbe *app_startup_probe;
+  QMutex app_accessor_mutex;
   QString app_ticket;
   QString app_module_name;
   char app_syslog_name[PATH_MAX];
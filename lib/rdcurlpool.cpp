@@ -0,0 +1,175 @@
+// rdcurlpool.cpp
+//
+// Process-wide pool of keep-alive HTTP client handles.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#include <QList>
+
+#include "rdcurlpool.h"
+
+//
+// Handles keep their connection cache when released, and all of them
+// share DNS, TLS session and (where libcurl supports it) connection
+// caches, so consecutive requests to the same Web API host reuse the
+// same keep-alive connection.
+//
+static pthread_mutex_t __rdcurlpool_mutex=PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t __rdcurlpool_share_mutex[CURL_LOCK_DATA_LAST];
+static pthread_once_t __rdcurlpool_once=PTHREAD_ONCE_INIT;
+static CURLSH *__rdcurlpool_share=NULL;
+static QList<CURL *> *__rdcurlpool_idle=NULL;
+static uint64_t __rdcurlpool_connections=0;
+static uint64_t __rdcurlpool_requests=0;
+
+static void __RDCurlPool_Lock(CURL *handle,curl_lock_data data,
+			      curl_lock_access access,void *userptr)
+{
+  pthread_mutex_lock(&__rdcurlpool_share_mutex[data]);
+}
+
+
+static void __RDCurlPool_Unlock(CURL *handle,curl_lock_data data,
+				void *userptr)
+{
+  pthread_mutex_unlock(&__rdcurlpool_share_mutex[data]);
+}
+
+
+static void __RDCurlPool_Report()
+{
+  //
+  // The facility comes from the openlog(3) call made at startup
+  //
+  syslog(LOG_DEBUG,"Web API requests: %llu, connections opened: %llu",
+	 (unsigned long long)RDCurlPool::requestsMade(),
+	 (unsigned long long)RDCurlPool::connectionsOpened());
+}
+
+
+static void __RDCurlPool_Init()
+{
+  for(int i=0;i<CURL_LOCK_DATA_LAST;i++) {
+    pthread_mutex_init(&__rdcurlpool_share_mutex[i],NULL);
+  }
+  __rdcurlpool_idle=new QList<CURL *>;
+  if((__rdcurlpool_share=curl_share_init())!=NULL) {
+    curl_share_setopt(__rdcurlpool_share,CURLSHOPT_LOCKFUNC,
+		      __RDCurlPool_Lock);
+    curl_share_setopt(__rdcurlpool_share,CURLSHOPT_UNLOCKFUNC,
+		      __RDCurlPool_Unlock);
+    curl_share_setopt(__rdcurlpool_share,CURLSHOPT_SHARE,
+		      CURL_LOCK_DATA_DNS);
+    curl_share_setopt(__rdcurlpool_share,CURLSHOPT_SHARE,
+		      CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM>=0x073900
+    curl_share_setopt(__rdcurlpool_share,CURLSHOPT_SHARE,
+		      CURL_LOCK_DATA_CONNECT);
+#endif  // LIBCURL_VERSION_NUM>=0x073900
+  }
+  atexit(__RDCurlPool_Report);
+}
+
+
+CURL *RDCurlPool::acquire()
+{
+  CURL *curl=NULL;
+
+  pthread_once(&__rdcurlpool_once,__RDCurlPool_Init);
+  pthread_mutex_lock(&__rdcurlpool_mutex);
+  if(__rdcurlpool_idle->size()>0) {
+    curl=__rdcurlpool_idle->takeLast();
+  }
+  pthread_mutex_unlock(&__rdcurlpool_mutex);
+  if(curl==NULL) {
+    if((curl=curl_easy_init())==NULL) {
+      return NULL;
+    }
+  }
+  if(__rdcurlpool_share!=NULL) {
+    curl_easy_setopt(curl,CURLOPT_SHARE,__rdcurlpool_share);
+  }
+  curl_easy_setopt(curl,CURLOPT_TCP_KEEPALIVE,1L);
+
+  return curl;
+}
+
+
+CURLcode RDCurlPool::perform(CURL *curl)
+{
+  CURLcode ret=curl_easy_perform(curl);
+  long conns=0;
+
+  curl_easy_getinfo(curl,CURLINFO_NUM_CONNECTS,&conns);
+  pthread_mutex_lock(&__rdcurlpool_mutex);
+  __rdcurlpool_requests++;
+  __rdcurlpool_connections+=conns;
+  pthread_mutex_unlock(&__rdcurlpool_mutex);
+
+  return ret;
+}
+
+
+void RDCurlPool::release(CURL *curl)
+{
+  if(curl==NULL) {
+    return;
+  }
+
+  //
+  // Resetting clears the options of the previous request but keeps
+  // its live connections
+  //
+  curl_easy_reset(curl);
+  pthread_mutex_lock(&__rdcurlpool_mutex);
+  if(__rdcurlpool_idle->size()<RDCURLPOOL_MAX_IDLE_HANDLES) {
+    __rdcurlpool_idle->push_back(curl);
+    curl=NULL;
+  }
+  pthread_mutex_unlock(&__rdcurlpool_mutex);
+  if(curl!=NULL) {
+    curl_easy_cleanup(curl);
+  }
+}
+
+
+uint64_t RDCurlPool::connectionsOpened()
+{
+  uint64_t ret=0;
+
+  pthread_mutex_lock(&__rdcurlpool_mutex);
+  ret=__rdcurlpool_connections;
+  pthread_mutex_unlock(&__rdcurlpool_mutex);
+
+  return ret;
+}
+
+
+uint64_t RDCurlPool::requestsMade()
+{
+  uint64_t ret=0;
+
+  pthread_mutex_lock(&__rdcurlpool_mutex);
+  ret=__rdcurlpool_requests;
+  pthread_mutex_unlock(&__rdcurlpool_mutex);
+
+  return ret;
+}
@@ -0,0 +1,44 @@
+// rdcurlpool.h
+//
+// Process-wide pool of keep-alive HTTP client handles.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDCURLPOOL_H
+#define RDCURLPOOL_H
+
+#include <stdint.h>
+
+#include <curl/curl.h>
+
+//
+// Maximum number of idle handles kept for reuse
+//
+#define RDCURLPOOL_MAX_IDLE_HANDLES 8
+
+class RDCurlPool
+{
+ public:
+  static CURL *acquire();
+  static CURLcode perform(CURL *curl);
+  static void release(CURL *curl);
+  static uint64_t connectionsOpened();
+  static uint64_t requestsMade();
+};
+
+
+#endif  // RDCURLPOOL_H
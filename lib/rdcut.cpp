@@ -24,6 +24,7 @@
 #include <fcntl.h>
 
 #include "rd.h"
+#include "rdaudiodedup.h"
 #include "rdconf.h"
 #include "rdconfig.h"
 #include "rdcopyaudio.h"
@@ -32,6 +33,7 @@
 #include "rddisclookup.h"
 #include "rdescape_string.h"
 #include "rdgroup.h"
+#include "rdsqltransaction.h"
 #include "rdtextvalidator.h"
 #include "rdtrimaudio.h"
 #include "rdwavefile.h"
@@ -43,6 +45,7 @@
 RDCut::RDCut(const QString &name,bool create)
 {
   cut_name=name;
+  cut_snapshot=new RDRowSnapshot("CUTS","CUT_NAME");
 
   if(name.isEmpty()) {
     cut_number=0;
@@ -61,6 +64,7 @@ RDCut::RDCut(const QString &name,bool create)
 RDCut::RDCut(unsigned cartnum,int cutnum,bool create)
 {
   cut_name=RDCut::cutName(cartnum,cutnum);
+  cut_snapshot=new RDRowSnapshot("CUTS","CUT_NAME");
 
   if(create) {
     RDCut::create(cut_name);
@@ -72,6 +76,7 @@ RDCut::RDCut(unsigned cartnum,int cutnum,bool create)
 
 RDCut::~RDCut()
 {
+  delete cut_snapshot;
 }
 
 
@@ -81,6 +86,18 @@ bool RDCut::exists() const
 }
 
 
+bool RDCut::snapshotEnabled() const
+{
+  return cut_snapshot->isEnabled();
+}
+
+
+void RDCut::setSnapshotEnabled(bool state)
+{
+  cut_snapshot->setEnabled(state);
+}
+
+
 bool RDCut::isValid() const
 {
   return isValid(QDateTime(QDate::currentDate(),QTime::currentTime()));
@@ -173,7 +190,7 @@ void RDCut::setCartNumber(unsigned num) const
 
 bool RDCut::evergreen() const
 {
-  return RDBool(RDGetSqlValue("CUTS","CUT_NAME",cut_name,"EVERGREEN").
+  return RDBool(cut_snapshot->value(cut_name,"EVERGREEN").
 	       toString());
 }
 
@@ -186,7 +203,7 @@ void RDCut::setEvergreen(bool state) const
 
 QString RDCut::description() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"DESCRIPTION").
+  return cut_snapshot->value(cut_name,"DESCRIPTION").
     toString();
 }
 
@@ -199,7 +216,7 @@ void RDCut::setDescription(const QString &string) const
 
 QString RDCut::outcue() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"OUTCUE").toString();
+  return cut_snapshot->value(cut_name,"OUTCUE").toString();
 }
 
 
@@ -211,7 +228,7 @@ void RDCut::setOutcue(const QString &string) const
 
 QString RDCut::isrc(IsrcFormat fmt) const
 {
-  QString str= RDGetSqlValue("CUTS","CUT_NAME",cut_name,"ISRC").
+  QString str= cut_snapshot->value(cut_name,"ISRC").
     toString();
   if((fmt==RDCut::RawIsrc)||(!RDDiscLookup::isrcIsValid(str))) {
     return str;
@@ -228,13 +245,13 @@ void RDCut::setIsrc(const QString &isrc) const
 
 QString RDCut::isci() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"ISCI").toString();
+  return cut_snapshot->value(cut_name,"ISCI").toString();
 }
 
 
 QString RDCut::recordingMbId() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"RECORDING_MBID").toString();
+  return cut_snapshot->value(cut_name,"RECORDING_MBID").toString();
 }
 
 
@@ -246,7 +263,7 @@ void RDCut::setRecordingMbId(const QString &mbid)
 
 QString RDCut::releaseMbId() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"RELEASE_MBID").toString();
+  return cut_snapshot->value(cut_name,"RELEASE_MBID").toString();
 }
 
 
@@ -264,7 +281,7 @@ void RDCut::setIsci(const QString &isci) const
 
 QString RDCut::sha1Hash() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SHA1_HASH").
+  return cut_snapshot->value(cut_name,"SHA1_HASH").
     toString();
 }
 
@@ -277,7 +294,7 @@ void RDCut::setSha1Hash(const QString &str)
 
 unsigned RDCut::length() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"LENGTH").
+  return cut_snapshot->value(cut_name,"LENGTH").
     toUInt();
 }
 
@@ -291,7 +308,7 @@ void RDCut::setLength(int length) const
 QDateTime RDCut::originDatetime(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"ORIGIN_DATETIME",valid).
+    cut_snapshot->value(cut_name,"ORIGIN_DATETIME",valid).
     toDateTime();
 }
 
@@ -305,7 +322,7 @@ void RDCut::setOriginDatetime(const QDateTime &datetime) const
 QDateTime RDCut::startDatetime(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"START_DATETIME",valid).
+    cut_snapshot->value(cut_name,"START_DATETIME",valid).
     toDateTime();
 }
 
@@ -324,7 +341,7 @@ void RDCut::setStartDatetime(const QDateTime &datetime,bool valid) const
 QDateTime RDCut::endDatetime(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"END_DATETIME",valid).
+    cut_snapshot->value(cut_name,"END_DATETIME",valid).
     toDateTime();
 }
 
@@ -343,7 +360,7 @@ void RDCut::setEndDatetime(const QDateTime &datetime,bool valid) const
 QTime RDCut::startDaypart(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"START_DAYPART",valid).
+    cut_snapshot->value(cut_name,"START_DAYPART",valid).
     toTime();
 }
 
@@ -361,7 +378,7 @@ void RDCut::setStartDaypart(const QTime &time,bool valid) const
 
 bool RDCut::weekPart(int dayofweek) const
 {
-  return RDBool(RDGetSqlValue("CUTS","CUT_NAME",cut_name,
+  return RDBool(cut_snapshot->value(cut_name,
 			    RDGetShortDayNameEN(dayofweek).toUpper()).
 	       toString());
 }
@@ -376,7 +393,7 @@ void RDCut::setWeekPart(int dayofweek,bool state) const
 QTime RDCut::endDaypart(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"END_DAYPART",valid).
+    cut_snapshot->value(cut_name,"END_DAYPART",valid).
     toTime();
 }
 
@@ -394,7 +411,7 @@ void RDCut::setEndDaypart(const QTime &time,bool valid) const
 
 QString RDCut::originName() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"ORIGIN_NAME").
+  return cut_snapshot->value(cut_name,"ORIGIN_NAME").
     toString();
 }
 
@@ -407,7 +424,7 @@ void RDCut::setOriginName(const QString &name) const
 
 QString RDCut::originLoginName() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"ORIGIN_LOGIN_NAME").
+  return cut_snapshot->value(cut_name,"ORIGIN_LOGIN_NAME").
     toString();
 }
 
@@ -420,7 +437,7 @@ void RDCut::setOriginLoginName(const QString &name) const
 
 QString RDCut::sourceHostname() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SOURCE_HOSTNAME").
+  return cut_snapshot->value(cut_name,"SOURCE_HOSTNAME").
     toString();
 }
 
@@ -433,7 +450,7 @@ void RDCut::setSourceHostname(const QString &name) const
 
 unsigned RDCut::weight() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"WEIGHT").
+  return cut_snapshot->value(cut_name,"WEIGHT").
     toUInt();
 }
 
@@ -446,7 +463,7 @@ void RDCut::setWeight(int value) const
 
 int RDCut::playOrder() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"PLAY_ORDER").
+  return cut_snapshot->value(cut_name,"PLAY_ORDER").
     toInt();
 }
 
@@ -460,7 +477,7 @@ void RDCut::setPlayOrder(int order) const
 QDateTime RDCut::lastPlayDatetime(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"LAST_PLAY_DATETIME",valid).
+    cut_snapshot->value(cut_name,"LAST_PLAY_DATETIME",valid).
     toDateTime();
 }
 
@@ -479,7 +496,7 @@ void RDCut::setLastPlayDatetime(const QDateTime &datetime,bool valid) const
 QDateTime RDCut::uploadDatetime(bool *valid) const
 {
   return 
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"UPLOAD_DATETIME",valid).
+    cut_snapshot->value(cut_name,"UPLOAD_DATETIME",valid).
     toDateTime();
 }
 
@@ -497,7 +514,7 @@ void RDCut::setUploadDatetime(const QDateTime &datetime,bool valid) const
 
 unsigned RDCut::playCounter() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"PLAY_COUNTER").
+  return cut_snapshot->value(cut_name,"PLAY_COUNTER").
     toUInt();
 }
 
@@ -511,7 +528,7 @@ void RDCut::setPlayCounter(unsigned count) const
 RDCut::Validity RDCut::validity() const
 {
   return (RDCut::Validity)
-    RDGetSqlValue("CUTS","CUT_NAME",cut_name,"VALIDITY").toUInt();
+    cut_snapshot->value(cut_name,"VALIDITY").toUInt();
 }
 
 
@@ -523,7 +540,7 @@ void RDCut::setValidity(RDCut::Validity state)
 
 unsigned RDCut::localCounter() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"LOCAL_COUNTER").
+  return cut_snapshot->value(cut_name,"LOCAL_COUNTER").
     toUInt();
 }
 
@@ -536,7 +553,7 @@ void RDCut::setLocalCounter(unsigned count) const
 
 unsigned RDCut::codingFormat() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"CODING_FORMAT").
+  return cut_snapshot->value(cut_name,"CODING_FORMAT").
     toUInt();
 }
 
@@ -549,7 +566,7 @@ void RDCut::setCodingFormat(unsigned format) const
 
 unsigned RDCut::sampleRate() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SAMPLE_RATE").
+  return cut_snapshot->value(cut_name,"SAMPLE_RATE").
     toUInt();
 }
 
@@ -562,7 +579,7 @@ void RDCut::setSampleRate(unsigned rate) const
 
 unsigned RDCut::bitRate() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"BIT_RATE").
+  return cut_snapshot->value(cut_name,"BIT_RATE").
     toUInt();
 }
 
@@ -575,7 +592,7 @@ void RDCut::setBitRate(unsigned rate) const
 
 unsigned RDCut::channels() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"CHANNELS").
+  return cut_snapshot->value(cut_name,"CHANNELS").
     toUInt();
 }
 
@@ -588,7 +605,7 @@ void RDCut::setChannels(unsigned chan) const
 
 int RDCut::playGain() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"PLAY_GAIN").
+  return cut_snapshot->value(cut_name,"PLAY_GAIN").
     toInt();
 }
 
@@ -604,10 +621,10 @@ int RDCut::startPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"START_POINT").
+    return cut_snapshot->value(cut_name,"START_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"START_POINT").
+  if((n=cut_snapshot->value(cut_name,"START_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -626,10 +643,10 @@ int RDCut::endPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"END_POINT").
+    return cut_snapshot->value(cut_name,"END_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"END_POINT").
+  if((n=cut_snapshot->value(cut_name,"END_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -648,10 +665,10 @@ int RDCut::fadeupPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"FADEUP_POINT").
+    return cut_snapshot->value(cut_name,"FADEUP_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"FADEUP_POINT").
+  if((n=cut_snapshot->value(cut_name,"FADEUP_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -670,10 +687,10 @@ int RDCut::fadedownPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"FADEDOWN_POINT").
+    return cut_snapshot->value(cut_name,"FADEDOWN_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"FADEDOWN_POINT").
+  if((n=cut_snapshot->value(cut_name,"FADEDOWN_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -692,10 +709,10 @@ int RDCut::segueStartPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SEGUE_START_POINT").
+    return cut_snapshot->value(cut_name,"SEGUE_START_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SEGUE_START_POINT").
+  if((n=cut_snapshot->value(cut_name,"SEGUE_START_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -714,10 +731,10 @@ int RDCut::segueEndPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SEGUE_END_POINT").
+    return cut_snapshot->value(cut_name,"SEGUE_END_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SEGUE_END_POINT").
+  if((n=cut_snapshot->value(cut_name,"SEGUE_END_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -733,7 +750,7 @@ void RDCut::setSegueEndPoint(int point) const
 
 int RDCut::segueGain() const
 {
-  return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"SEGUE_GAIN").toInt();
+  return cut_snapshot->value(cut_name,"SEGUE_GAIN").toInt();
 }
 
 
@@ -748,10 +765,10 @@ int RDCut::hookStartPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"HOOK_START_POINT").
+    return cut_snapshot->value(cut_name,"HOOK_START_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"HOOK_START_POINT").
+  if((n=cut_snapshot->value(cut_name,"HOOK_START_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -770,10 +787,10 @@ int RDCut::hookEndPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"HOOK_END_POINT").
+    return cut_snapshot->value(cut_name,"HOOK_END_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"HOOK_END_POINT").
+  if((n=cut_snapshot->value(cut_name,"HOOK_END_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -792,10 +809,10 @@ int RDCut::talkStartPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"TALK_START_POINT").
+    return cut_snapshot->value(cut_name,"TALK_START_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"TALK_START_POINT").
+  if((n=cut_snapshot->value(cut_name,"TALK_START_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -814,10 +831,10 @@ int RDCut::talkEndPoint(bool calc) const
   int n;
 
   if(!calc) {
-    return RDGetSqlValue("CUTS","CUT_NAME",cut_name,"TALK_END_POINT").
+    return cut_snapshot->value(cut_name,"TALK_END_POINT").
       toInt();
   }
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"TALK_END_POINT").
+  if((n=cut_snapshot->value(cut_name,"TALK_END_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -835,7 +852,7 @@ int RDCut::effectiveStart() const
 {
   int n;
 
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"START_POINT").
+  if((n=cut_snapshot->value(cut_name,"START_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -847,7 +864,7 @@ int RDCut::effectiveEnd() const
 {
   int n;
 
-  if((n=RDGetSqlValue("CUTS","CUT_NAME",cut_name,"END_POINT").
+  if((n=cut_snapshot->value(cut_name,"END_POINT").
       toInt())!=-1) {
     return n;
   }
@@ -878,6 +895,7 @@ bool RDCut::copyTo(RDStation *station,RDUser *user,
   //
   // Copy the Database Record
   //
+  RDSqlTransaction trans(QStringList()<<"CUTS"<<"CUT_EVENTS");
   sql=QString("select ")+
     "`DESCRIPTION`,"+        // 00
     "`OUTCUE`,"+             // 01
@@ -987,17 +1005,27 @@ bool RDCut::copyTo(RDStation *station,RDUser *user,
   //
   // Copy the Cut Events
   //
+  QString placeholders;
+  QVariantList values;
   sql=QString("select `NUMBER`,`POINT` from `CUT_EVENTS` ")+
     "where `CUT_NAME`='"+cutName()+"'";
   q=new RDSqlQuery(sql);
   while(q->next()) {
-    sql=QString("insert into `CUT_EVENTS` set ")+
-      "`CUT_NAME`='"+cutname+"',"+
-      QString::asprintf("`NUMBER`=%d,",q->value(0).toInt())+
-      QString::asprintf("`POINT`=%d",q->value(1).toInt());
-    RDSqlQuery::apply(sql);
+    if(!placeholders.isEmpty()) {
+      placeholders+=",";
+    }
+    placeholders+="(?,?,?)";
+    values.push_back(cutname);
+    values.push_back(q->value(0).toInt());
+    values.push_back(q->value(1).toInt());
   }
   delete q;
+  if(!placeholders.isEmpty()) {
+    sql=QString("insert into `CUT_EVENTS` (`CUT_NAME`,`NUMBER`,`POINT`) ")+
+      "values "+placeholders;
+    RDSqlQuery::apply(sql,values);
+  }
+  trans.commit();
 
   //
   // Copy the Audio
@@ -1512,144 +1540,280 @@ void RDCut::reset() const
 }
 
 
-QString RDCut::xml(RDSqlQuery *q,bool absolute,RDSettings *settings)
+QString RDCut::xml(RDSqlQuery *q,bool absolute,RDSettings *settings,
+		   const QStringList &fields)
 {
   //
   // The 'RDSqlQuery *q' query should be generated using the field
-  // definitions provided by 'RDCart::xmlSql()'.
+  // definitions provided by 'RDCart::xmlSql()'.  If 'fields' is not
+  // empty, only the fields it names are included.
   //
   QString xml="";
 
   xml+="<cut>\n";
-  xml+="  "+RDXmlField("cutName",q->value(31).toString());
-  xml+="  "+RDXmlField("cartNumber",RDCut::cartNumber(q->value(31).toString()));
-  xml+="  "+RDXmlField("cutNumber",RDCut::cutNumber(q->value(31).toString()));
-
-  xml+="  "+RDXmlField("evergreen",RDBool(q->value(32).toString()));
-  xml+="  "+RDXmlField("description",q->value(33).toString());
-  xml+="  "+RDXmlField("outcue",q->value(34).toString());
-  xml+="  "+RDXmlField("isrc",q->value(35).toString());
-  xml+="  "+RDXmlField("isci",q->value(36).toString());
-  xml+="  "+RDXmlField("recordingMbId",q->value(74).toString());
-  xml+="  "+RDXmlField("releaseMbId",q->value(75).toString());
-  xml+="  "+RDXmlField("length",q->value(37).toUInt());
-  if(q->value(38).isNull()) {
-    xml+="  "+RDXmlField("originDatetime","");
+  if(RDXmlSelected(fields,"cutName")) {
+    xml+="  "+RDXmlField("cutName",q->value(31).toString());
   }
-  else {
-    xml+="  "+RDXmlField("originDatetime",q->value(38).toDateTime());
+  if(RDXmlSelected(fields,"cartNumber")) {
+    xml+="  "+
+      RDXmlField("cartNumber",RDCut::cartNumber(q->value(31).toString()));
   }
-  if(q->value(39).isNull()) {
-    xml+="  "+RDXmlField("startDatetime","");
+  if(RDXmlSelected(fields,"cutNumber")) {
+    xml+="  "+
+      RDXmlField("cutNumber",RDCut::cutNumber(q->value(31).toString()));
   }
-  else {
-    xml+="  "+RDXmlField("startDatetime",q->value(39).toDateTime());
+
+  if(RDXmlSelected(fields,"evergreen")) {
+    xml+="  "+RDXmlField("evergreen",RDBool(q->value(32).toString()));
   }
-  if(q->value(40).isNull()) {
-    xml+="  "+RDXmlField("endDatetime","");
+  if(RDXmlSelected(fields,"description")) {
+    xml+="  "+RDXmlField("description",q->value(33).toString());
   }
-  else {
-    xml+="  "+RDXmlField("endDatetime",q->value(40).toDateTime());
-  }
-  xml+="  "+RDXmlField("sun",RDBool(q->value(41).toString()));
-  xml+="  "+RDXmlField("mon",RDBool(q->value(42).toString()));
-  xml+="  "+RDXmlField("tue",RDBool(q->value(43).toString()));
-  xml+="  "+RDXmlField("wed",RDBool(q->value(44).toString()));
-  xml+="  "+RDXmlField("thu",RDBool(q->value(45).toString()));
-  xml+="  "+RDXmlField("fri",RDBool(q->value(46).toString()));
-  xml+="  "+RDXmlField("sat",RDBool(q->value(47).toString()));
-  if(q->value(48).isNull()) {
-    xml+="  "+RDXmlField("startDaypart","");
+  if(RDXmlSelected(fields,"outcue")) {
+    xml+="  "+RDXmlField("outcue",q->value(34).toString());
   }
-  else {
-    xml+="  "+RDXmlField("startDaypart",q->value(48).toTime());
+  if(RDXmlSelected(fields,"isrc")) {
+    xml+="  "+RDXmlField("isrc",q->value(35).toString());
   }
-  if(q->value(49).isNull()) {
-    xml+="  "+RDXmlField("endDaypart","");
+  if(RDXmlSelected(fields,"isci")) {
+    xml+="  "+RDXmlField("isci",q->value(36).toString());
+  }
+  if(RDXmlSelected(fields,"recordingMbId")) {
+    xml+="  "+RDXmlField("recordingMbId",q->value(74).toString());
+  }
+  if(RDXmlSelected(fields,"releaseMbId")) {
+    xml+="  "+RDXmlField("releaseMbId",q->value(75).toString());
+  }
+  if(RDXmlSelected(fields,"length")) {
+    xml+="  "+RDXmlField("length",q->value(37).toUInt());
+  }
+  if(RDXmlSelected(fields,"originDatetime")) {
+    if(q->value(38).isNull()) {
+      xml+="  "+RDXmlField("originDatetime","");
+    }
+    else {
+      xml+="  "+RDXmlField("originDatetime",q->value(38).toDateTime());
+    }
+  }
+  if(RDXmlSelected(fields,"startDatetime")) {
+    if(q->value(39).isNull()) {
+      xml+="  "+RDXmlField("startDatetime","");
+    }
+    else {
+      xml+="  "+RDXmlField("startDatetime",q->value(39).toDateTime());
+    }
+  }
+  if(RDXmlSelected(fields,"endDatetime")) {
+    if(q->value(40).isNull()) {
+      xml+="  "+RDXmlField("endDatetime","");
+    }
+    else {
+      xml+="  "+RDXmlField("endDatetime",q->value(40).toDateTime());
+    }
+  }
+  if(RDXmlSelected(fields,"sun")) {
+    xml+="  "+RDXmlField("sun",RDBool(q->value(41).toString()));
+  }
+  if(RDXmlSelected(fields,"mon")) {
+    xml+="  "+RDXmlField("mon",RDBool(q->value(42).toString()));
+  }
+  if(RDXmlSelected(fields,"tue")) {
+    xml+="  "+RDXmlField("tue",RDBool(q->value(43).toString()));
+  }
+  if(RDXmlSelected(fields,"wed")) {
+    xml+="  "+RDXmlField("wed",RDBool(q->value(44).toString()));
+  }
+  if(RDXmlSelected(fields,"thu")) {
+    xml+="  "+RDXmlField("thu",RDBool(q->value(45).toString()));
+  }
+  if(RDXmlSelected(fields,"fri")) {
+    xml+="  "+RDXmlField("fri",RDBool(q->value(46).toString()));
+  }
+  if(RDXmlSelected(fields,"sat")) {
+    xml+="  "+RDXmlField("sat",RDBool(q->value(47).toString()));
+  }
+  if(RDXmlSelected(fields,"startDaypart")) {
+    if(q->value(48).isNull()) {
+      xml+="  "+RDXmlField("startDaypart","");
+    }
+    else {
+      xml+="  "+RDXmlField("startDaypart",q->value(48).toTime());
+    }
+  }
+  if(RDXmlSelected(fields,"endDaypart")) {
+    if(q->value(49).isNull()) {
+      xml+="  "+RDXmlField("endDaypart","");
+    }
+    else {
+      xml+="  "+RDXmlField("endDaypart",q->value(49).toTime());
+    }
+  }
+  if(RDXmlSelected(fields,"originName")) {
+    xml+="  "+RDXmlField("originName",q->value(50).toString());
+  }
+  if(RDXmlSelected(fields,"originLoginName")) {
+    xml+="  "+RDXmlField("originLoginName",q->value(51).toString());
+  }
+  if(RDXmlSelected(fields,"sourceHostname")) {
+    xml+="  "+RDXmlField("sourceHostname",q->value(52).toString());
+  }
+  if(RDXmlSelected(fields,"weight")) {
+    xml+="  "+RDXmlField("weight",q->value(53).toUInt());
+  }
+  if(RDXmlSelected(fields,"lastPlayDatetime")) {
+    xml+="  "+RDXmlField("lastPlayDatetime",q->value(54).toDateTime());
+  }
+  if(RDXmlSelected(fields,"playCounter")) {
+    xml+="  "+RDXmlField("playCounter",q->value(55).toUInt());
   }
-  else {
-    xml+="  "+RDXmlField("endDaypart",q->value(49).toTime());
-  }
-  xml+="  "+RDXmlField("originName",q->value(50).toString());
-  xml+="  "+RDXmlField("originLoginName",q->value(51).toString());
-  xml+="  "+RDXmlField("sourceHostname",q->value(52).toString());
-  xml+="  "+RDXmlField("weight",q->value(53).toUInt());
-  xml+="  "+RDXmlField("lastPlayDatetime",q->value(54).toDateTime());
-  xml+="  "+RDXmlField("playCounter",q->value(55).toUInt());
   if(settings==NULL) {
-    xml+="  "+RDXmlField("codingFormat",q->value(58).toUInt());
-    xml+="  "+RDXmlField("sampleRate",q->value(59).toUInt());
-    xml+="  "+RDXmlField("bitRate",q->value(60).toUInt());
-    xml+="  "+RDXmlField("channels",q->value(61).toUInt());
+    if(RDXmlSelected(fields,"codingFormat")) {
+      xml+="  "+RDXmlField("codingFormat",q->value(58).toUInt());
+    }
+    if(RDXmlSelected(fields,"sampleRate")) {
+      xml+="  "+RDXmlField("sampleRate",q->value(59).toUInt());
+    }
+    if(RDXmlSelected(fields,"bitRate")) {
+      xml+="  "+RDXmlField("bitRate",q->value(60).toUInt());
+    }
+    if(RDXmlSelected(fields,"channels")) {
+      xml+="  "+RDXmlField("channels",q->value(61).toUInt());
+    }
   }
   else {
-    xml+="  "+RDXmlField("codingFormat",(int)settings->format());
-    xml+="  "+RDXmlField("sampleRate",settings->sampleRate());
-    xml+="  "+RDXmlField("bitRate",settings->bitRate());
-    xml+="  "+RDXmlField("channels",settings->channels());
+    if(RDXmlSelected(fields,"codingFormat")) {
+      xml+="  "+RDXmlField("codingFormat",(int)settings->format());
+    }
+    if(RDXmlSelected(fields,"sampleRate")) {
+      xml+="  "+RDXmlField("sampleRate",settings->sampleRate());
+    }
+    if(RDXmlSelected(fields,"bitRate")) {
+      xml+="  "+RDXmlField("bitRate",settings->bitRate());
+    }
+    if(RDXmlSelected(fields,"channels")) {
+      xml+="  "+RDXmlField("channels",settings->channels());
+    }
+  }
+  if(RDXmlSelected(fields,"playGain")) {
+    xml+="  "+RDXmlField("playGain",q->value(62).toUInt());
   }
-  xml+="  "+RDXmlField("playGain",q->value(62).toUInt());
   if(absolute) {
-    xml+="  "+RDXmlField("startPoint",q->value(63).toInt());
-    xml+="  "+RDXmlField("endPoint",q->value(64).toInt());
-    xml+="  "+RDXmlField("fadeupPoint",q->value(65).toInt());
-    xml+="  "+RDXmlField("fadedownPoint",q->value(66).toInt());
-    xml+="  "+RDXmlField("segueStartPoint",q->value(67).toInt());
-    xml+="  "+RDXmlField("segueEndPoint",q->value(68).toInt());
-    xml+="  "+RDXmlField("segueGain",q->value(69).toInt());
-    xml+="  "+RDXmlField("hookStartPoint",q->value(70).toInt());
-    xml+="  "+RDXmlField("hookEndPoint",q->value(71).toInt());
-    xml+="  "+RDXmlField("talkStartPoint",q->value(72).toInt());
-    xml+="  "+RDXmlField("talkEndPoint",q->value(73).toInt());
+    if(RDXmlSelected(fields,"startPoint")) {
+      xml+="  "+RDXmlField("startPoint",q->value(63).toInt());
+    }
+    if(RDXmlSelected(fields,"endPoint")) {
+      xml+="  "+RDXmlField("endPoint",q->value(64).toInt());
+    }
+    if(RDXmlSelected(fields,"fadeupPoint")) {
+      xml+="  "+RDXmlField("fadeupPoint",q->value(65).toInt());
+    }
+    if(RDXmlSelected(fields,"fadedownPoint")) {
+      xml+="  "+RDXmlField("fadedownPoint",q->value(66).toInt());
+    }
+    if(RDXmlSelected(fields,"segueStartPoint")) {
+      xml+="  "+RDXmlField("segueStartPoint",q->value(67).toInt());
+    }
+    if(RDXmlSelected(fields,"segueEndPoint")) {
+      xml+="  "+RDXmlField("segueEndPoint",q->value(68).toInt());
+    }
+    if(RDXmlSelected(fields,"segueGain")) {
+      xml+="  "+RDXmlField("segueGain",q->value(69).toInt());
+    }
+    if(RDXmlSelected(fields,"hookStartPoint")) {
+      xml+="  "+RDXmlField("hookStartPoint",q->value(70).toInt());
+    }
+    if(RDXmlSelected(fields,"hookEndPoint")) {
+      xml+="  "+RDXmlField("hookEndPoint",q->value(71).toInt());
+    }
+    if(RDXmlSelected(fields,"talkStartPoint")) {
+      xml+="  "+RDXmlField("talkStartPoint",q->value(72).toInt());
+    }
+    if(RDXmlSelected(fields,"talkEndPoint")) {
+      xml+="  "+RDXmlField("talkEndPoint",q->value(73).toInt());
+    }
   }
   else {
-    xml+="  "+RDXmlField("startPoint",0);
-    xml+="  "+
-      RDXmlField("endPoint",q->value(64).toInt()-q->value(61).toInt());
-    if(q->value(65).toInt()<0) {
-      xml+="  "+RDXmlField("fadeupPoint",-1);
+    if(RDXmlSelected(fields,"startPoint")) {
+      xml+="  "+RDXmlField("startPoint",0);
     }
-    else {
+    if(RDXmlSelected(fields,"endPoint")) {
       xml+="  "+
-	RDXmlField("fadeupPoint",q->value(65).toInt()-q->value(61).toInt());
+	RDXmlField("endPoint",q->value(64).toInt()-q->value(61).toInt());
     }
-    if(q->value(66).toInt()<0) {
-      xml+="  "+RDXmlField("fadedownPoint",-1);
+    if(RDXmlSelected(fields,"fadeupPoint")) {
+      if(q->value(65).toInt()<0) {
+	xml+="  "+RDXmlField("fadeupPoint",-1);
+      }
+      else {
+	xml+="  "+
+	  RDXmlField("fadeupPoint",q->value(65).toInt()-q->value(61).toInt());
+      }
     }
-    else {
-      xml+="  "+
-	RDXmlField("fadedownPoint",q->value(66).toInt()-q->value(61).toInt());
+    if(RDXmlSelected(fields,"fadedownPoint")) {
+      if(q->value(66).toInt()<0) {
+	xml+="  "+RDXmlField("fadedownPoint",-1);
+      }
+      else {
+	xml+="  "+RDXmlField("fadedownPoint",
+			     q->value(66).toInt()-q->value(61).toInt());
+      }
     }
     if(q->value(67).toInt()<0) {
-      xml+="  "+RDXmlField("segueStartPoint",-1);
-      xml+="  "+RDXmlField("segueEndPoint",-1);
+      if(RDXmlSelected(fields,"segueStartPoint")) {
+	xml+="  "+RDXmlField("segueStartPoint",-1);
+      }
+      if(RDXmlSelected(fields,"segueEndPoint")) {
+	xml+="  "+RDXmlField("segueEndPoint",-1);
+      }
     }
     else {
-      xml+="  "+RDXmlField("segueStartPoint",
-			   q->value(67).toInt()-q->value(61).toInt());
-      xml+="  "+RDXmlField("segueEndPoint",
-			   q->value(68).toInt()-q->value(61).toInt());
+      if(RDXmlSelected(fields,"segueStartPoint")) {
+	xml+="  "+RDXmlField("segueStartPoint",
+			     q->value(67).toInt()-q->value(61).toInt());
+      }
+      if(RDXmlSelected(fields,"segueEndPoint")) {
+	xml+="  "+RDXmlField("segueEndPoint",
+			     q->value(68).toInt()-q->value(61).toInt());
+      }
+    }
+    if(RDXmlSelected(fields,"segueGain")) {
+      xml+="  "+RDXmlField("segueGain",q->value(69).toInt());
     }
-    xml+="  "+RDXmlField("segueGain",q->value(69).toInt());
     if(q->value(70).toInt()<0) {
-      xml+="  "+RDXmlField("hookStartPoint",-1);
-      xml+="  "+RDXmlField("hookEndPoint",-1);
+      if(RDXmlSelected(fields,"hookStartPoint")) {
+	xml+="  "+RDXmlField("hookStartPoint",-1);
+      }
+      if(RDXmlSelected(fields,"hookEndPoint")) {
+	xml+="  "+RDXmlField("hookEndPoint",-1);
+      }
     }
     else {
-      xml+="  "+RDXmlField("hookStartPoint",
-			   q->value(70).toInt()-q->value(63).toInt());
-      xml+="  "+RDXmlField("hookEndPoint",
-			   q->value(71).toInt()-q->value(63).toInt());
+      if(RDXmlSelected(fields,"hookStartPoint")) {
+	xml+="  "+RDXmlField("hookStartPoint",
+			     q->value(70).toInt()-q->value(63).toInt());
+      }
+      if(RDXmlSelected(fields,"hookEndPoint")) {
+	xml+="  "+RDXmlField("hookEndPoint",
+			     q->value(71).toInt()-q->value(63).toInt());
+      }
     }
     if(q->value(41).toInt()<0) {
-      xml+="  "+RDXmlField("talkStartPoint",-1);
-      xml+="  "+RDXmlField("talkEndPoint",-1);
+      if(RDXmlSelected(fields,"talkStartPoint")) {
+	xml+="  "+RDXmlField("talkStartPoint",-1);
+      }
+      if(RDXmlSelected(fields,"talkEndPoint")) {
+	xml+="  "+RDXmlField("talkEndPoint",-1);
+      }
     }
     else {
-      xml+="  "+RDXmlField("talkStartPoint",
-			   q->value(72).toInt()-q->value(63).toInt());
-      xml+="  "+RDXmlField("talkEndPoint",
-			   q->value(73).toInt()-q->value(63).toInt());
+      if(RDXmlSelected(fields,"talkStartPoint")) {
+	xml+="  "+RDXmlField("talkStartPoint",
+			     q->value(72).toInt()-q->value(63).toInt());
+      }
+      if(RDXmlSelected(fields,"talkEndPoint")) {
+	xml+="  "+RDXmlField("talkEndPoint",
+			     q->value(73).toInt()-q->value(63).toInt());
+      }
     }
   }
   
@@ -1801,6 +1965,7 @@ bool RDCut::FileCopy(const QString &srcfile,const QString &destfile) const
     close(src_fd);
     return false;
   }
+  RDAudioDedup::unshare(destfile);
   if((dest_fd=open((const char *)destfile.toUtf8(),O_RDWR|O_CREAT,src_stat.st_mode))
      <0) {
     close(src_fd);
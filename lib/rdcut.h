@@ -19,9 +19,11 @@
 //
 
 #include <QObject>
+#include <QStringList>
 
 #include <rdconfig.h>
 #include <rddb.h>
+#include <rdrowsnapshot.h>
 #include <rdwavedata.h>
 #include <rdsettings.h>
 #include <rdstation.h>
@@ -40,6 +42,8 @@ class RDCut
   RDCut(unsigned cartnum,int cutnum,bool create=false);
   ~RDCut();
   bool exists() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   bool isValid() const;
   bool isValid(const QTime &time) const;
   bool isValid(const QDateTime &datetime) const;
@@ -143,7 +147,8 @@ class RDCut
   void autoSegue(int level,int length,RDStation *station,RDUser *user,
 		 RDConfig *config);
   void reset() const;
-  static QString xml(RDSqlQuery *q,bool absolute,RDSettings *settings=NULL);
+  static QString xml(RDSqlQuery *q,bool absolute,RDSettings *settings=NULL,
+		     const QStringList &fields=QStringList());
   static QString cutName(unsigned cartnum,unsigned cutnum);
   static unsigned cartNumber(const QString &cutname);
   static unsigned cutNumber(const QString &cutname);
@@ -170,6 +175,7 @@ class RDCut
   QString cut_name;
   unsigned cart_number;
   unsigned cut_number;
+  RDRowSnapshot *cut_snapshot;
 };
 
 
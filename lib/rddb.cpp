@@ -22,13 +22,21 @@
 #include <netdb.h>
 #include <stdio.h>
 #include <syslog.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QSqlRecord>
 #include <QString>
 #include <QTextCodec>
+#include <QThread>
+#include <QThreadStorage>
 #include <QTranslator>
 #include <QSqlError>
 #include <QStringList>
@@ -37,20 +45,359 @@
 #include "rdapplication.h"
 #include "rddb.h"
 #include "rddbheartbeat.h"
+#include "rdsqlprofiler.h"
+#include "rdsqltransaction.h"
 
-RDSqlQuery::RDSqlQuery (const QString &query,bool reconnect):
-  QSqlQuery(query)
+//
+// Process-wide counts of statements sent to the server
+//
+static QAtomicInteger<quint64> __rd_sql_round_trips;
+static QAtomicInteger<quint64> __rd_sql_writes;
+
+//
+// A database connection, with the prepared statements made on it (keyed
+// by SQL text).  A statement is 'busy' while an RDSqlQuery is using it,
+// since the result set lives in the statement.
+//
+struct RDDbConnection
+{
+  RDDbConnection(const QString &conn_name,bool conn_pooled);
+  ~RDDbConnection();
+  QString name;
+  bool pooled;
+  time_t last_used;
+  QHash<QString,QSqlQuery> statements;
+  QStringList statement_order;
+  QSet<QString> busy_statements;
+};
+
+
+//
+// The default connection belongs to the thread that opened the database.
+// It is never freed, as the database driver may already be gone by the
+// time static destructors run.
+//
+static RDConfig *__rd_db_config=NULL;
+static QThread *__rd_db_owner=NULL;
+static RDDbConnection *__rd_db_default=NULL;
+static QThreadStorage<RDDbConnection *> __rd_db_threads;
+static QAtomicInt __rd_db_pool_size;
+static QAtomicInt __rd_db_pool_serial;
+
+//
+// Read replica connections, and when each thread last wrote anything
+//
+static RDDbConnection *__rd_db_replica_default=NULL;
+static QThreadStorage<RDDbConnection *> __rd_db_replica_threads;
+static QThreadStorage<time_t> __rd_db_last_write;
+
+RDDbConnection::RDDbConnection(const QString &conn_name,bool conn_pooled)
+{
+  name=conn_name;
+  pooled=conn_pooled;
+  last_used=time(NULL);
+  if(pooled) {
+    __rd_db_pool_size.fetchAndAddRelaxed(1);
+  }
+}
+
+
+RDDbConnection::~RDDbConnection()
+{
+  if(pooled) {
+    statements.clear();
+    QSqlDatabase::database(name,false).close();
+    QSqlDatabase::removeDatabase(name);
+    __rd_db_pool_size.fetchAndAddRelaxed(-1);
+  }
+}
+
+
+static RDDbConnection *__RDDbPool_Connection(bool heartbeat)
+{
+  RDDbConnection *conn=NULL;
+  QSqlDatabase db;
+  time_t now=time(NULL);
+
+  if((__rd_db_config==NULL)||(QThread::currentThread()==__rd_db_owner)) {
+    if(__rd_db_default==NULL) {
+      __rd_db_default=
+	new RDDbConnection(QSqlDatabase::defaultConnection,false);
+    }
+    return __rd_db_default;
+  }
+
+  if(!__rd_db_threads.hasLocalData()) {
+    conn=new RDDbConnection(QString(RD_DB_POOL_CONNECTION_PREFIX)+
+	    QString::asprintf("%d",__rd_db_pool_serial.fetchAndAddRelaxed(1)),
+			    true);
+    db=QSqlDatabase::addDatabase(__rd_db_config->mysqlDriver(),conn->name);
+    db.setHostName(__rd_db_config->mysqlHostname());
+    db.setDatabaseName(__rd_db_config->mysqlDbname());
+    db.setUserName(__rd_db_config->mysqlUsername());
+    db.setPassword(__rd_db_config->mysqlPassword());
+    if(db.open()) {
+      QSqlQuery *q=
+	new QSqlQuery("set NAMES utf8mb4 collate utf8mb4_general_ci",db);
+      delete q;
+    }
+    __rd_db_threads.setLocalData(conn);
+    return conn;
+  }
+  conn=__rd_db_threads.localData();
+
+  //
+  // Worker threads seldom run an event loop for an RDDbHeartbeat, so
+  // check a connection that has sat idle before handing it out again
+  //
+  if(heartbeat&&(__rd_db_config->mysqlHeartbeatInterval()>0)&&
+     ((now-conn->last_used)>=__rd_db_config->mysqlHeartbeatInterval())) {
+    if(!RDDbHeartbeat::ping(conn->name)) {
+      conn->statements.clear();
+      conn->statement_order.clear();
+    }
+  }
+  conn->last_used=now;
+
+  return conn;
+}
+
+
+static RDDbConnection *__RDDbPool_ReplicaConnection(bool heartbeat)
+{
+  RDDbConnection *conn=NULL;
+  QSqlDatabase db;
+  time_t now=time(NULL);
+  bool owner=QThread::currentThread()==__rd_db_owner;
+  int serial=0;
+  int n=0;
+
+  if(owner) {
+    conn=__rd_db_replica_default;
+  }
+  else {
+    if(__rd_db_replica_threads.hasLocalData()) {
+      conn=__rd_db_replica_threads.localData();
+    }
+  }
+
+  if(conn==NULL) {
+    //
+    // Spread the threads (and processes) across the replicas
+    //
+    serial=__rd_db_pool_serial.fetchAndAddRelaxed(1);
+    n=(getpid()+serial)%__rd_db_config->mysqlReplicas();
+    conn=new RDDbConnection(QString(RD_DB_REPLICA_CONNECTION_PREFIX)+
+			    QString::asprintf("%d",serial),true);
+    db=QSqlDatabase::addDatabase(__rd_db_config->mysqlDriver(),conn->name);
+    db.setHostName(__rd_db_config->mysqlReplicaHostname(n));
+    if(__rd_db_config->mysqlReplicaPort(n)>0) {
+      db.setPort(__rd_db_config->mysqlReplicaPort(n));
+    }
+    db.setDatabaseName(__rd_db_config->mysqlDbname());
+    db.setUserName(__rd_db_config->mysqlUsername());
+    db.setPassword(__rd_db_config->mysqlPassword());
+    if(db.open()) {
+      QSqlQuery *q=
+	new QSqlQuery("set NAMES utf8mb4 collate utf8mb4_general_ci",db);
+      delete q;
+    }
+    else {
+      if(rda!=NULL) {
+	rda->syslog(LOG_WARNING,
+		    "unable to connect to database replica \"%s\" [%s]",
+		    __rd_db_config->mysqlReplicaHostname(n).toUtf8().constData(),
+		    db.lastError().text().toUtf8().constData());
+      }
+    }
+    if(owner) {
+      __rd_db_replica_default=conn;
+    }
+    else {
+      __rd_db_replica_threads.setLocalData(conn);
+    }
+    return db.isOpen()?conn:NULL;
+  }
+
+  //
+  // Reads fall back to the primary while a replica is unreachable
+  //
+  db=QSqlDatabase::database(conn->name,false);
+  if(!db.isOpen()) {
+    if((now-conn->last_used)<RD_DB_REPLICA_RETRY_INTERVAL) {
+      return NULL;
+    }
+    conn->last_used=now;
+    if(!db.open()) {
+      return NULL;
+    }
+    QSqlQuery *q=
+      new QSqlQuery("set NAMES utf8mb4 collate utf8mb4_general_ci",db);
+    delete q;
+    conn->statements.clear();
+    conn->statement_order.clear();
+  }
+  if(heartbeat&&(__rd_db_config->mysqlHeartbeatInterval()>0)&&
+     ((now-conn->last_used)>=__rd_db_config->mysqlHeartbeatInterval())) {
+    if(!RDDbHeartbeat::ping(conn->name)) {
+      conn->statements.clear();
+      conn->statement_order.clear();
+    }
+  }
+  conn->last_used=now;
+
+  return conn;
+}
+
+
+//
+// When a query fails on a replica that no longer answers, take the replica
+// out of use for RD_DB_REPLICA_RETRY_INTERVAL seconds and return the
+// primary connection to re-run the query on.  Returns NULL for the primary,
+// or for a replica that is still up (so that the query itself is at fault).
+//
+static RDDbConnection *__RDDbPool_Failover(RDDbConnection *conn)
+{
+  QSqlDatabase db;
+  QSqlQuery *q=NULL;
+  bool alive=false;
+
+  if(!conn->name.startsWith(RD_DB_REPLICA_CONNECTION_PREFIX)) {
+    return NULL;
+  }
+  db=QSqlDatabase::database(conn->name,false);
+  if(db.isOpen()) {
+    q=new QSqlQuery("select `DB` from `VERSION`",db);
+    alive=q->first();
+    delete q;
+  }
+  if(alive) {
+    return NULL;
+  }
+  conn->statements.clear();
+  conn->statement_order.clear();
+  db.close();
+  conn->last_used=time(NULL);
+  if(rda!=NULL) {
+    rda->syslog(LOG_WARNING,
+		"lost connection to database replica, reading from the primary");
+  }
+
+  return __RDDbPool_Connection(true);
+}
+
+
+static bool __RDSqlQuery_UseReplica(const QString &query,
+				    RDSqlQuery::Route route)
+{
+  QString sql;
+
+  if((route!=RDSqlQuery::Replica)||(__rd_db_config==NULL)||
+     (__rd_db_config->mysqlReplicas()==0)) {
+    return false;
+  }
+
+  //
+  // Replication lags, so anything that may need to see this thread's own
+  // writes stays on the primary
+  //
+  if(RDSqlTransaction::currentDepth()>0) {
+    return false;
+  }
+  if((time(NULL)-__rd_db_last_write.localData())<
+     __rd_db_config->mysqlReplicaStickiness()) {
+    return false;
+  }
+
+  //
+  // Nothing that writes or takes a lock belongs on a replica, whatever the
+  // caller asked for
+  //
+  sql=query.trimmed().toLower();
+  if(sql.section(" ",0,0)!="select") {
+    return false;
+  }
+  return !(sql.contains(" for update")||sql.contains(" lock in share mode")||
+	   sql.contains("get_lock(")||sql.contains("release_lock(")||
+	   sql.contains("last_insert_id(")||sql.contains("found_rows("));
+}
+
+
+static RDDbConnection *__RDSqlQuery_Route(const QString &query,
+					  RDSqlQuery::Route route)
+{
+  RDDbConnection *conn=NULL;
+
+  if(__RDSqlQuery_UseReplica(query,route)) {
+    conn=__RDDbPool_ReplicaConnection(true);
+  }
+  if(conn==NULL) {
+    conn=__RDDbPool_Connection(true);
+  }
+
+  return conn;
+}
+
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,bool reconnect)
+  : RDSqlQuery(query,RDSqlQuery::Auto,reconnect)
+{
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,Route route,bool reconnect)
+  : RDSqlQuery(query,__RDSqlQuery_Route(query,route),reconnect)
+{
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,const QVariantList &values,
+		       bool reconnect)
+  : RDSqlQuery(query,values,RDSqlQuery::Auto,reconnect)
+{
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,const QVariantList &values,
+		       Route route,bool reconnect)
+  : RDSqlQuery(query,values,__RDSqlQuery_Route(query,route),reconnect)
+{
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,RDDbConnection *conn,
+		       bool reconnect)
+  : QSqlQuery(QSqlDatabase::database(conn->name,false))
 {
   QSqlDatabase db;
   QString err;
-  sql_columns=0;
+  QElapsedTimer timer;
+  RDDbConnection *primary=NULL;
+
+  sql_connection=conn;
+  timer.start();
+  if(!query.isEmpty()) {
+    exec(query);
+  }
+  CountStatement(query);
+
+  if((!isActive())&&reconnect&&
+     ((primary=__RDDbPool_Failover(sql_connection))!=NULL)) {
+    sql_connection=primary;
+    QSqlQuery::operator=(QSqlQuery(QSqlDatabase::database(primary->name,
+							  false)));
+    exec(query);
+    __rd_sql_round_trips.fetchAndAddRelaxed(1);
+  }
 
   if (!isActive() && reconnect) {
-    db = QSqlDatabase::database();
+    db=QSqlDatabase::database(sql_connection->name,false);
 
     if (db.open()) {
       clear();
       exec(query);
+      __rd_sql_round_trips.fetchAndAddRelaxed(1);
       err=QObject::tr("DB connection re-established");
     }
     else {
@@ -65,24 +412,92 @@ RDSqlQuery::RDSqlQuery (const QString &query,bool reconnect):
   }
 
   if(isActive()) {
+    if(RDSqlProfiler::isActive()) {
+      RDSqlProfiler::record(query,timer.nsecsElapsed()/1000,
+			    isSelect()?size():numRowsAffected());
+    }
     if((rda!=NULL)&&(rda->config()->logSqlQueries())) {
       rda->syslog(rda->config()->logSqlQueriesLevel(),
 		  "SQL: %s",query.toUtf8().constData());
     }
     //printf("QUERY: %s\n",(const char *)query.toUtf8());
-    QStringList f0=query.split(" ");
-    if(f0[0].toLower()=="select") {
-      for(int i=1;i<f0.size();i++) {
-	if(f0[i].toLower()=="from") {
-	  QString fields;
-	  for(int j=1;j<i;j++) {
-	    fields+=f0[j];
-	  }
-	  QStringList f1=fields.split(",");
-	  sql_columns=f1.size();
-	  continue;
-	}
+  }
+  else {
+    err=QObject::tr("invalid SQL or failed DB connection")+
+      +"["+lastError().text()+"]: "+query;
+
+    fprintf(stderr,"%s\n",err.toUtf8().constData());
+    if(rda!=NULL) {
+      rda->syslog(LOG_ERR,err.toUtf8().constData());
+    }
+  }
+}
+
+
+RDSqlQuery::RDSqlQuery(const QString &query,const QVariantList &values,
+		       RDDbConnection *conn,bool reconnect)
+  : QSqlQuery(QSqlDatabase::database(conn->name,false))
+{
+  QSqlDatabase db;
+  QString err;
+  QElapsedTimer timer;
+  RDDbConnection *primary=NULL;
+  bool ok=false;
+
+  sql_connection=conn;
+  timer.start();
+  ok=ExecPrepared(query,values);
+  if((!ok)&&reconnect&&
+     ((primary=__RDDbPool_Failover(sql_connection))!=NULL)) {
+    if(!sql_statement_key.isEmpty()) {
+      sql_connection->busy_statements.remove(sql_statement_key);
+      sql_statement_key="";
+    }
+    sql_connection=primary;
+    QSqlQuery::operator=(QSqlQuery(QSqlDatabase::database(primary->name,
+							  false)));
+    ok=ExecPrepared(query,values);
+  }
+  if((!ok)&&reconnect) {
+    //
+    // Prepared statements don't survive the connection they were made on
+    //
+    if(!sql_statement_key.isEmpty()) {
+      sql_connection->busy_statements.remove(sql_statement_key);
+      sql_statement_key="";
+    }
+    db=QSqlDatabase::database(sql_connection->name,false);
+    QSqlQuery::operator=(QSqlQuery(db));
+    sql_connection->statements.clear();
+    sql_connection->statement_order.clear();
+    if(db.open()) {
+      ExecPrepared(query,values);
+      err=QObject::tr("DB connection re-established");
+    }
+    else {
+      err=QObject::tr("Could not re-establish DB connection")+
+	"["+db.lastError().text()+"]";
+    }
+
+    fprintf(stderr,"%s\n",err.toUtf8().constData());
+    if(rda!=NULL) {
+      rda->syslog(LOG_ERR,err.toUtf8().constData());
+    }
+  }
+
+  if(isActive()) {
+    if(RDSqlProfiler::isActive()) {
+      RDSqlProfiler::record(query,timer.nsecsElapsed()/1000,
+			    isSelect()?size():numRowsAffected());
+    }
+    if((rda!=NULL)&&(rda->config()->logSqlQueries())) {
+      QStringList f0;
+      for(int i=0;i<values.size();i++) {
+	f0.push_back(values.at(i).isNull()?"NULL":values.at(i).toString());
       }
+      rda->syslog(rda->config()->logSqlQueriesLevel(),"SQL: %s [%s]",
+		  query.toUtf8().constData(),
+		  f0.join(",").toUtf8().constData());
     }
   }
   else {
@@ -97,9 +512,18 @@ RDSqlQuery::RDSqlQuery (const QString &query,bool reconnect):
 }
 
 
+RDSqlQuery::~RDSqlQuery()
+{
+  if(!sql_statement_key.isEmpty()) {
+    finish();
+    sql_connection->busy_statements.remove(sql_statement_key);
+  }
+}
+
+
 int RDSqlQuery::columns() const
 {
-  return sql_columns;
+  return record().count();
 }
 
 
@@ -157,6 +581,178 @@ int RDSqlQuery::rows(const QString &sql)
 }
 
 
+QVariant RDSqlQuery::run(const QString &sql,const QVariantList &values,
+			 bool *ok)
+{
+  QVariant ret;
+
+  RDSqlQuery *q=new RDSqlQuery(sql,values);
+  if(ok!=NULL) {
+    *ok=q->isActive();
+  }
+  ret=q->lastInsertId();
+  delete q;
+
+  return ret;
+}
+
+
+bool RDSqlQuery::apply(const QString &sql,const QVariantList &values,
+		       QString *err_msg)
+{
+  bool ret=false;
+
+  RDSqlQuery *q=new RDSqlQuery(sql,values);
+  ret=q->isActive();
+  if((err_msg!=NULL)&&(!ret)) {
+    *err_msg="sql error: "+q->lastError().text()+" query: "+sql;
+  }
+  delete q;
+
+  return ret;
+}
+
+
+void RDSqlQuery::clearStatementCache()
+{
+  RDDbConnection *conn=__RDDbPool_Connection(false);
+
+  conn->statements.clear();
+  conn->statement_order.clear();
+  if(QThread::currentThread()==__rd_db_owner) {
+    conn=__rd_db_replica_default;
+  }
+  else {
+    conn=NULL;
+    if(__rd_db_replica_threads.hasLocalData()) {
+      conn=__rd_db_replica_threads.localData();
+    }
+  }
+  if(conn!=NULL) {
+    conn->statements.clear();
+    conn->statement_order.clear();
+  }
+}
+
+
+uint64_t RDSqlQuery::roundTrips()
+{
+  return __rd_sql_round_trips.loadAcquire();
+}
+
+
+void RDSqlQuery::resetRoundTrips()
+{
+  __rd_sql_round_trips.storeRelease(0);
+}
+
+
+uint64_t RDSqlQuery::writeCount()
+{
+  return __rd_sql_writes.loadAcquire();
+}
+
+
+bool RDSqlQuery::ExecPrepared(const QString &query,const QVariantList &values)
+{
+  RDDbConnection *conn=sql_connection;
+
+  if(conn->busy_statements.contains(query)) {
+    //
+    // Already in use further up the stack, so make a private one
+    //
+    if(!prepare(query)) {
+      return false;
+    }
+  }
+  else {
+    if(conn->statements.contains(query)) {
+      QSqlQuery::operator=(conn->statements.value(query));
+      conn->statement_order.removeOne(query);
+    }
+    else {
+      if(!prepare(query)) {
+	return false;
+      }
+      for(int i=0;(i<conn->statement_order.size())&&
+	    (conn->statement_order.size()>=RD_SQL_STATEMENT_CACHE_SIZE);) {
+	if(conn->busy_statements.contains(conn->statement_order.at(i))) {
+	  i++;
+	}
+	else {
+	  conn->statements.remove(conn->statement_order.takeAt(i));
+	}
+      }
+      conn->statements[query]=*this;
+    }
+    conn->statement_order.push_back(query);
+    conn->busy_statements.insert(query);
+    sql_statement_key=query;
+  }
+  for(int i=0;i<values.size();i++) {
+    addBindValue(values.at(i));
+  }
+  CountStatement(query);
+
+  return exec();
+}
+
+
+void RDSqlQuery::CountStatement(const QString &query)
+{
+  __rd_sql_round_trips.fetchAndAddRelaxed(1);
+  QString verb=query.trimmed().section(" ",0,0).toLower();
+
+  //
+  // Transaction control doesn't write anything itself
+  //
+  if((verb!="select")&&(verb!="show")&&(verb!="start")&&(verb!="begin")&&
+     (verb!="commit")&&(verb!="rollback")&&(verb!="savepoint")&&
+     (verb!="release")) {
+    __rd_sql_writes.fetchAndAddRelaxed(1);
+    __rd_db_last_write.setLocalData(time(NULL));
+  }
+}
+
+
+QSqlDatabase RDDbPool::database()
+{
+  return QSqlDatabase::database(__RDDbPool_Connection(true)->name,false);
+}
+
+
+QString RDDbPool::connectionName()
+{
+  return __RDDbPool_Connection(false)->name;
+}
+
+
+int RDDbPool::connections()
+{
+  return __rd_db_pool_size.loadAcquire();
+}
+
+
+int RDDbPool::replicas()
+{
+  if(__rd_db_config==NULL) {
+    return 0;
+  }
+  return __rd_db_config->mysqlReplicas();
+}
+
+
+void RDDbPool::release()
+{
+  if(__rd_db_threads.hasLocalData()) {
+    __rd_db_threads.setLocalData(NULL);
+  }
+  if(__rd_db_replica_threads.hasLocalData()) {
+    __rd_db_replica_threads.setLocalData(NULL);
+  }
+}
+
+
 bool RDOpenDb (int *schema,QString *err_str,RDConfig *config)
 {
   QSqlDatabase db;
@@ -181,7 +777,10 @@ bool RDOpenDb (int *schema,QString *err_str,RDConfig *config)
       return false;
     }
   }
+  __rd_db_config=config;
+  __rd_db_owner=QThread::currentThread();
   new RDDbHeartbeat(config->mysqlHeartbeatInterval());
+  RDSqlProfiler::start(config);
   sql=QString("set NAMES utf8mb4 collate utf8mb4_general_ci");
   q=new QSqlQuery(sql);
   delete q;
@@ -22,24 +22,98 @@
 #ifndef RDDB_H
 #define RDDB_H
 
+#include <stdint.h>
+
 #include <QString>
+#include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QVariant>
+#include <QVariantList>
 
 #include <rdconfig.h>
 
+//
+// Maximum number of prepared statements kept open
+//
+#define RD_SQL_STATEMENT_CACHE_SIZE 256
+
+//
+// Name prefix for the per-thread connections handed out by RDDbPool
+//
+#define RD_DB_POOL_CONNECTION_PREFIX "rddb-thread-"
+
+//
+// Name prefix for the per-thread read replica connections
+//
+#define RD_DB_REPLICA_CONNECTION_PREFIX "rddb-replica-"
+
+//
+// Minimum interval between attempts to open an unreachable replica [secs]
+//
+#define RD_DB_REPLICA_RETRY_INTERVAL 30
+
+struct RDDbConnection;
+
+//
+// A query is sent to a read replica (when any are configured in rd.conf)
+// only if it is marked 'Replica' and is a plain SELECT; 'Auto' and
+// 'Primary' queries always go to the primary.  Even a 'Replica' query goes
+// to the primary if this thread has a transaction open or has written
+// anything in the last ReplicaStickiness seconds, so that a thread always
+// reads back what it has just written, or if its replica has stopped
+// answering.
+//
 class RDSqlQuery : public QSqlQuery
 {
  public:
+  enum Route {Auto=0,Primary=1,Replica=2};
   RDSqlQuery(const QString &query,bool reconnect=true);
+  RDSqlQuery(const QString &query,Route route,bool reconnect=true);
+  RDSqlQuery(const QString &query,const QVariantList &values,
+	     bool reconnect=true);
+  RDSqlQuery(const QString &query,const QVariantList &values,Route route,
+	     bool reconnect=true);
+  ~RDSqlQuery();
   int columns() const;
   QVariant value(int index) const;
   static QVariant run(const QString &sql,bool *ok=NULL);
+  static QVariant run(const QString &sql,const QVariantList &values,
+		      bool *ok=NULL);
   static bool apply(const QString &sql,QString *err_msg=NULL);
+  static bool apply(const QString &sql,const QVariantList &values,
+		    QString *err_msg=NULL);
   static int rows(const QString &sql);
+  static void clearStatementCache();
+  static uint64_t roundTrips();
+  static void resetRoundTrips();
+  static uint64_t writeCount();
 
  private:
-  int sql_columns;
+  RDSqlQuery(const QString &query,RDDbConnection *conn,bool reconnect);
+  RDSqlQuery(const QString &query,const QVariantList &values,
+	     RDDbConnection *conn,bool reconnect);
+  bool ExecPrepared(const QString &query,const QVariantList &values);
+  static void CountStatement(const QString &query);
+  QString sql_statement_key;
+  RDDbConnection *sql_connection;
+};
+
+
+//
+// Per-thread database connections.  The thread that calls RDOpenDb() uses
+// the default connection; any other thread gets a connection of its own
+// the first time it runs a query, which is closed when the thread exits
+// (or by release()).  Connections to read replicas are made the same way,
+// alongside the primary ones.
+//
+class RDDbPool
+{
+ public:
+  static QSqlDatabase database();
+  static QString connectionName();
+  static int connections();
+  static int replicas();
+  static void release();
 };
 
 bool RDOpenDb(int *schema,QString *err_str,RDConfig *config);
@@ -18,6 +18,8 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <qsqlquery.h>
+
 #include <rddbheartbeat.h>
 #include <rddb.h>
 
@@ -31,9 +33,45 @@ RDDbHeartbeat::RDDbHeartbeat(int interval,QObject *parent)
 }
 
 
+bool RDDbHeartbeat::ping(const QString &conn_name)
+{
+  QSqlDatabase db=QSqlDatabase::database(conn_name,false);
+  QSqlQuery *q=NULL;
+  bool ret=false;
+
+  q=new QSqlQuery("select `DB` from `VERSION`",db);
+  ret=q->first();
+  delete q;
+
+  //
+  // Reopen a connection that no longer answers.  We still return false,
+  // as anything prepared on the old connection is gone.
+  //
+  if(!ret) {
+    db.close();
+    if(db.open()) {
+      q=new QSqlQuery("set NAMES utf8mb4 collate utf8mb4_general_ci",db);
+      delete q;
+    }
+  }
+
+  return ret;
+}
+
+
 void RDDbHeartbeat::intervalTimeoutData()
 {
-  RDSqlQuery *q=new RDSqlQuery("select `DB` from `VERSION`");
+  //
+  // Runs on whichever connection belongs to the thread this object lives
+  // in, so a worker thread with an event loop can keep its own alive
+  //
+  RDSqlQuery *q=
+    new RDSqlQuery("select `DB` from `VERSION`",RDSqlQuery::Primary);
   q->first();
   delete q;
+  if(RDDbPool::replicas()>0) {
+    q=new RDSqlQuery("select `DB` from `VERSION`",RDSqlQuery::Replica);
+    q->first();
+    delete q;
+  }
 }
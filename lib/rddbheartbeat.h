@@ -22,6 +22,7 @@
 #define RDDBHEARTBEAT_H
 
 #include <qobject.h>
+#include <qstring.h>
 #include <qsqldatabase.h>
 #include <qtimer.h>
 
@@ -30,6 +31,7 @@ class RDDbHeartbeat : public QObject
   Q_OBJECT;
  public:
   RDDbHeartbeat(int interval,QObject *parent=0);
+  static bool ping(const QString &conn_name);
 
  private slots:
   void intervalTimeoutData();
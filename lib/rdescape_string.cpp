@@ -75,6 +75,36 @@ QString RDCheckDateTime(QDate const &date, QString const &format)
 }
 
 
+//
+// As RDCheckDateTime(), but for binding to a prepared statement
+//
+QVariant RDBindDateTime(const QTime &time,const QString &format)
+{
+  if(time.isValid()) {
+    return QVariant(time.toString(format));
+  }
+  return QVariant(QVariant::String);
+}
+
+
+QVariant RDBindDateTime(const QDateTime &datetime,const QString &format)
+{
+  if(datetime.isValid()) {
+    return QVariant(datetime.toString(format));
+  }
+  return QVariant(QVariant::String);
+}
+
+
+QVariant RDBindDateTime(const QDate &date,const QString &format)
+{
+  if(date.isValid()) {
+    return QVariant(date.toString(format));
+  }
+  return QVariant(QVariant::String);
+}
+
+
 QString RDEscapeString(QString const &str)
 {
   QString res;
@@ -24,10 +24,14 @@
 #include <qbytearray.h>
 #include <qdatetime.h>
 #include <qstring.h>
+#include <qvariant.h>
 
 QString RDCheckDateTime(const QTime &time, const QString &format);
 QString RDCheckDateTime(const QDateTime &datetime, const QString &format);
 QString RDCheckDateTime(const QDate &date, const QString &format);
+QVariant RDBindDateTime(const QTime &time,const QString &format);
+QVariant RDBindDateTime(const QDateTime &datetime,const QString &format);
+QVariant RDBindDateTime(const QDate &date,const QString &format);
 QString RDEscapeString(const QString &str);
 QString RDEscapeShellString(QString str);
 QString RDEscapeBlob(const QByteArray &data);
@@ -1000,16 +1000,17 @@ void RDEventLine::linkLog(RDLogModel *e,RDLog *log,const QString &svcname,
     sql=QString("select ")+
       "`NESTED_EVENT` "+  // 00
       "from `EVENTS` where "+
-      "`NAME`='"+RDEscapeString(event_name)+"'";
-    q=new RDSqlQuery(sql);
+      "`NAME`=?";
+    q=new RDSqlQuery(sql,QVariantList()<<event_name);
     if(q->first()) {
       if(!q->value(0).toString().trimmed().isEmpty()) {
 	sql=QString("select ")+
 	  "`START_SLOP`,"+  // 00
 	  "`END_SLOP` "+    // 01
 	  "from `EVENTS` where "+
-	  "`NAME`='"+RDEscapeString(q->value(0).toString().trimmed())+"'";
-	q1=new RDSqlQuery(sql);
+	  "`NAME`=?";
+	q1=new RDSqlQuery(sql,
+			  QVariantList()<<q->value(0).toString().trimmed());
 	if(q1->first()) {
 	  inline_start_slop=q1->value(0).toInt();
 	  inline_end_slop=q1->value(1).toInt();
@@ -1084,13 +1085,16 @@ void RDEventLine::linkLog(RDLogModel *e,RDLog *log,const QString &svcname,
     "`LINK_START_TIME`,"+ // 09
     "`LINK_LENGTH` "+     // 10
     "from `IMPORTER_LINES` where "+
-    "`STATION_NAME`='"+RDEscapeString(event_station->name())+"' && "+
-    QString::asprintf("`PROCESS_ID`=%u && ",getpid())+
-    QString::asprintf("(`START_HOUR`=%d)&&",start_start_hour)+
-    QString::asprintf("(`START_SECS`>=%d)&&",start_start_secs/1000)+
-    QString::asprintf("(`START_SECS`<=%d)&&",end_start_secs/1000)+
+    "`STATION_NAME`=? && "+
+    "`PROCESS_ID`=? && "+
+    "(`START_HOUR`=?)&&"+
+    "(`START_SECS`>=?)&&"+
+    "(`START_SECS`<=?)&&"+
     "(`EVENT_USED`='N') order by `LINE_ID`";
-  q=new RDSqlQuery(sql);
+  QVariantList importer_values;
+  importer_values<<event_station->name()<<(unsigned)getpid()<<
+    start_start_hour<<start_start_secs/1000<<end_start_secs/1000;
+  q=new RDSqlQuery(sql,importer_values);
   while(q->next()) {
     int length=GetLength(q->value(0).toUInt(),q->value(2).toInt());
 
@@ -1212,13 +1216,13 @@ void RDEventLine::linkLog(RDLogModel *e,RDLog *log,const QString &svcname,
   //
   sql=QString("update `IMPORTER_LINES` set ")+
     "`EVENT_USED`='Y' where "+
-    "`STATION_NAME`='"+RDEscapeString(event_station->name())+"' && "+
-    QString::asprintf("`PROCESS_ID`=%u && ",getpid())+
-    QString::asprintf("(`START_HOUR`=%d)&&",start_start_hour)+
-    QString::asprintf("(`START_SECS`>=%d)&&",start_start_secs/1000)+
-    QString::asprintf("(`START_SECS`<=%d)&&",end_start_secs/1000)+
+    "`STATION_NAME`=? && "+
+    "`PROCESS_ID`=? && "+
+    "(`START_HOUR`=?)&&"+
+    "(`START_SECS`>=?)&&"+
+    "(`START_SECS`<=?)&&"+
     "(`EVENT_USED`='N')";
-  q=new RDSqlQuery(sql);
+  q=new RDSqlQuery(sql,importer_values);
   delete q;
 
   //
@@ -1233,11 +1237,11 @@ void RDEventLine::linkLog(RDLogModel *e,RDLog *log,const QString &svcname,
       "`CART`.`FORCED_LENGTH` "+     // 01
       "from `AUTOFILLS` left join `CART` "+
       "on `AUTOFILLS`.`CART_NUMBER`=`CART`.`NUMBER` where "+
-      "(`AUTOFILLS`.`SERVICE`='"+RDEscapeString(svcname)+"')&&"+
-      QString::asprintf("(`CART`.`FORCED_LENGTH`<=%d)&&",time.msecsTo(end_time))+
+      "(`AUTOFILLS`.`SERVICE`=?)&&"+
+      "(`CART`.`FORCED_LENGTH`<=?)&&"+
       "(`CART`.`FORCED_LENGTH`>0) "+
       "order by `CART`.`FORCED_LENGTH` desc";
-    q=new RDSqlQuery(sql);
+    q=new RDSqlQuery(sql,QVariantList()<<svcname<<time.msecsTo(end_time));
     bool fit=true;
     while(fit) {
       fit=false;
@@ -1391,12 +1395,15 @@ QString RDEventLine::propertiesText(int prepos_msec,
 
 int RDEventLine::GetLength(unsigned cartnum,int def_length)
 {
-  RDCart *cart=new RDCart(cartnum);
-  if(!cart->exists()) {
-    delete cart;
-    return def_length;
+  int length=def_length;
+
+  RDSqlQuery *q=
+    new RDSqlQuery("select `FORCED_LENGTH` from `CART` where `NUMBER`=?",
+		   QVariantList()<<cartnum);
+  if(q->first()) {
+    length=q->value(0).toInt();
   }
-  int length=cart->forcedLength();
-  delete cart;
+  delete q;
+
   return length;
 }
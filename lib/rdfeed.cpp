@@ -30,6 +30,7 @@
 #include "rdcart.h"
 #include "rdcut.h"
 #include "rdconf.h"
+#include "rdcurlpool.h"
 #include "rddb.h"
 #include "rddelete.h"
 #include "rdescape_string.h"
@@ -82,6 +83,7 @@ RDFeed::RDFeed(const QString &keyname,RDConfig *config,QObject *parent)
 
   feed_keyname=keyname;
   feed_config=config;
+  feed_snapshot=new RDRowSnapshot("FEEDS","KEY_NAME");
 
   sql=QString("select `ID` from `FEEDS` where ")+
     "`KEY_NAME`='"+RDEscapeString(keyname)+"'";
@@ -108,6 +110,7 @@ RDFeed::RDFeed(unsigned id,RDConfig *config,QObject *parent)
 
   feed_id=id;
   feed_config=config;
+  feed_snapshot=new RDRowSnapshot("FEEDS","KEY_NAME");
 
   sql=QString::asprintf("select `KEY_NAME` from `FEEDS` where `ID`=%u",id);
   q=new RDSqlQuery(sql);
@@ -118,15 +121,33 @@ RDFeed::RDFeed(unsigned id,RDConfig *config,QObject *parent)
 }
 
 
+RDFeed::~RDFeed()
+{
+  delete feed_snapshot;
+}
+
+
 bool RDFeed::exists() const
 {
   return RDDoesRowExist("FEEDS","KEY_NAME",feed_keyname);
 }
 
 
+bool RDFeed::snapshotEnabled() const
+{
+  return feed_snapshot->isEnabled();
+}
+
+
+void RDFeed::setSnapshotEnabled(bool state)
+{
+  feed_snapshot->setEnabled(state);
+}
+
+
 bool RDFeed::isSuperfeed() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"IS_SUPERFEED").
+  return RDBool(feed_snapshot->value(feed_keyname,"IS_SUPERFEED").
 		toString());
   
 }
@@ -190,7 +211,7 @@ unsigned RDFeed::id() const
 
 QString RDFeed::channelTitle() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_TITLE").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_TITLE").
     toString();
 }
 
@@ -203,7 +224,7 @@ void RDFeed::setChannelTitle(const QString &str) const
 
 QString RDFeed::channelDescription() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_DESCRIPTION").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_DESCRIPTION").
     toString();
 }
 
@@ -216,7 +237,7 @@ void RDFeed::setChannelDescription(const QString &str) const
 
 QString RDFeed::channelCategory() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_CATEGORY").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_CATEGORY").
     toString();
 }
 
@@ -229,7 +250,7 @@ void RDFeed::setChannelCategory(const QString &str) const
 
 QString RDFeed::channelSubCategory() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_SUB_CATEGORY").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_SUB_CATEGORY").
     toString();
 }
 
@@ -242,7 +263,7 @@ void RDFeed::setChannelSubCategory(const QString &str) const
 
 QString RDFeed::channelLink() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_LINK").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_LINK").
     toString();
 }
 
@@ -255,7 +276,7 @@ void RDFeed::setChannelLink(const QString &str) const
 
 QString RDFeed::channelCopyright() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_COPYRIGHT").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_COPYRIGHT").
     toString();
 }
 
@@ -268,7 +289,7 @@ void RDFeed::setChannelCopyright(const QString &str) const
 
 QString RDFeed::channelWebmaster() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_WEBMASTER").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_WEBMASTER").
     toString();
 }
 
@@ -282,7 +303,7 @@ void RDFeed::setChannelWebmaster(const QString &str) const
 
 QString RDFeed::channelEditor() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_EDITOR").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_EDITOR").
     toString();
 }
 
@@ -295,7 +316,7 @@ void RDFeed::setChannelEditor(const QString &str) const
 
 QString RDFeed::channelAuthor() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_AUTHOR").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_AUTHOR").
     toString();
 }
 
@@ -308,7 +329,7 @@ void RDFeed::setChannelAuthor(const QString &str) const
 
 bool RDFeed::channelAuthorIsDefault() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return RDBool(feed_snapshot->value(feed_keyname,
 			      "CHANNEL_AUTHOR_IS_DEFAULT").toString());
 }
 
@@ -321,7 +342,7 @@ void RDFeed::setChannelAuthorIsDefault(bool state) const
 
 QString RDFeed::channelOwnerName() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_OWNER_NAME").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_OWNER_NAME").
     toString();
 }
 
@@ -334,7 +355,7 @@ void RDFeed::setChannelOwnerName(const QString &str) const
 
 QString RDFeed::channelOwnerEmail() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_OWNER_EMAIL").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_OWNER_EMAIL").
     toString();
 }
 
@@ -347,7 +368,7 @@ void RDFeed::setChannelOwnerEmail(const QString &str) const
 
 QString RDFeed::channelLanguage() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_LANGUAGE").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_LANGUAGE").
     toString();
 }
 
@@ -360,7 +381,7 @@ void RDFeed::setChannelLanguage(const QString &str)
 
 bool RDFeed::channelExplicit() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return RDBool(feed_snapshot->value(feed_keyname,
 			      "CHANNEL_EXPLICIT").toString());
 }
 
@@ -373,7 +394,7 @@ void RDFeed::setChannelExplicit(bool state) const
 
 int RDFeed::channelImageId() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_IMAGE_ID").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_IMAGE_ID").
     toInt();
 }
 
@@ -386,7 +407,7 @@ void RDFeed::setChannelImageId(int img_id) const
 
 int RDFeed::defaultItemImageId() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"DEFAULT_ITEM_IMAGE_ID").
+  return feed_snapshot->value(feed_keyname,"DEFAULT_ITEM_IMAGE_ID").
     toInt();
 }
 
@@ -426,7 +447,7 @@ void RDFeed::setBaseUrl(const QString &str) const
 
 QString RDFeed::basePreamble() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"BASE_PREAMBLE").
+  return feed_snapshot->value(feed_keyname,"BASE_PREAMBLE").
     toString();
 }
 
@@ -439,7 +460,7 @@ void RDFeed::setBasePreamble(const QString &str) const
 
 QString RDFeed::purgeUrl() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"PURGE_URL").
+  return feed_snapshot->value(feed_keyname,"PURGE_URL").
     toString();
 }
 
@@ -452,7 +473,7 @@ void RDFeed::setPurgeUrl(const QString &str) const
 
 QString RDFeed::purgeUsername() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"PURGE_USERNAME").
+  return feed_snapshot->value(feed_keyname,"PURGE_USERNAME").
     toString();
 }
 
@@ -465,8 +486,8 @@ void RDFeed::setPurgeUsername(const QString &str) const
 
 QString RDFeed::purgePassword() const
 {
-  return QString(QByteArray::fromBase64(RDGetSqlValue("FEEDS","KEY_NAME",
-			 feed_keyname,"PURGE_PASSWORD").toString().toUtf8()));
+  return QString(QByteArray::fromBase64(feed_snapshot->
+		    value(feed_keyname,"PURGE_PASSWORD").toString().toUtf8()));
 }
 
 
@@ -478,7 +499,7 @@ void RDFeed::setPurgePassword(const QString &str) const
 
 bool RDFeed::purgeUseIdFile() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return RDBool(feed_snapshot->value(feed_keyname,
 			      "PURGE_USE_ID_FILE").toString());
 }
 
@@ -491,7 +512,7 @@ void RDFeed::setPurgeUseIdFile(bool state) const
 
 RDRssSchemas::RssSchema RDFeed::rssSchema() const
 {
-  return (RDRssSchemas::RssSchema)RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return (RDRssSchemas::RssSchema)feed_snapshot->value(feed_keyname,
 					       "RSS_SCHEMA").toUInt();
 }
 
@@ -504,7 +525,7 @@ void RDFeed::setRssSchema(RDRssSchemas::RssSchema schema) const
 
 QString RDFeed::headerXml() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"HEADER_XML").
+  return feed_snapshot->value(feed_keyname,"HEADER_XML").
     toString();
 }
 
@@ -517,7 +538,7 @@ void RDFeed::setHeaderXml(const QString &str)
 
 QString RDFeed::channelXml() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CHANNEL_XML").
+  return feed_snapshot->value(feed_keyname,"CHANNEL_XML").
     toString();
 }
 
@@ -530,7 +551,7 @@ void RDFeed::setChannelXml(const QString &str)
 
 QString RDFeed::itemXml() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"ITEM_XML").
+  return feed_snapshot->value(feed_keyname,"ITEM_XML").
     toString();
 }
 
@@ -549,7 +570,7 @@ QString RDFeed::feedUrl() const
 
 bool RDFeed::castOrderIsAscending() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return RDBool(feed_snapshot->value(feed_keyname,
 			      "CAST_ORDER").toString());
 }
 
@@ -562,7 +583,7 @@ void RDFeed::setCastOrderIsAscending(bool state) const
 
 int RDFeed::maxShelfLife() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"MAX_SHELF_LIFE").toInt();
+  return feed_snapshot->value(feed_keyname,"MAX_SHELF_LIFE").toInt();
 }
 
 
@@ -574,7 +595,7 @@ void RDFeed::setMaxShelfLife(int days)
 
 QDateTime RDFeed::lastBuildDateTime() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"LAST_BUILD_DATETIME").
+  return feed_snapshot->value(feed_keyname,"LAST_BUILD_DATETIME").
     toDateTime();
 }
 
@@ -587,7 +608,7 @@ void RDFeed::setLastBuildDateTime(const QDateTime &datetime) const
 
 QDateTime RDFeed::originDateTime() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"ORIGIN_DATETIME").
+  return feed_snapshot->value(feed_keyname,"ORIGIN_DATETIME").
     toDateTime();
 }
 
@@ -600,7 +621,7 @@ void RDFeed::setOriginDateTime(const QDateTime &datetime) const
 
 bool RDFeed::enableAutopost() const
 {
-  return RDBool(RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return RDBool(feed_snapshot->value(feed_keyname,
 			      "ENABLE_AUTOPOST").toString());
 }
 
@@ -613,7 +634,7 @@ void RDFeed::setEnableAutopost(bool state) const
 
 RDSettings::Format RDFeed::uploadFormat() const
 {
-  return (RDSettings::Format)RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,
+  return (RDSettings::Format)feed_snapshot->value(feed_keyname,
 					   "UPLOAD_FORMAT").toInt();
 }
 
@@ -626,7 +647,7 @@ void RDFeed::setUploadFormat(RDSettings::Format fmt) const
 
 int RDFeed::uploadChannels() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_CHANNELS").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_CHANNELS").
     toInt();
 }
 
@@ -639,7 +660,7 @@ void RDFeed::setUploadChannels(int chans) const
 
 int RDFeed::uploadQuality() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_QUALITY").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_QUALITY").
     toInt();
 }
 
@@ -652,7 +673,7 @@ void RDFeed::setUploadQuality(int qual) const
 
 int RDFeed::uploadBitRate() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_BITRATE").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_BITRATE").
     toInt();
 }
 
@@ -665,7 +686,7 @@ void RDFeed::setUploadBitRate(int rate) const
 
 int RDFeed::uploadSampleRate() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_SAMPRATE").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_SAMPRATE").
     toInt();
 }
 
@@ -678,7 +699,7 @@ void RDFeed::setUploadSampleRate(int rate) const
 
 QString RDFeed::uploadExtension() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_EXTENSION").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_EXTENSION").
     toString();
 }
 
@@ -691,7 +712,7 @@ void RDFeed::setUploadExtension(const QString &str)
 
 QString RDFeed::uploadMimetype() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"UPLOAD_MIMETYPE").
+  return feed_snapshot->value(feed_keyname,"UPLOAD_MIMETYPE").
     toString();
 }
 
@@ -704,7 +725,7 @@ void RDFeed::setUploadMimetype(const QString &str)
 
 int RDFeed::normalizeLevel() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"NORMALIZE_LEVEL").
+  return feed_snapshot->value(feed_keyname,"NORMALIZE_LEVEL").
     toInt();
 }
 
@@ -717,7 +738,7 @@ void RDFeed::setNormalizeLevel(int lvl) const
 
 QString RDFeed::sha1Hash() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"SHA1_HASH").toString();
+  return feed_snapshot->value(feed_keyname,"SHA1_HASH").toString();
 }
 
 
@@ -729,7 +750,7 @@ void RDFeed::setSha1Hash(const QString &str) const
 
 QString RDFeed::cdnPurgePluginPath() const
 {
-  return RDGetSqlValue("FEEDS","KEY_NAME",feed_keyname,"CDN_PURGE_PLUGIN_PATH").
+  return feed_snapshot->value(feed_keyname,"CDN_PURGE_PLUGIN_PATH").
     toString();
 }
 
@@ -892,7 +913,7 @@ bool RDFeed::postPodcast(unsigned cast_id,QString *err_msg)
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     *err_msg=tr("Internal error");
     return false;
@@ -914,9 +935,9 @@ bool RDFeed::postPodcast(unsigned cast_id,QString *err_msg)
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
     *err_msg=curl_easy_strerror(curl_err);
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     delete err_msgs;
@@ -928,7 +949,7 @@ bool RDFeed::postPodcast(unsigned cast_id,QString *err_msg)
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1015,7 +1036,7 @@ bool RDFeed::postXml(QString *err_msg)
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -1035,9 +1056,9 @@ bool RDFeed::postXml(QString *err_msg)
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
     *err_msg=QString::fromUtf8(curl_errorbuffer);
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -1047,7 +1068,7 @@ bool RDFeed::postXml(QString *err_msg)
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1108,7 +1129,7 @@ bool RDFeed::removeRss()
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -1127,8 +1148,8 @@ bool RDFeed::removeRss()
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -1138,7 +1159,7 @@ bool RDFeed::removeRss()
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1184,7 +1205,7 @@ bool RDFeed::postImage(int img_id) const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -1203,8 +1224,8 @@ bool RDFeed::postImage(int img_id) const
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -1214,7 +1235,7 @@ bool RDFeed::postImage(int img_id) const
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1260,7 +1281,7 @@ bool RDFeed::removeImage(int img_id) const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -1279,8 +1300,8 @@ bool RDFeed::removeImage(int img_id) const
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -1290,7 +1311,7 @@ bool RDFeed::removeImage(int img_id) const
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1856,7 +1877,7 @@ bool RDFeed::rssFrontXml(QByteArray *xml,QString *err_msg) const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -1879,9 +1900,9 @@ bool RDFeed::rssFrontXml(QByteArray *xml,QString *err_msg) const
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
     *err_msg=QString::fromUtf8(curl_errorbuffer);
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -1891,7 +1912,7 @@ bool RDFeed::rssFrontXml(QByteArray *xml,QString *err_msg) const
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -1916,7 +1937,7 @@ bool RDFeed::rssBackXml(QByteArray *xml,QString *err_msg) const
   long response_code;
   bool ret=false;
 
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     *err_msg=tr("Unable to initialize CURL");
     ret=false;
   }
@@ -1931,7 +1952,7 @@ bool RDFeed::rssBackXml(QByteArray *xml,QString *err_msg) const
     curl_easy_setopt(curl,CURLOPT_URL,
 		     RDFeed::publicUrl(baseUrl(""),feed_keyname).
 		     toUtf8().constData());
-    curl_err=curl_easy_perform(curl);
+    curl_err=RDCurlPool::perform(curl);
     if((ret=(curl_err==CURLE_OK))) {
       curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
       if((ret=(response_code>=200)||(response_code<300))) {
@@ -1945,7 +1966,7 @@ bool RDFeed::rssBackXml(QByteArray *xml,QString *err_msg) const
       ret=false;
     }
   }
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   return ret;
 }
 
@@ -2212,7 +2233,7 @@ bool RDFeed::SavePodcast(unsigned cast_id,const QString &src_filename,
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -2233,8 +2254,8 @@ bool RDFeed::SavePodcast(unsigned cast_id,const QString &src_filename,
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     *err_msg=curl_easy_strerror(curl_err);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
@@ -2245,7 +2266,7 @@ bool RDFeed::SavePodcast(unsigned cast_id,const QString &src_filename,
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -2382,7 +2403,7 @@ void RDFeed::AbandonCast(unsigned cast_id) const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
   }
   else {
@@ -2401,13 +2422,13 @@ void RDFeed::AbandonCast(unsigned cast_id) const
     //
     // Send it
     //
-    curl_easy_perform(curl);  // May fail, which is OK
+    RDCurlPool::perform(curl);  // May fail, which is OK
 
     //
     // Clean up
     //
     curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     delete err_msgs;
   }
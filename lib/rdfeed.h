@@ -27,6 +27,7 @@
 
 #include <rdapplication.h>
 #include <rdconfig.h>
+#include <rdrowsnapshot.h>
 #include <rdrssschemas.h>
 #include <rdsettings.h>
 #include <rdstation.h>
@@ -42,9 +43,12 @@ class RDFeed : public QObject
  public:
   RDFeed(const QString &keyname,RDConfig *config,QObject *parent=0);
   RDFeed(unsigned id,RDConfig *config,QObject *parent=0);
+  ~RDFeed();
   QString keyName() const;
   unsigned id() const;
   bool exists() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   bool isSuperfeed() const;
   void setIsSuperfeed(bool state) const;
   QStringList subfeedNames() const;
@@ -198,6 +202,7 @@ class RDFeed : public QObject
   int feed_xml_ptr;
   int feed_render_start_line;
   int feed_render_end_line;
+  RDRowSnapshot *feed_snapshot;
 };
 
 
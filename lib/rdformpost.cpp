@@ -41,6 +41,7 @@ RDFormPost::RDFormPost(RDFormPost::Encoding encoding,bool auto_delete)
   post_error=RDFormPost::ErrorNotInitialized;
   post_auto_delete=auto_delete;
   post_data=NULL;
+  post_stream=NULL;
   post_tempdir=NULL;
   post_bytes_downloaded=0;
 
@@ -144,11 +145,12 @@ RDFormPost::~RDFormPost()
     if(post_tempdir!=NULL) {
       delete post_tempdir;
     }
-    /*
-    if(post_data!=NULL) {
-      delete post_data;
-    }
-    */
+  }
+  if(post_data!=NULL) {
+    delete[] post_data;
+  }
+  if(post_stream!=NULL) {
+    fclose(post_stream);
   }
 }
 
@@ -611,7 +613,7 @@ void RDFormPost::LoadUrlEncoding(char first)
 
   post_data[0]=first;
   while(total_read<(post_content_length-1)) {
-    if((n=read(0,post_data+1+total_read,post_content_length-1-total_read))<0) {
+    if((n=read(0,post_data+1+total_read,post_content_length-1-total_read))<=0) {
       post_error=RDFormPost::ErrorMalformedData;
       return;
     }
@@ -650,11 +652,20 @@ void RDFormPost::LoadUrlEncoding(char first)
 void RDFormPost::LoadMultipartEncoding(char first)
 {
   bool ok=false;
+  int fd=-1;
 
   //
   // Create Stream Reader
   //
-  if((post_stream=fdopen(0,"r"))==NULL) {
+  // On a copy of stdin, as closing the stream closes its descriptor and
+  // stdin may go on to serve other requests
+  //
+  if((fd=dup(0))<0) {
+    post_error=RDFormPost::ErrorInternal;
+    return;
+  }
+  if((post_stream=fdopen(fd,"r"))==NULL) {
+    close(fd);
     post_error=RDFormPost::ErrorInternal;
     return;
   }
@@ -803,10 +814,13 @@ bool RDFormPost::GetMimePart(QString *name,QString *value,bool *is_file,
 QByteArray RDFormPost::GetLine(bool *ok)
 {
   char *data=NULL;
-  size_t n=0;
+  size_t len=0;
+  ssize_t n=0;
 
-  if((n=getline(&data,&n,post_stream))<0) {
+  if((n=getline(&data,&len,post_stream))<0) {
+    free(data);
     *ok=false;
+    return QByteArray();
   }
   post_bytes_downloaded+=n;
   QByteArray ret(data,n);
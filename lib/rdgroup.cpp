@@ -572,7 +572,7 @@ bool RDGroup::ReserveCart(const QString &station_name,RDCart::Type type,
       "`PENDING_STATION`='"+RDEscapeString(station_name)+"',"+
       QString::asprintf("`PENDING_PID`=%d,",getpid())+
       "`PENDING_DATETIME`=now()";
-    q=new QSqlQuery(sql);
+    q=new QSqlQuery(sql,RDDbPool::database());
     ret=q->isActive();
     delete q;
   }
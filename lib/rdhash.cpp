@@ -18,11 +18,6 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
-#include <fcntl.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <unistd.h>
-
 #include <stdio.h>
 
 #include <openssl/sha.h>
@@ -30,6 +25,7 @@
 #include <QDateTime>
 
 #include "rdhash.h"
+#include "rdhashengine.h"
 
 QString __RDSha1Hash_MakePasswordHash(const QString &secret,const QString &salt)
 {
@@ -68,31 +64,7 @@ QString RDSha1HashData(const QByteArray &data)
 
 QString RDSha1HashFile(const QString &filename,bool throttle)
 {
-  QString ret;
-  SHA_CTX ctx;
-  int fd=-1;
-  int n;
-  char data[1024];
-  unsigned char md[SHA_DIGEST_LENGTH];
-
-  if((fd=open(filename.toUtf8(),O_RDONLY))<0) {
-    return ret;
-  }
-  SHA1_Init(&ctx);
-  while((n=read(fd,data,1024))>0) {
-    SHA1_Update(&ctx,data,n);
-    if(throttle) {
-      usleep(1);
-    }
-  }
-  close(fd);
-  SHA1_Final(md,&ctx);
-  ret="";
-  for(int i=0;i<SHA_DIGEST_LENGTH;i++) {
-    ret+=QString::asprintf("%02x",0xff&md[i]);
-  }
-
-  return ret;
+  return RDHashEngine::hashFile(filename,throttle);
 }
 
 
@@ -0,0 +1,343 @@
+// rdhashengine.cpp
+//
+// Parallel SHA1 hashing of audio files.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+
+#include <QFile>
+#include <QSet>
+
+#include "rd.h"
+#include "rdhashengine.h"
+
+void *__RDHashEngine_Worker(void *priv)
+{
+  ((RDHashEngine *)priv)->RunWorker();
+
+  return NULL;
+}
+
+
+RDHashEngine::RDHashEngine(RDConfig *config)
+{
+  hash_workers=RD_DEFAULT_REHASH_WORKERS;
+  hash_rate_limit=0;
+  if(config!=NULL) {
+    hash_workers=config->rehashWorkers();
+    hash_rate_limit=config->rehashRateLimit();
+  }
+  hash_progress_stream=NULL;
+  hash_skipped=0;
+  hash_next=0;
+  hash_returned=0;
+  hash_bytes_read=0;
+  hash_rate_clock=0.0;
+  pthread_mutex_init(&hash_mutex,NULL);
+  pthread_cond_init(&hash_cond,NULL);
+}
+
+
+RDHashEngine::~RDHashEngine()
+{
+  Stop();
+  if(hash_progress_stream!=NULL) {
+    fclose(hash_progress_stream);
+  }
+  pthread_cond_destroy(&hash_cond);
+  pthread_mutex_destroy(&hash_mutex);
+}
+
+
+int RDHashEngine::workers() const
+{
+  return hash_workers;
+}
+
+
+void RDHashEngine::setWorkers(int num)
+{
+  hash_workers=num;
+}
+
+
+unsigned RDHashEngine::rateLimit() const
+{
+  return hash_rate_limit;
+}
+
+
+void RDHashEngine::setRateLimit(unsigned mbytes)
+{
+  hash_rate_limit=mbytes;
+}
+
+
+QString RDHashEngine::progressFile() const
+{
+  return hash_progress_file;
+}
+
+
+void RDHashEngine::setProgressFile(const QString &filename)
+{
+  hash_progress_file=filename;
+}
+
+
+void RDHashEngine::addFile(const QString &key,const QString &filename)
+{
+  hash_files.push_back(QPair<QString,QString>(key,filename));
+}
+
+
+int RDHashEngine::skipped() const
+{
+  return hash_skipped;
+}
+
+
+bool RDHashEngine::start()
+{
+  pthread_t thread;
+
+  //
+  // Skip whatever a previous, interrupted run already finished
+  //
+  if(!hash_progress_file.isEmpty()) {
+    QSet<QString> done;
+    QFile file(hash_progress_file);
+    if(file.open(QIODevice::ReadOnly)) {
+      while(!file.atEnd()) {
+	done.insert(QString::fromUtf8(file.readLine()).trimmed());
+      }
+      file.close();
+    }
+    for(int i=hash_files.size()-1;i>=0;i--) {
+      if(done.contains(hash_files.at(i).first)) {
+	hash_files.removeAt(i);
+	hash_skipped++;
+      }
+    }
+    if((hash_progress_stream=
+	fopen(hash_progress_file.toUtf8(),"a"))==NULL) {
+      return false;
+    }
+  }
+
+  hash_next=0;
+  hash_returned=0;
+  hash_rate_clock=0.0;
+  for(int i=0;(i<hash_workers)&&(i<hash_files.size());i++) {
+    if(pthread_create(&thread,NULL,__RDHashEngine_Worker,this)!=0) {
+      break;
+    }
+    hash_threads.push_back(thread);
+  }
+
+  return (hash_threads.size()>0)||(hash_files.size()==0);
+}
+
+
+bool RDHashEngine::next(QString *key,QString *hash)
+{
+  if(!hash_last_key.isEmpty()) {
+    MarkDone(hash_last_key);
+    hash_last_key="";
+  }
+
+  pthread_mutex_lock(&hash_mutex);
+  while(hash_results.isEmpty()&&(hash_returned<hash_files.size())) {
+    pthread_cond_wait(&hash_cond,&hash_mutex);
+  }
+  if(hash_results.isEmpty()) {
+    pthread_mutex_unlock(&hash_mutex);
+    Stop();
+    if(hash_progress_stream!=NULL) {
+      fclose(hash_progress_stream);
+      hash_progress_stream=NULL;
+      unlink(hash_progress_file.toUtf8());
+    }
+    return false;
+  }
+  QPair<QString,QString> result=hash_results.takeFirst();
+  hash_returned++;
+  pthread_mutex_unlock(&hash_mutex);
+
+  *key=result.first;
+  *hash=result.second;
+  hash_last_key=result.first;
+
+  return true;
+}
+
+
+uint64_t RDHashEngine::bytesRead() const
+{
+  return hash_bytes_read;
+}
+
+
+QString RDHashEngine::hashFile(const QString &filename,bool throttle)
+{
+  return RDHashEngine::Digest(filename,NULL,throttle);
+}
+
+
+void RDHashEngine::RunWorker()
+{
+  while(true) {
+    pthread_mutex_lock(&hash_mutex);
+    if(hash_next>=hash_files.size()) {
+      pthread_mutex_unlock(&hash_mutex);
+      return;
+    }
+    QPair<QString,QString> file=hash_files.at(hash_next++);
+    pthread_mutex_unlock(&hash_mutex);
+
+    QString hash=RDHashEngine::Digest(file.second,this,false);
+
+    pthread_mutex_lock(&hash_mutex);
+    hash_results.push_back(QPair<QString,QString>(file.first,hash));
+    pthread_cond_signal(&hash_cond);
+    pthread_mutex_unlock(&hash_mutex);
+  }
+}
+
+
+void RDHashEngine::Throttle(size_t bytes)
+{
+  struct timeval tv;
+  double now;
+  double slot;
+
+  if(hash_rate_limit==0) {
+    return;
+  }
+
+  //
+  // Each read books the next free slot on a clock shared by all of the
+  // workers, then waits for it to come round.
+  //
+  gettimeofday(&tv,NULL);
+  now=(double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+  pthread_mutex_lock(&hash_mutex);
+  slot=hash_rate_clock;
+  if(slot<now) {
+    slot=now;
+  }
+  hash_rate_clock=slot+(double)bytes/(1048576.0*(double)hash_rate_limit);
+  pthread_mutex_unlock(&hash_mutex);
+  if(slot>now) {
+    usleep(1000000.0*(slot-now));
+  }
+}
+
+
+void RDHashEngine::MarkDone(const QString &key)
+{
+  if(hash_progress_stream!=NULL) {
+    fprintf(hash_progress_stream,"%s\n",key.toUtf8().constData());
+    fflush(hash_progress_stream);
+  }
+}
+
+
+void RDHashEngine::Stop()
+{
+  pthread_mutex_lock(&hash_mutex);
+  hash_next=hash_files.size();
+  pthread_mutex_unlock(&hash_mutex);
+  for(int i=0;i<hash_threads.size();i++) {
+    pthread_join(hash_threads.at(i),NULL);
+  }
+  hash_threads.clear();
+}
+
+
+QString RDHashEngine::Digest(const QString &filename,RDHashEngine *engine,
+			     bool throttle)
+{
+  QString ret;
+  int fd=-1;
+  ssize_t n;
+  off_t offset=0;
+  void *data=NULL;
+  EVP_MD_CTX *ctx=NULL;
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned md_len=0;
+  bool ok=true;
+
+  if((fd=open(filename.toUtf8(),O_RDONLY))<0) {
+    return ret;
+  }
+  if(posix_memalign(&data,4096,RDHASHENGINE_BLOCK_SIZE)!=0) {
+    close(fd);
+    return ret;
+  }
+  posix_fadvise(fd,0,0,POSIX_FADV_SEQUENTIAL);
+  ctx=EVP_MD_CTX_new();
+  EVP_DigestInit_ex(ctx,EVP_sha1(),NULL);
+  while(true) {
+    if(engine!=NULL) {
+      engine->Throttle(RDHASHENGINE_BLOCK_SIZE);
+    }
+    if((n=read(fd,data,RDHASHENGINE_BLOCK_SIZE))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      ok=false;
+      break;
+    }
+    if(n==0) {
+      break;
+    }
+    EVP_DigestUpdate(ctx,data,n);
+    if(engine!=NULL) {
+      //
+      // Don't let a scan of the whole library push the working set of
+      // the rest of the system out of the page cache
+      //
+      posix_fadvise(fd,offset,n,POSIX_FADV_DONTNEED);
+      pthread_mutex_lock(&engine->hash_mutex);
+      engine->hash_bytes_read+=n;
+      pthread_mutex_unlock(&engine->hash_mutex);
+    }
+    offset+=n;
+    if(throttle) {
+      usleep(RDHASHENGINE_THROTTLE_DELAY);
+    }
+  }
+  EVP_DigestFinal_ex(ctx,md,&md_len);
+  EVP_MD_CTX_free(ctx);
+  free(data);
+  close(fd);
+  if(ok) {
+    for(unsigned i=0;i<md_len;i++) {
+      ret+=QString::asprintf("%02x",0xff&md[i]);
+    }
+  }
+
+  return ret;
+}
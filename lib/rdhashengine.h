@@ -0,0 +1,88 @@
+// rdhashengine.h
+//
+// Parallel SHA1 hashing of audio files.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDHASHENGINE_H
+#define RDHASHENGINE_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include <rdconfig.h>
+
+//
+// Size of each read [bytes]
+//
+#define RDHASHENGINE_BLOCK_SIZE 1048576
+
+//
+// Pause after each block when hashing with 'throttle' set [uSecs]
+//
+#define RDHASHENGINE_THROTTLE_DELAY 1000
+
+class RDHashEngine
+{
+ public:
+  RDHashEngine(RDConfig *config=NULL);
+  ~RDHashEngine();
+  int workers() const;
+  void setWorkers(int num);
+  unsigned rateLimit() const;
+  void setRateLimit(unsigned mbytes);
+  QString progressFile() const;
+  void setProgressFile(const QString &filename);
+  void addFile(const QString &key,const QString &filename);
+  int skipped() const;
+  bool start();
+  bool next(QString *key,QString *hash);
+  uint64_t bytesRead() const;
+  static QString hashFile(const QString &filename,bool throttle=false);
+
+ private:
+  void RunWorker();
+  void Throttle(size_t bytes);
+  void MarkDone(const QString &key);
+  void Stop();
+  static QString Digest(const QString &filename,RDHashEngine *engine,
+			bool throttle);
+  int hash_workers;
+  unsigned hash_rate_limit;
+  QString hash_progress_file;
+  FILE *hash_progress_stream;
+  QList<QPair<QString,QString> > hash_files;
+  QList<QPair<QString,QString> > hash_results;
+  QString hash_last_key;
+  int hash_skipped;
+  int hash_next;
+  int hash_returned;
+  uint64_t hash_bytes_read;
+  double hash_rate_clock;
+  QList<pthread_t> hash_threads;
+  pthread_mutex_t hash_mutex;
+  pthread_cond_t hash_cond;
+  friend void *__RDHashEngine_Worker(void *priv);
+};
+
+
+#endif  // RDHASHENGINE_H
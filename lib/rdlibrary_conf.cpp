@@ -54,6 +54,14 @@ RDLibraryConf::RDLibraryConf(const QString &station)
   }
   lib_id=q->value(0).toUInt();
   delete q;
+  lib_snapshot=new RDRowSnapshot("RDLIBRARY","ID");
+  lib_snapshot->setFollowsWrites(false);
+}
+
+
+RDLibraryConf::~RDLibraryConf()
+{
+  delete lib_snapshot;
 }
 
 
@@ -63,15 +71,27 @@ QString RDLibraryConf::station() const
 }
 
 
+bool RDLibraryConf::snapshotEnabled() const
+{
+  return lib_snapshot->isEnabled();
+}
+
+
+void RDLibraryConf::setSnapshotEnabled(bool state)
+{
+  lib_snapshot->setEnabled(state);
+}
+
+
 int RDLibraryConf::inputCard() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"INPUT_CARD").toInt();
+  return lib_snapshot->value(lib_id,"INPUT_CARD").toInt();
 }
 
 
 int RDLibraryConf::inputPort() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"INPUT_PORT").toInt();
+  return lib_snapshot->value(lib_id,"INPUT_PORT").toInt();
 }
 
 
@@ -89,13 +109,13 @@ void RDLibraryConf::setInputPort(int input) const
 
 int RDLibraryConf::outputCard() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"OUTPUT_CARD").toInt();
+  return lib_snapshot->value(lib_id,"OUTPUT_CARD").toInt();
 }
 
 
 int RDLibraryConf::outputPort() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"OUTPUT_PORT").toInt();
+  return lib_snapshot->value(lib_id,"OUTPUT_PORT").toInt();
 }
 
 
@@ -113,7 +133,7 @@ void RDLibraryConf::setOutputPort(int output) const
 
 int RDLibraryConf::voxThreshold() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"VOX_THRESHOLD").toInt();
+  return lib_snapshot->value(lib_id,"VOX_THRESHOLD").toInt();
 }
 
 
@@ -125,7 +145,7 @@ void RDLibraryConf::setVoxThreshold(int level) const
 
 int RDLibraryConf::trimThreshold() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"TRIM_THRESHOLD").toInt();
+  return lib_snapshot->value(lib_id,"TRIM_THRESHOLD").toInt();
 }
 
 
@@ -137,7 +157,7 @@ void RDLibraryConf::setTrimThreshold(int level) const
 
 unsigned RDLibraryConf::defaultFormat() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_FORMAT").toUInt();
+  return lib_snapshot->value(lib_id,"DEFAULT_FORMAT").toUInt();
 }
 
 
@@ -149,7 +169,7 @@ void RDLibraryConf::setDefaultFormat(unsigned format) const
 
 unsigned RDLibraryConf::defaultChannels() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_CHANNELS").toUInt();
+  return lib_snapshot->value(lib_id,"DEFAULT_CHANNELS").toUInt();
 }
 
 
@@ -161,7 +181,7 @@ void RDLibraryConf::setDefaultChannels(unsigned chans) const
 
 unsigned RDLibraryConf::defaultLayer() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_LAYER").toUInt();
+  return lib_snapshot->value(lib_id,"DEFAULT_LAYER").toUInt();
 }
 
 
@@ -173,7 +193,7 @@ void RDLibraryConf::setDefaultLayer(unsigned layer) const
 
 unsigned RDLibraryConf::defaultBitrate() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_BITRATE").toUInt();
+  return lib_snapshot->value(lib_id,"DEFAULT_BITRATE").toUInt();
 }
 
 
@@ -186,7 +206,7 @@ void RDLibraryConf::setDefaultBitrate(unsigned rate) const
 RDLibraryConf::RecordMode RDLibraryConf::defaultRecordMode() const
 {
   return (RDLibraryConf::RecordMode)
-    RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_RECORD_MODE").toUInt();
+    lib_snapshot->value(lib_id,"DEFAULT_RECORD_MODE").toUInt();
 }
 
 
@@ -198,7 +218,7 @@ void RDLibraryConf::setDefaultRecordMode(RecordMode mode) const
 
 bool RDLibraryConf::defaultTrimState() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"DEFAULT_TRIM_STATE").
+  return RDBool(lib_snapshot->value(lib_id,"DEFAULT_TRIM_STATE").
 	       toString());
 }
 
@@ -211,7 +231,7 @@ void RDLibraryConf::setDefaultTrimState(bool state) const
 
 unsigned RDLibraryConf::maxLength() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"MAXLENGTH").toUInt();
+  return lib_snapshot->value(lib_id,"MAXLENGTH").toUInt();
 }
 
 
@@ -223,7 +243,7 @@ void RDLibraryConf::setMaxLength(unsigned length) const
 
 unsigned RDLibraryConf::tailPreroll() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"TAIL_PREROLL").toUInt();
+  return lib_snapshot->value(lib_id,"TAIL_PREROLL").toUInt();
 }
 
 
@@ -235,7 +255,7 @@ void RDLibraryConf::setTailPreroll(unsigned length) const
 
 QString RDLibraryConf::ripperDevice() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"RIPPER_DEVICE").toString();
+  return lib_snapshot->value(lib_id,"RIPPER_DEVICE").toString();
 }
 
 
@@ -247,7 +267,7 @@ void RDLibraryConf::setRipperDevice(QString dev) const
 
 int RDLibraryConf::paranoiaLevel() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"PARANOIA_LEVEL").toInt();
+  return lib_snapshot->value(lib_id,"PARANOIA_LEVEL").toInt();
 }
 
 
@@ -259,7 +279,7 @@ void RDLibraryConf::setParanoiaLevel(int level) const
 
 int RDLibraryConf::ripperLevel() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"RIPPER_LEVEL").toInt();
+  return lib_snapshot->value(lib_id,"RIPPER_LEVEL").toInt();
 }
  
 
@@ -271,8 +291,8 @@ void RDLibraryConf::setRipperLevel(int level) const
 
 RDLibraryConf::CdServerType RDLibraryConf::cdServerType() const
 {
-  return (RDLibraryConf::CdServerType)RDGetSqlValue("RDLIBRARY","ID",lib_id,
-						    "CD_SERVER_TYPE").toInt();  
+  return (RDLibraryConf::CdServerType)lib_snapshot->
+    value(lib_id,"CD_SERVER_TYPE").toInt();
 }
 
 
@@ -284,7 +304,7 @@ void RDLibraryConf::setCdServerType(RDLibraryConf::CdServerType type) const
 
 QString RDLibraryConf::cddbServer() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"CDDB_SERVER").toString();
+  return lib_snapshot->value(lib_id,"CDDB_SERVER").toString();
 }
 
 
@@ -296,7 +316,7 @@ void RDLibraryConf::setCddbServer(QString server) const
 
 QString RDLibraryConf::mbServer() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"MB_SERVER").toString();
+  return lib_snapshot->value(lib_id,"MB_SERVER").toString();
 }
 
 
@@ -308,7 +328,7 @@ void RDLibraryConf::setMbServer(QString server) const
 
 bool RDLibraryConf::readIsrc() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"READ_ISRC").
+  return RDBool(lib_snapshot->value(lib_id,"READ_ISRC").
 		toString());
 }
 
@@ -321,7 +341,7 @@ void RDLibraryConf::setReadIsrc(bool state) const
 
 bool RDLibraryConf::enableEditor() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"ENABLE_EDITOR").
+  return RDBool(lib_snapshot->value(lib_id,"ENABLE_EDITOR").
 		toString());
 }
 
@@ -334,7 +354,7 @@ void RDLibraryConf::setEnableEditor(bool state) const
 
 int RDLibraryConf::srcConverter() const
 {
-  return RDGetSqlValue("RDLIBRARY","ID",lib_id,"SRC_CONVERTER").toInt();
+  return lib_snapshot->value(lib_id,"SRC_CONVERTER").toInt();
 }
 
 
@@ -347,7 +367,7 @@ void RDLibraryConf::setSrcConverter(int conv) const
 RDLibraryConf::SearchLimit RDLibraryConf::limitSearch() const
 {
   return (RDLibraryConf::SearchLimit)
-    RDGetSqlValue("RDLIBRARY","ID",lib_id,"LIMIT_SEARCH").toInt();
+    lib_snapshot->value(lib_id,"LIMIT_SEARCH").toInt();
 }
 
 
@@ -359,7 +379,7 @@ void RDLibraryConf::setLimitSearch(RDLibraryConf::SearchLimit lmt) const
 
 bool RDLibraryConf::searchLimited() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"SEARCH_LIMITED").
+  return RDBool(lib_snapshot->value(lib_id,"SEARCH_LIMITED").
 		toString());
 }
 
@@ -372,7 +392,7 @@ void RDLibraryConf::setSearchLimited(bool state) const
 
 bool RDLibraryConf::isSingleton() const
 {
-  return RDBool(RDGetSqlValue("RDLIBRARY","ID",lib_id,"IS_SINGLETON").
+  return RDBool(lib_snapshot->value(lib_id,"IS_SINGLETON").
 		toString());
 }
 
@@ -481,6 +501,7 @@ void RDLibraryConf::SetRow(const QString &param,int value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLIBRARY");
 }
 
 
@@ -494,6 +515,7 @@ void RDLibraryConf::SetRow(const QString &param,unsigned value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLIBRARY");
 }
 
 
@@ -507,6 +529,7 @@ void RDLibraryConf::SetRow(const QString &param,const QString &value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLIBRARY");
 }
 
 
@@ -22,6 +22,7 @@
 #define RDLIBRARY_CONF_H
 
 #include <rdconfig.h>
+#include <rdrowsnapshot.h>
 #include <rdsettings.h>
 
 class RDLibraryConf
@@ -31,7 +32,10 @@ class RDLibraryConf
   enum SearchLimit {LimitNo=0,LimitYes=1,LimitPrevious=2};
   enum CdServerType {DummyType=0,CddbType=1,MusicBrainzType=2,LastType=3};
   RDLibraryConf(const QString &station);
+  ~RDLibraryConf();
   QString station() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   int inputCard() const;
   void setInputCard(int input) const;
   int inputPort() const;
@@ -95,6 +99,7 @@ class RDLibraryConf
   void SetRow(const QString &param,bool value) const;
   QString lib_station;
   unsigned lib_id;
+  RDRowSnapshot *lib_snapshot;
 };
 
 
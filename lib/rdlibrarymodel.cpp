@@ -685,7 +685,12 @@ void RDLibraryModel::updateModel(const QString &filter_sql)
 #endif  // RDLIBRARYMODEL_ENABLE_UPDATE_PROFILING
 
   //  printf("RDLibraryModel::updateModel() SQL: %s\n",sql.toUtf8().constData());
-  q=new RDSqlQuery(sql);
+
+  //
+  // Browsing can stand a little replication lag; rows refreshed on a
+  // notification come from the primary
+  //
+  q=new RDSqlQuery(sql,RDSqlQuery::Replica);
   while(q->next()&&(carts_loaded<d_cart_limit)) {
     if(q->value(0).toUInt()!=prev_cartnum) {
       d_texts.push_back(list);
@@ -0,0 +1,403 @@
+// rdlocalxport.cpp
+//
+// In-process implementations of Web API operations for a local audio store.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <QHostAddress>
+
+#include "rd.h"
+#include "rdapplication.h"
+#include "rdaudiodedup.h"
+#include "rdcart.h"
+#include "rdcut.h"
+#include "rdhash.h"
+#include "rdlibrary_conf.h"
+#include "rdlocalxport.h"
+#include "rdtranscodecache.h"
+#include "rduser.h"
+
+bool RDLocalXport::isLocalService(RDStation *station,RDConfig *config)
+{
+  QHostAddress addr=station->httpAddress(config);
+
+  return addr.isLoopback()||(addr==station->address());
+}
+
+
+bool RDLocalXport::isAvailable(RDStation *station,RDConfig *config,
+			       unsigned cartnum,int cutnum)
+{
+  //
+  // Only when the Web API is served by this host, so that the audio we
+  // see is the audio it would see. Files we can't read (e.g. because
+  // of ownership) are left to the web service.
+  //
+  if(!config->inProcessWebApi()) {
+    return false;
+  }
+  if(!RDLocalXport::isLocalService(station,config)) {
+    return false;
+  }
+  if(access(RDCut::pathName(cartnum,cutnum).toUtf8(),R_OK)!=0) {
+    return false;
+  }
+
+  return true;
+}
+
+
+bool RDLocalXport::isImportAvailable(RDStation *station,RDConfig *config,
+				     unsigned cartnum,int cutnum)
+{
+  QString path=RDCut::pathName(cartnum,cutnum);
+
+  if(!config->inProcessWebApi()) {
+    return false;
+  }
+  if(!RDLocalXport::isLocalService(station,config)) {
+    return false;
+  }
+  if(access(config->audioRoot().toUtf8(),W_OK|X_OK)!=0) {
+    return false;
+  }
+
+  //
+  // Imported files must end up owned by the Rivendell user, which only
+  // root can arrange when running as anyone else
+  //
+  if((geteuid()!=config->uid())&&(geteuid()!=0)) {
+    return false;
+  }
+  if((access(path.toUtf8(),F_OK)==0)&&(access(path.toUtf8(),W_OK)!=0)) {
+    return false;
+  }
+
+  return true;
+}
+
+
+bool RDLocalXport::authenticate(const QString &username)
+{
+  //
+  // Requests from the local host are whitelisted by the web service, so
+  // the user need only exist.
+  //
+  RDUser *user=new RDUser(username);
+  bool ret=user->exists();
+
+  if(!ret) {
+    rda->logAuthenticationFailure(QHostAddress(QHostAddress::LocalHost),
+				  username);
+  }
+  delete user;
+
+  return ret;
+}
+
+
+bool RDLocalXport::cartAuthorized(const QString &username,unsigned cartnum)
+{
+  RDUser *user=new RDUser(username);
+  bool ret=user->cartAuthorized(cartnum);
+
+  delete user;
+
+  return ret;
+}
+
+
+RDAudioConvert *RDLocalXport::exportConverter(unsigned cartnum,int cutnum,
+					      RDSettings *settings,
+					      int start_pt,int end_pt,
+					      bool enable_metadata,
+					      RDWaveData **wavedata,
+					      QString *rdxl,float *speed_ratio)
+{
+  *wavedata=NULL;
+  *rdxl="";
+  *speed_ratio=1.0;
+
+  if(enable_metadata) {
+    RDCart *cart=new RDCart(cartnum);
+    RDCut *cut=new RDCut(cartnum,cutnum);
+    *wavedata=new RDWaveData();
+    cart->getMetadata(*wavedata);
+    cut->getMetadata(*wavedata);
+    if(cart->enforceLength()) {
+      *speed_ratio=(float)cut->length()/(float)cart->forcedLength();
+    }
+    *rdxl=cart->xml(true,start_pt<0,settings,cutnum);
+    delete cut;
+    delete cart;
+  }
+
+  RDAudioConvert *conv=new RDAudioConvert();
+  conv->setSourceFile(RDCut::pathName(cartnum,cutnum));
+  conv->setDestinationSettings(settings);
+  conv->setDestinationWaveData(*wavedata);
+  conv->setDestinationRdxl(*rdxl);
+  conv->setRange(start_pt,end_pt);
+  conv->setSpeedRatio(*speed_ratio);
+
+  return conv;
+}
+
+
+void RDLocalXport::peakRange(RDWaveFile *wave,int start_pt,int end_pt,
+			     unsigned *first,unsigned *last)
+{
+  //
+  // Peak values are interleaved by channel, one per 1152 frame block.
+  //
+  unsigned chans=wave->getChannels();
+
+  *first=0;
+  *last=wave->energySize();
+  if(start_pt>=0) {
+    *first=chans*(unsigned)((uint64_t)start_pt*wave->getSamplesPerSec()/
+			    1152000);
+  }
+  if(end_pt>=0) {
+    *last=chans*(unsigned)(((uint64_t)end_pt*wave->getSamplesPerSec()+
+			    1151999)/1152000);
+  }
+  if(*last>wave->energySize()) {
+    *last=wave->energySize();
+  }
+  if(*first>*last) {
+    *first=*last;
+  }
+}
+
+
+void RDLocalXport::trimPoints(RDWaveFile *wave,int trim_level,
+			      int *start_pt,int *end_pt)
+{
+  *start_pt=wave->startTrim(REFERENCE_LEVEL-trim_level);
+  if(*start_pt>=0) {
+    *start_pt=(double)*start_pt*1000.0/(double)wave->getSamplesPerSec();
+  }
+  *end_pt=wave->endTrim(REFERENCE_LEVEL-trim_level);
+  if(*end_pt>=0) {
+    *end_pt=(double)*end_pt*1000.0/(double)wave->getSamplesPerSec();
+  }
+}
+
+
+RDSettings *RDLocalXport::importSettings(int channels,int normalization_level)
+{
+  RDLibraryConf *conf=new RDLibraryConf(rda->config()->stationName());
+  RDSettings *settings=new RDSettings();
+
+  switch(conf->defaultFormat()) {
+  case 0:
+    settings->setFormat(RDSettings::Pcm16);
+    break;
+
+  case 1:
+    settings->setFormat(RDSettings::MpegL2Wav);
+    break;
+
+  case 2:
+    settings->setFormat(RDSettings::Pcm24);
+    break;
+  }
+  settings->setChannels(channels);
+  settings->setSampleRate(rda->system()->sampleRate());
+  settings->setBitRate(channels*conf->defaultBitrate());
+  settings->setNormalizationLevel(normalization_level);
+  delete conf;
+
+  return settings;
+}
+
+
+RDAudioConvert::ErrorCode RDLocalXport::importAudio(const QString &srcfile,
+						    RDCart *cart,RDCut *cut,
+						    RDSettings *settings,
+						    bool use_metadata,
+						    int autotrim_level,
+						    const QString &username,
+						    const QString &src_hostname,
+						    bool move_source)
+{
+  QString dstfile=RDCut::pathName(cart->number(),cut->cutNumber());
+  RDWaveData wavedata;
+  QString hash;
+  unsigned msecs=0;
+  unsigned length_deviation=0;
+  RDAudioConvert::ErrorCode conv_err=RDAudioConvert::ErrorOk;
+
+  //
+  // Audio that is already in the format of the audio store goes in as is
+  //
+  if(RDLocalXport::PlaceCompliantFile(srcfile,dstfile,settings,move_source,
+				      &wavedata)) {
+    hash=RDSha1HashFile(dstfile);
+  }
+  else {
+    QString tmpfile=dstfile+QString::asprintf(".%d.import",getpid());
+    RDAudioConvert *conv=new RDAudioConvert();
+    conv->setSourceFile(srcfile);
+    conv->setDestinationFile(tmpfile);
+    conv->setDestinationSettings(settings);
+    conv->setDestinationHashing(true);
+    if((conv_err=conv->convert())!=RDAudioConvert::ErrorOk) {
+      delete conv;
+      unlink(tmpfile.toUtf8());
+      return conv_err;
+    }
+    wavedata=*(conv->sourceWaveData());
+    hash=conv->destinationSha1Hash();
+    delete conv;
+    if((!RDLocalXport::SetOwnership(tmpfile))||
+       (rename(tmpfile.toUtf8(),dstfile.toUtf8())!=0)) {
+      unlink(tmpfile.toUtf8());
+      return RDAudioConvert::ErrorInternal;
+    }
+    unlink((dstfile+".energy").toUtf8());
+  }
+
+  RDWaveFile *wave=new RDWaveFile(dstfile);
+  if(!wave->openWave()) {
+    delete wave;
+    return RDAudioConvert::ErrorInternal;
+  }
+  msecs=wave->getExtTimeLength();
+  delete wave;
+  cut->checkInRecording(rda->config()->stationName(),username,src_hostname,
+			settings,msecs);
+  if(use_metadata) {
+    cart->setMetadata(&wavedata);
+    cut->setMetadata(&wavedata);
+  }
+  if(autotrim_level!=0) {
+    cut->autoTrim(RDCut::AudioBoth,100*autotrim_level);
+  }
+  cart->updateLength();
+  cart->resetRotation();
+  cart->calculateAverageLength(&length_deviation);
+  cart->setLengthDeviation(length_deviation);
+  cut->setSha1Hash(hash);
+  RDAudioDedup *dedup=new RDAudioDedup(rda->config());
+  if(dedup->isEnabled()) {
+    dedup->dedup(cut->cutName(),hash);
+  }
+  delete dedup;
+  RDTranscodeCache *cache=new RDTranscodeCache(rda->config());
+  cache->invalidate(cart->number(),cut->cutNumber());
+  delete cache;
+
+  return RDAudioConvert::ErrorOk;
+}
+
+
+bool RDLocalXport::PlaceCompliantFile(const QString &srcfile,
+				      const QString &dstfile,
+				      RDSettings *settings,bool move_source,
+				      RDWaveData *wavedata)
+{
+  QString tmpfile=dstfile+QString::asprintf(".%d.import",getpid());
+  mode_t mode=S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH;
+  unsigned bits=0;
+  struct stat st;
+  bool ok=false;
+
+  switch(settings->format()) {
+  case RDSettings::Pcm16:
+    bits=16;
+    break;
+
+  case RDSettings::Pcm24:
+    bits=24;
+    break;
+
+  default:
+    return false;
+  }
+  if((settings->normalizationLevel()!=0)||
+     (stat(srcfile.toUtf8(),&st)!=0)) {
+    return false;
+  }
+
+  //
+  // Plain PCM WAV with the right parameters and a complete data chunk
+  //
+  RDWaveFile *wave=new RDWaveFile(srcfile);
+  if(wave->openWave(wavedata)) {
+    ok=(wave->type()==RDWaveFile::Wave)&&
+      (wave->getFormatTag()==WAVE_FORMAT_PCM)&&
+      (wave->getBitsPerSample()==bits)&&
+      (wave->getChannels()==settings->channels())&&
+      (wave->getSamplesPerSec()==settings->sampleRate())&&
+      (wave->getSampleLength()>0)&&
+      ((uint64_t)wave->getDataLength()==
+       (uint64_t)wave->getSampleLength()*wave->getChannels()*bits/8)&&
+      ((uint64_t)st.st_size>=(uint64_t)wave->getDataLength());
+  }
+  delete wave;
+  if(!ok) {
+    return false;
+  }
+
+  //
+  // Move it if the caller is done with it, otherwise reflink it; a full
+  // copy is no cheaper than going through the converter.
+  //
+  if(move_source&&RDLocalXport::SetOwnership(srcfile)) {
+    if(rename(srcfile.toUtf8(),dstfile.toUtf8())==0) {
+      unlink((dstfile+".energy").toUtf8());
+      return true;
+    }
+  }
+  unlink(tmpfile.toUtf8());
+  if(!RDAudioDedup::reflink(srcfile,tmpfile,mode)) {
+    return false;
+  }
+  if((!RDLocalXport::SetOwnership(tmpfile))||
+     (rename(tmpfile.toUtf8(),dstfile.toUtf8())!=0)) {
+    unlink(tmpfile.toUtf8());
+    return false;
+  }
+  unlink((dstfile+".energy").toUtf8());
+
+  return true;
+}
+
+
+bool RDLocalXport::SetOwnership(const QString &filename)
+{
+  //
+  // rdxport.cgi(8) rewrites audio (trims, re-imports, energy data) as the
+  // Rivendell user, so hand over anything that a caller running as root
+  // has put in the audio store
+  //
+  if(chown(filename.toUtf8(),rda->config()->uid(),rda->config()->gid())!=0) {
+    if(geteuid()!=rda->config()->uid()) {
+      return false;
+    }
+  }
+
+  return chmod(filename.toUtf8(),S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH)==0;
+}
@@ -0,0 +1,73 @@
+// rdlocalxport.h
+//
+// In-process implementations of Web API operations for a local audio store.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDLOCALXPORT_H
+#define RDLOCALXPORT_H
+
+#include <qstring.h>
+
+#include <rdaudioconvert.h>
+#include <rdcart.h>
+#include <rdconfig.h>
+#include <rdcut.h>
+#include <rdsettings.h>
+#include <rdstation.h>
+#include <rdwavedata.h>
+#include <rdwavefile.h>
+
+class RDLocalXport
+{
+ public:
+  static bool isLocalService(RDStation *station,RDConfig *config);
+  static bool isAvailable(RDStation *station,RDConfig *config,
+			  unsigned cartnum,int cutnum);
+  static bool isImportAvailable(RDStation *station,RDConfig *config,
+				unsigned cartnum,int cutnum);
+  static bool authenticate(const QString &username);
+  static bool cartAuthorized(const QString &username,unsigned cartnum);
+  static RDAudioConvert *exportConverter(unsigned cartnum,int cutnum,
+					 RDSettings *settings,
+					 int start_pt,int end_pt,
+					 bool enable_metadata,
+					 RDWaveData **wavedata,
+					 QString *rdxl,float *speed_ratio);
+  static void peakRange(RDWaveFile *wave,int start_pt,int end_pt,
+			unsigned *first,unsigned *last);
+  static void trimPoints(RDWaveFile *wave,int trim_level,
+			 int *start_pt,int *end_pt);
+  static RDSettings *importSettings(int channels,int normalization_level);
+  static RDAudioConvert::ErrorCode importAudio(const QString &srcfile,
+					       RDCart *cart,RDCut *cut,
+					       RDSettings *settings,
+					       bool use_metadata,
+					       int autotrim_level,
+					       const QString &username,
+					       const QString &src_hostname,
+					       bool move_source);
+
+ private:
+  static bool PlaceCompliantFile(const QString &srcfile,
+				 const QString &dstfile,RDSettings *settings,
+				 bool move_source,RDWaveData *wavedata);
+  static bool SetOwnership(const QString &filename);
+};
+
+
+#endif  // RDLOCALXPORT_H
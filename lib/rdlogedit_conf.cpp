@@ -43,6 +43,14 @@ RDLogeditConf::RDLogeditConf(const QString &station)
     q=new RDSqlQuery(sql);
   }
   delete q;
+  lib_snapshot=new RDRowSnapshot("RDLOGEDIT","STATION");
+  lib_snapshot->setFollowsWrites(false);
+}
+
+
+RDLogeditConf::~RDLogeditConf()
+{
+  delete lib_snapshot;
 }
 
 
@@ -52,15 +60,27 @@ QString RDLogeditConf::station() const
 }
 
 
+bool RDLogeditConf::snapshotEnabled() const
+{
+  return lib_snapshot->isEnabled();
+}
+
+
+void RDLogeditConf::setSnapshotEnabled(bool state)
+{
+  lib_snapshot->setEnabled(state);
+}
+
+
 int RDLogeditConf::inputCard() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"INPUT_CARD").toInt();
+  return lib_snapshot->value(lib_station,"INPUT_CARD").toInt();
 }
 
 
 int RDLogeditConf::inputPort() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"INPUT_PORT").toInt();
+  return lib_snapshot->value(lib_station,"INPUT_PORT").toInt();
 }
 
 
@@ -78,13 +98,13 @@ void RDLogeditConf::setInputPort(int input) const
 
 int RDLogeditConf::outputCard() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"OUTPUT_CARD").toInt();
+  return lib_snapshot->value(lib_station,"OUTPUT_CARD").toInt();
 }
 
 
 int RDLogeditConf::outputPort() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"OUTPUT_PORT").toInt();
+  return lib_snapshot->value(lib_station,"OUTPUT_PORT").toInt();
 }
 
 
@@ -102,7 +122,7 @@ void RDLogeditConf::setOutputPort(int output) const
 
 unsigned RDLogeditConf::format() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"FORMAT").toUInt();
+  return lib_snapshot->value(lib_station,"FORMAT").toUInt();
 }
 
 
@@ -114,7 +134,7 @@ void RDLogeditConf::setFormat(unsigned format) const
 
 unsigned RDLogeditConf::layer() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"LAYER").toUInt();
+  return lib_snapshot->value(lib_station,"LAYER").toUInt();
 }
 
 
@@ -126,7 +146,7 @@ void RDLogeditConf::setLayer(unsigned layer) const
 
 unsigned RDLogeditConf::bitrate() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"BITRATE").toUInt();
+  return lib_snapshot->value(lib_station,"BITRATE").toUInt();
 }
 
 
@@ -138,8 +158,8 @@ void RDLogeditConf::setBitrate(unsigned rate) const
 
 bool RDLogeditConf::enableSecondStart() const
 {
-  return RDBool(RDGetSqlValue("RDLOGEDIT","STATION",lib_station,
-			      "ENABLE_SECOND_START").toString());
+  return RDBool(lib_snapshot->value(lib_station,"ENABLE_SECOND_START").
+		toString());
 }
   
 
@@ -151,7 +171,7 @@ void RDLogeditConf::setEnableSecondStart(bool state) const
 
 unsigned RDLogeditConf::defaultChannels() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"DEFAULT_CHANNELS").toUInt();
+  return lib_snapshot->value(lib_station,"DEFAULT_CHANNELS").toUInt();
 }
 
 
@@ -163,7 +183,7 @@ void RDLogeditConf::setDefaultChannels(unsigned chans) const
 
 unsigned RDLogeditConf::maxLength() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"MAXLENGTH").toUInt();
+  return lib_snapshot->value(lib_station,"MAXLENGTH").toUInt();
 }
 
 
@@ -175,7 +195,7 @@ void RDLogeditConf::setMaxLength(unsigned length) const
 
 unsigned RDLogeditConf::tailPreroll() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"TAIL_PREROLL").
+  return lib_snapshot->value(lib_station,"TAIL_PREROLL").
     toUInt();
 }
 
@@ -188,7 +208,7 @@ void RDLogeditConf::setTailPreroll(unsigned length) const
 
 QString RDLogeditConf::waveformCaption() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"WAVEFORM_CAPTION").
+  return lib_snapshot->value(lib_station,"WAVEFORM_CAPTION").
     toString();
 }
 
@@ -201,7 +221,7 @@ void RDLogeditConf::setWaveformCaption(const QString &str)
 
 unsigned RDLogeditConf::startCart() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"START_CART").toUInt();
+  return lib_snapshot->value(lib_station,"START_CART").toUInt();
 }
 
 
@@ -213,7 +233,7 @@ void RDLogeditConf::setStartCart(unsigned cartnum) const
 
 unsigned RDLogeditConf::endCart() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"END_CART").toUInt();
+  return lib_snapshot->value(lib_station,"END_CART").toUInt();
 }
 
 
@@ -225,7 +245,7 @@ void RDLogeditConf::setEndCart(unsigned cartnum) const
 
 unsigned RDLogeditConf::recStartCart() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"REC_START_CART").
+  return lib_snapshot->value(lib_station,"REC_START_CART").
     toUInt();
 }
 
@@ -238,7 +258,7 @@ void RDLogeditConf::setRecStartCart(unsigned cartnum) const
 
 unsigned RDLogeditConf::recEndCart() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"REC_END_CART").
+  return lib_snapshot->value(lib_station,"REC_END_CART").
     toUInt();
 }
 
@@ -251,7 +271,7 @@ void RDLogeditConf::setRecEndCart(unsigned cartnum) const
 
 int RDLogeditConf::trimThreshold() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"TRIM_THRESHOLD").
+  return lib_snapshot->value(lib_station,"TRIM_THRESHOLD").
     toInt();
 }
 
@@ -264,7 +284,7 @@ void RDLogeditConf::setTrimThreshold(int level)
 
 int RDLogeditConf::ripperLevel() const
 {
-  return RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"RIPPER_LEVEL").
+  return lib_snapshot->value(lib_station,"RIPPER_LEVEL").
     toInt();
 }
 
@@ -277,8 +297,8 @@ void RDLogeditConf::setRipperLevel(int level)
 
 RDLogLine::TransType RDLogeditConf::defaultTransType() const
 {
-  return (RDLogLine::TransType)RDGetSqlValue("RDLOGEDIT","STATION",lib_station,
-					    "DEFAULT_TRANS_TYPE").toInt();
+  return (RDLogLine::TransType)lib_snapshot->
+    value(lib_station,"DEFAULT_TRANS_TYPE").toInt();
 }
 
 
@@ -330,7 +350,7 @@ void RDLogeditConf::getSettings(RDSettings *s) const
 
 bool RDLogeditConf::isSingleton() const
 {
-  return RDBool(RDGetSqlValue("RDLOGEDIT","STATION",lib_station,"IS_SINGLETON").
+  return RDBool(lib_snapshot->value(lib_station,"IS_SINGLETON").
 		toString());
 }
 
@@ -351,6 +371,7 @@ void RDLogeditConf::SetRow(const QString &param,int value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLOGEDIT");
 }
 
 
@@ -364,6 +385,7 @@ void RDLogeditConf::SetRow(const QString &param,unsigned value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'",
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLOGEDIT");
 }
 
 
@@ -377,6 +399,7 @@ void RDLogeditConf::SetRow(const QString &param,const QString &value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'",
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLOGEDIT");
 }
 
 
@@ -390,4 +413,5 @@ void RDLogeditConf::SetRow(const QString &param,bool value) const
     "`STATION`='"+RDEscapeString(lib_station)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDLOGEDIT");
 }
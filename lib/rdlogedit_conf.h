@@ -25,12 +25,16 @@
 
 #include <rdsettings.h>
 #include <rdlog_line.h>
+#include <rdrowsnapshot.h>
 
 class RDLogeditConf
 {
  public:
   RDLogeditConf(const QString &station);
+  ~RDLogeditConf();
   QString station() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   int inputCard() const;
   void setInputCard(int input) const;
   int inputPort() const;
@@ -79,6 +83,7 @@ class RDLogeditConf
   void SetRow(const QString &param,bool value) const;
   void SetRow(const QString &param,const QString &value) const;
   QString lib_station;
+  RDRowSnapshot *lib_snapshot;
 };
 
 
@@ -18,18 +18,24 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <stdlib.h>
+
+#include <QHash>
+
 #include "rdapplication.h"
 #include "rdconf.h"
 #include "rdescape_string.h"
 #include "rdlog.h"
 #include "rdlog_line.h"
 #include "rdlogmodel.h"
+#include "rdsqltransaction.h"
 
 RDLogModel::RDLogModel(const QString &logname,bool read_only,QObject *parent)
   : QAbstractTableModel(parent)
 {
   d_log_name=logname;
   d_read_only=read_only;
+  d_saved_lines_valid=false;
 
   MakeModel();
 }
@@ -39,6 +45,7 @@ RDLogModel::RDLogModel(QObject *parent)
   : QAbstractTableModel(parent)
 {
   d_read_only=false;
+  d_saved_lines_valid=false;
 
   MakeModel();
 }
@@ -251,6 +258,7 @@ void RDLogModel::setLogName(QString logname)
   RDLog *log=new RDLog(logname);
   d_log_name=log->name();  // So we normalize the case
   delete log;
+  d_saved_lines_valid=false;
 }
 
 
@@ -265,15 +273,15 @@ int RDLogModel::load(bool track_ptrs)
   RDLogLine line;
   QString sql;
   RDSqlQuery *q;
+  bool fresh=d_log_lines.size()==0;
 
   beginResetModel();
 
   //
   // Get the service name
   //
-  sql=QString("select `SERVICE` from `LOGS` where ")+
-    "`NAME`='"+RDEscapeString(d_log_name)+"'";
-  q=new RDSqlQuery(sql);
+  sql=QString("select `SERVICE` from `LOGS` where `NAME`=?");
+  q=new RDSqlQuery(sql,QVariantList()<<d_log_name,RDSqlQuery::Primary);
   if(q->next()) {
     d_service_name=q->value(0).toString();
   }
@@ -285,6 +293,17 @@ int RDLogModel::load(bool track_ptrs)
 
   LoadLines(d_log_name,0,track_ptrs);
 
+  //
+  // Lines left over from before (such as rdairplay's holdovers) aren't
+  // in the database under these positions
+  //
+  if(fresh) {
+    MarkSaved();
+  }
+  else {
+    d_saved_lines_valid=false;
+  }
+
   endResetModel();
 
   return d_log_lines.size();
@@ -307,32 +326,53 @@ void RDLogModel::save(RDConfig *config,bool update_tracks,int line)
   if(d_log_name.isEmpty()) {
     return;
   }
+  RDSqlTransaction trans(QStringList()<<"LOG_LINES"<<"LOGS");
   if(line<0) {
-    if(exists()) {
-      sql=QString("delete from `LOG_LINES` where ")+
-	"`LOG_NAME`='"+RDEscapeString(d_log_name)+"'";
-      RDSqlQuery::apply(sql);
-    }
-    if (d_log_lines.size() > 0) {
-       QString values = "";
-       for(int i=0;i<d_log_lines.size();i++) {
-         InsertLineValues(&values, i);
-        if (i<d_log_lines.size()-1) {
-           values += ",";
-         }
-       }
-       InsertLines(values);
+    //
+    // Write only what has changed since the lines were loaded or last
+    // saved, falling back to rewriting the whole log when we don't know
+    // what is in the database
+    //
+    if((!d_saved_lines_valid)||(!SaveChanges())) {
+      if(exists()) {
+	sql=QString("delete from `LOG_LINES` where `LOG_NAME`=?");
+	RDSqlQuery::apply(sql,QVariantList()<<d_log_name);
+      }
+
+      //
+      // Full-sized batches all share one statement
+      //
+      for(int i=0;i<d_log_lines.size();i+=RDLOGMODEL_INSERT_BATCH_SIZE) {
+	QString placeholders;
+	QVariantList values;
+	for(int j=i;(j<d_log_lines.size())&&
+	      (j<(i+RDLOGMODEL_INSERT_BATCH_SIZE));j++) {
+	  if(j>i) {
+	    placeholders+=",";
+	  }
+	  InsertLineValues(&placeholders,&values,j);
+	}
+	InsertLines(placeholders,values);
+      }
     }
+    MarkSaved();
   }
   else {
     sql=QString("delete from `LOG_LINES` where ")+
-      "`LOG_NAME`='"+RDEscapeString(d_log_name)+"' && "+
-      QString::asprintf("`COUNT`=%d",line);
-    q=new RDSqlQuery(sql);
+      "`LOG_NAME`=? && `COUNT`=?";
+    q=new RDSqlQuery(sql,QVariantList()<<d_log_name<<line);
     delete q;
     SaveLine(line);
     // BPM - Clear the modified flag
     d_log_lines[line]->clearModified();
+    if(d_saved_lines_valid) {
+      if(line<d_saved_lines.size()) {
+	d_saved_lines[line]=LineValues(line);
+      }
+      else {
+	d_saved_lines_valid=false;
+      }
+    }
   }
   RDLog *log=new RDLog(d_log_name);
   if(log->nextId()<nextId()) {
@@ -342,6 +382,7 @@ void RDLogModel::save(RDConfig *config,bool update_tracks,int line)
     log->updateTracks();
   }
   delete log;
+  trans.commit();
 }
 
 
@@ -363,6 +404,8 @@ void RDLogModel::clear()
   }
   d_log_name="";
   d_max_id=0;
+  d_saved_lines.clear();
+  d_saved_lines_valid=false;
 }
 
 
@@ -1063,7 +1106,6 @@ QString RDLogModel::StartTimeString(int line) const
 int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
 {
   RDLogLine line;
-  RDSqlQuery *q1;
   QString sql;
   RDSqlQuery *q;
   bool prev_custom=false;
@@ -1078,7 +1120,7 @@ int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
     "`NAME`,"+   // 00
     "`COLOR` "+  // 01
     "from `GROUPS`";
-  q=new RDSqlQuery(sql);
+  q=new RDSqlQuery(sql,RDSqlQuery::Primary);
   while(q->next()) {
     group_colors[q->value(0).toString()]=QColor(q->value(1).toString());
   }
@@ -1152,12 +1194,15 @@ int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
     "`CART`.`END_DATETIME`,"+            // 61
     "`LOG_LINES`.`EVENT_LENGTH`,"+       // 62
     "`CART`.`USE_EVENT_LENGTH`,"+        // 63
-    "`CART`.`NOTES` "+                   // 64
+    "`CART`.`NOTES`,"+                   // 64
+    "`CHAIN_LOGS`.`DESCRIPTION` "+       // 65
     "from `LOG_LINES` left join `CART` "+
-    "on `LOG_LINES`.`CART_NUMBER`=`CART`.`NUMBER` where "+
-    "`LOG_LINES`.`LOG_NAME`='"+RDEscapeString(logname)+"' "+
+    "on `LOG_LINES`.`CART_NUMBER`=`CART`.`NUMBER` "+
+    "left join `LOGS` as `CHAIN_LOGS` "+
+    "on `LOG_LINES`.`LABEL`=`CHAIN_LOGS`.`NAME` where "+
+    "`LOG_LINES`.`LOG_NAME`=? "+
     "order by `COUNT`";
-  q=new RDSqlQuery(sql);
+  q=new RDSqlQuery(sql,QVariantList()<<logname,RDSqlQuery::Primary);
   if(q->size()<=0) {
     delete q;
     return 0;
@@ -1330,13 +1375,9 @@ int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
       break;
 
     case RDLogLine::Chain:
-      sql=QString("select `DESCRIPTION` from `LOGS` where ")+
-	"`NAME`='"+RDEscapeString(line.markerLabel())+"'";
-      q1=new RDSqlQuery(sql);
-      if(q1->first()) {
-	line.setMarkerComment(q1->value(0).toString());
+      if(!q->value(65).isNull()) {                      // Chain Description
+	line.setMarkerComment(q->value(65).toString());
       }
-      delete q1;
       break;
 
     default:
@@ -1362,53 +1403,69 @@ int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
     // Load default cart pointers for "representative" cuts.  This is
     // really only useful when setting up a voice tracker.
     //
+    // The first cut of every cart in the log comes back from one query,
+    // rather than one query per line.
+    //
+    QHash<unsigned,QVariantList> first_cuts;
+    sql=QString("select ")+
+      "`CART_NUMBER`,"+        // 00
+      "`START_POINT`,"+        // 01
+      "`END_POINT`,"+          // 02
+      "`SEGUE_START_POINT`,"+  // 03
+      "`SEGUE_END_POINT`,"+    // 04
+      "`TALK_START_POINT`,"+   // 05
+      "`TALK_END_POINT`,"+     // 06
+      "`HOOK_START_POINT`,"+   // 07
+      "`HOOK_END_POINT`,"+     // 08
+      "`FADEUP_POINT`,"+       // 09
+      "`FADEDOWN_POINT`,"+     // 10
+      "`CUT_NAME`,"+           // 11
+      "`ORIGIN_NAME`,"+        // 12
+      "`ORIGIN_DATETIME`,"+    // 13
+      "`DESCRIPTION`,"+        // 14
+      "`ISRC`,"+               // 15
+      "`ISCI`,"+               // 16
+      "`RECORDING_MBID`,"+     // 17
+      "`RELEASE_MBID` "+       // 18
+      "from `CUTS` where "+
+      "`CART_NUMBER` in (select `CART_NUMBER` from `LOG_LINES` "+
+      "where `LOG_NAME`=?) "+
+      "order by `CART_NUMBER`,`CUT_NAME`";
+    q=new RDSqlQuery(sql,QVariantList()<<logname,RDSqlQuery::Primary);
+    while(q->next()) {
+      unsigned cartnum=q->value(0).toUInt();
+      if(!first_cuts.contains(cartnum)) {
+	QVariantList values;
+	for(int i=0;i<19;i++) {
+	  values.push_back(q->value(i));
+	}
+	first_cuts[cartnum]=values;
+      }
+    }
+    delete q;
     for(int i=start_line;i<lineCount();i++) {
       RDLogLine *ll=logLine(i);
-      if(ll->cartType()==RDCart::Audio) {
-	sql=QString("select ")+
-	  "`START_POINT`,"+        // 00
-	  "`END_POINT`,"+          // 01
-	  "`SEGUE_START_POINT`,"+  // 02
-	  "`SEGUE_END_POINT`,"+    // 03
-	  "`TALK_START_POINT`,"+   // 04
-	  "`TALK_END_POINT`,"+     // 05
-	  "`HOOK_START_POINT`,"+   // 06
-	  "`HOOK_END_POINT`,"+     // 07
-	  "`FADEUP_POINT`,"+       // 08
-	  "`FADEDOWN_POINT`,"+     // 09
-	  "`CUT_NAME`,"+           // 10
-	  "`ORIGIN_NAME`,"+        // 11
-	  "`ORIGIN_DATETIME`,"+    // 12
-	  "`DESCRIPTION`,"+        // 13
-	  "`ISRC`,"+               // 14
-	  "`ISCI`,"+               // 15
-	  "`RECORDING_MBID`,"+     // 16
-	  "`RELEASE_MBID` "+       // 17
-	  "from `CUTS` where "+
-	  QString::asprintf("`CART_NUMBER`=%u ",ll->cartNumber())+
-	  "order by `CUT_NAME`";
-	q=new RDSqlQuery(sql);
-	if(q->first()) {
-	  ll->setStartPoint(q->value(0).toInt(),RDLogLine::CartPointer);
-	  ll->setEndPoint(q->value(1).toInt(),RDLogLine::CartPointer);
-	  ll->setSegueStartPoint(q->value(2).toInt(),RDLogLine::CartPointer);
-	  ll->setSegueEndPoint(q->value(3).toInt(),RDLogLine::CartPointer);
-	  ll->setTalkStartPoint(q->value(4).toInt());
-	  ll->setTalkEndPoint(q->value(5).toInt());
-	  ll->setHookStartPoint(q->value(6).toInt());
-	  ll->setHookEndPoint(q->value(7).toInt());
-	  ll->setFadeupPoint(q->value(8).toInt(),RDLogLine::CartPointer);
-	  ll->setFadedownPoint(q->value(9).toInt(),RDLogLine::CartPointer);
-	  ll->setCutNumber(RDCut::cutNumber(q->value(10).toString()));
-	  ll->setOriginUser(q->value(11).toString());
-	  ll->setOriginDateTime(q->value(12).toDateTime());
-	  ll->setDescription(q->value(13).toString());
-	  ll->setIsrc(q->value(14).toString());
-	  ll->setIsci(q->value(15).toString());
-	  ll->setRecordingMbId(q->value(16).toString());
-	  ll->setReleaseMbId(q->value(17).toString());
-	}
-	delete q;
+      if((ll->cartType()==RDCart::Audio)&&
+	 first_cuts.contains(ll->cartNumber())) {
+	const QVariantList &cut=first_cuts[ll->cartNumber()];
+	ll->setStartPoint(cut.at(1).toInt(),RDLogLine::CartPointer);
+	ll->setEndPoint(cut.at(2).toInt(),RDLogLine::CartPointer);
+	ll->setSegueStartPoint(cut.at(3).toInt(),RDLogLine::CartPointer);
+	ll->setSegueEndPoint(cut.at(4).toInt(),RDLogLine::CartPointer);
+	ll->setTalkStartPoint(cut.at(5).toInt());
+	ll->setTalkEndPoint(cut.at(6).toInt());
+	ll->setHookStartPoint(cut.at(7).toInt());
+	ll->setHookEndPoint(cut.at(8).toInt());
+	ll->setFadeupPoint(cut.at(9).toInt(),RDLogLine::CartPointer);
+	ll->setFadedownPoint(cut.at(10).toInt(),RDLogLine::CartPointer);
+	ll->setCutNumber(RDCut::cutNumber(cut.at(11).toString()));
+	ll->setOriginUser(cut.at(12).toString());
+	ll->setOriginDateTime(cut.at(13).toDateTime());
+	ll->setDescription(cut.at(14).toString());
+	ll->setIsrc(cut.at(15).toString());
+	ll->setIsci(cut.at(16).toString());
+	ll->setRecordingMbId(cut.at(17).toString());
+	ll->setReleaseMbId(cut.at(18).toString());
       }
     }
   }
@@ -1417,9 +1474,10 @@ int RDLogModel::LoadLines(const QString &logname,int id_offset,bool track_ptrs)
 }
 
 
-void RDLogModel::InsertLines(QString values) {
+bool RDLogModel::InsertLines(const QString &placeholders,
+			     const QVariantList &values)
+{
   QString sql;
-  RDSqlQuery *q;
 
   sql = QString("insert into LOG_LINES (")+
     "`LOG_NAME`,"+           // 00
@@ -1461,64 +1519,250 @@ void RDLogModel::InsertLines(QString values) {
     "`DUCK_UP_GAIN`,"+       // 36
     "`DUCK_DOWN_GAIN`,"+     // 37
     "`EVENT_LENGTH`) "+      // 38
-    "values "+values;
-  q=new RDSqlQuery(sql);
-  delete q;
+    "values "+placeholders;
+
+  return RDSqlQuery::apply(sql,values);
+}
+
+
+void RDLogModel::InsertLineValues(QString *placeholders,QVariantList *values,
+				  int line)
+{
+  *placeholders+="(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,"
+    "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+  *values+=LineValues(line);
 }
 
 
-void RDLogModel::InsertLineValues(QString *query, int line)
+bool RDLogModel::SaveChanges()
+{
+  QString sql;
+  int prefix=0;
+  int suffix=0;
+  int shift=d_log_lines.size()-d_saved_lines.size();
+  int common=0;
+  QList<int> changed;
+  int statements=0;
+  bool ok=true;
+
+  //
+  // Lines that are unchanged at the start and (save for their COUNT) at
+  // the end stay where they are, so that an insert or delete only writes
+  // the lines between them and then moves the tail with one statement
+  //
+  while((prefix<d_log_lines.size())&&(prefix<d_saved_lines.size())&&
+	(LineValues(prefix)==d_saved_lines.at(prefix))) {
+    prefix++;
+  }
+  while(((prefix+suffix)<d_log_lines.size())&&
+	((prefix+suffix)<d_saved_lines.size())) {
+    QVariantList values=LineValues(d_log_lines.size()-suffix-1);
+    QVariantList saved=d_saved_lines.at(d_saved_lines.size()-suffix-1);
+    values.removeAt(2);  // COUNT
+    saved.removeAt(2);
+    if(values!=saved) {
+      break;
+    }
+    suffix++;
+  }
+  if((shift==0)&&(prefix==d_log_lines.size())) {
+    return true;
+  }
+
+  //
+  // Rows in between are matched by position, so that an existing row
+  // never has its COUNT changed (which the unique index on LOG_NAME and
+  // COUNT would trip over part way through)
+  //
+  common=d_saved_lines.size()-suffix;
+  if((d_log_lines.size()-suffix)<common) {
+    common=d_log_lines.size()-suffix;
+  }
+  for(int i=prefix;i<common;i++) {
+    if(LineValues(i)!=d_saved_lines.at(i)) {
+      changed.push_back(i);
+    }
+  }
+
+  //
+  // Past the point where that costs more than writing the whole log out
+  // again, have the caller do that instead
+  //
+  statements=changed.size();
+  if(shift!=0) {
+    statements+=1+(abs(shift)+RDLOGMODEL_INSERT_BATCH_SIZE-1)/
+      RDLOGMODEL_INSERT_BATCH_SIZE;
+  }
+  if(statements>(1+(d_log_lines.size()+RDLOGMODEL_INSERT_BATCH_SIZE-1)/
+		 RDLOGMODEL_INSERT_BATCH_SIZE)) {
+    return false;
+  }
+
+  RDSqlTransaction trans;
+  if(!trans.isActive()) {
+    return false;
+  }
+  sql=QString("update `LOG_LINES` set ")+
+    "`LINE_ID`=?,"+            // 01
+    "`CART_NUMBER`=?,"+        // 03
+    "`START_TIME`=?,"+         // 04
+    "`TIME_TYPE`=?,"+          // 05
+    "`TRANS_TYPE`=?,"+         // 06
+    "`START_POINT`=?,"+        // 07
+    "`END_POINT`=?,"+          // 08
+    "`SEGUE_START_POINT`=?,"+  // 09
+    "`SEGUE_END_POINT`=?,"+    // 10
+    "`TYPE`=?,"+               // 11
+    "`COMMENT`=?,"+            // 12
+    "`LABEL`=?,"+              // 13
+    "`GRACE_TIME`=?,"+         // 14
+    "`SOURCE`=?,"+             // 15
+    "`EXT_START_TIME`=?,"+     // 16
+    "`EXT_LENGTH`=?,"+         // 17
+    "`EXT_DATA`=?,"+           // 18
+    "`EXT_EVENT_ID`=?,"+       // 19
+    "`EXT_ANNC_TYPE`=?,"+      // 20
+    "`EXT_CART_NAME`=?,"+      // 21
+    "`FADEUP_POINT`=?,"+       // 22
+    "`FADEUP_GAIN`=?,"+        // 23
+    "`FADEDOWN_POINT`=?,"+     // 24
+    "`FADEDOWN_GAIN`=?,"+      // 25
+    "`SEGUE_GAIN`=?,"+         // 26
+    "`LINK_EVENT_NAME`=?,"+    // 27
+    "`LINK_START_TIME`=?,"+    // 28
+    "`LINK_LENGTH`=?,"+        // 29
+    "`LINK_ID`=?,"+            // 30
+    "`LINK_EMBEDDED`=?,"+      // 31
+    "`ORIGIN_USER`=?,"+        // 32
+    "`ORIGIN_DATETIME`=?,"+    // 33
+    "`LINK_START_SLOP`=?,"+    // 34
+    "`LINK_END_SLOP`=?,"+      // 35
+    "`DUCK_UP_GAIN`=?,"+       // 36
+    "`DUCK_DOWN_GAIN`=?,"+     // 37
+    "`EVENT_LENGTH`=? "+       // 38
+    "where `LOG_NAME`=? && `COUNT`=?";
+  for(int i=0;(i<changed.size())&&ok;i++) {
+    QVariantList values=LineValues(changed.at(i));
+    values.removeAt(2);  // COUNT
+    values.removeAt(0);  // LOG_NAME
+    values<<d_log_name<<changed.at(i);
+    ok=RDSqlQuery::apply(sql,values);
+  }
+
+  //
+  // Lines removed
+  //
+  if(ok&&(shift<0)) {
+    sql=QString("delete from `LOG_LINES` where ")+
+      "`LOG_NAME`=? && `COUNT`>=? && `COUNT`<?";
+    ok=RDSqlQuery::apply(sql,QVariantList()<<d_log_name<<common<<
+			 d_saved_lines.size()-suffix);
+  }
+
+  //
+  // Move the tail, starting from the end it is moving towards
+  //
+  if(ok&&(shift!=0)&&(suffix>0)) {
+    sql=QString("update `LOG_LINES` set `COUNT`=`COUNT`+? where ")+
+      "`LOG_NAME`=? && `COUNT`>=? order by `COUNT`";
+    if(shift>0) {
+      sql+=" desc";
+    }
+    ok=RDSqlQuery::apply(sql,QVariantList()<<shift<<d_log_name<<
+			 d_saved_lines.size()-suffix);
+  }
+
+  //
+  // Lines added
+  //
+  for(int i=common;(i<(d_log_lines.size()-suffix))&&ok;
+      i+=RDLOGMODEL_INSERT_BATCH_SIZE) {
+    QString placeholders;
+    QVariantList values;
+    for(int j=i;(j<(d_log_lines.size()-suffix))&&
+	  (j<(i+RDLOGMODEL_INSERT_BATCH_SIZE));j++) {
+      if(j>i) {
+	placeholders+=",";
+      }
+      InsertLineValues(&placeholders,&values,j);
+    }
+    ok=InsertLines(placeholders,values);
+  }
+
+  if(ok) {
+    ok=trans.commit();
+  }
+
+  return ok;
+}
+
+
+QVariantList RDLogModel::LineValues(int line) const
 {
-  // one line to save query space
   RDLogLine *ll=d_log_lines[line];
-  QString sql=QString("(")+
-    "'"+RDEscapeString(d_log_name)+"',"+
-    QString::asprintf("%d,",ll->id())+
-    QString::asprintf("%d,",line)+
-    QString::asprintf("%u,",ll->cartNumber())+
-    QString::asprintf("%d,",QTime(0,0,0).msecsTo(ll->startTime(RDLogLine::Logged)))+
-    QString::asprintf("%d,",ll->timeType())+
-    QString::asprintf("%d,",ll->transType())+
-    QString::asprintf("%d,",ll->startPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->endPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->segueStartPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->segueEndPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->type())+
-    "'"+RDEscapeString(ll->markerComment())+"',"+
-    "'"+RDEscapeString(ll->markerLabel())+"',"+
-    QString::asprintf("%d,",ll->graceTime())+
-    QString::asprintf("%d,",ll->source())+
-    RDCheckDateTime(ll->extStartTime(),"hh:mm:ss")+","+
-    QString::asprintf("%d,",ll->extLength())+
-    "'"+RDEscapeString(ll->extData())+"',"+
-    "'"+RDEscapeString(ll->extEventId())+"',"+
-    "'"+RDEscapeString(ll->extAnncType())+"',"+
-    "'"+RDEscapeString(ll->extCartName())+"',"+
-    QString::asprintf("%d,",ll->fadeupPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->fadeupGain())+
-    QString::asprintf("%d,",ll->fadedownPoint(RDLogLine::LogPointer))+
-    QString::asprintf("%d,",ll->fadedownGain())+
-    QString::asprintf("%d,",ll->segueGain())+
-    "'"+RDEscapeString(ll->linkEventName())+"',"+
-    QString::asprintf("%d,",QTime(0,0,0).msecsTo(ll->linkStartTime()))+
-    QString::asprintf("%d,",ll->linkLength())+
-    QString::asprintf("%d,",ll->linkId())+
-    "'"+RDYesNo(ll->linkEmbedded())+"',"+
-    "'"+RDEscapeString(ll->originUser())+"',"+
-    RDCheckDateTime(ll->originDateTime(),"yyyy-MM-dd hh:mm:ss")+","+
-    QString::asprintf("%d,",ll->linkStartSlop())+
-    QString::asprintf("%d,",ll->linkEndSlop())+
-    QString::asprintf("%d,",ll->duckUpGain())+
-    QString::asprintf("%d,",ll->duckDownGain())+
-    QString::asprintf("%d)",ll->eventLength());
-  *query += sql;
+  QVariantList ret;
+
+  ret<<d_log_name<<
+    ll->id()<<
+    line<<
+    ll->cartNumber()<<
+    QTime(0,0,0).msecsTo(ll->startTime(RDLogLine::Logged))<<
+    (int)ll->timeType()<<
+    (int)ll->transType()<<
+    ll->startPoint(RDLogLine::LogPointer)<<
+    ll->endPoint(RDLogLine::LogPointer)<<
+    ll->segueStartPoint(RDLogLine::LogPointer)<<
+    ll->segueEndPoint(RDLogLine::LogPointer)<<
+    (int)ll->type()<<
+    ll->markerComment()<<
+    ll->markerLabel()<<
+    ll->graceTime()<<
+    (int)ll->source()<<
+    RDBindDateTime(ll->extStartTime(),"hh:mm:ss")<<
+    ll->extLength()<<
+    ll->extData()<<
+    ll->extEventId()<<
+    ll->extAnncType()<<
+    ll->extCartName()<<
+    ll->fadeupPoint(RDLogLine::LogPointer)<<
+    ll->fadeupGain()<<
+    ll->fadedownPoint(RDLogLine::LogPointer)<<
+    ll->fadedownGain()<<
+    ll->segueGain()<<
+    ll->linkEventName()<<
+    QTime(0,0,0).msecsTo(ll->linkStartTime())<<
+    ll->linkLength()<<
+    ll->linkId()<<
+    RDYesNo(ll->linkEmbedded())<<
+    ll->originUser()<<
+    RDBindDateTime(ll->originDateTime(),"yyyy-MM-dd hh:mm:ss")<<
+    ll->linkStartSlop()<<
+    ll->linkEndSlop()<<
+    ll->duckUpGain()<<
+    ll->duckDownGain()<<
+    ll->eventLength();
+
+  return ret;
+}
+
+
+void RDLogModel::MarkSaved()
+{
+  d_saved_lines.clear();
+  for(int i=0;i<d_log_lines.size();i++) {
+    d_saved_lines.push_back(LineValues(i));
+  }
+  d_saved_lines_valid=true;
 }
 
+
 void RDLogModel::SaveLine(int line)
 {
-  QString values = "";
-  InsertLineValues(&values, line);
-  InsertLines(values);
+  QString placeholders;
+  QVariantList values;
+
+  InsertLineValues(&placeholders,&values,line);
+  InsertLines(placeholders,values);
 }
 
 
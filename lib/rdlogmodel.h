@@ -26,10 +26,16 @@
 #include <QFontMetrics>
 #include <QList>
 #include <QPalette>
+#include <QVariantList>
 
 #include <rdlog_line.h>
 #include <rdnotification.h>
 
+//
+// Maximum number of lines written by a single INSERT when saving a log
+//
+#define RDLOGMODEL_INSERT_BATCH_SIZE 250
+
 class RDLogModel : public QAbstractTableModel
 {
   Q_OBJECT
@@ -103,8 +109,11 @@ class RDLogModel : public QAbstractTableModel
   QString StartTimeString(int line) const;
   int LoadLines(const QString &logname,int id_offset,bool track_ptrs);
   void SaveLine(int line);
-  void InsertLines(QString values);
-  void InsertLineValues(QString *query, int line);
+  bool InsertLines(const QString &placeholders,const QVariantList &values);
+  void InsertLineValues(QString *placeholders,QVariantList *values,int line);
+  bool SaveChanges();
+  QVariantList LineValues(int line) const;
+  void MarkSaved();
   void MakeModel();
   QPalette d_palette;
   QFont d_font;
@@ -120,6 +129,8 @@ class RDLogModel : public QAbstractTableModel
   int d_max_id;
   bool d_read_only;
   QList<RDLogLine *> d_log_lines;
+  QList<QVariantList> d_saved_lines;
+  bool d_saved_lines_valid;
 };
 
 
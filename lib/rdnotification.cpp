@@ -130,6 +130,10 @@ bool RDNotification::read(const QString &str)
 	  notify_id=QVariant(args[3].toInt());
 	  break;
 
+	case RDNotification::ConfigType:
+	  notify_id=QVariant(args[3]);
+	  break;
+
 	case RDNotification::NullType:
 	case RDNotification::LastType:
 	  break;
@@ -194,6 +198,10 @@ QString RDNotification::write() const
     ret+=QString::asprintf("%d",notify_id.toInt());
     break;
 
+  case RDNotification::ConfigType:
+    ret+=notify_id.toString();
+    break;
+
   case RDNotification::NullType:
   case RDNotification::LastType:
     break;
@@ -271,6 +279,10 @@ QString RDNotification::typeString(RDNotification::Type type)
     ret="EXTENDED_PANEL_BUTTON";
     break;
 
+  case RDNotification::ConfigType:
+    ret="CONFIG";
+    break;
+
   case RDNotification::NullType:
   case RDNotification::LastType:
     break;
@@ -30,9 +30,12 @@
 #include <curl/curl.h>
 
 #include "rd.h"
+#include "rdcurlpool.h"
 #include "rdapplication.h"
+#include "rdcut.h"
 #include "rdxport_interface.h"
 #include "rdformpost.h"
+#include "rdlocalxport.h"
 #include "rdpeaksexport.h"
 
 //
@@ -65,6 +68,8 @@ RDPeaksExport::RDPeaksExport(QObject *parent)
 {
   conv_cart_number=0;
   conv_cut_number=0;
+  conv_start_point=-1;
+  conv_end_point=-1;
   conv_energy_data=NULL;
   conv_write_ptr=0;
 }
@@ -82,6 +87,13 @@ void RDPeaksExport::setCutNumber(unsigned cutnum)
 }
 
 
+void RDPeaksExport::setRange(int start_pt,int end_pt)
+{
+  conv_start_point=start_pt;
+  conv_end_point=end_pt;
+}
+
+
 RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
 						  const QString &password)
 {
@@ -91,6 +103,11 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
   struct curl_httppost *first=NULL;
   struct curl_httppost *last=NULL;
 
+  if(RDLocalXport::isAvailable(rda->station(),rda->config(),
+			       conv_cart_number,conv_cut_number)) {
+    return RunLocal(username);
+  }
+
   //
   // Generate POST Data
   //
@@ -113,7 +130,19 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_cut_number).toUtf8().constData(),
 	       CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if(conv_start_point>=0) {
+    curl_formadd(&first,&last,CURLFORM_PTRNAME,"START_POINT",
+		 CURLFORM_COPYCONTENTS,
+		 QString::asprintf("%d",conv_start_point).toUtf8().constData(),
+		 CURLFORM_END);
+  }
+  if(conv_end_point>=0) {
+    curl_formadd(&first,&last,CURLFORM_PTRNAME,"END_POINT",
+		 CURLFORM_COPYCONTENTS,
+		 QString::asprintf("%d",conv_end_point).toUtf8().constData(),
+		 CURLFORM_END);
+  }
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDPeaksExport::ErrorInternal;
   }
@@ -129,12 +158,12 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
 		   rda->config()->userAgent().toUtf8().constData());
   //curl_easy_setopt(curl,CURLOPT_VERBOSE,1);
 
-  switch((curl_err=curl_easy_perform(curl))) {
+  switch((curl_err=RDCurlPool::perform(curl))) {
   case CURLE_OK:
     break;
 
   case CURLE_ABORTED_BY_CALLBACK:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDPeaksExport::ErrorAborted;
 
@@ -148,7 +177,7 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDPeaksExport::ErrorInternal;
 
@@ -156,12 +185,12 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:  // CURLE_REMOTE_ACCESS_DENIED
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDPeaksExport::ErrorUrlInvalid;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
     curl_formfree(first);
 
   switch(response_code) {
@@ -178,6 +207,42 @@ RDPeaksExport::ErrorCode RDPeaksExport::runExport(const QString &username,
 }
 
 
+RDPeaksExport::ErrorCode RDPeaksExport::RunLocal(const QString &username)
+{
+  unsigned first=0;
+  unsigned last=0;
+
+  if(!RDLocalXport::authenticate(username)) {
+    return RDPeaksExport::ErrorInvalidUser;
+  }
+  if(!RDLocalXport::cartAuthorized(username,conv_cart_number)) {
+    return RDPeaksExport::ErrorNoSource;
+  }
+  RDWaveFile *wave=
+    new RDWaveFile(RDCut::pathName(conv_cart_number,conv_cut_number));
+  if(!wave->openWave()) {
+    delete wave;
+    return RDPeaksExport::ErrorNoSource;
+  }
+  if(!wave->hasEnergy()) {
+    delete wave;
+    return RDPeaksExport::ErrorService;
+  }
+  RDLocalXport::peakRange(wave,conv_start_point,conv_end_point,&first,&last);
+  unsigned bytes=sizeof(unsigned short)*(last-first);
+  conv_energy_data=
+    (unsigned short *)realloc(conv_energy_data,conv_write_ptr+bytes);
+  for(unsigned i=first;i<last;i++) {
+    conv_energy_data[conv_write_ptr/sizeof(unsigned short)+i-first]=
+      wave->energy(i);
+  }
+  conv_write_ptr+=bytes;
+  delete wave;
+
+  return RDPeaksExport::ErrorOk;
+}
+
+
 QString RDPeaksExport::errorText(RDPeaksExport::ErrorCode err)
 {
   QString ret=QString::asprintf("Unknown RDPeaksExport Error [%u]",err);
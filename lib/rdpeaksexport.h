@@ -35,6 +35,7 @@ class RDPeaksExport
   ~RDPeaksExport();
   void setCartNumber(unsigned cartnum);
   void setCutNumber(unsigned cutnum);
+  void setRange(int start_pt,int end_pt);
   RDPeaksExport::ErrorCode runExport(const QString &username,
 				     const QString &password);
   unsigned energySize();
@@ -43,8 +44,11 @@ class RDPeaksExport
   static QString errorText(RDPeaksExport::ErrorCode err);
 
  private:
+  RDPeaksExport::ErrorCode RunLocal(const QString &username);
   unsigned conv_cart_number;
   unsigned conv_cut_number;
+  int conv_start_point;
+  int conv_end_point;
   unsigned short *conv_energy_data;
   unsigned conv_write_ptr;
   friend size_t RDPeaksExportWrite(void *ptr, size_t size, size_t nmemb, 
@@ -22,6 +22,7 @@
 
 #include "rdapplication.h"
 #include "rdconf.h"
+#include "rdcurlpool.h"
 #include "rddb.h"
 #include "rddelete.h"
 #include "rdescape_string.h"
@@ -395,7 +396,7 @@ bool RDPodcast::removePodcast() const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -414,8 +415,8 @@ bool RDPodcast::removePodcast() const
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -425,7 +426,7 @@ bool RDPodcast::removePodcast() const
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -485,7 +486,7 @@ bool RDPodcast::DeletePodcast(unsigned cast_id) const
   //
   // Set up the transfer
   //
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return false;
   }
@@ -504,8 +505,8 @@ bool RDPodcast::DeletePodcast(unsigned cast_id) const
   //
   // Send it
   //
-  if((curl_err=curl_easy_perform(curl))!=CURLE_OK) {
-    curl_easy_cleanup(curl);
+  if((curl_err=RDCurlPool::perform(curl))!=CURLE_OK) {
+    RDCurlPool::release(curl);
     curl_formfree(first);
     ProcessCurlLogging("RDFeed::postPodcast()",err_msgs);
     return false;
@@ -515,7 +516,7 @@ bool RDPodcast::DeletePodcast(unsigned cast_id) const
   // Clean up
   //
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   //
@@ -24,7 +24,27 @@
 RDPortNames::RDPortNames(const QString &station_name)
 {
   d_station_name=station_name;
+  reload();
+}
+
+
+QString RDPortNames::stationName() const
+{
+  return d_station_name;
+}
+
+
+QString RDPortNames::portName(int card,int port) const
+{
+  if((card<0)||(port<0)) {
+    return QString("----");
+  }
+  return d_port_names[card][port];
+}
+
 
+void RDPortNames::reload()
+{
   QString sql;
   RDSqlQuery *q=NULL;
 
@@ -45,18 +65,3 @@ RDPortNames::RDPortNames(const QString &station_name)
   }
   delete q;
 }
-
-
-QString RDPortNames::stationName() const
-{
-  return d_station_name;
-}
-
-
-QString RDPortNames::portName(int card,int port) const
-{
-  if((card<0)||(port<0)) {
-    return QString("----");
-  }
-  return d_port_names[card][port];
-}
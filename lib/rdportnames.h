@@ -31,6 +31,7 @@ class RDPortNames
   RDPortNames(const QString &station_name);
   QString stationName() const;
   QString portName(int card,int port) const;
+  void reload();
 
  private:
   QString d_port_names[RD_MAX_CARDS][RD_MAX_PORTS];
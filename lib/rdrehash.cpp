@@ -31,6 +31,7 @@
 #include <qstringlist.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdxport_interface.h>
 #include <rdformpost.h>
 #include <rdrehash.h>
@@ -94,7 +95,7 @@ RDRehash::ErrorCode RDRehash::runRehash(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_cut_number).toUtf8().constData(),
 	       CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDRehash::ErrorInternal;
   }
@@ -107,7 +108,7 @@ RDRehash::ErrorCode RDRehash::runRehash(const QString &username,
 		   conv_config->userAgent().toUtf8().constData());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
 
-  switch(curl_err=curl_easy_perform(curl)) {
+  switch(curl_err=RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
@@ -120,7 +121,7 @@ RDRehash::ErrorCode RDRehash::runRehash(const QString &username,
   case CURLE_OUT_OF_MEMORY:
   case CURLE_OPERATION_TIMEDOUT:
   case CURLE_HTTP_POST_ERROR:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     fprintf(stderr,"curl error: %d\n",curl_err);
     return RDRehash::ErrorInternal;
@@ -129,16 +130,16 @@ RDRehash::ErrorCode RDRehash::runRehash(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDRehash::ErrorUrlInvalid;
 
   default:
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     return RDRehash::ErrorService;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   switch(response_code) {
@@ -76,6 +76,12 @@ bool RDRipc::onairFlag() const
 }
 
 
+bool RDRipc::isConnected() const
+{
+  return ripc_socket->state()==QAbstractSocket::ConnectedState;
+}
+
+
 void RDRipc::setUser(QString user)
 {
   SendCommand(QString("SU ")+user+"!");
@@ -0,0 +1,216 @@
+// rdrowsnapshot.cpp
+//
+// Serve column values for one database row from a single fetch.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <QHash>
+#include <QMutex>
+
+#include "rdapplication.h"
+#include "rdconf.h"
+#include "rddb.h"
+#include "rdrowsnapshot.h"
+
+static QHash<QString,uint64_t> __rd_row_snapshot_generations;
+static QMutex __rd_row_snapshot_mutex;
+
+RDRowSnapshot::RDRowSnapshot(const QString &table,const QString &key_field)
+{
+  row_table=table;
+  row_key_field=key_field;
+  row_enabled=false;
+  row_follows_writes=true;
+  row_loaded=false;
+  row_write_count=0;
+  row_generation=0;
+}
+
+
+bool RDRowSnapshot::isEnabled() const
+{
+  return row_enabled;
+}
+
+
+void RDRowSnapshot::setEnabled(bool state)
+{
+  row_enabled=state;
+  if(!state) {
+    invalidate();
+  }
+}
+
+
+bool RDRowSnapshot::followsWrites() const
+{
+  return row_follows_writes;
+}
+
+
+void RDRowSnapshot::setFollowsWrites(bool state)
+{
+  row_follows_writes=state;
+}
+
+
+QVariant RDRowSnapshot::value(const QString &key,const QString &field,
+			      bool *valid)
+{
+  RDSqlQuery *q=NULL;
+  QString sql;
+
+  if(row_key_field.isEmpty()) {
+    if(!row_enabled) {
+      QVariant ret;
+      sql=QString("select `")+field+"` from `"+row_table+"`";
+      q=new RDSqlQuery(sql,RDSqlQuery::Primary);
+      if(q->first()) {
+	ret=q->value(0);
+      }
+      if(valid!=NULL) {
+	*valid=q->isValid()&&(!q->isNull(0));
+      }
+      delete q;
+      return ret;
+    }
+    if(!IsCurrent(key)) {
+      sql=QString("select * from `")+row_table+"` limit 1";
+      q=new RDSqlQuery(sql,RDSqlQuery::Primary);
+      if(q->first()) {
+	setRecord(key,q->record());
+      }
+      else {
+	setRecord(key,QSqlRecord());
+      }
+      delete q;
+    }
+    return Value(field,valid);
+  }
+
+  if(!row_enabled) {
+    return RDGetSqlValue(row_table,row_key_field,key,field,valid);
+  }
+  if(!IsCurrent(key)) {
+    sql=QString("select * from `")+row_table+"` where "+
+      "`"+row_key_field+"`=?";
+    q=new RDSqlQuery(sql,QVariantList()<<key,RDSqlQuery::Primary);
+    if(q->first()) {
+      setRecord(key,q->record());
+    }
+    else {
+      setRecord(key,QSqlRecord());
+    }
+    delete q;
+  }
+
+  return Value(field,valid);
+}
+
+
+QVariant RDRowSnapshot::value(unsigned key,const QString &field,bool *valid)
+{
+  RDSqlQuery *q=NULL;
+  QString sql;
+
+  if(!row_enabled) {
+    return RDGetSqlValue(row_table,row_key_field,key,field,valid);
+  }
+  if(!IsCurrent(QString::asprintf("%u",key))) {
+    sql=QString("select * from `")+row_table+"` where "+
+      "`"+row_key_field+"`=?";
+    q=new RDSqlQuery(sql,QVariantList()<<key,RDSqlQuery::Primary);
+    if(q->first()) {
+      setRecord(QString::asprintf("%u",key),q->record());
+    }
+    else {
+      setRecord(QString::asprintf("%u",key),QSqlRecord());
+    }
+    delete q;
+  }
+
+  return Value(field,valid);
+}
+
+
+void RDRowSnapshot::setRecord(const QString &key,const QSqlRecord &rec)
+{
+  row_key=key;
+  row_record=rec;
+  row_loaded=true;
+  row_write_count=RDSqlQuery::writeCount();
+  row_generation=RDRowSnapshot::tableGeneration(row_table);
+}
+
+
+void RDRowSnapshot::invalidate()
+{
+  row_loaded=false;
+  row_record.clear();
+}
+
+
+uint64_t RDRowSnapshot::tableGeneration(const QString &table)
+{
+  uint64_t ret=0;
+
+  __rd_row_snapshot_mutex.lock();
+  ret=__rd_row_snapshot_generations.value(table,0);
+  __rd_row_snapshot_mutex.unlock();
+
+  return ret;
+}
+
+
+void RDRowSnapshot::invalidateTable(const QString &table)
+{
+  __rd_row_snapshot_mutex.lock();
+  __rd_row_snapshot_generations[table]++;
+  __rd_row_snapshot_mutex.unlock();
+}
+
+
+void RDRowSnapshot::notifyChanged(const QString &table)
+{
+  RDRowSnapshot::invalidateTable(table);
+  if((rda!=NULL)&&rda->hasRipc()&&rda->ripc()->isConnected()) {
+    rda->ripc()->sendNotification(RDNotification::ConfigType,
+				  RDNotification::ModifyAction,table);
+  }
+}
+
+
+QVariant RDRowSnapshot::Value(const QString &field,bool *valid) const
+{
+  int index=row_record.indexOf(field);
+
+  if(valid!=NULL) {
+    *valid=(index>=0)&&(!row_record.isNull(index));
+  }
+  if(index<0) {
+    return QVariant();
+  }
+  return row_record.value(index);
+}
+
+
+bool RDRowSnapshot::IsCurrent(const QString &key) const
+{
+  return row_loaded&&(row_key==key)&&
+    ((!row_follows_writes)||(row_write_count==RDSqlQuery::writeCount()))&&
+    (row_generation==RDRowSnapshot::tableGeneration(row_table));
+}
@@ -0,0 +1,72 @@
+// rdrowsnapshot.h
+//
+// Serve column values for one database row from a single fetch.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDROWSNAPSHOT_H
+#define RDROWSNAPSHOT_H
+
+#include <stdint.h>
+
+#include <QSqlRecord>
+#include <QString>
+#include <QVariant>
+
+//
+// When disabled (the default), each value() call is passed straight
+// through to RDGetSqlValue().  When enabled, the first call fetches the
+// whole row and later calls are answered from it until the next write
+// made through RDSqlQuery by this process, at which point the row is
+// fetched again.  With 'follows writes' turned off, the row is instead
+// kept until invalidateTable() is called for its table, as happens when
+// an RDNotification::ConfigType notification arrives.
+//
+// An empty key field selects the first (only) row of the table.
+//
+class RDRowSnapshot
+{
+ public:
+  RDRowSnapshot(const QString &table,const QString &key_field);
+  bool isEnabled() const;
+  void setEnabled(bool state);
+  bool followsWrites() const;
+  void setFollowsWrites(bool state);
+  QVariant value(const QString &key,const QString &field,bool *valid=NULL);
+  QVariant value(unsigned key,const QString &field,bool *valid=NULL);
+  void setRecord(const QString &key,const QSqlRecord &rec);
+  void invalidate();
+  static uint64_t tableGeneration(const QString &table);
+  static void invalidateTable(const QString &table);
+  static void notifyChanged(const QString &table);
+
+ private:
+  QVariant Value(const QString &field,bool *valid) const;
+  bool IsCurrent(const QString &key) const;
+  QString row_table;
+  QString row_key_field;
+  bool row_enabled;
+  bool row_follows_writes;
+  bool row_loaded;
+  QString row_key;
+  QSqlRecord row_record;
+  uint64_t row_write_count;
+  uint64_t row_generation;
+};
+
+
+#endif  // RDROWSNAPSHOT_H
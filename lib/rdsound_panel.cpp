@@ -528,6 +528,7 @@ void RDSoundPanel::setButton(RDAirPlayConf::PanelType type,int panel,
   if(cartnum>0) {
     button->setCart(cartnum);
     RDCart *cart=new RDCart(cartnum);
+    cart->setSnapshotEnabled(true);
     if(cart->exists()) {
       if(title.isEmpty()) {
 	button->
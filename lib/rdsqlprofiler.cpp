@@ -0,0 +1,280 @@
+// rdsqlprofiler.cpp
+//
+// Aggregate timings of the SQL statements run by a process.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <signal.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#include <algorithm>
+
+#include <QAbstractEventDispatcher>
+#include <QList>
+#include <QPair>
+
+#include "rdsqlprofiler.h"
+
+//
+// Never freed, so that a report can still be made from atexit(3)
+//
+static RDSqlProfiler *__rd_sql_profiler=NULL;
+static volatile sig_atomic_t __rd_sql_profiler_report=0;
+
+void __RDSqlProfiler_SigHandler(int signo)
+{
+  __rd_sql_profiler_report=1;
+}
+
+
+void __RDSqlProfiler_ExitCallback()
+{
+  RDSqlProfiler::report();
+}
+
+
+void RDSqlProfiler::start(RDConfig *config)
+{
+  if((__rd_sql_profiler!=NULL)||(!config->profileSqlQueries())) {
+    return;
+  }
+  __rd_sql_profiler=new RDSqlProfiler(config);
+  ::signal(SIGUSR2,__RDSqlProfiler_SigHandler);
+  atexit(__RDSqlProfiler_ExitCallback);
+}
+
+
+bool RDSqlProfiler::isActive()
+{
+  return __rd_sql_profiler!=NULL;
+}
+
+
+void RDSqlProfiler::record(const QString &sql,int64_t usecs,int rows)
+{
+  if(__rd_sql_profiler!=NULL) {
+    __rd_sql_profiler->Record(sql,usecs,rows);
+  }
+}
+
+
+void RDSqlProfiler::report()
+{
+  if(__rd_sql_profiler!=NULL) {
+    __rd_sql_profiler->Report();
+  }
+}
+
+
+QString RDSqlProfiler::normalize(const QString &sql)
+{
+  QString ret;
+  QChar c;
+  QChar quote;
+  bool space=false;
+
+  for(int i=0;i<sql.length();i++) {
+    c=sql.at(i);
+    if(c.isSpace()) {
+      space=true;
+      continue;
+    }
+    if(space&&(!ret.isEmpty())) {
+      ret+=" ";
+    }
+    space=false;
+
+    //
+    // String literals
+    //
+    if((c=='\'')||(c=='"')) {
+      quote=c;
+      for(i++;i<sql.length();i++) {
+	if(sql.at(i)=='\\') {
+	  i++;
+	  continue;
+	}
+	if(sql.at(i)==quote) {
+	  if(((i+1)<sql.length())&&(sql.at(i+1)==quote)) {
+	    i++;
+	    continue;
+	  }
+	  break;
+	}
+      }
+      ret+="?";
+      continue;
+    }
+
+    //
+    // Quoted identifiers are kept as they are
+    //
+    if(c=='`') {
+      ret+=c;
+      for(i++;(i<sql.length())&&(sql.at(i)!='`');i++) {
+	ret+=sql.at(i);
+      }
+      ret+="`";
+      continue;
+    }
+
+    //
+    // Numeric literals, but not digits within an identifier
+    //
+    if(c.isDigit()&&(ret.isEmpty()||
+		     ((!ret.at(ret.length()-1).isLetterOrNumber())&&
+		      (ret.at(ret.length()-1)!='_')))) {
+      while(((i+1)<sql.length())&&
+	    (sql.at(i+1).isDigit()||(sql.at(i+1)=='.'))) {
+	i++;
+      }
+      ret+="?";
+      continue;
+    }
+
+    ret+=c;
+  }
+
+  //
+  // Lists and multi-row inserts have the same shape whatever their length
+  //
+  while(ret.contains("?,?")||ret.contains("?, ?")) {
+    ret.replace("?,?","?");
+    ret.replace("?, ?","?");
+  }
+  while(ret.contains("(?),(?)")||ret.contains("(?), (?)")) {
+    ret.replace("(?),(?)","(?)");
+    ret.replace("(?), (?)","(?)");
+  }
+
+  return ret;
+}
+
+
+void RDSqlProfiler::aboutToBlockData()
+{
+  prof_mutex.lock();
+  prof_pass++;
+  prof_mutex.unlock();
+}
+
+
+void RDSqlProfiler::signalTimerData()
+{
+  if(__rd_sql_profiler_report!=0) {
+    __rd_sql_profiler_report=0;
+    Report();
+  }
+}
+
+
+RDSqlProfiler::RDSqlProfiler(RDConfig *config,QObject *parent)
+  : QObject(parent)
+{
+  QAbstractEventDispatcher *dispatcher=NULL;
+
+  prof_level=config->profileSqlQueriesLevel();
+  prof_repeat_limit=config->profileSqlRepeatLimit();
+  prof_thread=QThread::currentThread();
+  prof_pass=1;
+
+  //
+  // The event dispatcher blocks once per pass of the event loop, so that
+  // is where a pass ends
+  //
+  if((dispatcher=QAbstractEventDispatcher::instance())!=NULL) {
+    connect(dispatcher,SIGNAL(aboutToBlock()),this,SLOT(aboutToBlockData()));
+  }
+
+  prof_signal_timer=new QTimer(this);
+  connect(prof_signal_timer,SIGNAL(timeout()),this,SLOT(signalTimerData()));
+  prof_signal_timer->start(RDSQLPROFILER_SIGNAL_INTERVAL);
+}
+
+
+void RDSqlProfiler::Record(const QString &sql,int64_t usecs,int rows)
+{
+  QString key=RDSqlProfiler::normalize(sql);
+  bool repeated=false;
+
+  prof_mutex.lock();
+  Shape &shape=prof_shapes[key];
+  shape.count++;
+  shape.total_usecs+=usecs;
+  if(usecs>shape.max_usecs) {
+    shape.max_usecs=usecs;
+  }
+  if(rows>0) {
+    shape.rows+=rows;
+  }
+
+  //
+  // Passes are only tracked for the thread running the event loop
+  //
+  if((prof_repeat_limit>0)&&(QThread::currentThread()==prof_thread)) {
+    if(shape.pass!=prof_pass) {
+      shape.pass=prof_pass;
+      shape.pass_count=0;
+    }
+    if(++shape.pass_count==(prof_repeat_limit+1)) {
+      shape.repeats++;
+      repeated=true;
+    }
+  }
+  prof_mutex.unlock();
+
+  if(repeated) {
+    syslog(prof_level,"SQL profile: possible N+1 (over %d per pass): %s",
+	   prof_repeat_limit,key.toUtf8().constData());
+  }
+}
+
+
+void RDSqlProfiler::Report()
+{
+  QHash<QString,Shape> shapes;
+  QList<QPair<int64_t,QString> > order;
+  uint64_t count=0;
+  int64_t usecs=0;
+
+  prof_mutex.lock();
+  shapes=prof_shapes;
+  prof_mutex.unlock();
+
+  for(QHash<QString,Shape>::const_iterator it=shapes.begin();
+      it!=shapes.end();it++) {
+    order.push_back(QPair<int64_t,QString>(it.value().total_usecs,it.key()));
+    count+=it.value().count;
+    usecs+=it.value().total_usecs;
+  }
+  std::sort(order.begin(),order.end());
+  std::reverse(order.begin(),order.end());
+
+  syslog(prof_level,"SQL profile: %lu statements in %d shapes, %.1f ms total",
+	 (unsigned long)count,shapes.size(),(double)usecs/1000.0);
+  for(int i=0;(i<order.size())&&(i<RDSQLPROFILER_REPORT_SHAPES);i++) {
+    Shape shape=shapes.value(order.at(i).second);
+    syslog(prof_level,"SQL profile: %lu calls, %.1f ms total, %.2f ms max, %s",
+	   (unsigned long)shape.count,(double)shape.total_usecs/1000.0,
+	   (double)shape.max_usecs/1000.0,
+	   (QString::asprintf("%.1f rows/call, %lu N+1: ",
+			      (double)shape.rows/(double)shape.count,
+			      (unsigned long)shape.repeats)+
+	    order.at(i).second).toUtf8().constData());
+  }
+}
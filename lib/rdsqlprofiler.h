@@ -0,0 +1,83 @@
+// rdsqlprofiler.h
+//
+// Aggregate timings of the SQL statements run by a process.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSQLPROFILER_H
+#define RDSQLPROFILER_H
+
+#include <stdint.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+
+#include <rdconfig.h>
+
+//
+// Most statement shapes to list in a report
+//
+#define RDSQLPROFILER_REPORT_SHAPES 50
+
+//
+// How often to check for a report request [mSecs]
+//
+#define RDSQLPROFILER_SIGNAL_INTERVAL 1000
+
+class RDSqlProfiler : public QObject
+{
+  Q_OBJECT
+ public:
+  static void start(RDConfig *config);
+  static bool isActive();
+  static void record(const QString &sql,int64_t usecs,int rows);
+  static void report();
+  static QString normalize(const QString &sql);
+
+ private slots:
+  void aboutToBlockData();
+  void signalTimerData();
+
+ private:
+  struct Shape
+  {
+    uint64_t count;
+    int64_t total_usecs;
+    int64_t max_usecs;
+    uint64_t rows;
+    uint64_t pass;
+    int pass_count;
+    uint64_t repeats;
+  };
+  RDSqlProfiler(RDConfig *config,QObject *parent=0);
+  void Record(const QString &sql,int64_t usecs,int rows);
+  void Report();
+  int prof_level;
+  int prof_repeat_limit;
+  QThread *prof_thread;
+  uint64_t prof_pass;
+  QHash<QString,Shape> prof_shapes;
+  QMutex prof_mutex;
+  QTimer *prof_signal_timer;
+};
+
+
+#endif  // RDSQLPROFILER_H
@@ -0,0 +1,183 @@
+// rdsqltransaction.cpp
+//
+// Scoped database transactions, nested by means of savepoints.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <syslog.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QThreadStorage>
+
+#include "rddb.h"
+#include "rdsqltransaction.h"
+
+//
+// Each thread runs its queries on its own connection (see RDDbPool), and
+// so has its own stack of open transactions
+//
+static QThreadStorage<int> __rd_sql_transaction_depth;
+
+//
+// Whether each table's engine supports transactions.  Engines are
+// changed only by rddbmgr(8), so this is looked up once per process.
+//
+static QHash<QString,bool> __rd_sql_transaction_engines;
+static QMutex __rd_sql_transaction_engines_mutex;
+
+RDSqlTransaction::RDSqlTransaction(const QStringList &tables)
+{
+  QString sql;
+
+  trans_atomic=RDSqlTransaction::nonTransactionalTables(tables).size()==0;
+  trans_depth=__rd_sql_transaction_depth.localData()+1;
+  if(trans_depth==1) {
+    sql="start transaction";
+  }
+  else {
+    sql=QString::asprintf("savepoint `RDSAVEPOINT_%d`",trans_depth);
+  }
+  trans_active=RDSqlQuery::apply(sql);
+  if(trans_active) {
+    __rd_sql_transaction_depth.setLocalData(trans_depth);
+  }
+}
+
+
+RDSqlTransaction::~RDSqlTransaction()
+{
+  if(trans_active) {
+    rollback();
+  }
+}
+
+
+bool RDSqlTransaction::isActive() const
+{
+  return trans_active;
+}
+
+
+bool RDSqlTransaction::isAtomic() const
+{
+  return trans_active&&trans_atomic;
+}
+
+
+int RDSqlTransaction::depth() const
+{
+  return trans_depth;
+}
+
+
+bool RDSqlTransaction::commit()
+{
+  if(trans_depth==1) {
+    return Finish("commit");
+  }
+  return Finish(QString::asprintf("release savepoint `RDSAVEPOINT_%d`",
+				  trans_depth));
+}
+
+
+void RDSqlTransaction::rollback()
+{
+  if(trans_depth==1) {
+    Finish("rollback");
+  }
+  else {
+    Finish(QString::asprintf("rollback to savepoint `RDSAVEPOINT_%d`",
+			     trans_depth));
+  }
+}
+
+
+int RDSqlTransaction::currentDepth()
+{
+  return __rd_sql_transaction_depth.localData();
+}
+
+
+QStringList RDSqlTransaction::nonTransactionalTables(const QStringList &tables)
+{
+  QStringList ret;
+  QStringList unknown;
+  QString placeholders;
+  QVariantList values;
+  QMutexLocker locker(&__rd_sql_transaction_engines_mutex);
+
+  for(int i=0;i<tables.size();i++) {
+    if(!__rd_sql_transaction_engines.contains(tables.at(i))) {
+      unknown.push_back(tables.at(i));
+    }
+  }
+  if(unknown.size()>0) {
+    for(int i=0;i<unknown.size();i++) {
+      if(i>0) {
+	placeholders+=",";
+      }
+      placeholders+="?";
+      values.push_back(unknown.at(i));
+    }
+    RDSqlQuery *q=new RDSqlQuery(QString("select ")+
+				 "`TABLE_NAME`,"+  // 00
+				 "`ENGINE` "+      // 01
+				 "from `information_schema`.`TABLES` where "+
+				 "`TABLE_SCHEMA`=database() && "+
+				 "`TABLE_NAME` in ("+placeholders+")",values);
+    while(q->next()) {
+      QString engine=q->value(1).toString().toLower();
+      bool ok=(engine=="innodb")||(engine=="ndbcluster");
+      __rd_sql_transaction_engines[q->value(0).toString()]=ok;
+      if(!ok) {
+	syslog(LOG_WARNING,"table `%s` uses the %s engine, which does not "
+	       "support transactions, so writes to it will not be atomic",
+	       q->value(0).toString().toUtf8().constData(),
+	       q->value(1).toString().toUtf8().constData());
+      }
+    }
+    delete q;
+  }
+  for(int i=0;i<tables.size();i++) {
+    if(!__rd_sql_transaction_engines.value(tables.at(i),true)) {
+      ret.push_back(tables.at(i));
+    }
+  }
+
+  return ret;
+}
+
+
+bool RDSqlTransaction::Finish(const QString &sql)
+{
+  bool ret=false;
+
+  if(!trans_active) {
+    return false;
+  }
+  if(__rd_sql_transaction_depth.localData()!=trans_depth) {
+    syslog(LOG_WARNING,
+	   "transaction at depth %d finished while depth %d was still open",
+	   trans_depth,__rd_sql_transaction_depth.localData());
+  }
+  ret=RDSqlQuery::apply(sql);
+  trans_active=false;
+  __rd_sql_transaction_depth.setLocalData(trans_depth-1);
+
+  return ret;
+}
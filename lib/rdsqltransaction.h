@@ -0,0 +1,59 @@
+// rdsqltransaction.h
+//
+// Scoped database transactions, nested by means of savepoints.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDSQLTRANSACTION_H
+#define RDSQLTRANSACTION_H
+
+#include <QString>
+#include <QStringList>
+
+//
+// Meant to be declared on the stack, so that a return before commit()
+// rolls the work back.
+//
+// Only transactional storage engines (such as InnoDB) honor transactions;
+// writes to tables using anything else (including MyISAM, the default in
+// rd.conf(5)) take effect at once and are not undone by a rollback.  A
+// transaction checks the engines of the tables it is given, logging a
+// warning (once per table) and clearing isAtomic() if any of them can't
+// take part.
+//
+class RDSqlTransaction
+{
+ public:
+  RDSqlTransaction(const QStringList &tables=QStringList());
+  ~RDSqlTransaction();
+  bool isActive() const;
+  bool isAtomic() const;
+  int depth() const;
+  bool commit();
+  void rollback();
+  static int currentDepth();
+  static QStringList nonTransactionalTables(const QStringList &tables);
+
+ private:
+  bool Finish(const QString &sql);
+  int trans_depth;
+  bool trans_active;
+  bool trans_atomic;
+};
+
+
+#endif  // RDSQLTRANSACTION_H
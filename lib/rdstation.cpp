@@ -30,18 +30,33 @@ RDStation::RDStation(const QString &name,bool create)
   QString sql;
   time_offset_valid = false;
   station_name=name;
+  station_snapshot=new RDRowSnapshot("STATIONS","NAME");
+  station_snapshot->setFollowsWrites(false);
 }
 
 
 RDStation::~RDStation()
 {
 //  printf("Destroying RDStation\n");
+  delete station_snapshot;
 }
 
 
 bool RDStation::exists() const
 {
-  return RDDoesRowExist("STATIONS","NAME",RDEscapeString(station_name));
+  return RDDoesRowExist("STATIONS","NAME",station_name);
+}
+
+
+bool RDStation::snapshotEnabled() const
+{
+  return station_snapshot->isEnabled();
+}
+
+
+void RDStation::setSnapshotEnabled(bool state)
+{
+  station_snapshot->setEnabled(state);
 }
 
 
@@ -53,7 +68,7 @@ QString RDStation::name() const
 
 QString RDStation::shortName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"SHORT_NAME").toString();
+  return station_snapshot->value(station_name,"SHORT_NAME").toString();
 }
 
 
@@ -65,7 +80,7 @@ void RDStation::setShortName(const QString &str) const
 
 QString RDStation::description() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"DESCRIPTION").toString();
+  return station_snapshot->value(station_name,"DESCRIPTION").toString();
 }
 
 
@@ -77,7 +92,7 @@ void RDStation::setDescription(QString desc) const
 
 QString RDStation::userName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"USER_NAME").toString();
+  return station_snapshot->value(station_name,"USER_NAME").toString();
 }
 
 
@@ -89,7 +104,7 @@ void RDStation::setUserName(QString name) const
 
 QString RDStation::defaultName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"DEFAULT_NAME").
+  return station_snapshot->value(station_name,"DEFAULT_NAME").
     toString();
 }
 
@@ -103,7 +118,7 @@ void RDStation::setDefaultName(QString name) const
 QHostAddress RDStation::address() const
 {
   QHostAddress addr;
-  addr.setAddress(RDGetSqlValue("STATIONS","NAME",station_name,"IPV4_ADDRESS").
+  addr.setAddress(station_snapshot->value(station_name,"IPV4_ADDRESS").
 		  toString());
   return addr;
 }
@@ -137,7 +152,7 @@ QHostAddress RDStation::httpAddress(RDConfig *config) const
 QString RDStation::httpStation() const
 {
   return
-    RDGetSqlValue("STATIONS","NAME",station_name,"HTTP_STATION").toString();
+    station_snapshot->value(station_name,"HTTP_STATION").toString();
 }
 
 
@@ -150,7 +165,7 @@ void RDStation::setHttpStation(const QString &str)
 QString RDStation::caeStation() const
 {
   return
-    RDGetSqlValue("STATIONS","NAME",station_name,"CAE_STATION").toString();
+    station_snapshot->value(station_name,"CAE_STATION").toString();
 }
 
 
@@ -189,7 +204,8 @@ QString RDStation::webServiceUrl(RDConfig *config) const
 int RDStation::timeOffset()
 {
   if (!time_offset_valid){
-    time_offset = RDGetSqlValue("STATIONS","NAME",station_name,"TIME_OFFSET").toInt();
+    time_offset=
+      station_snapshot->value(station_name,"TIME_OFFSET").toInt();
     time_offset_valid = true;
   }
   return time_offset;
@@ -205,7 +221,7 @@ void RDStation::setTimeOffset(int msecs)
 
 unsigned RDStation::heartbeatCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"HEARTBEAT_CART").
+  return station_snapshot->value(station_name,"HEARTBEAT_CART").
     toUInt();
 }
 
@@ -218,7 +234,7 @@ void RDStation::setHeartbeatCart(unsigned cartnum) const
 
 unsigned RDStation::heartbeatInterval() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"HEARTBEAT_INTERVAL").
+  return station_snapshot->value(station_name,"HEARTBEAT_INTERVAL").
     toUInt();
 }
 
@@ -231,7 +247,7 @@ void RDStation::setHeartbeatInterval(unsigned interval) const
 
 unsigned RDStation::startupCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"STARTUP_CART").
+  return station_snapshot->value(station_name,"STARTUP_CART").
     toUInt();
 }
 
@@ -244,7 +260,7 @@ void RDStation::setStartupCart(unsigned cartnum) const
 
 QString RDStation::reportEditorPath() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"REPORT_EDITOR_PATH").
+  return station_snapshot->value(station_name,"REPORT_EDITOR_PATH").
     toString();
 }
 
@@ -257,7 +273,7 @@ void RDStation::setReportEditorPath(const QString &cmd)
 
 QString RDStation::browserPath() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"BROWSER_PATH").
+  return station_snapshot->value(station_name,"BROWSER_PATH").
     toString();
 }
 
@@ -270,7 +286,7 @@ void RDStation::setBrowserPath(const QString &cmd) const
 
 QString RDStation::sshIdentityFile() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"SSH_IDENTITY_FILE").
+  return station_snapshot->value(station_name,"SSH_IDENTITY_FILE").
     toString();
 }
 
@@ -283,7 +299,7 @@ void RDStation::setSshIdentityFile(const QString &str) const
 
 RDStation::FilterMode RDStation::filterMode() const
 {
-  return (RDStation::FilterMode)RDGetSqlValue("STATIONS","NAME",station_name,
+  return (RDStation::FilterMode)station_snapshot->value(station_name,
 					      "FILTER_MODE").toInt();
 }
 
@@ -296,7 +312,7 @@ void RDStation::setFilterMode(RDStation::FilterMode mode) const
 
 bool RDStation::startJack() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"START_JACK").
+  return RDBool(station_snapshot->value(station_name,"START_JACK").
 		toString());
 }
 
@@ -309,7 +325,7 @@ void RDStation::setStartJack(bool state) const
 
 QString RDStation::jackServerName() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_SERVER_NAME").
+  return station_snapshot->value(station_name,"JACK_SERVER_NAME").
     toString();
 }
 
@@ -322,7 +338,7 @@ void RDStation::setJackServerName(const QString &str) const
 
 QString RDStation::jackCommandLine() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_COMMAND_LINE").
+  return station_snapshot->value(station_name,"JACK_COMMAND_LINE").
     toString();
 }
 
@@ -335,7 +351,7 @@ void RDStation::setJackCommandLine(const QString &str) const
 
 int RDStation::jackPorts() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_PORTS").toInt();
+  return station_snapshot->value(station_name,"JACK_PORTS").toInt();
 }
 
 
@@ -347,7 +363,7 @@ void RDStation::setJackPorts(int ports) const
 
 int RDStation::cueCard() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_CARD").toInt();
+  return station_snapshot->value(station_name,"CUE_CARD").toInt();
 }
 
 
@@ -359,7 +375,7 @@ void RDStation::setCueCard(int card)
 
 int RDStation::cuePort() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_PORT").toInt();
+  return station_snapshot->value(station_name,"CUE_PORT").toInt();
 }
 
 
@@ -371,7 +387,7 @@ void RDStation::setCuePort(int port)
 
 unsigned RDStation::cueStartCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_START_CART").
+  return station_snapshot->value(station_name,"CUE_START_CART").
     toUInt();
 }
 
@@ -384,7 +400,7 @@ void RDStation::setCueStartCart(unsigned cartnum) const
 
 unsigned RDStation::cueStopCart() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CUE_STOP_CART").toUInt();
+  return station_snapshot->value(station_name,"CUE_STOP_CART").toUInt();
 }
 
 
@@ -396,7 +412,7 @@ void RDStation::setCueStopCart(unsigned cartnum) const
 
 int RDStation::cartSlotColumns() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CARTSLOT_COLUMNS").
+  return station_snapshot->value(station_name,"CARTSLOT_COLUMNS").
     toInt();
 }
 
@@ -409,7 +425,7 @@ void RDStation::setCartSlotColumns(int cols)
 
 int RDStation::cartSlotRows() const
 {
-  return RDGetSqlValue("STATIONS","NAME",station_name,"CARTSLOT_ROWS").toInt();
+  return station_snapshot->value(station_name,"CARTSLOT_ROWS").toInt();
 }
 
 
@@ -421,7 +437,7 @@ void RDStation::setCartSlotRows(int rows)
 
 bool RDStation::enableDragdrop() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+  return RDBool(station_snapshot->value(station_name,
 			      "ENABLE_DRAGDROP").toString());
 }
 
@@ -434,7 +450,7 @@ void RDStation::setEnableDragdrop(bool state)
 
 bool RDStation::enforcePanelSetup() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+  return RDBool(station_snapshot->value(station_name,
 			      "ENFORCE_PANEL_SETUP").toString());
 }
 
@@ -447,7 +463,7 @@ void RDStation::setEnforcePanelSetup(bool state)
 
 bool RDStation::systemMaint() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"SYSTEM_MAINT").
+  return RDBool(station_snapshot->value(station_name,"SYSTEM_MAINT").
 	       toString());
 }
 
@@ -460,7 +476,7 @@ void RDStation::setSystemMaint(bool state) const
 
 bool RDStation::scanned() const
 {
-  return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,"STATION_SCANNED").
+  return RDBool(station_snapshot->value(station_name,"STATION_SCANNED").
 	       toString());
 }
 
@@ -475,35 +491,35 @@ bool RDStation::haveCapability(Capability cap) const
 {
   switch(cap) {
   case RDStation::HaveOggenc:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				"HAVE_OGGENC").toString());
     break;
  
   case RDStation::HaveOgg123:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				  "HAVE_OGG123").toString());
     break;
 
   case RDStation::HaveFlac:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				  "HAVE_FLAC").toString());
     break;
 
   case RDStation::HaveLame:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				  "HAVE_LAME").toString());
     break;
 
   case RDStation::HaveMp4Decode:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				"HAVE_MP4_DECODE").toString());
 
   case RDStation::HaveMpg321:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				"HAVE_MPG321").toString());
 
   case RDStation::HaveTwoLame:
-    return RDBool(RDGetSqlValue("STATIONS","NAME",station_name,
+    return RDBool(station_snapshot->value(station_name,
 				"HAVE_TWOLAME").toString());
     break;
   }
@@ -596,15 +612,15 @@ QString RDStation::driverVersion(AudioDriver driver) const
     return QString();
 
   case RDStation::Hpi:
-    return RDGetSqlValue("STATIONS","NAME",station_name,"HPI_VERSION").
+    return station_snapshot->value(station_name,"HPI_VERSION").
       toString();
 
   case RDStation::Jack:
-    return RDGetSqlValue("STATIONS","NAME",station_name,"JACK_VERSION").
+    return station_snapshot->value(station_name,"JACK_VERSION").
       toString();
 
   case RDStation::Alsa:
-    return RDGetSqlValue("STATIONS","NAME",station_name,"ALSA_VERSION").
+    return station_snapshot->value(station_name,"ALSA_VERSION").
       toString();
   }
   return QString();
@@ -1861,6 +1877,24 @@ bool RDStation::create(const QString &name,QString *err_msg,
     }
     delete q;  
   }
+
+  //
+  // Rows of these tables may be held in snapshots elsewhere
+  //
+  QStringList tables;
+  tables<<"AUDIO_CARDS"<<"AUDIO_INPUTS"<<"AUDIO_OUTPUTS"<<"DECK_EVENTS"<<
+    "LOG_MACHINES"<<"LOG_MODES"<<"RDAIRPLAY_CHANNELS"<<"RDLIBRARY"<<
+    "RDLOGEDIT"<<"RDPANEL_CHANNELS"<<"SERVICE_PERMS"<<"STATIONS";
+  if(!exemplar.isEmpty()) {
+    tables<<"CARTSLOTS"<<"DECKS"<<"EXTENDED_PANELS"<<"GPIS"<<"GPOS"<<
+      "HOSTVARS"<<"INPUTS"<<"JACK_CLIENTS"<<"MATRICES"<<"OUTPUTS"<<"PANELS"<<
+      "PYPAD_INSTANCES"<<"RDAIRPLAY"<<"RDHOTKEYS"<<"RDPANEL"<<
+      "SWITCHER_NODES"<<"TTYS"<<"VGUEST_RESOURCES";
+  }
+  for(int i=0;i<tables.size();i++) {
+    RDRowSnapshot::notifyChanged(tables.at(i));
+  }
+
   return true;
 }
 
@@ -2029,6 +2063,7 @@ void RDStation::SetRow(const QString &param,const QString &value) const
     param+"`='"+RDEscapeString(value)+"' where "+
     "`NAME`='"+RDEscapeString(station_name)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("STATIONS");
 }
 
 
@@ -2040,6 +2075,7 @@ void RDStation::SetRow(const QString &param,int value) const
     param+QString::asprintf("`=%d where ",value)+
     "`NAME`='"+RDEscapeString(station_name)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("STATIONS");
 }
 
 
@@ -2051,6 +2087,7 @@ void RDStation::SetRow(const QString &param,unsigned value) const
     param+QString::asprintf("`=%u where ",value)+
     "`NAME`='"+RDEscapeString(station_name)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("STATIONS");
 }
 
 
@@ -2062,4 +2099,5 @@ void RDStation::SetRow(const QString &param,bool value) const
     param+"`='"+RDYesNo(value)+"' where "+
     "`NAME`='"+RDEscapeString(station_name)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("STATIONS");
 }
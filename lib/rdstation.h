@@ -24,6 +24,7 @@
 #include <QHostAddress>
 
 #include <rdconfig.h>
+#include <rdrowsnapshot.h>
 
 class RDStation
 {
@@ -36,6 +37,8 @@ class RDStation
   ~RDStation();
   QString name() const;
   bool exists() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   QString shortName() const;
   void setShortName(const QString &str) const;
   QString description() const;
@@ -124,6 +127,7 @@ class RDStation
   QString station_name;
   int time_offset;
   bool time_offset_valid;
+  RDRowSnapshot *station_snapshot;
 };
 
 
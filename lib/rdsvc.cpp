@@ -30,6 +30,7 @@
 #include "rdescape_string.h"
 #include "rdevent_line.h"
 #include "rdlogmodel.h"
+#include "rdsqltransaction.h"
 #include "rdsvc.h"
 #include "rdweb.h"
 
@@ -39,6 +40,13 @@ RDSvc::RDSvc(QString svcname,RDStation *station,RDConfig *config,QObject *parent
   svc_name=svcname;
   svc_station=station;
   svc_config=config;
+  svc_snapshot=new RDRowSnapshot("SERVICES","NAME");
+}
+
+
+RDSvc::~RDSvc()
+{
+  delete svc_snapshot;
 }
 
 
@@ -48,6 +56,18 @@ bool RDSvc::exists() const
 }
 
 
+bool RDSvc::snapshotEnabled() const
+{
+  return svc_snapshot->isEnabled();
+}
+
+
+void RDSvc::setSnapshotEnabled(bool state)
+{
+  svc_snapshot->setEnabled(state);
+}
+
+
 QString RDSvc::name() const
 {
   return svc_name;
@@ -56,7 +76,7 @@ QString RDSvc::name() const
 
 QString RDSvc::description() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"DESCRIPTION").
+  return svc_snapshot->value(svc_name,"DESCRIPTION").
     toString();
 }
 
@@ -69,7 +89,7 @@ void RDSvc::setDescription(const QString &desc) const
 
 bool RDSvc::bypassMode() const
 {
-  return RDBool(RDGetSqlValue("SERVICES","NAME",svc_name,"BYPASS_MODE").
+  return RDBool(svc_snapshot->value(svc_name,"BYPASS_MODE").
     toString());
 }
 
@@ -82,7 +102,7 @@ void RDSvc::setBypassMode(bool state) const
 
 QString RDSvc::programCode() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"PROGRAM_CODE").
+  return svc_snapshot->value(svc_name,"PROGRAM_CODE").
     toString();
 }
 
@@ -95,7 +115,7 @@ void RDSvc::setProgramCode(const QString &str) const
 
 QString RDSvc::nameTemplate() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"NAME_TEMPLATE").
+  return svc_snapshot->value(svc_name,"NAME_TEMPLATE").
     toString();
 }
 
@@ -108,7 +128,7 @@ void RDSvc::setNameTemplate(const QString &str) const
 
 QString RDSvc::descriptionTemplate() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"DESCRIPTION_TEMPLATE").
+  return svc_snapshot->value(svc_name,"DESCRIPTION_TEMPLATE").
     toString();
 }
 
@@ -121,7 +141,7 @@ void RDSvc::setDescriptionTemplate(const QString &str) const
 
 QString RDSvc::trackGroup() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"TRACK_GROUP").
+  return svc_snapshot->value(svc_name,"TRACK_GROUP").
     toString();
 }
 
@@ -134,7 +154,7 @@ void RDSvc::setTrackGroup(const QString &group) const
 
 QString RDSvc::autospotGroup() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"AUTOSPOT_GROUP").
+  return svc_snapshot->value(svc_name,"AUTOSPOT_GROUP").
     toString();
 }
 
@@ -147,7 +167,7 @@ void RDSvc::setAutospotGroup(const QString &group) const
 
 bool RDSvc::autoRefresh() const
 {
-  return RDBool(RDGetSqlValue("SERVICES","NAME",svc_name,"AUTO_REFRESH").
+  return RDBool(svc_snapshot->value(svc_name,"AUTO_REFRESH").
     toString());
 }
 
@@ -160,7 +180,7 @@ void RDSvc::setAutoRefresh(bool state)
 
 int RDSvc::defaultLogShelflife() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"DEFAULT_LOG_SHELFLIFE").toInt();
+  return svc_snapshot->value(svc_name,"DEFAULT_LOG_SHELFLIFE").toInt();
 }
 
 
@@ -172,7 +192,7 @@ void RDSvc::setDefaultLogShelflife(int days) const
 
 RDSvc::ShelflifeOrigin RDSvc::logShelflifeOrigin() const
 {
-  return (RDSvc::ShelflifeOrigin)RDGetSqlValue("SERVICES","NAME",svc_name,
+  return (RDSvc::ShelflifeOrigin)svc_snapshot->value(svc_name,
 					       "LOG_SHELFLIFE_ORIGIN").toInt();
 }
 
@@ -185,7 +205,7 @@ void RDSvc::setLogShelflifeOrigin(RDSvc::ShelflifeOrigin orig)
 
 int RDSvc::elrShelflife() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"ELR_SHELFLIFE").toInt();
+  return svc_snapshot->value(svc_name,"ELR_SHELFLIFE").toInt();
 }
 
 
@@ -199,11 +219,11 @@ bool RDSvc::includeImportMarkers(RDSvc::ImportSource src) const
 {
   if(src==RDSvc::Music) {
     return 
-      RDBool(RDGetSqlValue("SERVICES","NAME",svc_name,
+      RDBool(svc_snapshot->value(svc_name,
 			   "INCLUDE_MUS_IMPORT_MARKERS").toString());
   }
   return 
-    RDBool(RDGetSqlValue("SERVICES","NAME",svc_name,
+    RDBool(svc_snapshot->value(svc_name,
 			 "INCLUDE_TFC_IMPORT_MARKERS").toString());
 }
 
@@ -221,7 +241,7 @@ void RDSvc::setIncludeImportMarkers(RDSvc::ImportSource src,bool state)
 bool RDSvc::chainto() const
 {
   return 
-    RDBool(RDGetSqlValue("SERVICES","NAME",svc_name,"CHAIN_LOG").toString());
+    RDBool(svc_snapshot->value(svc_name,"CHAIN_LOG").toString());
 }
 
 
@@ -234,7 +254,7 @@ void RDSvc::setChainto(bool state) const
 RDSvc::SubEventInheritance RDSvc::subEventInheritance() const
 {
   return (RDSvc::SubEventInheritance)
-    RDGetSqlValue("SERVICES","NAME",svc_name,"SUB_EVENT_INHERITANCE").toInt();
+    svc_snapshot->value(svc_name,"SUB_EVENT_INHERITANCE").toInt();
 }
 
 
@@ -247,7 +267,7 @@ void RDSvc::setSubEventInheritance(RDSvc::SubEventInheritance inherit) const
 QString RDSvc::importTemplate(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"IMPORT_TEMPLATE";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).
+  return svc_snapshot->value(svc_name,fieldname).
     toString();
 }
 
@@ -261,7 +281,7 @@ void RDSvc::setImportTemplate(ImportSource src,const QString &str) const
 
 QString RDSvc::breakString() const
 {
-  return RDGetSqlValue("SERVICES","NAME",svc_name,"MUS_BREAK_STRING").
+  return svc_snapshot->value(svc_name,"MUS_BREAK_STRING").
     toString();
 }
 
@@ -275,7 +295,7 @@ void RDSvc::setBreakString(const QString &str)
 QString RDSvc::trackString(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"TRACK_STRING";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).
+  return svc_snapshot->value(svc_name,fieldname).
     toString();
 }
 
@@ -290,7 +310,7 @@ void RDSvc::setTrackString(ImportSource src,const QString &str)
 QString RDSvc::labelCart(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"LABEL_CART";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).toString();
+  return svc_snapshot->value(svc_name,fieldname).toString();
 }
 
 
@@ -304,7 +324,7 @@ void RDSvc::setLabelCart(ImportSource src,const QString &str)
 QString RDSvc::trackCart(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"TRACK_CART";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).toString();
+  return svc_snapshot->value(svc_name,fieldname).toString();
 }
 
 
@@ -318,7 +338,7 @@ void RDSvc::setTrackCart(ImportSource src,const QString &str)
 QString RDSvc::importPath(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"PATH";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).
+  return svc_snapshot->value(svc_name,fieldname).
     toString();
 }
 
@@ -334,7 +354,7 @@ void RDSvc::setImportPath(ImportSource src,const QString &path)
 QString RDSvc::preimportCommand(ImportSource src) const
 {
   QString fieldname=SourceString(src)+"PREIMPORT_CMD";
-  return RDGetSqlValue("SERVICES","NAME",svc_name,fieldname).
+  return svc_snapshot->value(svc_name,fieldname).
     toString();
 }
 
@@ -917,6 +937,13 @@ bool RDSvc::generateLog(const QDate &date,const QString &logname,
     delete log_lock;
     return false;
   }
+
+  //
+  // The lines are written as a single transaction, so that (on tables
+  // using a transactional engine) readers never see a half-generated log
+  // and the rows aren't flushed one at a time
+  //
+  RDSqlTransaction trans(QStringList()<<"LOG_LINES"<<"LOGS");
   log=new RDLog(logname);
   log->setDescription(RDDateDecode(descriptionTemplate(),date,svc_station,
 				   svc_config,svc_name));
@@ -1013,6 +1040,7 @@ bool RDSvc::generateLog(const QDate &date,const QString &logname,
   log->setNextId(count);
   log->setAutoRefresh(autoRefresh());
   delete log;
+  trans.commit();
   delete log_lock;
 
   return true;
@@ -1124,6 +1152,7 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
 		      link_src,src_type,&autofill_errors);
   }
 
+  RDSqlTransaction trans(QStringList()<<"LOG_LINES"<<"LOGS");
   dst_model->save(svc_config);
 
   //
@@ -1138,6 +1167,7 @@ bool RDSvc::linkLog(RDSvc::ImportSource src,const QDate &date,
   log->setLinkDatetime(current_datetime);
   log->setModifiedDatetime(current_datetime);
   delete log;
+  trans.commit();
 
   //
   // Generate Missing Event and Skipped Events Report
@@ -1270,6 +1300,7 @@ bool RDSvc::clearLogLinks(RDSvc::ImportSource src,const QString &logname,
       dst_model->logLine(dst_model->lineCount()-1)->setId(dst_model->nextId());
     }
   }
+  RDSqlTransaction trans(QStringList()<<"LOG_LINES"<<"LOGS");
   dst_model->save(svc_config);
   delete src_model;
   delete dst_model;
@@ -1282,6 +1313,7 @@ bool RDSvc::clearLogLinks(RDSvc::ImportSource src,const QString &logname,
     log->setLinkState(RDLog::SourceMusic,false);
   }
   delete log;
+  trans.commit();
   delete log_lock;
   *err_msg="OK";
   return true;
@@ -1678,6 +1710,7 @@ void RDSvc::remove(const QString &name)
     "`DEFAULT_SERVICE`='"+RDEscapeString(name)+"'";
   q=new RDSqlQuery(sql);
   delete q;
+  RDRowSnapshot::notifyChanged("RDAIRPLAY");
 
   sql=QString("delete from `EVENT_PERMS` where ")+
     "`SERVICE_NAME`='"+RDEscapeString(name)+"'";
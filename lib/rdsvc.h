@@ -28,6 +28,7 @@
 #include "rdconfig.h"
 #include "rdlog.h"
 #include "rdloglock.h"
+#include "rdrowsnapshot.h"
 #include "rdstation.h"
 #include "rduser.h"
 
@@ -43,8 +44,11 @@ class RDSvc : public QObject
   enum ShelflifeOrigin {OriginAirDate=0,OriginCreationDate=1};
   enum SubEventInheritance {ParentEvent=0,SchedFile=1};
   RDSvc(QString svcname,RDStation *station,RDConfig *config,QObject *parent=0);
+  ~RDSvc();
   QString name() const;
   bool exists() const;
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   QString description() const;
   void setDescription(const QString &desc) const;
   bool bypassMode() const;
@@ -147,6 +151,7 @@ class RDSvc : public QObject
   QString svc_name;
   RDStation *svc_station;
   RDConfig *svc_config;
+  RDRowSnapshot *svc_snapshot;
 };
 
 
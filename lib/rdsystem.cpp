@@ -27,6 +27,26 @@
 
 RDSystem::RDSystem()
 {
+  system_snapshot=new RDRowSnapshot("SYSTEM","");
+  system_snapshot->setFollowsWrites(false);
+}
+
+
+RDSystem::~RDSystem()
+{
+  delete system_snapshot;
+}
+
+
+bool RDSystem::snapshotEnabled() const
+{
+  return system_snapshot->isEnabled();
+}
+
+
+void RDSystem::setSnapshotEnabled(bool state)
+{
+  system_snapshot->setEnabled(state);
 }
 
 
@@ -56,17 +76,7 @@ void RDSystem::setSampleRate(unsigned rate) const
 
 bool RDSystem::allowDuplicateCartTitles() const
 {
-  bool ret=false;
-  QString sql;
-  RDSqlQuery *q;
-
-  sql="select `DUP_CART_TITLES` from `SYSTEM`";
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=RDBool(q->value(0).toString());
-  }
-  delete q;
-  return ret;
+  return RDBool(GetValue("DUP_CART_TITLES").toString());
 }
 
 
@@ -77,22 +87,13 @@ void RDSystem::setAllowDuplicateCartTitles(bool state) const
   sql=QString("update `SYSTEM` set ")+
     "`DUP_CART_TITLES`='"+RDYesNo(state)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("SYSTEM");
 }
 
 
 bool RDSystem::fixDuplicateCartTitles() const
 {
-  bool ret=false;
-  QString sql;
-  RDSqlQuery *q;
-
-  sql="select `FIX_DUP_CART_TITLES` from `SYSTEM`";
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=RDBool(q->value(0).toString());
-  }
-  delete q;
-  return ret;
+  return RDBool(GetValue("FIX_DUP_CART_TITLES").toString());
 }
 
 
@@ -103,6 +104,7 @@ void RDSystem::setFixDuplicateCartTitles(bool state) const
   sql=QString("update `SYSTEM` set ")+
     "`FIX_DUP_CART_TITLES`='"+RDYesNo(state)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("SYSTEM");
 }
 
 
@@ -144,17 +146,7 @@ void RDSystem::setTempCartGroup(const QString &str) const
 
 bool RDSystem::showUserList() const
 {
-  bool ret=false;
-  QString sql;
-  RDSqlQuery *q;
-
-  sql="select `SHOW_USER_LIST` from `SYSTEM`";
-  q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=RDBool(q->value(0).toString());
-  }
-  delete q;
-  return ret;
+  return RDBool(GetValue("SHOW_USER_LIST").toString());
 }
 
 
@@ -165,6 +157,7 @@ void RDSystem::setShowUserList(bool state) const
   sql=QString("update `SYSTEM` set ")+
     "`SHOW_USER_LIST`='"+RDYesNo(state)+"'";
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("SYSTEM");
 }
 
 
@@ -248,15 +241,7 @@ QString RDSystem::xml() const
 
 QVariant RDSystem::GetValue(const QString &field) const
 {
-  QVariant ret;
-  QString sql=QString("select `")+
-    field+"` from `SYSTEM`";
-  RDSqlQuery *q=new RDSqlQuery(sql);
-  if(q->first()) {
-    ret=q->value(0);
-  }
-  delete q;
-  return ret;
+  return system_snapshot->value("",field);
 }
 
 
@@ -273,6 +258,7 @@ void RDSystem::SetRow(const QString &param,QString value) const
       param+"`='"+RDEscapeString(value)+"'";
   }
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("SYSTEM");
 }
 
 
@@ -283,4 +269,5 @@ void RDSystem::SetRow(const QString &param,int value) const
   sql=QString("update `SYSTEM` set `")+
     param+QString::asprintf("`=%d",value);
   RDSqlQuery::apply(sql);
+  RDRowSnapshot::notifyChanged("SYSTEM");
 }
@@ -24,10 +24,15 @@
 #include <qhostaddress.h>
 #include <qvariant.h>
 
+#include <rdrowsnapshot.h>
+
 class RDSystem
 {
  public:
   RDSystem();
+  ~RDSystem();
+  bool snapshotEnabled() const;
+  void setSnapshotEnabled(bool state);
   QString realmName() const;
   void setRealmName(const QString &str) const;
   unsigned sampleRate() const;
@@ -60,6 +65,7 @@ class RDSystem
   QVariant GetValue(const QString &field) const;
   void SetRow(const QString &param,QString value) const;
   void SetRow(const QString &param,int value) const;
+  RDRowSnapshot *system_snapshot;
 };
 
 
@@ -0,0 +1,372 @@
+// rdtranscodecache.cpp
+//
+// On-disk cache of transcoded cut audio.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "rdcut.h"
+#include "rdhash.h"
+#include "rdtranscodecache.h"
+
+RDTranscodeCache::RDTranscodeCache(RDConfig *config)
+{
+  cache_directory=config->transcodeCacheDirectory();
+  cache_maximum_size=
+    (uint64_t)config->transcodeCacheSize()*(uint64_t)1048576;
+}
+
+
+bool RDTranscodeCache::isEnabled() const
+{
+  return (!cache_directory.isEmpty())&&(cache_maximum_size>0);
+}
+
+
+QString RDTranscodeCache::directory() const
+{
+  return cache_directory;
+}
+
+
+uint64_t RDTranscodeCache::maximumSize() const
+{
+  return cache_maximum_size;
+}
+
+
+QString RDTranscodeCache::key(unsigned cartnum,int cutnum,
+			      RDSettings *settings,int start_pt,int end_pt,
+			      float speed_ratio,const QString &rdxl) const
+{
+  QString tag=RDTranscodeCache::audioTag(cartnum,cutnum);
+
+  if(tag.isEmpty()) {
+    return QString();
+  }
+  QString desc=tag+
+    QString::asprintf("|%u|%u|%u|%u|%u|%d",settings->format(),
+		      settings->sampleRate(),settings->channels(),
+		      settings->bitRate(),settings->quality(),
+		      settings->normalizationLevel())+
+    QString::asprintf("|%d|%d|%.6f|",start_pt,end_pt,speed_ratio)+
+    RDSha1HashData(rdxl.toUtf8());
+
+  return RDCut::cutName(cartnum,cutnum)+"-"+RDSha1HashData(desc.toUtf8());
+}
+
+
+QString RDTranscodeCache::lookup(const QString &key)
+{
+  QString path=EntryPath(key);
+
+  if(key.isEmpty()||(access(path.toUtf8(),R_OK)!=0)) {
+    UpdateCounters(0,1);
+    return QString();
+  }
+
+  //
+  // Mark the entry as recently used
+  //
+  utime(path.toUtf8(),NULL);
+  UpdateCounters(1,0);
+
+  return path;
+}
+
+
+QString RDTranscodeCache::scratchFile(const QString &key) const
+{
+  return cache_directory+"/."+key+QString::asprintf(".%d.tmp",getpid());
+}
+
+
+bool RDTranscodeCache::insert(const QString &key,const QString &scratch_file)
+{
+  struct stat st;
+
+  memset(&st,0,sizeof(st));
+  if(key.isEmpty()||(stat(scratch_file.toUtf8(),&st)!=0)||
+     (rename(scratch_file.toUtf8(),EntryPath(key).toUtf8())!=0)) {
+    unlink(scratch_file.toUtf8());
+    return false;
+  }
+
+  //
+  // Only walk the directory when the running total says we're over
+  // budget, or when it's due to be checked
+  //
+  if(UpdateCounters(0,0,st.st_size)) {
+    Evict();
+  }
+
+  return true;
+}
+
+
+void RDTranscodeCache::invalidate(unsigned cartnum,int cutnum)
+{
+  if(!isEnabled()) {
+    return;
+  }
+  QDir dir(cache_directory);
+  QStringList entries=
+    dir.entryList(QStringList(RDCut::cutName(cartnum,cutnum)+"-*"),
+		  QDir::Files);
+  for(int i=0;i<entries.size();i++) {
+    unlink((cache_directory+"/"+entries.at(i)).toUtf8());
+  }
+}
+
+
+uint64_t RDTranscodeCache::hits() const
+{
+  uint64_t hits=0;
+  uint64_t misses=0;
+
+  ReadCounters(&hits,&misses);
+
+  return hits;
+}
+
+
+uint64_t RDTranscodeCache::misses() const
+{
+  uint64_t hits=0;
+  uint64_t misses=0;
+
+  ReadCounters(&hits,&misses);
+
+  return misses;
+}
+
+
+uint64_t RDTranscodeCache::size() const
+{
+  uint64_t ret=0;
+  QDir dir(cache_directory);
+  QFileInfoList entries=dir.entryInfoList(QDir::Files);
+
+  for(int i=0;i<entries.size();i++) {
+    ret+=entries.at(i).size();
+  }
+
+  return ret;
+}
+
+
+QString RDTranscodeCache::audioTag(unsigned cartnum,int cutnum)
+{
+  struct stat st;
+
+  //
+  // The stored hash isn't updated by every path that can write audio,
+  // so the size and modification time of the file go into the tag as well.
+  //
+  memset(&st,0,sizeof(st));
+  if(stat(RDCut::pathName(cartnum,cutnum).toUtf8(),&st)!=0) {
+    return QString();
+  }
+  RDCut *cut=new RDCut(cartnum,cutnum);
+  QString ret=cut->sha1Hash()+
+    QString::asprintf("|%ld|%ld.%09ld",st.st_size,
+		      st.st_mtim.tv_sec,st.st_mtim.tv_nsec);
+  delete cut;
+
+  return ret;
+}
+
+
+QString RDTranscodeCache::EntryPath(const QString &key) const
+{
+  return cache_directory+"/"+key;
+}
+
+
+void RDTranscodeCache::Evict()
+{
+  uint64_t total=0;
+  time_t now=time(NULL);
+  QDir dir(cache_directory);
+
+  //
+  // Clear out scratch files abandoned by crashed exports
+  //
+  QFileInfoList scratch=
+    dir.entryInfoList(QStringList(".*.tmp"),QDir::Files|QDir::Hidden);
+  for(int i=0;i<scratch.size();i++) {
+    if((now-scratch.at(i).lastModified().toTime_t())>
+       RDTRANSCODECACHE_SCRATCH_TIMEOUT) {
+      unlink(scratch.at(i).absoluteFilePath().toUtf8());
+    }
+  }
+
+  //
+  // Drop least recently used entries until we fit the budget
+  //
+  QFileInfoList entries=dir.entryInfoList(QDir::Files,QDir::Time);
+  for(int i=0;i<entries.size();i++) {
+    total+=entries.at(i).size();
+  }
+  for(int i=entries.size()-1;(i>=0)&&(total>cache_maximum_size);i--) {
+    if(unlink(entries.at(i).absoluteFilePath().toUtf8())==0) {
+      total-=entries.at(i).size();
+    }
+  }
+  StoreSize(total);
+}
+
+
+bool RDTranscodeCache::UpdateCounters(int hits,int misses,int64_t bytes)
+{
+  int fd=-1;
+  FILE *f=NULL;
+  unsigned long long h=0;
+  unsigned long long m=0;
+  unsigned long long size=0;
+  long scanned=0;
+  time_t now=time(NULL);
+  bool ret=false;
+
+  if((fd=open((cache_directory+"/"+RDTRANSCODECACHE_COUNTERS_FILE).toUtf8(),
+	      O_RDWR|O_CREAT,S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+    return true;
+  }
+  if((f=fdopen(fd,"r+"))==NULL) {
+    close(fd);
+    return true;
+  }
+  flock(fd,LOCK_EX);
+  switch(fscanf(f,"Hits=%llu\nMisses=%llu\nSize=%llu\nScanned=%ld\n",
+		&h,&m,&size,&scanned)) {
+  case 4:
+    break;
+
+  case 2:
+  case 3:
+    size=0;   // Total not kept yet, so force a scan
+    scanned=0;
+    break;
+
+  default:
+    h=0;
+    m=0;
+    size=0;
+    scanned=0;
+    break;
+  }
+
+  //
+  // Entries removed other than by eviction (invalidation, replacement of
+  // an existing key) leave the total too high, never too low, so the
+  // worst case is an extra scan
+  //
+  if((bytes<0)&&((unsigned long long)(-bytes)>size)) {
+    size=0;
+  }
+  else {
+    size+=bytes;
+  }
+  if((bytes!=0)&&((size>cache_maximum_size)||
+		  ((now-scanned)>RDTRANSCODECACHE_SCAN_INTERVAL))) {
+    //
+    // Claim the scan, so that concurrent inserts don't all do it
+    //
+    scanned=now;
+    ret=true;
+  }
+  rewind(f);
+  fprintf(f,"Hits=%llu\nMisses=%llu\nSize=%llu\nScanned=%ld\n",
+	  h+hits,m+misses,size,scanned);
+  fflush(f);
+  ftruncate(fd,ftell(f));
+  flock(fd,LOCK_UN);
+  fclose(f);
+
+  return ret;
+}
+
+
+void RDTranscodeCache::StoreSize(uint64_t size)
+{
+  int fd=-1;
+  FILE *f=NULL;
+  unsigned long long h=0;
+  unsigned long long m=0;
+  unsigned long long old_size=0;
+  long scanned=0;
+
+  if((fd=open((cache_directory+"/"+RDTRANSCODECACHE_COUNTERS_FILE).toUtf8(),
+	      O_RDWR|O_CREAT,S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH))<0) {
+    return;
+  }
+  if((f=fdopen(fd,"r+"))==NULL) {
+    close(fd);
+    return;
+  }
+  flock(fd,LOCK_EX);
+  if(fscanf(f,"Hits=%llu\nMisses=%llu\nSize=%llu\nScanned=%ld\n",
+	    &h,&m,&old_size,&scanned)<2) {
+    h=0;
+    m=0;
+  }
+  rewind(f);
+  fprintf(f,"Hits=%llu\nMisses=%llu\nSize=%llu\nScanned=%ld\n",
+	  h,m,(unsigned long long)size,(long)time(NULL));
+  fflush(f);
+  ftruncate(fd,ftell(f));
+  flock(fd,LOCK_UN);
+  fclose(f);
+}
+
+
+bool RDTranscodeCache::ReadCounters(uint64_t *hits,uint64_t *misses) const
+{
+  FILE *f=NULL;
+  unsigned long long h=0;
+  unsigned long long m=0;
+  bool ret=false;
+
+  if((f=fopen((cache_directory+"/"+RDTRANSCODECACHE_COUNTERS_FILE).toUtf8(),
+	      "r"))==NULL) {
+    return false;
+  }
+  flock(fileno(f),LOCK_SH);
+  if(fscanf(f,"Hits=%llu\nMisses=%llu\n",&h,&m)==2) {
+    *hits=h;
+    *misses=m;
+    ret=true;
+  }
+  flock(fileno(f),LOCK_UN);
+  fclose(f);
+
+  return ret;
+}
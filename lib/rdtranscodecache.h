@@ -0,0 +1,78 @@
+// rdtranscodecache.h
+//
+// On-disk cache of transcoded cut audio.
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU Library General Public License
+//   version 2 as published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef RDTRANSCODECACHE_H
+#define RDTRANSCODECACHE_H
+
+#include <stdint.h>
+
+#include <qstring.h>
+
+#include <rdconfig.h>
+#include <rdsettings.h>
+
+//
+// Name of the file holding the hit/miss counters and the running total
+// of the cache size
+//
+#define RDTRANSCODECACHE_COUNTERS_FILE ".counters"
+
+//
+// Age after which an abandoned scratch file is removed [seconds]
+//
+#define RDTRANSCODECACHE_SCRATCH_TIMEOUT 86400
+
+//
+// Longest time between scans of the cache directory, to correct the
+// running total of the cache size [seconds]
+//
+#define RDTRANSCODECACHE_SCAN_INTERVAL 3600
+
+class RDTranscodeCache
+{
+ public:
+  RDTranscodeCache(RDConfig *config);
+  bool isEnabled() const;
+  QString directory() const;
+  uint64_t maximumSize() const;
+  QString key(unsigned cartnum,int cutnum,RDSettings *settings,
+	      int start_pt,int end_pt,float speed_ratio,
+	      const QString &rdxl) const;
+  QString lookup(const QString &key);
+  QString scratchFile(const QString &key) const;
+  bool insert(const QString &key,const QString &scratch_file);
+  void invalidate(unsigned cartnum,int cutnum);
+  uint64_t hits() const;
+  uint64_t misses() const;
+  uint64_t size() const;
+  static QString audioTag(unsigned cartnum,int cutnum);
+
+ private:
+  QString EntryPath(const QString &key) const;
+  void Evict();
+  bool UpdateCounters(int hits,int misses,int64_t bytes=0);
+  void StoreSize(uint64_t size);
+  bool ReadCounters(uint64_t *hits,uint64_t *misses) const;
+  QString cache_directory;
+  uint64_t cache_maximum_size;
+};
+
+
+#endif  // RDTRANSCODECACHE_H
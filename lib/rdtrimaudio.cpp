@@ -31,8 +31,11 @@
 #include <qstringlist.h>
 
 #include <rd.h>
+#include <rdcurlpool.h>
 #include <rdxport_interface.h>
+#include <rdcut.h>
 #include <rdformpost.h>
+#include <rdlocalxport.h>
 #include <rdtrimaudio.h>
 
 size_t RDTrimAudioCallback(void *ptr,size_t size,size_t nmemb,void *userdata)
@@ -96,6 +99,11 @@ RDTrimAudio::ErrorCode RDTrimAudio::runTrim(const QString &username,
   struct curl_httppost *first=NULL;
   struct curl_httppost *last=NULL;
 
+  if(RDLocalXport::isAvailable(conv_station,conv_config,
+			       conv_cart_number,conv_cut_number)) {
+    return RunLocal(username);
+  }
+
   //
   // Generate POST Data
   //
@@ -122,7 +130,7 @@ RDTrimAudio::ErrorCode RDTrimAudio::runTrim(const QString &username,
 	       CURLFORM_COPYCONTENTS,
 	       QString::asprintf("%u",conv_trim_level).toUtf8().constData(),
 	       CURLFORM_END);
-  if((curl=curl_easy_init())==NULL) {
+  if((curl=RDCurlPool::acquire())==NULL) {
     curl_formfree(first);
     return RDTrimAudio::ErrorInternal;
   }
@@ -136,7 +144,7 @@ RDTrimAudio::ErrorCode RDTrimAudio::runTrim(const QString &username,
 		   conv_config->userAgent().toUtf8().constData());
   curl_easy_setopt(curl,CURLOPT_TIMEOUT,RD_CURL_TIMEOUT);
 
-  switch(curl_err=curl_easy_perform(curl)) {
+  switch(curl_err=RDCurlPool::perform(curl)) {
   case CURLE_OK:
     break;
 
@@ -152,7 +160,7 @@ RDTrimAudio::ErrorCode RDTrimAudio::runTrim(const QString &username,
   default:
     //fprintf(stderr,"CURL Error: %s [%d]\n",curl_easy_strerror(curl_err),
     //curl_err);
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDTrimAudio::ErrorInternal;
 
@@ -160,12 +168,12 @@ RDTrimAudio::ErrorCode RDTrimAudio::runTrim(const QString &username,
   case CURLE_COULDNT_RESOLVE_HOST:
   case CURLE_COULDNT_CONNECT:
   case 9:   // CURLE_REMOTE_ACCESS_DENIED
-    curl_easy_cleanup(curl);
+    RDCurlPool::release(curl);
     curl_formfree(first);
     return RDTrimAudio::ErrorUrlInvalid;
   }
   curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&response_code);
-  curl_easy_cleanup(curl);
+  RDCurlPool::release(curl);
   curl_formfree(first);
 
   switch(response_code) {
@@ -219,6 +227,32 @@ QString RDTrimAudio::errorText(RDTrimAudio::ErrorCode err)
 }
 
 
+RDTrimAudio::ErrorCode RDTrimAudio::RunLocal(const QString &username)
+{
+  if(!RDLocalXport::authenticate(username)) {
+    return RDTrimAudio::ErrorInvalidUser;
+  }
+  if(!RDLocalXport::cartAuthorized(username,conv_cart_number)) {
+    return RDTrimAudio::ErrorNoAudio;
+  }
+  RDWaveFile *wave=
+    new RDWaveFile(RDCut::pathName(conv_cart_number,conv_cut_number));
+  if(!wave->openWave()) {
+    delete wave;
+    return RDTrimAudio::ErrorNoAudio;
+  }
+  if(!wave->hasEnergy()) {
+    delete wave;
+    return RDTrimAudio::ErrorService;
+  }
+  RDLocalXport::trimPoints(wave,conv_trim_level,
+			   &conv_start_point,&conv_end_point);
+  delete wave;
+
+  return RDTrimAudio::ErrorOk;
+}
+
+
 bool RDTrimAudio::ParseXml(const QString &xml)
 {
   //
@@ -43,6 +43,7 @@ class RDTrimAudio : public QObject
   static QString errorText(RDTrimAudio::ErrorCode err);
 
  private:
+  RDTrimAudio::ErrorCode RunLocal(const QString &username);
   bool ParseXml(const QString &xml);
   int ParsePoint(const QString &tag,const QString &xml);
   RDStation *conv_station;
@@ -49,9 +49,12 @@
 #endif  // HAVE_FLAC
 
 #include <rd.h>
+#include <rdaudiodedup.h>
 #include <rdcart.h>
 #include <rdwavefile.h>
 #include <rdconf.h>
+#include <rdconfig.h>
+#include <rdhash.h>
 #include <rdmp4.h>
 
 #ifdef HAVE_MP4_LIBS
@@ -65,6 +68,15 @@ RDWaveFile::RDWaveFile(QString file_name)
   //
   wave_file_name=file_name;
   wave_file.setFileName(file_name);
+  wave_reader=NULL;
+  wave_read_block_size=-1;
+  wave_read_ahead=false;
+  wave_read_requests=0;
+  wave_hashing=false;
+  wave_hash_streaming=false;
+  wave_hash_data_length=0;
+  wave_hash_bytes=0;
+  wave_metadata_pending=false;
   wave_data=NULL;
   recordable=false;
   format_chunk=false;
@@ -176,6 +188,9 @@ RDWaveFile::RDWaveFile(QString file_name)
 
 RDWaveFile::~RDWaveFile()
 {
+  if(wave_reader!=NULL) {
+    delete wave_reader;
+  }
   if(bext_coding_data!=NULL) {
     free(bext_coding_data);
   }
@@ -202,7 +217,7 @@ void RDWaveFile::nameWave(QString file_name)
 
 
 
-bool RDWaveFile::openWave(RDWaveData *data)
+bool RDWaveFile::openWave(RDWaveData *data,RDWaveFile::OpenMode mode)
 {
 #ifdef HAVE_VORBIS
   vorbis_info *vorbis_info;
@@ -211,12 +226,24 @@ bool RDWaveFile::openWave(RDWaveData *data)
   int fd=-1;
 
   wave_data=data;
+  wave_metadata_pending=false;
   if((fd=open(wave_file_name.toUtf8(),O_RDONLY))<0) {
     return false;
   }
   if(!wave_file.open(fd,QIODevice::ReadOnly,QFile::AutoCloseHandle)) {
     return false;
   }
+  if(wave_reader!=NULL) {
+    delete wave_reader;
+    wave_reader=NULL;
+  }
+  if(wave_read_block_size<0) {
+    wave_read_block_size=RDConfiguration()->audioReadBlockSize();
+    wave_read_ahead=RDConfiguration()->audioReadAhead();
+  }
+  if(wave_read_block_size>0) {
+    wave_reader=new RDBufferedReader(fd,wave_read_block_size,wave_read_ahead);
+  }
   switch(GetType(wave_file.handle())) {
   case RDWaveFile::Wave:
     if(GetFmt(wave_file.handle())) {
@@ -230,7 +257,7 @@ bool RDWaveFile::openWave(RDWaveData *data)
       return false;
     }
     data_chunk=true;
-    data_start=lseek(wave_file.handle(),0,SEEK_CUR);
+    data_start=SeekFile(wave_file.handle(),0,SEEK_CUR);
     if((!GetFact(wave_file.handle()))||(sample_length==0)) {
       if((format_tag!=WAVE_FORMAT_PCM)&&
 	 (format_tag!=WAVE_FORMAT_IEEE_FLOAT)&&format_chunk) {
@@ -260,7 +287,7 @@ bool RDWaveFile::openWave(RDWaveData *data)
 	  }
 	  data_length=wave_file.size()-data_start;
 	  sample_length=1152*(data_length/mpeg_frame_size);
-	  lseek(wave_file.handle(),data_start,SEEK_SET);
+	  SeekFile(wave_file.handle(),data_start,SEEK_SET);
 	  format_chunk=true;
 	}
       }
@@ -276,14 +303,6 @@ bool RDWaveFile::openWave(RDWaveData *data)
 	ext_time_length=0;
       }
     }
-    GetCart(wave_file.handle());
-    GetBext(wave_file.handle());
-    GetMext(wave_file.handle());
-    GetList(wave_file.handle());
-    GetScot(wave_file.handle());
-    GetAv10(wave_file.handle());
-    GetAir1(wave_file.handle());
-    GetRdxl(wave_file.handle());
     break;
 
   case RDWaveFile::Aiff:
@@ -295,7 +314,7 @@ bool RDWaveFile::openWave(RDWaveData *data)
     }
     data_length-=8;  // SSND chunk has eight data bytes at the beginning!
     data_chunk=true;
-    data_start=lseek(wave_file.handle(),8,SEEK_CUR);
+    data_start=SeekFile(wave_file.handle(),8,SEEK_CUR);
     ext_time_length=(unsigned)(1000.0*(double)sample_length/
 			       (double)samples_per_sec);
     time_length=ext_time_length/1000;
@@ -317,10 +336,9 @@ bool RDWaveFile::openWave(RDWaveData *data)
     data_start=id3v2_offset[0];
     sample_length=1152*(data_length/mpeg_frame_size);
     data_chunk=true;
-    lseek(wave_file.handle(),data_start,SEEK_SET);
+    SeekFile(wave_file.handle(),data_start,SEEK_SET);
     format_chunk=true;
     wave_type=RDWaveFile::Mpeg;
-    ReadId3Metadata();
     break;
 
   case RDWaveFile::M4A:
@@ -430,7 +448,7 @@ bool RDWaveFile::openWave(RDWaveData *data)
       (unsigned)(1000.0*(double)sample_length/(double)samples_per_sec);
     time_length=ext_time_length/1000;
     data_chunk=true;
-    lseek(wave_file.handle(),data_start,SEEK_SET);
+    SeekFile(wave_file.handle(),data_start,SEEK_SET);
     format_chunk=true;
     wave_type=RDWaveFile::Atx;	
     break;
@@ -442,9 +460,9 @@ bool RDWaveFile::openWave(RDWaveData *data)
       wave_file.close();
       return false;
     }
-    lseek(wave_file.handle(),0,SEEK_SET);
+    SeekFile(wave_file.handle(),0,SEEK_SET);
     CheckExitCode("RDWaveFile::openWave()",
-		  read(wave_file.handle(),tmc_buffer,4));
+		  ReadFile(wave_file.handle(),tmc_buffer,4));
     data_length=(0xFF&tmc_buffer[0])+(0xFF&tmc_buffer[1])*256+
       (0xFF&tmc_buffer[2])*65536+(0xFF&tmc_buffer[3])*16777216;
     data_start=atx_offset;
@@ -453,10 +471,9 @@ bool RDWaveFile::openWave(RDWaveData *data)
       (unsigned)(1000.0*(double)sample_length/(double)samples_per_sec);
     time_length=ext_time_length/1000;
     data_chunk=true;
-    lseek(wave_file.handle(),data_start,SEEK_SET);
+    SeekFile(wave_file.handle(),data_start,SEEK_SET);
     format_chunk=true;
     wave_type=RDWaveFile::Tmc;
-    ReadTmcMetadata(wave_file.handle());
     break;
 #ifdef HAVE_FLAC
   case RDWaveFile::Flac:
@@ -467,30 +484,57 @@ bool RDWaveFile::openWave(RDWaveData *data)
     }
     wave_type=RDWaveFile::Flac;
     format_chunk=true;
-    if(wave_data!=NULL) {
-      ReadId3Metadata();
-      ReadFlacMetadata();
-    }
     break;
 #endif  // HAVE_FLAC
 
   default:
+    if(wave_reader!=NULL) {
+      delete wave_reader;
+      wave_reader=NULL;
+    }
     close(wave_file.handle());
     return false;
     break;
   }
-  lseek(wave_file.handle(),data_start,SEEK_SET);
+
+  //
+  // Metadata isn't needed for playout, so in 'PlaybackOpen' mode we wait
+  // until something asks for it.
+  //
+  wave_metadata_pending=true;
+  if(mode==RDWaveFile::FullOpen) {
+    ReadMetadata();
+  }
+  SeekFile(wave_file.handle(),data_start,SEEK_SET);
 
   return true;
 }
 
 
+void RDWaveFile::setReadBuffering(int block_size,bool read_ahead)
+{
+  wave_read_block_size=block_size;
+  wave_read_ahead=read_ahead;
+}
+
+
+unsigned long long RDWaveFile::readRequests() const
+{
+  if(wave_reader!=NULL) {
+    return wave_read_requests+wave_reader->physicalReads();
+  }
+  return wave_read_requests;
+}
+
+
 bool RDWaveFile::createWave(RDWaveData *data,unsigned ptr_offset)
 {
   mode_t prev_mask;
   bool rc;
   wave_data=data;
   ptr_offset_msecs=ptr_offset;
+  wave_sha1_hash="";
+  wave_hash_streaming=false;
   if(wave_data!=NULL) {
     cart_title=wave_data->title();
     cart_artist=wave_data->artist();
@@ -526,6 +570,7 @@ bool RDWaveFile::createWave(RDWaveData *data,unsigned ptr_offset)
 	  return false;
 	}
         prev_mask = umask(0113);      // Set umask so files are user and group writable.
+	RDAudioDedup::unshare(wave_file_name);
         rc=wave_file.open(QIODevice::ReadWrite|QIODevice::Truncate);
 	unlink((wave_file_name+".energy").toUtf8());
         umask(prev_mask);
@@ -562,6 +607,9 @@ bool RDWaveFile::createWave(RDWaveData *data,unsigned ptr_offset)
 	CheckExitCode("RDWaveFile::createWave()",
 		      write(wave_file.handle(),"data\0\0\0\0",8));
 	data_start=lseek(wave_file.handle(),0,SEEK_CUR);
+	if(wave_hashing) {
+	  wave_hash_streaming=HashHeader();
+	}
 	break;
 
       case WAVE_FORMAT_VORBIS:
@@ -576,6 +624,7 @@ bool RDWaveFile::createWave(RDWaveData *data,unsigned ptr_offset)
 	vorbis_encode_ctl(&vorbis_inf,OV_ECTL_RATEMANAGE_SET,NULL);
 
         prev_mask = umask(0113);      // Set umask so files are user and group writable.
+	RDAudioDedup::unshare(wave_file_name);
 	    rc=wave_file.open(QIODevice::ReadWrite|QIODevice::Truncate);
         umask(prev_mask);
 	if(rc==false) {
@@ -663,6 +712,10 @@ void RDWaveFile::closeWave(int samples)
 	    }
 	    CheckExitCode("RDWaveFile::closeWave()",
 			  write(wave_file.handle(),sbuf,2*energy_data.size()));
+	    HashData("levl",4);
+	    HashData(size_buf,4);
+	    HashData(levl_chunk_data,LEVL_CHUNK_SIZE-8);
+	    HashData(sbuf,2*energy_data.size());
 	    delete [] sbuf;
 	    CheckExitCode("RDWaveFile::closeWave()",
 			  ftruncate(wave_file.handle(),lseek(wave_file.handle(),
@@ -755,6 +808,7 @@ void RDWaveFile::closeWave(int samples)
 					      "data",&csize)+data_length));
 	    }
 	  }
+	  FinishHash();
 	  break;
 
 	case RDWaveFile::Ogg:
@@ -779,7 +833,22 @@ void RDWaveFile::closeWave(int samples)
     }
 #endif  // HAVE_VORBIS
   }
+  if(wave_reader!=NULL) {
+    wave_read_requests+=wave_reader->physicalReads();
+    delete wave_reader;
+    wave_reader=NULL;
+  }
   wave_file.close();
+  if(wave_hashing) {
+    if(wave_sha1_hash.isEmpty()) {
+      wave_sha1_hash=RDSha1HashFile(wave_file_name);
+    }
+    wave_hashing=false;
+    wave_hash_streaming=false;
+    wave_hash_data_length=0;
+    wave_hash_header.clear();
+  }
+  wave_metadata_pending=false;
   recordable=false;
   time_length=0;
   format_chunk=false;
@@ -886,8 +955,22 @@ void RDWaveFile::closeWave(int samples)
 }
 
 
+void RDWaveFile::setHashing(bool state,unsigned data_length)
+{
+  wave_hashing=state;
+  wave_hash_data_length=data_length;
+}
+
+
+QString RDWaveFile::sha1Hash() const
+{
+  return wave_sha1_hash;
+}
+
+
 void RDWaveFile::resetWave()
 {
+  wave_hash_streaming=false;
   if(wave_type!=RDWaveFile::Ogg) {
     lseek(wave_file.handle(),data_start,SEEK_SET);
     CheckExitCode("RDWaveFile::resetWave()",
@@ -978,7 +1061,7 @@ int RDWaveFile::readWave(void *buf,int count)
 	return 0;
 
       case RDWaveFile::Wave:
-	pos = lseek(wave_file.handle(),0,SEEK_CUR);
+	pos = SeekFile(wave_file.handle(),0,SEEK_CUR);
 	//
 	// FIXME: how fix comparing singed (data_start, count) vs. 
 	// unsigned (pos, data_length) ... WAVE standard is 32 bit, 
@@ -988,10 +1071,10 @@ int RDWaveFile::readWave(void *buf,int count)
         if (((pos+count)>(data_start+data_length))&&(data_length>0)) {
           count=count - ( (pos+count) - (data_start+data_length) );
         }
-	c = read(wave_file.handle(),buf,count);
+	c = ReadFile(wave_file.handle(),buf,count);
 	break;
       default:
-	c = read(wave_file.handle(),buf,count);
+	c = ReadFile(wave_file.handle(),buf,count);
   }
   if ( c <0 ) return 0; // read error
   // Fixup the buffer for big endian hosts (Wav is defined as LE).
@@ -1076,7 +1159,7 @@ int RDWaveFile::writeWave(void *buf,int count)
 	  WriteSword((unsigned char *)buf,2*i,s);
 	}
       }
-      return write(wave_file.handle(),buf,count);
+      return WriteData(buf,count);
 
     case 24:
       if(levl_chunk) {
@@ -1140,7 +1223,7 @@ int RDWaveFile::writeWave(void *buf,int count)
       }
       lseek(wave_file.handle(),0,SEEK_END);
       data_length+=count;
-      return write(wave_file.handle(),buf,count);
+      return WriteData(buf,count);
     }
 
   case WAVE_FORMAT_MPEG:
@@ -1184,7 +1267,7 @@ int RDWaveFile::writeWave(void *buf,int count)
     }
     lseek(wave_file.handle(),0,SEEK_END);
     data_length+=count;
-    return write(wave_file.handle(),buf,count);
+    return WriteData(buf,count);
 
   case WAVE_FORMAT_VORBIS:
     WriteOggBuffer((char *)buf,count);
@@ -1355,12 +1438,12 @@ int RDWaveFile::seekWave(int offset,int whence)
               if((unsigned)offset>data_length) {
                 offset=data_length;
               }
-              return lseek(wave_file.handle(),
+              return SeekFile(wave_file.handle(),
                            offset+data_start,SEEK_SET)-data_start;
               break;
 
             case SEEK_CUR:
-              pos = lseek(wave_file.handle(),0,SEEK_CUR);
+              pos = SeekFile(wave_file.handle(),0,SEEK_CUR);
 	      abspos=pos+offset;
 	      if((pos+offset)<0) {
 		abspos=0;
@@ -1371,10 +1454,10 @@ int RDWaveFile::seekWave(int offset,int whence)
               if (abspos>(data_start+data_length)) { 
                 offset=offset - (abspos - (data_start+data_length));
               }
-              return lseek(wave_file.handle(),offset,SEEK_CUR)-data_start;
+              return SeekFile(wave_file.handle(),offset,SEEK_CUR)-data_start;
               break;
             case SEEK_END:
-              pos = lseek(wave_file.handle(),0,SEEK_END);
+              pos = SeekFile(wave_file.handle(),0,SEEK_END);
 	      abspos=pos+offset;
 	      if((pos+offset)<0) {
 		abspos=0;
@@ -1385,7 +1468,7 @@ int RDWaveFile::seekWave(int offset,int whence)
               if (abspos>(data_start+data_length)) {
                 offset=offset - (abspos - (data_start+data_length));
               }
-              return lseek(wave_file.handle(),offset,SEEK_END)-data_start;
+              return SeekFile(wave_file.handle(),offset,SEEK_END)-data_start;
               break;
         }
         break;
@@ -1393,14 +1476,14 @@ int RDWaveFile::seekWave(int offset,int whence)
       default:
 	switch(whence) {
 	    case SEEK_SET:
-	      return lseek(wave_file.handle(),
+	      return SeekFile(wave_file.handle(),
 			   offset+data_start,SEEK_SET)-data_start;
 	      break;
 	    case SEEK_CUR:
-	      return lseek(wave_file.handle(),offset,SEEK_CUR)-data_start;
+	      return SeekFile(wave_file.handle(),offset,SEEK_CUR)-data_start;
 	      break;
 	    case SEEK_END:
-	      return lseek(wave_file.handle(),offset,SEEK_END)-data_start;
+	      return SeekFile(wave_file.handle(),offset,SEEK_END)-data_start;
 	      break;
 	}
   }
@@ -1549,6 +1632,7 @@ unsigned short RDWaveFile::getHeadFlags() const
 
 bool RDWaveFile::getCartChunk() const
 {
+  LoadMetadata();
   return cart_chunk;
 }
 
@@ -1563,12 +1647,14 @@ void RDWaveFile::setCartChunk(bool state)
 
 unsigned RDWaveFile::getCartVersion() const
 {
+  LoadMetadata();
   return cart_version;
 }
 
 
 QString RDWaveFile::getCartTitle() const
 {
+  LoadMetadata();
   return cart_title;
 }
 
@@ -1581,6 +1667,7 @@ void RDWaveFile::setCartTitle(QString string)
 
 QString RDWaveFile::getCartArtist() const
 {
+  LoadMetadata();
   return cart_artist;
 }
 
@@ -1593,6 +1680,7 @@ void RDWaveFile::setCartArtist(QString string)
 
 QString RDWaveFile::getCartCutID() const
 {
+  LoadMetadata();
   return cart_cut_id;
 }
 
@@ -1605,6 +1693,7 @@ void RDWaveFile::setCartCutID(QString string)
 
 QString RDWaveFile::getCartClientID() const
 {
+  LoadMetadata();
   return cart_client_id;
 }
 
@@ -1617,6 +1706,7 @@ void RDWaveFile::setCartClientID(QString string)
 
 QString RDWaveFile::getCartCategory() const
 {
+  LoadMetadata();
   return cart_category;
 }
 
@@ -1629,6 +1719,7 @@ void RDWaveFile::setCartCategory(QString string)
 
 QString RDWaveFile::getCartClassification() const
 {
+  LoadMetadata();
   return cart_classification;
 }
 
@@ -1641,6 +1732,7 @@ void RDWaveFile::setCartClassification(QString string)
 
 QString RDWaveFile::getCartOutCue() const
 {
+  LoadMetadata();
   return cart_out_cue;
 }
 
@@ -1653,6 +1745,7 @@ void RDWaveFile::setCartOutCue(QString string)
 
 QDate RDWaveFile::getCartStartDate() const
 {
+  LoadMetadata();
   return cart_start_date;
 }
 
@@ -1665,6 +1758,7 @@ void RDWaveFile::setCartStartDate(QDate date)
 
 QTime RDWaveFile::getCartStartTime() const
 {
+  LoadMetadata();
   return cart_start_time;
 }
 
@@ -1677,6 +1771,7 @@ void RDWaveFile::setCartStartTime(QTime time)
 
 QDate RDWaveFile::getCartEndDate() const
 {
+  LoadMetadata();
   return cart_end_date;
 }
 
@@ -1689,6 +1784,7 @@ void RDWaveFile::setCartEndDate(QDate date)
 
 QTime RDWaveFile::getCartEndTime() const
 {
+  LoadMetadata();
   return cart_end_time;
 }
 
@@ -1701,18 +1797,21 @@ void RDWaveFile::setCartEndTime(QTime time)
 
 QString RDWaveFile::getCartProducerAppID() const
 {
+  LoadMetadata();
   return cart_producer_app_id;
 }
 
 
 QString RDWaveFile::getCartProducerAppVer() const
 {
+  LoadMetadata();
   return cart_producer_app_ver;
 }
 
 
 QString RDWaveFile::getCartUserDef() const
 {
+  LoadMetadata();
   return cart_user_def;
 }
 
@@ -1725,6 +1824,7 @@ void RDWaveFile::setCartUserDef(QString string)
 
 unsigned RDWaveFile::getCartLevelRef() const
 {
+  LoadMetadata();
   return cart_level_ref;
 }
 
@@ -1737,6 +1837,7 @@ void RDWaveFile::setCartLevelRef(unsigned level)
 
 QString RDWaveFile::getCartTimerLabel(int index) const
 {
+  LoadMetadata();
   if(index<MAX_TIMERS) {
     return cart_timer_label[index];
   }
@@ -1746,6 +1847,7 @@ QString RDWaveFile::getCartTimerLabel(int index) const
 
 unsigned RDWaveFile::getCartTimerSample(int index) const
 {
+  LoadMetadata();
   if(index<MAX_TIMERS) {
     return cart_timer_sample[index];
   }
@@ -1755,6 +1857,7 @@ unsigned RDWaveFile::getCartTimerSample(int index) const
 
 QString RDWaveFile::getCartURL() const
 {
+  LoadMetadata();
   return cart_url;
 }
 
@@ -1767,12 +1870,14 @@ void RDWaveFile::setCartURL(QString string)
 
 QString RDWaveFile::getCartTagText() const
 {
+  LoadMetadata();
   return cart_tag_text;
 }
 
 
 bool RDWaveFile::getBextChunk() const
 {
+  LoadMetadata();
   return bext_chunk;
 }
 
@@ -1787,6 +1892,7 @@ void RDWaveFile::setBextChunk(bool state)
 
 QString RDWaveFile::getBextDescription() const
 {
+  LoadMetadata();
   return bext_description;
 }
 
@@ -1799,6 +1905,7 @@ void RDWaveFile::setBextDescription(QString string)
 
 QString RDWaveFile::getBextOriginator() const
 {
+  LoadMetadata();
   return bext_originator;
 }
 
@@ -1811,6 +1918,7 @@ void RDWaveFile::setBextOriginator(QString string)
 
 QString RDWaveFile::getBextOriginatorRef() const
 {
+  LoadMetadata();
   return bext_originator_ref;
 }
 
@@ -1823,6 +1931,7 @@ void RDWaveFile::setBextOriginatorRef(QString string)
 
 QDate RDWaveFile::getBextOriginationDate() const
 {
+  LoadMetadata();
   return bext_origination_date;
 }
 
@@ -1835,6 +1944,7 @@ void RDWaveFile::setBextOriginationDate(QDate date)
 
 QTime RDWaveFile::getBextOriginationTime() const
 {
+  LoadMetadata();
   return bext_origination_time;
 }
 
@@ -1847,6 +1957,7 @@ void RDWaveFile::setBextOriginationTime(QTime time)
 
 unsigned RDWaveFile::getBextTimeReferenceLow() const
 {
+  LoadMetadata();
   return bext_time_reference_low;
 }
 
@@ -1859,6 +1970,7 @@ void RDWaveFile::setBextTimeReferenceLow(unsigned sample)
 
 unsigned RDWaveFile::getBextTimeReferenceHigh() const
 {
+  LoadMetadata();
   return bext_time_reference_low;
 }
 
@@ -1871,12 +1983,14 @@ void RDWaveFile::setBextTimeReferenceHigh(unsigned sample)
 
 unsigned short RDWaveFile::getBextVersion() const
 {
+  LoadMetadata();
   return bext_version;
 }
 
 
 void RDWaveFile::getBextUMD(unsigned char *buf) const
 {
+  LoadMetadata();
   for(int i=0;i<64;i++) {
     buf[i]=bext_umid[i];
   }
@@ -1893,6 +2007,7 @@ void RDWaveFile::setBextUMD(unsigned char *buf)
 
 QString RDWaveFile::getBextCodingHistory() const
 {
+  LoadMetadata();
   return bext_coding_history;
 }
 
@@ -1907,6 +2022,7 @@ void RDWaveFile::setBextCodingHistory(QString string)
 
 bool RDWaveFile::getMextChunk() const
 {
+  LoadMetadata();
   return mext_chunk;
 }
 
@@ -1921,6 +2037,7 @@ void RDWaveFile::setMextChunk(bool state)
 
 bool RDWaveFile::getMextHomogenous() const
 {
+  LoadMetadata();
   return mext_homogenous;
 }
 
@@ -1933,6 +2050,7 @@ void RDWaveFile::setMextHomogenous(bool state)
 
 bool RDWaveFile::getMextPaddingUsed() const
 {
+  LoadMetadata();
   return mext_padding_used;
 }
 
@@ -1945,6 +2063,7 @@ void RDWaveFile::setMextPaddingUsed(bool state)
 
 bool RDWaveFile::getMextHackedBitRate() const
 {
+  LoadMetadata();
   return mext_rate_hacked;
 }
 
@@ -1957,6 +2076,7 @@ void RDWaveFile::setMextHackedBitRate(bool state)
 
 bool RDWaveFile::getMextFreeFormat() const
 {
+  LoadMetadata();
   return mext_free_format;
 }
 
@@ -1969,6 +2089,7 @@ void RDWaveFile::setMextFreeFormat(bool state)
 
 int RDWaveFile::getMextFrameSize() const
 {
+  LoadMetadata();
   return mext_frame_size;
 }
 
@@ -1981,6 +2102,7 @@ void RDWaveFile::setMextFrameSize(int size)
 
 int RDWaveFile::getMextAncillaryLength() const
 {
+  LoadMetadata();
   return mext_anc_length;
 }
 
@@ -1993,6 +2115,7 @@ void RDWaveFile::setMextAncillaryLength(int length)
 
 bool RDWaveFile::getMextLeftEnergyPresent() const
 {
+  LoadMetadata();
   return mext_left_energy;
 }
 
@@ -2005,6 +2128,7 @@ void RDWaveFile::setMextLeftEnergyPresent(bool state)
 
 bool RDWaveFile::getMextPrivateDataPresent() const
 {
+  LoadMetadata();
   return mext_ancillary_private;
 }
 
@@ -2017,6 +2141,7 @@ void RDWaveFile::setMextPrivateDataPresent(bool state)
 
 bool RDWaveFile::getMextRightEnergyPresent() const
 {
+  LoadMetadata();
   return mext_right_energy;
 }
 
@@ -2101,24 +2226,28 @@ void RDWaveFile::setSerialNumber(int serial)
 
 bool RDWaveFile::getScotChunk() const
 {
+  LoadMetadata();
   return scot_chunk;
 }
 
 
 bool RDWaveFile::getAIR1Chunk() const
 {
+  LoadMetadata();
   return AIR1_chunk;
 }
 
 
 bool RDWaveFile::getRdxlChunk() const
 {
+  LoadMetadata();
   return rdxl_chunk;
 }
 
 
 QString RDWaveFile::getRdxlContents() const
 {
+  LoadMetadata();
   return rdxl_contents;
 }
 
@@ -2275,8 +2404,8 @@ bool RDWaveFile::IsWav(int fd)
   /* 
    * Is this a riff file? 
    */
-  lseek(fd,0,SEEK_SET);
-  i=read(fd,buffer,4);
+  SeekFile(fd,0,SEEK_SET);
+  i=ReadFile(fd,buffer,4);
   if(i==4) {
     buffer[4]=0;
     if(strcmp("RIFF",buffer)!=0) {
@@ -2290,10 +2419,10 @@ bool RDWaveFile::IsWav(int fd)
   /* 
    * Is this a WAVE file? 
    */
-  if(lseek(fd,8,SEEK_SET)!=8) {
+  if(SeekFile(fd,8,SEEK_SET)!=8) {
     return false;
   }
-  i=read(fd,buffer,4);
+  i=ReadFile(fd,buffer,4);
   if(i==4) {
     buffer[4]=0;
     if(strcmp("WAVE",buffer)!=0) {
@@ -2319,8 +2448,8 @@ bool RDWaveFile::IsMpeg(int fd)
   id3v2_offset[0]=0;
   id3v2_offset[1]=0;
 
-  lseek(fd,0,SEEK_SET);
-  if((i=read(fd,buffer,10))!=10) {
+  SeekFile(fd,0,SEEK_SET);
+  if((i=ReadFile(fd,buffer,10))!=10) {
     return false;
   }
   buffer[3]=0;
@@ -2329,19 +2458,19 @@ bool RDWaveFile::IsMpeg(int fd)
     id3v2_offset[0]=
       (buffer[9]|(buffer[8]<<7)|(buffer[7]<<14)|(buffer[6]<<21))+10;
   }  
-  lseek(fd,id3v2_offset[0],SEEK_SET);
-  if((i=read(fd,buffer,2))!=2) {
+  SeekFile(fd,id3v2_offset[0],SEEK_SET);
+  if((i=ReadFile(fd,buffer,2))!=2) {
     return false;
   }
   if((buffer[0]==0xFF)&&((buffer[1]&0xE0)==0xE0)) {
     return true;
   }
-  while(read(fd,buffer,1)==1) {
+  while(ReadFile(fd,buffer,1)==1) {
     if(buffer[0]==0xFF) {  // Could be it -- check the next byte
-      if(read(fd,buffer,1)==1) {
+      if(ReadFile(fd,buffer,1)==1) {
 	if((buffer[0]&0xF0)==0xF0) {  // Got it -- fix things up
 	  id3v2_tag[0]=true;
-	  id3v2_offset[0]=lseek(fd,0,SEEK_CUR)-2;
+	  id3v2_offset[0]=SeekFile(fd,0,SEEK_CUR)-2;
 	  return true;
 	}
       }
@@ -2367,8 +2496,8 @@ bool RDWaveFile::IsAtx(int fd)
 {
   char buffer[6];
 
-  lseek(fd,0,SEEK_SET);
-  if(read(fd,buffer,5)!=5) {
+  SeekFile(fd,0,SEEK_SET);
+  if(ReadFile(fd,buffer,5)!=5) {
     return false;
   }
   buffer[5]=0;
@@ -2384,8 +2513,8 @@ bool RDWaveFile::IsTmc(int fd)
 {
   unsigned char buffer[7];
 
-  lseek(fd,0,SEEK_SET);
-  if(read(fd,buffer,6)!=6) {
+  SeekFile(fd,0,SEEK_SET);
+  if(ReadFile(fd,buffer,6)!=6) {
     return false;
   }
   buffer[6]=0;
@@ -2402,8 +2531,8 @@ bool RDWaveFile::IsFlac(int fd)
   char buffer[5];
 
   ID3_Tag id3_tag(wave_file_name.toUtf8());
-  lseek(fd,id3_tag.GetPrependedBytes(),SEEK_SET);
-  if(read(fd,buffer,4)!=4) {
+  SeekFile(fd,id3_tag.GetPrependedBytes(),SEEK_SET);
+  if(ReadFile(fd,buffer,4)!=4) {
     return false;
   }
   buffer[4]=0;
@@ -2422,8 +2551,8 @@ bool RDWaveFile::IsAiff(int fd)
   int i;
   char buffer[5];
   
-  lseek(fd,0,SEEK_SET);
-  i=read(fd,buffer,4);
+  SeekFile(fd,0,SEEK_SET);
+  i=ReadFile(fd,buffer,4);
   if(i==4) {
     buffer[4]=0;
     if(strcmp("FORM",buffer)!=0) {
@@ -2434,10 +2563,10 @@ bool RDWaveFile::IsAiff(int fd)
     return false;
   }
 
-  if(lseek(fd,8,SEEK_SET)!=8) {
+  if(SeekFile(fd,8,SEEK_SET)!=8) {
     return false;
   }
-  i=read(fd,buffer,4);
+  i=ReadFile(fd,buffer,4);
   if(i==4) {
     buffer[4]=0;
     if(strcmp("AIFF",buffer)!=0) {
@@ -2474,15 +2603,15 @@ off_t RDWaveFile::FindChunk(int fd,const char *chunk_name,unsigned *chunk_size,
   char name[5]={0,0,0,0,0};
   unsigned char buffer[4];
 
-  lseek(fd,12,SEEK_SET);
-  offset=read(fd,name,4);
+  SeekFile(fd,12,SEEK_SET);
+  offset=ReadFile(fd,name,4);
   if(!isalnum(0xff&name[0])) {
     name[0]=name[1];
     name[1]=name[2];
     name[2]=name[3];
-    offset=read(fd,name+3,1);
+    offset=ReadFile(fd,name+3,1);
   }
-  offset=read(fd,buffer,4);
+  offset=ReadFile(fd,buffer,4);
   if(big_end) {
     *chunk_size=
       buffer[3]+(256*buffer[2])+(65536*buffer[1])+(16777216*buffer[0]);
@@ -2493,10 +2622,10 @@ off_t RDWaveFile::FindChunk(int fd,const char *chunk_name,unsigned *chunk_size,
   }
   while(offset==4) {
     if(strcasecmp(chunk_name,name)==0) {
-      return lseek(fd,0,SEEK_CUR);
+      return SeekFile(fd,0,SEEK_CUR);
     }
-    lseek(fd,*chunk_size,SEEK_CUR);
-    offset=read(fd,name,4);
+    SeekFile(fd,*chunk_size,SEEK_CUR);
+    offset=ReadFile(fd,name,4);
     //
     // Attempt to work around known fencepost errors in WAV files generated by
     // "Sonic Studio soundBlade" by "PME Mastering, Inc." (and perhaps others?)
@@ -2505,9 +2634,9 @@ off_t RDWaveFile::FindChunk(int fd,const char *chunk_name,unsigned *chunk_size,
       name[0]=name[1];
       name[1]=name[2];
       name[2]=name[3];
-      offset=read(fd,name+3,1);
+      offset=ReadFile(fd,name+3,1);
     }
-    offset=read(fd,buffer,4);
+    offset=ReadFile(fd,buffer,4);
     if(big_end) {
       *chunk_size=buffer[3]+(256*buffer[2])+(65536*buffer[1])+
 	(16777216*buffer[0]);
@@ -2528,8 +2657,8 @@ bool RDWaveFile::GetChunk(int fd,const char *chunk_name,unsigned *chunk_size,
   if((pos=FindChunk(fd,chunk_name,chunk_size,big_end))<0) {
     return false;
   }
-  lseek(fd,SEEK_SET,pos);
-  CheckExitCode("RDWaveFile::GetChunk()",read(fd,chunk,size));
+  SeekFile(fd,pos,SEEK_SET);
+  CheckExitCode("RDWaveFile::GetChunk()",ReadFile(fd,chunk,size));
   return true;
 }
 
@@ -2632,7 +2761,7 @@ bool RDWaveFile::GetFmt(int fd)
     if(!GetChunk(wave_file.handle(),"data",&data_length,NULL,0)) {
       return false;
     }
-    data_start=lseek(wave_file.handle(),0,SEEK_CUR);
+    data_start=SeekFile(wave_file.handle(),0,SEEK_CUR);
     GetMpegHeader(fd,data_start);
     format_tag=WAVE_FORMAT_MPEG;
   }
@@ -2720,7 +2849,7 @@ bool RDWaveFile::GetCart(int fd)
     if(chunk_size>2048) {
       tag_buffer=(char *)malloc(chunk_size-2048+1);
       CheckExitCode("RDWaveFile::GetCart()",
-		    read(wave_file.handle(),tag_buffer,chunk_size-2048));
+		    ReadFile(wave_file.handle(),tag_buffer,chunk_size-2048));
       tag_buffer[chunk_size-2048]=0;
       cart_tag_text=tag_buffer;
       free(tag_buffer);
@@ -2845,7 +2974,7 @@ bool RDWaveFile::GetBext(int fd)
   if(chunk_size>602) {
     tag_buffer=(char *)malloc(chunk_size-602+1);
     CheckExitCode("RDWaveFile::GetBext()",
-		  read(wave_file.handle(),tag_buffer,chunk_size-602));
+		  ReadFile(wave_file.handle(),tag_buffer,chunk_size-602));
     tag_buffer[chunk_size-602]=0;
     bext_coding_history=tag_buffer;
     free(tag_buffer);
@@ -2934,11 +3063,11 @@ bool RDWaveFile::GetLevl(int fd)
   if(levl_block_size!=1152) {
     return true;
   }
-  lseek(wave_file.handle(),FindChunk(wave_file.handle(),"levl",&size)+
+  SeekFile(wave_file.handle(),FindChunk(wave_file.handle(),"levl",&size)+
 	levl_block_offset-8,SEEK_SET);
   for(unsigned i=1;i<levl_frames;i++) {
     for(int j=0;j<levl_channels;j++) {
-      CheckExitCode("RDWaveFile::GetLevl()",read(wave_file.handle(),frame,2));
+      CheckExitCode("RDWaveFile::GetLevl()",ReadFile(wave_file.handle(),frame,2));
       energy_data.push_back(frame[0]+256*frame[1]);
     }
   }
@@ -3212,10 +3341,10 @@ bool RDWaveFile::GetRdxl(int fd)
   if((pos=FindChunk(fd,"rdxl",&chunk_size))<0) {
     return false;
   }
-  lseek(fd,SEEK_SET,pos);
+  SeekFile(fd,pos,SEEK_SET);
   chunk=new char[chunk_size+1];
   memset(chunk,0,chunk_size+1);
-  CheckExitCode("RDWaveFile::GetRdxl()",read(fd,chunk,chunk_size));
+  CheckExitCode("RDWaveFile::GetRdxl()",ReadFile(fd,chunk,chunk_size));
   rdxl_contents=QString::fromUtf8(chunk);
   delete chunk;
 
@@ -3262,7 +3391,7 @@ bool RDWaveFile::GetList(int fd)
     return false;
   }
   unsigned char *chunk_data=new unsigned char[chunk_size];
-  CheckExitCode("RDWaveFile::GetList()",read(fd,chunk_data,chunk_size));
+  CheckExitCode("RDWaveFile::GetList()",ReadFile(fd,chunk_data,chunk_size));
   unsigned offset=4;
   while(ReadListElement(chunk_data,&offset,chunk_size));
   if((wave_data->segueStartPos()>=0)&&(wave_data->segueEndPos()<0)) {
@@ -3367,7 +3496,7 @@ bool RDWaveFile::ReadTmcMetadata(int fd)
   char buffer[256];
   QString current_tag;
 
-  lseek(fd,data_length+4,SEEK_SET);
+  SeekFile(fd,data_length+4,SEEK_SET);
   while(GetLine(fd,buffer,255)) {
     if(buffer[0]=='#') {
       current_tag=QString(buffer+1);
@@ -3452,7 +3581,7 @@ void RDWaveFile::ReadTmcTag(const QString tag,const QString value)
 bool RDWaveFile::GetLine(int fd,char *buffer,int max_len)
 {
   for(int i=0;i<max_len;i++) {
-    if(read(fd,buffer+i,1)==0) {
+    if(ReadFile(fd,buffer+i,1)==0) {
       return false;
     }
     if(buffer[i]==10) {
@@ -3744,8 +3873,8 @@ bool RDWaveFile::GetMpegHeader(int fd,int offset)
   int frame_size;
   int total_frame_quan=-1;
 
-  lseek(fd,offset,SEEK_SET);
-  if((n=read(fd,header,4))!=4) {
+  SeekFile(fd,offset,SEEK_SET);
+  if((n=ReadFile(fd,header,4))!=4) {
     return false;
   }
   //  frame_start=lseek(fd,0,SEEK_CUR)-4;
@@ -3837,7 +3966,7 @@ bool RDWaveFile::GetMpegHeader(int fd,int offset)
   // Load the frame data
   //
   frame=new char[frame_size];
-  if((n=read(fd,frame,frame_size-4))!=(frame_size-4)) {
+  if((n=ReadFile(fd,frame,frame_size-4))!=(frame_size-4)) {
     delete frame;
     return false;
   }
@@ -3887,9 +4016,9 @@ bool RDWaveFile::GetMpegHeader(int fd,int offset)
 int RDWaveFile::GetAtxOffset(int fd)
 {
   unsigned char buffer[MAX_ATX_HEADER_SIZE];
-  lseek(fd,0,SEEK_SET);
+  SeekFile(fd,0,SEEK_SET);
 
-  int n=read(fd,buffer,MAX_ATX_HEADER_SIZE-1);
+  int n=ReadFile(fd,buffer,MAX_ATX_HEADER_SIZE-1);
   for(int i=0;i<n;i++) {
     if(buffer[i]==0xFF) {
       return i;
@@ -4409,6 +4538,7 @@ void RDWaveFile::GetEnergy()
 {
   int file_ptr;
 
+  LoadMetadata();  // For the levl chunk and MPEG extension energy
   ReadEnergyFile(wave_file_name);
   
   if(!levl_chunk) {
@@ -4417,11 +4547,11 @@ void RDWaveFile::GetEnergy()
   if(energy_loaded) {
     return;
   }
-  file_ptr=lseek(wave_file.handle(),0,SEEK_CUR);
-  lseek(wave_file.handle(),0,SEEK_SET);
+  file_ptr=SeekFile(wave_file.handle(),0,SEEK_CUR);
+  SeekFile(wave_file.handle(),0,SEEK_SET);
   LoadEnergy();
   energy_loaded=true;
-  lseek(wave_file.handle(),file_ptr,SEEK_SET);
+  SeekFile(wave_file.handle(),file_ptr,SEEK_SET);
 }
 
 
@@ -4442,8 +4572,8 @@ unsigned RDWaveFile::LoadEnergy()
   case WAVE_FORMAT_MPEG:
     if((head_layer==2)&&(mext_left_energy||mext_right_energy)) {
       while(i<energy_size) {
-	lseek(wave_file.handle(),block_align-5,SEEK_CUR);
-	if(read(wave_file.handle(),block,5)<5) {
+	SeekFile(wave_file.handle(),block_align-5,SEEK_CUR);
+	if(ReadFile(wave_file.handle(),block,5)<5) {
 	  has_energy=true;
 	  return i;
 	}
@@ -4470,7 +4600,7 @@ unsigned RDWaveFile::LoadEnergy()
     case 16:
       block_size=2304*channels;
       while(i<energy_size) {
-	if(read(wave_file.handle(),pcm,block_size)!=block_size) {
+	if(ReadFile(wave_file.handle(),pcm,block_size)!=block_size) {
 	  has_energy=true;
 	  return i;
 	}
@@ -4491,7 +4621,7 @@ unsigned RDWaveFile::LoadEnergy()
     case 24:
       block_size=3456*channels;
       while(i<energy_size) {
-	if(read(wave_file.handle(),pcm,block_size)!=block_size) {
+	if(ReadFile(wave_file.handle(),pcm,block_size)!=block_size) {
 	  has_energy=true;
 	  return i;
 	}
@@ -4685,3 +4815,159 @@ int RDWaveFile::CheckExitCode(const QString &msg,int exit_code)
   }
   return exit_code;
 }
+
+
+ssize_t RDWaveFile::ReadFile(int fd,void *buf,size_t count)
+{
+  if((wave_reader!=NULL)&&(wave_reader->fd()==fd)) {
+    return wave_reader->read(buf,count);
+  }
+  wave_read_requests++;
+  return read(fd,buf,count);
+}
+
+
+off_t RDWaveFile::SeekFile(int fd,off_t offset,int whence)
+{
+  if((wave_reader!=NULL)&&(wave_reader->fd()==fd)) {
+    return wave_reader->seek(offset,whence);
+  }
+  return lseek(fd,offset,whence);
+}
+
+
+int RDWaveFile::WriteData(const void *buf,int count)
+{
+  int n=write(wave_file.handle(),buf,count);
+
+  if(n!=count) {
+    wave_hash_streaming=false;
+  }
+  HashData(buf,count);
+
+  return n;
+}
+
+
+bool RDWaveFile::HashHeader()
+{
+  //
+  // Given the final length of the audio, we know what the header will
+  // look like once closeWave() has updated it, so the file can be hashed
+  // as it is written. FinishHash() checks the guess.
+  //
+  if((format_tag!=WAVE_FORMAT_PCM)||(wave_hash_data_length==0)||
+     ((bits_per_sample!=16)&&(bits_per_sample!=24))||(block_align==0)) {
+    return false;
+  }
+  unsigned riff_size=data_start+wave_hash_data_length-8;
+  if(levl_chunk) {
+    riff_size+=LEVL_CHUNK_SIZE+
+      2*channels*(wave_hash_data_length/block_align/1152+1);
+  }
+  wave_hash_header=QByteArray(data_start,0);
+  if(pread(wave_file.handle(),wave_hash_header.data(),data_start,0)!=
+     data_start) {
+    return false;
+  }
+  WriteDword((unsigned char *)wave_hash_header.data(),4,riff_size);
+  WriteDword((unsigned char *)wave_hash_header.data(),data_start-4,
+	     wave_hash_data_length);
+  SHA1_Init(&wave_hash_ctx);
+  SHA1_Update(&wave_hash_ctx,wave_hash_header.constData(),data_start);
+  wave_hash_bytes=data_start;
+
+  return true;
+}
+
+
+void RDWaveFile::HashData(const void *buf,size_t count)
+{
+  if(wave_hash_streaming) {
+    SHA1_Update(&wave_hash_ctx,buf,count);
+    wave_hash_bytes+=count;
+  }
+}
+
+
+void RDWaveFile::FinishHash()
+{
+  unsigned char md[SHA_DIGEST_LENGTH];
+
+  if(!wave_hash_streaming) {
+    return;
+  }
+  wave_hash_streaming=false;
+
+  //
+  // Anything that doesn't match what was hashed gets the file read back
+  // instead (see closeWave()).
+  //
+  QByteArray header(data_start,0);
+  if((data_length!=wave_hash_data_length)||
+     (lseek(wave_file.handle(),0,SEEK_END)!=(off_t)wave_hash_bytes)||
+     (pread(wave_file.handle(),header.data(),data_start,0)!=data_start)||
+     (header!=wave_hash_header)) {
+    return;
+  }
+  SHA1_Final(md,&wave_hash_ctx);
+  wave_sha1_hash="";
+  for(int i=0;i<SHA_DIGEST_LENGTH;i++) {
+    wave_sha1_hash+=QString::asprintf("%02x",0xff&md[i]);
+  }
+}
+
+
+void RDWaveFile::ReadMetadata()
+{
+  off_t pos;
+
+  if(!wave_metadata_pending) {
+    return;
+  }
+  wave_metadata_pending=false;
+  if(!wave_file.isOpen()) {
+    return;
+  }
+  pos=SeekFile(wave_file.handle(),0,SEEK_CUR);
+  switch(wave_type) {
+  case RDWaveFile::Wave:
+  case RDWaveFile::Ambos:
+    GetCart(wave_file.handle());
+    GetBext(wave_file.handle());
+    GetMext(wave_file.handle());
+    GetList(wave_file.handle());
+    GetScot(wave_file.handle());
+    GetAv10(wave_file.handle());
+    GetAir1(wave_file.handle());
+    GetRdxl(wave_file.handle());
+    break;
+
+  case RDWaveFile::Mpeg:
+    ReadId3Metadata();
+    break;
+
+  case RDWaveFile::Tmc:
+    ReadTmcMetadata(wave_file.handle());
+    break;
+
+  case RDWaveFile::Flac:
+    if(wave_data!=NULL) {
+      ReadId3Metadata();
+      ReadFlacMetadata();
+    }
+    break;
+
+  default:
+    break;
+  }
+  SeekFile(wave_file.handle(),pos,SEEK_SET);
+}
+
+
+void RDWaveFile::LoadMetadata() const
+{
+  if(wave_metadata_pending) {
+    const_cast<RDWaveFile *>(this)->ReadMetadata();
+  }
+}
@@ -22,12 +22,16 @@
 #ifndef RDWAVEFILE_H
 #define RDWAVEFILE_H
 
+#include <stdint.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include <vector>
 
+#include <openssl/sha.h>
+
+#include <QByteArray>
 #include <QDateTime>
 #include <QFile>
 #include <QObject>
@@ -38,6 +42,7 @@
 #include <vorbis/vorbisenc.h>
 #endif  // HAVE_VORBIS
 
+#include <rdbufferedreader.h>
 #include <rdmp4.h>
 #include <rdringbuffer.h>
 #include <rdsettings.h>
@@ -101,13 +106,19 @@ class RDWaveFile
   	       DolbyAc2=6,DolbyAc3=7,Vorbis=8,Pcm24=9};
   enum Type {Unknown=0,Wave=1,Mpeg=2,Ogg=3,Atx=4,Tmc=5,Flac=6,Ambos=7,
 	     Aiff=8,M4A=9};
+  enum OpenMode {FullOpen=0,PlaybackOpen=1};
   RDWaveFile(QString file_name="");
   ~RDWaveFile();
   RDWaveFile::Type type() const;
   void nameWave(QString file_name);
   bool createWave(RDWaveData *data=NULL,unsigned ptr_offset=0);
-  bool openWave(RDWaveData *data=NULL);
+  bool openWave(RDWaveData *data=NULL,
+		RDWaveFile::OpenMode mode=RDWaveFile::FullOpen);
+  void setReadBuffering(int block_size,bool read_ahead);
+  unsigned long long readRequests() const;
   void closeWave(int samples=-1);
+  void setHashing(bool state,unsigned data_length=0);
+  QString sha1Hash() const;
   void resetWave();
   bool getFormatChunk() const;
   bool getFactChunk() const;
@@ -305,8 +316,28 @@ class RDWaveFile
    int WriteOggBuffer(char *buf,int size);
    unsigned FrameOffset(int msecs) const;
    int CheckExitCode(const QString &msg,int exit_code);
+   void ReadMetadata();
+   void LoadMetadata() const;
+   ssize_t ReadFile(int fd,void *buf,size_t count);
+   off_t SeekFile(int fd,off_t offset,int whence);
+   int WriteData(const void *buf,int count);
+   bool HashHeader();
+   void HashData(const void *buf,size_t count);
+   void FinishHash();
    QString wave_file_name;
    QFile wave_file;
+   RDBufferedReader *wave_reader;
+   int wave_read_block_size;       // -1 = use rd.conf(5) value
+   bool wave_read_ahead;
+   unsigned long long wave_read_requests;
+   bool wave_hashing;
+   bool wave_hash_streaming;
+   unsigned wave_hash_data_length;
+   QByteArray wave_hash_header;
+   uint64_t wave_hash_bytes;
+   SHA_CTX wave_hash_ctx;
+   QString wave_sha1_hash;
+   bool wave_metadata_pending;
    RDWaveData *wave_data;
    bool recordable;                // Allow DATA chunk writes?
    unsigned time_length;           // Audio length in secs
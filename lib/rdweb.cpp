@@ -165,6 +165,16 @@ QString RDXmlField(const QString &tag)
 }
 
 
+bool RDXmlSelected(const QStringList &fields,const QString &tag)
+{
+  /*
+   * True if 'tag' is among 'fields', or if 'fields' is empty (meaning
+   * every field)
+   */
+  return fields.isEmpty()||fields.contains(tag);
+}
+
+
 QString RDXmlEscape(const QString &str)
 {
   /*
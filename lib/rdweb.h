@@ -24,6 +24,7 @@
 
 #include <QDateTime>
 #include <QString>
+#include <QStringList>
 
 #include <rdaudioconvert.h>
 
@@ -51,6 +52,7 @@ extern QString RDXmlField(const QString &tag,const QDate &value,
 extern QString RDXmlField(const QString &tag,const QTime &value,
 			  const QString &attrs="");
 extern QString RDXmlField(const QString &tag);
+extern bool RDXmlSelected(const QStringList &fields,const QString &tag);
 extern QString RDXmlEscape(const QString &str);
 extern QString RDXmlUnescape(const QString &str);
 extern QString RDJsonPadding(int padding);
@@ -67,6 +67,9 @@
 #define RDXPORT_COMMAND_POST_IMAGE 44
 #define RDXPORT_COMMAND_REMOVE_IMAGE 45
 #define RDXPORT_COMMAND_DOWNLOAD_RSS 46
+#define RDXPORT_COMMAND_EDITCARTS 47
+#define RDXPORT_COMMAND_EDITCUTS 48
+#define RDXPORT_COMMAND_ASSIGNSCHEDCODES 49
 
 
 #endif  // RDXPORT_INTERFACE_H
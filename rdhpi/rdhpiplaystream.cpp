@@ -305,7 +305,7 @@ RDHPIPlayStream::Error RDHPIPlayStream::openWave()
   nameWave(wave_name);
   samples_skipped=0;
   samples_pending=0;
-  if(!RDWaveFile::openWave()) {
+  if(!RDWaveFile::openWave(NULL,RDWaveFile::PlaybackOpen)) {
     return RDHPIPlayStream::NoFile;
   }
   if(GetStream()<0) {
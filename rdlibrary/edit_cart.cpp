@@ -60,6 +60,7 @@ EditCart::EditCart(const QList<unsigned> &cartnums,QString *path,bool new_cart,
 
   if(cartnums.size()==1) {
     rdcart_cart=new RDCart(cartnums.at(0));
+    rdcart_cart->setSnapshotEnabled(true);
     rdcart_import_path=path;
     setWindowTitle("RDLibrary - "+tr("Edit Cart")+
 		   QString::asprintf(" %06u",rdcart_cart->number())+" ["+
@@ -37,7 +37,8 @@
 #define RDSERVICE_RDRSSD_ID 7
 #define RDSERVICE_LOCALMAINT_ID 8
 #define RDSERVICE_SYSTEMMAINT_ID 9
-#define RDSERVICE_LAST_ID 10
+#define RDSERVICE_RDXPORT_ID 10
+#define RDSERVICE_LAST_ID 11
 #define RDSERVICE_FIRST_DROPBOX_ID 100
 
 class MainObject : public QObject
@@ -206,6 +206,23 @@ bool MainObject::Startup(QString *err_msg)
   }
   delete q;
 
+  //
+  // rdxport.cgi(8) Web API service
+  //
+  if(rda->config()->webServicePort()>0) {
+    svc_processes[RDSERVICE_RDXPORT_ID]=
+      new RDProcess(RDSERVICE_RDXPORT_ID,this);
+    args.clear();
+    args.push_back("--service");
+    svc_processes[RDSERVICE_RDXPORT_ID]->
+      start(QString(LIBEXECDIR)+"/rdxport.cgi",args);
+    if(!svc_processes[RDSERVICE_RDXPORT_ID]->process()->waitForStarted(-1)) {
+      *err_msg=tr("unable to start rdxport.cgi")+": "+
+	svc_processes[RDSERVICE_RDXPORT_ID]->errorText();
+      return false;
+    }
+  }
+
   if(!StartDropboxes(err_msg)) {
     return false;
   }
@@ -0,0 +1,316 @@
+// audio_convert_length_test.cpp
+//
+// Check the length of audio converter output
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sndfile.h>
+
+#include <qapplication.h>
+#include <qfile.h>
+
+#include <rdapplication.h>
+#include <rdaudioconvert.h>
+#include <rdtempdirectory.h>
+
+#include <audio_convert_length_test.h>
+
+MainObject::MainObject(QObject *parent)
+  :QObject(parent)
+{
+  QString err_msg;
+  bool ok=true;
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDCoreApplication(
+	       "audio_convert_length_test","audio_convert_length_test",
+	       AUDIO_CONVERT_LENGTH_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"audio_convert_length_test: %s\n",
+	    (const char *)err_msg.toUtf8());
+    exit(1);
+  }
+  for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(!rda->cmdSwitch()->processed(i)) {
+      fprintf(stderr,"audio_convert_length_test: unknown option \"%s\"\n",
+	      rda->cmdSwitch()->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+
+  //
+  // Generate the Source
+  //
+  RDTempDirectory *temp_dir=new RDTempDirectory("audio_convert_length_test");
+  if(!temp_dir->create(&err_msg)) {
+    fprintf(stderr,"audio_convert_length_test: %s\n",
+	    (const char *)err_msg.toUtf8());
+    exit(1);
+  }
+  test_source_filename=temp_dir->path()+"/source.wav";
+  test_destination_filename=temp_dir->path()+"/destination";
+  if(!Generate(test_source_filename)) {
+    delete temp_dir;
+    exit(1);
+  }
+
+  //
+  // Convert It
+  //
+  ok=Convert("PCM16, 44100 Hz",RDSettings::Pcm16,44100,1.0,0,false)&&ok;
+  ok=Convert("PCM16, 44100 Hz, normalized",
+	     RDSettings::Pcm16,44100,1.0,-13,false)&&ok;
+  ok=Convert("PCM16, speed 0.9",RDSettings::Pcm16,48000,0.9,0,false)&&ok;
+  ok=Convert("PCM16, 44100 Hz, speed 1.2",
+	     RDSettings::Pcm16,44100,1.2,0,false)&&ok;
+  ok=Convert("FLAC, 44100 Hz, speed 1.2",
+	     RDSettings::Flac,44100,1.2,0,false)&&ok;
+  ok=Convert("streamed PCM16, 44100 Hz",
+	     RDSettings::Pcm16,44100,1.0,0,true)&&ok;
+  ok=Convert("streamed PCM16, 44100 Hz, speed 0.9",
+	     RDSettings::Pcm16,44100,0.9,0,true)&&ok;
+  ok=Convert("streamed PCM24, 32000 Hz, speed 1.1, normalized",
+	     RDSettings::Pcm24,32000,1.1,-13,true)&&ok;
+  ok=ConvertRange("PCM16 range, 48000 Hz",
+		  RDSettings::Pcm16,48000,100001,300000)&&ok;
+  ok=ConvertRange("PCM24 range, 48000 Hz, from header",
+		  RDSettings::Pcm24,48000,10,99999)&&ok;
+  ok=ConvertRange("PCM16 range, 48000 Hz, to end",
+		  RDSettings::Pcm16,48000,1919000,-1)&&ok;
+  ok=ConvertRange("PCM16 range, 44100 Hz",
+		  RDSettings::Pcm16,44100,100001,300000)&&ok;
+
+  delete temp_dir;
+
+  exit(!ok);
+}
+
+
+bool MainObject::Generate(const QString &filename)
+{
+  SNDFILE *sf=NULL;
+  SF_INFO sf_info;
+  sf_count_t frames=
+    AUDIO_CONVERT_LENGTH_TEST_SAMPLE_RATE*AUDIO_CONVERT_LENGTH_TEST_SECONDS;
+  float *pcm=new float[AUDIO_CONVERT_LENGTH_TEST_CHANNELS];
+
+  memset(&sf_info,0,sizeof(sf_info));
+  sf_info.format=SF_FORMAT_WAV|SF_FORMAT_PCM_16;
+  sf_info.channels=AUDIO_CONVERT_LENGTH_TEST_CHANNELS;
+  sf_info.samplerate=AUDIO_CONVERT_LENGTH_TEST_SAMPLE_RATE;
+  if((sf=sf_open(filename.toUtf8(),SFM_WRITE,&sf_info))==NULL) {
+    fprintf(stderr,"audio_convert_length_test: %s\n",sf_strerror(NULL));
+    delete[] pcm;
+    return false;
+  }
+  for(sf_count_t i=0;i<frames;i++) {
+    for(int j=0;j<AUDIO_CONVERT_LENGTH_TEST_CHANNELS;j++) {
+      pcm[j]=0.5*sin(2.0*M_PI*1000.0*(double)i/
+		     (double)AUDIO_CONVERT_LENGTH_TEST_SAMPLE_RATE);
+    }
+    sf_writef_float(sf,pcm,1);
+  }
+  sf_close(sf);
+  delete[] pcm;
+
+  return true;
+}
+
+
+bool MainObject::Convert(const char *desc,RDSettings::Format fmt,
+			 unsigned rate,float speed,int level,bool stream)
+{
+  RDSettings *settings=new RDSettings();
+  RDAudioConvert *conv=new RDAudioConvert(this);
+  RDAudioConvert::ErrorCode err;
+  SNDFILE *sf=NULL;
+  SF_INFO sf_info;
+  struct stat stats;
+  int fd=-1;
+  double expected;
+  bool ret=true;
+
+  settings->setFormat(fmt);
+  settings->setChannels(AUDIO_CONVERT_LENGTH_TEST_CHANNELS);
+  settings->setSampleRate(rate);
+  settings->setNormalizationLevel(level);
+  conv->setSourceFile(test_source_filename);
+  conv->setDestinationSettings(settings);
+  conv->setSpeedRatio(speed);
+  unlink(test_destination_filename.toUtf8());
+  if(stream) {
+    fd=open(test_destination_filename.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
+	    S_IRUSR|S_IWUSR);
+    conv->setDestinationStream(fd);
+  }
+  else {
+    conv->setDestinationFile(test_destination_filename);
+  }
+  err=conv->convert();
+  if(fd>=0) {
+    close(fd);
+  }
+  delete conv;
+  delete settings;
+  if(err!=RDAudioConvert::ErrorOk) {
+    fprintf(stderr,"audio_convert_length_test: %s: %s\n",desc,
+	    RDAudioConvert::errorText(err).toUtf8().constData());
+    return false;
+  }
+
+  //
+  // Check the Length
+  //
+  memset(&sf_info,0,sizeof(sf_info));
+  if((sf=sf_open(test_destination_filename.toUtf8(),SFM_READ,&sf_info))==
+     NULL) {
+    fprintf(stderr,"audio_convert_length_test: %s: %s\n",desc,
+	    sf_strerror(NULL));
+    return false;
+  }
+  sf_close(sf);
+  expected=(double)AUDIO_CONVERT_LENGTH_TEST_SECONDS*(double)rate/speed;
+  if(stream) {
+    //
+    // The header went out first, so must match both the estimate and
+    // the data that followed
+    //
+    memset(&stats,0,sizeof(stats));
+    stat(test_destination_filename.toUtf8(),&stats);
+    int bytes=(fmt==RDSettings::Pcm24)?3:2;
+    off_t size=44+sf_info.frames*sf_info.channels*bytes;
+    if(sf_info.frames!=(sf_count_t)(expected+0.5)) {
+      ret=false;
+    }
+    if(stats.st_size!=(size+(size%2))) {
+      fprintf(stderr,"audio_convert_length_test: %s: "
+	      "file is %lld bytes, expected %lld\n",desc,
+	      (long long)stats.st_size,(long long)(size+(size%2)));
+      ret=false;
+    }
+  }
+  else {
+    if(fabs((double)sf_info.frames-expected)>
+       (expected*AUDIO_CONVERT_LENGTH_TEST_TOLERANCE)) {
+      ret=false;
+    }
+  }
+  printf("%s: %lld frames, expected %.0f -- %s\n",desc,
+	 (long long)sf_info.frames,expected,ret?"ok":"FAILED");
+
+  return ret;
+}
+
+
+bool MainObject::ConvertRange(const char *desc,RDSettings::Format fmt,
+			      unsigned rate,int64_t first,int64_t last)
+{
+  QString range_filename=test_destination_filename+".range";
+  int64_t length=-1;
+  int64_t range_length=-1;
+  QByteArray whole;
+  QByteArray part;
+  bool ret=true;
+
+  //
+  // The whole stream, then just the range, which must match the same bytes
+  // of the whole
+  //
+  if((!Stream(fmt,rate,0,-1,test_destination_filename,&length))||
+     (!Stream(fmt,rate,first,last,range_filename,&range_length))) {
+    fprintf(stderr,"audio_convert_length_test: %s: conversion failed\n",desc);
+    return false;
+  }
+  QFile whole_file(test_destination_filename);
+  if(whole_file.open(QIODevice::ReadOnly)) {
+    whole=whole_file.readAll();
+    whole_file.close();
+  }
+  QFile part_file(range_filename);
+  if(part_file.open(QIODevice::ReadOnly)) {
+    part=part_file.readAll();
+    part_file.close();
+  }
+  unlink(range_filename.toUtf8());
+  if(last<0) {
+    last=whole.size()-1;
+  }
+  if((length!=whole.size())||(range_length!=length)) {
+    fprintf(stderr,"audio_convert_length_test: %s: "
+	    "stream is %d bytes, predicted %lld\n",desc,whole.size(),
+	    (long long)length);
+    ret=false;
+  }
+  if(part!=whole.mid(first,last-first+1)) {
+    fprintf(stderr,"audio_convert_length_test: %s: "
+	    "range does not match the whole\n",desc);
+    ret=false;
+  }
+  printf("%s: bytes %lld-%lld of %d -- %s\n",desc,(long long)first,
+	 (long long)last,whole.size(),ret?"ok":"FAILED");
+
+  return ret;
+}
+
+
+bool MainObject::Stream(RDSettings::Format fmt,unsigned rate,int64_t first,
+			int64_t last,const QString &filename,int64_t *length)
+{
+  RDSettings *settings=new RDSettings();
+  RDAudioConvert *conv=new RDAudioConvert(this);
+  RDAudioConvert::ErrorCode err;
+  int fd=-1;
+
+  settings->setFormat(fmt);
+  settings->setChannels(AUDIO_CONVERT_LENGTH_TEST_CHANNELS);
+  settings->setSampleRate(rate);
+  conv->setSourceFile(test_source_filename);
+  conv->setDestinationSettings(settings);
+  *length=conv->streamLength();
+  if((fd=open(filename.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
+	      S_IRUSR|S_IWUSR))<0) {
+    delete conv;
+    delete settings;
+    return false;
+  }
+  conv->setDestinationStream(fd);
+  conv->setDestinationByteRange(first,last);
+  err=conv->convert();
+  close(fd);
+  delete conv;
+  delete settings;
+
+  return err==RDAudioConvert::ErrorOk;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv,false);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,60 @@
+// audio_convert_length_test.h
+//
+// Check the length of audio converter output
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef AUDIO_CONVERT_LENGTH_TEST_H
+#define AUDIO_CONVERT_LENGTH_TEST_H
+
+#include <qobject.h>
+
+#include <rdsettings.h>
+
+//
+// Source audio
+//
+#define AUDIO_CONVERT_LENGTH_TEST_SAMPLE_RATE 48000
+#define AUDIO_CONVERT_LENGTH_TEST_CHANNELS 2
+#define AUDIO_CONVERT_LENGTH_TEST_SECONDS 10
+
+//
+// Fraction by which the output of a speed change may be off
+//
+#define AUDIO_CONVERT_LENGTH_TEST_TOLERANCE 0.01
+
+#define AUDIO_CONVERT_LENGTH_TEST_USAGE "\n\nGenerate a WAV file, then convert it with various sample rates, speed\nratios and levels, both to a file and streamed, checking that each comes\nout as long as it should.  Streamed PCM must match the length given in\nits header exactly, and a streamed byte range must match the same bytes\nof the whole.  Exits non-zero if any conversion fails or is the\nwrong length.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Generate(const QString &filename);
+  bool Convert(const char *desc,RDSettings::Format fmt,unsigned rate,
+	       float speed,int level,bool stream);
+  bool ConvertRange(const char *desc,RDSettings::Format fmt,unsigned rate,
+		    int64_t first,int64_t last);
+  bool Stream(RDSettings::Format fmt,unsigned rate,int64_t first,
+	      int64_t last,const QString &filename,int64_t *length);
+  QString test_source_filename;
+  QString test_destination_filename;
+};
+
+
+#endif  // AUDIO_CONVERT_LENGTH_TEST_H
@@ -0,0 +1,191 @@
+// buffered_read_test.cpp
+//
+// Benchmark buffered audio file reads in RDWaveFile
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <QCoreApplication>
+
+#include <rdcmd_switch.h>
+#include <rdwavedata.h>
+#include <rdwavefile.h>
+
+#include "buffered_read_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  bool ok=false;
+  int block_size=RDBUFFEREDREADER_DEFAULT_BLOCK_SIZE;
+  bool read_ahead=false;
+  int passes=10;
+  int rpc_latency=0;
+  double secs[2]={0.0,0.0};
+  unsigned long long reqs[2]={0,0};
+  double t;
+  unsigned long long r;
+
+  test_read_size=4608;
+
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch("buffered_read_test",BUFFERED_READ_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--filename") {
+      test_filename=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--block-size") {
+      block_size=cmd->value(i).toInt(&ok);
+      if((!ok)||(block_size<=0)) {
+	fprintf(stderr,"buffered_read_test: invalid --block-size\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--read-ahead") {
+      read_ahead=true;
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--read-size") {
+      test_read_size=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_read_size<=0)) {
+	fprintf(stderr,"buffered_read_test: invalid --read-size\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--passes") {
+      passes=cmd->value(i).toInt(&ok);
+      if((!ok)||(passes<=0)) {
+	fprintf(stderr,"buffered_read_test: invalid --passes\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--rpc-latency") {
+      rpc_latency=cmd->value(i).toInt(&ok);
+      if((!ok)||(rpc_latency<0)) {
+	fprintf(stderr,"buffered_read_test: invalid --rpc-latency\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"buffered_read_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(test_filename.isEmpty()) {
+    fprintf(stderr,"buffered_read_test: you must supply --filename\n");
+    exit(1);
+  }
+
+  //
+  // Alternate runs, so that neither mode consistently benefits from
+  // a warmer page cache
+  //
+  for(int i=0;i<passes;i++) {
+    if(!RunPass(0,false,&t,&r)) {
+      fprintf(stderr,"buffered_read_test: unable to open \"%s\"\n",
+	      test_filename.toUtf8().constData());
+      exit(1);
+    }
+    secs[0]+=t;
+    reqs[0]+=r;
+    RunPass(block_size,read_ahead,&t,&r);
+    secs[1]+=t;
+    reqs[1]+=r;
+  }
+
+  printf("File: %s\n",test_filename.toUtf8().constData());
+  printf("Passes: %d  Read size: %d bytes\n",passes,test_read_size);
+  printf("\n");
+  printf("%-28s %12s %12s",
+	 "Mode","Requests","Time (ms)");
+  if(rpc_latency>0) {
+    printf(" %14s",QString::asprintf("@%dus (ms)",rpc_latency).
+	   toUtf8().constData());
+  }
+  printf("\n");
+  for(int i=0;i<2;i++) {
+    QString mode=QObject::tr("unbuffered");
+    if(i==1) {
+      mode=QString::asprintf("buffered [%d",block_size);
+      if(read_ahead) {
+	mode+=", read-ahead";
+      }
+      mode+="]";
+    }
+    printf("%-28s %12llu %12.1f",mode.toUtf8().constData(),
+	   reqs[i]/passes,1000.0*secs[i]/(double)passes);
+    if(rpc_latency>0) {
+      printf(" %14.1f",(1000.0*secs[i]+
+			(double)reqs[i]*(double)rpc_latency/1000.0)/
+	     (double)passes);
+    }
+    printf("\n");
+  }
+
+  exit(0);
+}
+
+
+bool MainObject::RunPass(int block_size,bool read_ahead,double *secs,
+			 unsigned long long *reqs)
+{
+  struct timeval start_tv;
+  struct timeval end_tv;
+  RDWaveData *wavedata=new RDWaveData();
+  RDWaveFile *wavefile=new RDWaveFile(test_filename);
+  char *buffer=(char *)malloc(test_read_size);
+
+  gettimeofday(&start_tv,NULL);
+  wavefile->setReadBuffering(block_size,read_ahead);
+  if(!wavefile->openWave(wavedata)) {
+    free(buffer);
+    delete wavefile;
+    delete wavedata;
+    return false;
+  }
+  while(wavefile->readWave(buffer,test_read_size)>0);
+  wavefile->closeWave();
+  gettimeofday(&end_tv,NULL);
+
+  *secs=(double)(end_tv.tv_sec-start_tv.tv_sec)+
+    (double)(end_tv.tv_usec-start_tv.tv_usec)/1000000.0;
+  *reqs=wavefile->readRequests();
+
+  free(buffer);
+  delete wavefile;
+  delete wavedata;
+
+  return true;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,42 @@
+// buffered_read_test.h
+//
+// Benchmark buffered audio file reads in RDWaveFile
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef BUFFERED_READ_TEST_H
+#define BUFFERED_READ_TEST_H
+
+#include <QObject>
+#include <QString>
+
+#define BUFFERED_READ_TEST_USAGE "[options]\n\nBenchmark buffered audio file reads in RDWaveFile\n\n--filename=<file-name>\n     The audio file to read. To obtain meaningful results, this should\n     reside on the storage to be evaluated (e.g. an NFS mount).\n\n--block-size=<bytes>\n     Size of the read buffer to test. Default is 65536.\n\n--read-ahead\n     Enable the background read-ahead thread.\n\n--read-size=<bytes>\n     Size of each readWave() request. Default is 4608 (one CAE\n     playout transfer of 16 bit stereo PCM).\n\n--passes=<n>\n     Number of times to open and read the file. Default is 10.\n\n--rpc-latency=<usecs>\n     Simulated round-trip latency of each I/O request, in microseconds.\n     When non-zero, the modeled time of each run is reported alongside\n     the measured time, as a stand-in for a throttled or remote disk.\n     Default is 0.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool RunPass(int block_size,bool read_ahead,double *secs,
+	       unsigned long long *reqs);
+  QString test_filename;
+  int test_read_size;
+};
+
+
+#endif  // BUFFERED_READ_TEST_H
@@ -0,0 +1,331 @@
+// config_cache_test.cpp
+//
+// Count the database round trips needed to read host configuration
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdnotification.h>
+#include <rdrowsnapshot.h>
+
+#include "config_cache_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  QString station_name;
+  int passes=10;
+  QString plain;
+  QString snap;
+  QString values;
+  uint64_t plain_trips=0;
+  uint64_t snap_trips=0;
+  uint64_t first_trips=0;
+  uint64_t reload_trips=0;
+  uint64_t setter_trips=0;
+  int vox=0;
+  bool ok=false;
+  int ret=0;
+
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch("config_cache_test",CONFIG_CACHE_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--station") {
+      station_name=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--passes") {
+      passes=cmd->value(i).toInt(&ok);
+      if((!ok)||(passes<2)) {
+	fprintf(stderr,"config_cache_test: invalid --passes\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"config_cache_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("config_cache_test",
+		       "config_cache_test",CONFIG_CACHE_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"config_cache_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+  if(station_name.isEmpty()) {
+    station_name=rda->config()->stationName();
+  }
+
+  RDStation *station=new RDStation(station_name);
+  RDSystem *system=new RDSystem();
+  RDLibraryConf *library=new RDLibraryConf(station_name);
+  RDLogeditConf *logedit=new RDLogeditConf(station_name);
+  RDAirPlayConf *airplay=new RDAirPlayConf(station_name,"RDAIRPLAY");
+  if(!station->exists()) {
+    fprintf(stderr,"config_cache_test: no such station \"%s\"\n",
+	    station_name.toUtf8().constData());
+    exit(1);
+  }
+
+  //
+  // Direct reads
+  //
+  RDSqlQuery::resetRoundTrips();
+  for(int i=0;i<passes;i++) {
+    plain=ReadStation(station)+ReadSystem(system)+ReadLibrary(library)+
+      ReadLogedit(logedit)+ReadAirPlay(airplay);
+  }
+  plain_trips=RDSqlQuery::roundTrips();
+
+  //
+  // Cached reads
+  //
+  station->setSnapshotEnabled(true);
+  system->setSnapshotEnabled(true);
+  library->setSnapshotEnabled(true);
+  logedit->setSnapshotEnabled(true);
+  airplay->setSnapshotEnabled(true);
+  RDSqlQuery::resetRoundTrips();
+  snap=ReadStation(station)+ReadSystem(system)+ReadLibrary(library)+
+    ReadLogedit(logedit)+ReadAirPlay(airplay);
+  first_trips=RDSqlQuery::roundTrips();
+  for(int i=1;i<passes;i++) {
+    values=ReadStation(station)+ReadSystem(system)+ReadLibrary(library)+
+      ReadLogedit(logedit)+ReadAirPlay(airplay);
+    if(values!=snap) {
+      fprintf(stderr,"config_cache_test: cached values changed on pass %d\n",
+	      i+1);
+      ret=1;
+    }
+  }
+  snap_trips=RDSqlQuery::roundTrips();
+  if(snap!=plain) {
+    fprintf(stderr,
+	    "config_cache_test: cached reads returned different values\n");
+    ret=1;
+  }
+
+  //
+  // Invalidate one table, as a CONFIG notification would
+  //
+  RDRowSnapshot::invalidateTable("RDLIBRARY");
+  RDSqlQuery::resetRoundTrips();
+  for(int i=0;i<passes;i++) {
+    ReadLibrary(library);
+  }
+  reload_trips=RDSqlQuery::roundTrips();
+
+  //
+  // A setter must drop our own cached copy, without waiting for the
+  // notification to come back from ripcd(8)
+  //
+  ReadLibrary(library);
+  vox=library->voxThreshold();
+  library->setVoxThreshold(vox-1);
+  RDSqlQuery::resetRoundTrips();
+  if(library->voxThreshold()!=(vox-1)) {
+    fprintf(stderr,"config_cache_test: setter left a stale cached value\n");
+    ret=1;
+  }
+  setter_trips=RDSqlQuery::roundTrips();
+  library->setVoxThreshold(vox);
+  if(library->voxThreshold()!=vox) {
+    fprintf(stderr,"config_cache_test: setter left a stale cached value\n");
+    ret=1;
+  }
+
+  //
+  // The notification must carry the table name through ripcd(8) intact
+  //
+  if(!CheckNotification("RDLIBRARY")) {
+    ret=1;
+  }
+
+  printf("Station:  %s\n",station_name.toUtf8().constData());
+  printf("Passes:   %d\n",passes);
+  printf("Direct:   %lu round trips\n",(unsigned long)plain_trips);
+  printf("Cached:   %lu round trips\n",(unsigned long)snap_trips);
+  printf("Reloaded: %lu round trips\n",(unsigned long)reload_trips);
+  printf("Set:      %lu round trips\n",(unsigned long)setter_trips);
+  if(snap_trips!=first_trips) {
+    fprintf(stderr,"config_cache_test: cached reads went back to the %s",
+	    "database\n");
+    ret=1;
+  }
+  if(reload_trips!=1) {
+    fprintf(stderr,"config_cache_test: invalidated table took %lu %s",
+	    (unsigned long)reload_trips,"round trips to reload\n");
+    ret=1;
+  }
+  if(setter_trips!=1) {
+    fprintf(stderr,"config_cache_test: changed table took %lu %s",
+	    (unsigned long)setter_trips,"round trips to reload\n");
+    ret=1;
+  }
+
+  delete airplay;
+  delete logedit;
+  delete library;
+  delete system;
+  delete station;
+
+  exit(ret);
+}
+
+
+QString MainObject::ReadStation(RDStation *station) const
+{
+  QStringList f0;
+
+  f0.push_back(station->shortName());
+  f0.push_back(station->description());
+  f0.push_back(station->userName());
+  f0.push_back(station->defaultName());
+  f0.push_back(station->address().toString());
+  f0.push_back(station->httpStation());
+  f0.push_back(station->caeStation());
+
+  return f0.join("|")+"|";
+}
+
+
+QString MainObject::ReadSystem(RDSystem *system) const
+{
+  QStringList f0;
+
+  f0.push_back(system->realmName());
+  f0.push_back(QString::asprintf("%u",system->sampleRate()));
+  f0.push_back(QString::asprintf("%u",system->allowDuplicateCartTitles()));
+  f0.push_back(QString::asprintf("%u",system->fixDuplicateCartTitles()));
+  f0.push_back(system->isciXreferencePath());
+  f0.push_back(system->originEmailAddress());
+  f0.push_back(system->tempCartGroup());
+  f0.push_back(QString::asprintf("%u",system->showUserList()));
+  f0.push_back(system->notificationAddress().toString());
+  f0.push_back(system->longDateFormat());
+  f0.push_back(system->shortDateFormat());
+
+  return f0.join("|")+"|";
+}
+
+
+QString MainObject::ReadLibrary(RDLibraryConf *conf) const
+{
+  QStringList f0;
+
+  f0.push_back(QString::asprintf("%d",conf->inputCard()));
+  f0.push_back(QString::asprintf("%d",conf->inputPort()));
+  f0.push_back(QString::asprintf("%d",conf->outputCard()));
+  f0.push_back(QString::asprintf("%d",conf->outputPort()));
+  f0.push_back(QString::asprintf("%d",conf->voxThreshold()));
+  f0.push_back(QString::asprintf("%d",conf->trimThreshold()));
+  f0.push_back(QString::asprintf("%u",conf->defaultFormat()));
+  f0.push_back(QString::asprintf("%u",conf->defaultChannels()));
+  f0.push_back(QString::asprintf("%u",conf->defaultBitrate()));
+  f0.push_back(QString::asprintf("%u",conf->maxLength()));
+  f0.push_back(conf->ripperDevice());
+  f0.push_back(QString::asprintf("%d",conf->paranoiaLevel()));
+
+  return f0.join("|")+"|";
+}
+
+
+QString MainObject::ReadLogedit(RDLogeditConf *conf) const
+{
+  QStringList f0;
+
+  f0.push_back(QString::asprintf("%d",conf->inputCard()));
+  f0.push_back(QString::asprintf("%d",conf->inputPort()));
+  f0.push_back(QString::asprintf("%d",conf->outputCard()));
+  f0.push_back(QString::asprintf("%d",conf->outputPort()));
+  f0.push_back(QString::asprintf("%u",conf->format()));
+  f0.push_back(QString::asprintf("%u",conf->bitrate()));
+  f0.push_back(QString::asprintf("%u",conf->enableSecondStart()));
+  f0.push_back(QString::asprintf("%u",conf->defaultChannels()));
+  f0.push_back(QString::asprintf("%u",conf->maxLength()));
+  f0.push_back(QString::asprintf("%u",conf->tailPreroll()));
+
+  return f0.join("|")+"|";
+}
+
+
+QString MainObject::ReadAirPlay(RDAirPlayConf *conf) const
+{
+  QStringList f0;
+
+  f0.push_back(QString::asprintf("%d",conf->segueLength()));
+  f0.push_back(QString::asprintf("%d",conf->transLength()));
+  f0.push_back(QString::asprintf("%d",conf->opModeStyle()));
+  f0.push_back(QString::asprintf("%d",conf->pieCountLength()));
+  f0.push_back(QString::asprintf("%d",conf->pieEndPoint()));
+  f0.push_back(QString::asprintf("%u",conf->checkTimesync()));
+  f0.push_back(QString::asprintf("%u",conf->clearFilter()));
+
+  return f0.join("|");
+}
+
+
+bool MainObject::CheckNotification(const QString &table) const
+{
+  RDNotification *notify=
+    new RDNotification(RDNotification::ConfigType,
+		       RDNotification::ModifyAction,table);
+  QString str=notify->write();
+  RDNotification *parsed=new RDNotification();
+  bool ret=true;
+
+  if(!parsed->read(str)) {
+    fprintf(stderr,"config_cache_test: unable to read back \"%s\"\n",
+	    str.toUtf8().constData());
+    ret=false;
+  }
+  else {
+    if((parsed->type()!=RDNotification::ConfigType)||
+       (parsed->action()!=RDNotification::ModifyAction)||
+       (parsed->id().toString()!=table)) {
+      fprintf(stderr,"config_cache_test: \"%s\" read back as \"%s\"\n",
+	      str.toUtf8().constData(),parsed->write().toUtf8().constData());
+      ret=false;
+    }
+  }
+  delete parsed;
+  delete notify;
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,49 @@
+// config_cache_test.h
+//
+// Count the database round trips needed to read host configuration
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef CONFIG_CACHE_TEST_H
+#define CONFIG_CACHE_TEST_H
+
+#include <QObject>
+
+#include <rdairplay_conf.h>
+#include <rdlibrary_conf.h>
+#include <rdlogedit_conf.h>
+#include <rdstation.h>
+#include <rdsystem.h>
+
+#define CONFIG_CACHE_TEST_USAGE "[--station=<name>] [--passes=<num>]\n\nRead the host and module settings of a station repeatedly, first\ndirectly and then through cached row snapshots, reporting the number of\ndatabase round trips taken.  Exits non-zero if the cached reads return\ndifferent values, if they go back to the database before a CONFIG\nnotification invalidates them, if a setter leaves a stale cached value,\nor if a CONFIG notification does not survive being written and read\nback.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  QString ReadStation(RDStation *station) const;
+  QString ReadSystem(RDSystem *system) const;
+  QString ReadLibrary(RDLibraryConf *conf) const;
+  QString ReadLogedit(RDLogeditConf *conf) const;
+  QString ReadAirPlay(RDAirPlayConf *conf) const;
+  bool CheckNotification(const QString &table) const;
+};
+
+
+#endif  // CONFIG_CACHE_TEST_H
@@ -0,0 +1,165 @@
+// db_replica_test.cpp
+//
+// Check the routing of queries to database read replicas
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <QCoreApplication>
+
+#include <rdapplication.h>
+#include <rdsqltransaction.h>
+
+#include "db_replica_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  int ret=0;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch("db_replica_test",DB_REPLICA_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"db_replica_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("db_replica_test",
+		 "db_replica_test",DB_REPLICA_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"db_replica_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+  if(RDDbPool::replicas()==0) {
+    fprintf(stderr,"db_replica_test: no replicas configured in rd.conf\n");
+    exit(1);
+  }
+
+  //
+  // Opening the application writes to the database, so wait for that to
+  // age out before expecting anything to go to the replica
+  //
+  sleep(rda->config()->mysqlReplicaStickiness()+1);
+
+  //
+  // Identify the Servers
+  //
+  RDSqlQuery *q=new RDSqlQuery("select @@server_id",RDSqlQuery::Primary);
+  q->first();
+  test_primary_id=q->value(0).toInt();
+  delete q;
+  q=new RDSqlQuery("select @@server_id",RDSqlQuery::Replica);
+  q->first();
+  test_replica_id=q->value(0).toInt();
+  delete q;
+  printf("Primary server ID: %d\n",test_primary_id);
+  printf("Replica server ID: %d\n",test_replica_id);
+  if(test_primary_id==test_replica_id) {
+    fprintf(stderr,
+	    "db_replica_test: replica is unreachable or is the primary\n");
+    exit(1);
+  }
+
+  //
+  // Reads
+  //
+  if(!Check("plain select","select @@server_id",RDSqlQuery::Auto,false)) {
+    ret=1;
+  }
+  if(!Check("explicit replica","select @@server_id",RDSqlQuery::Replica,
+	    true)) {
+    ret=1;
+  }
+  if(!Check("replica select for update",
+	    "select @@server_id from `VERSION` for update",
+	    RDSqlQuery::Replica,false)) {
+    ret=1;
+  }
+  if(!Check("explicit primary","select @@server_id",RDSqlQuery::Primary,
+	    false)) {
+    ret=1;
+  }
+
+  //
+  // Reads inside a transaction
+  //
+  {
+    RDSqlTransaction trans;
+    if(!Check("select in transaction","select @@server_id",RDSqlQuery::Auto,
+	      false)) {
+      ret=1;
+    }
+    if(!Check("explicit replica in transaction","select @@server_id",
+	      RDSqlQuery::Replica,false)) {
+      ret=1;
+    }
+    trans.commit();
+  }
+
+  //
+  // Reads after a write
+  //
+  RDSqlQuery::apply("update `VERSION` set `DB`=`DB`");
+  if(!Check("select after write","select @@server_id",RDSqlQuery::Replica,
+	    false)) {
+    ret=1;
+  }
+  sleep(rda->config()->mysqlReplicaStickiness()+1);
+  if(!Check("select after stickiness","select @@server_id",
+	    RDSqlQuery::Replica,true)) {
+    ret=1;
+  }
+
+  exit(ret);
+}
+
+
+bool MainObject::Check(const QString &label,const QString &sql,
+		       RDSqlQuery::Route route,bool replica)
+{
+  int id=-1;
+  bool ret=true;
+
+  RDSqlQuery *q=new RDSqlQuery(sql,route);
+  if(q->first()) {
+    id=q->value(0).toInt();
+  }
+  delete q;
+  ret=(id==(replica?test_replica_id:test_primary_id));
+  printf("%s: answered by %s: %s\n",label.toUtf8().constData(),
+	 (id==test_replica_id)?"replica":"primary",ret?"OK":"FAILED");
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,43 @@
+// db_replica_test.h
+//
+// Check the routing of queries to database read replicas
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef DB_REPLICA_TEST_H
+#define DB_REPLICA_TEST_H
+
+#include <QObject>
+
+#include <rddb.h>
+
+#define DB_REPLICA_TEST_USAGE "\n\nRun a set of queries and check which database server answers each\none, using the primary and a replica configured in rd.conf(5).\nFor testing, the replica can be a second mysqld(8) on the same host,\ngiven as \"Replica1=127.0.0.1:<port>\" (the primary and the replica\nmust have different server IDs).  Exits non-zero if a query goes to\nthe wrong server.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Check(const QString &label,const QString &sql,RDSqlQuery::Route route,
+	     bool replica);
+  int test_primary_id;
+  int test_replica_id;
+};
+
+
+#endif  // DB_REPLICA_TEST_H
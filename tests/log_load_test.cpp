@@ -0,0 +1,354 @@
+// log_load_test.cpp
+//
+// Benchmark the loading of a generated 24 hour log
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <rdapplication.h>
+#include <rdcut.h>
+#include <rddb.h>
+#include <rdlog.h>
+#include <rdlogmodel.h>
+
+#include "log_load_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  bool ok=false;
+  int ret=0;
+
+  test_lines=1500;
+  test_passes=5;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch("log_load_test",LOG_LOAD_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--service") {
+      test_service_name=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--lines") {
+      test_lines=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_lines<=0)) {
+	fprintf(stderr,"log_load_test: invalid --lines\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--passes") {
+      test_passes=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_passes<=0)) {
+	fprintf(stderr,"log_load_test: invalid --passes\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"log_load_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(test_service_name.isEmpty()) {
+    fprintf(stderr,"log_load_test: you must specify --service\n");
+    exit(1);
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("log_load_test",
+		       "log_load_test",LOG_LOAD_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"log_load_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+
+  //
+  // Generate the Log
+  //
+  test_log_name=QString::asprintf("LOG_LOAD_TEST_%d",getpid());
+  if(!Generate(&err_msg)) {
+    fprintf(stderr,"log_load_test: %s\n",err_msg.toUtf8().constData());
+    RDLog::remove(test_log_name,rda->station(),rda->user(),rda->config());
+    exit(1);
+  }
+  printf("Log:    %s\n",test_log_name.toUtf8().constData());
+  printf("Lines:  %d\n",test_lines);
+  printf("Passes: %d\n",test_passes);
+
+  //
+  // Load It
+  //
+  if(!Load(false)) {
+    ret=1;
+  }
+  if(!Load(true)) {
+    ret=1;
+  }
+
+  RDLog::remove(test_log_name,rda->station(),rda->user(),rda->config());
+
+  exit(ret);
+}
+
+
+bool MainObject::Generate(QString *err_msg)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QList<unsigned> cartnums;
+  QList<RDCart::Type> types;
+  RDLogLine *ll=NULL;
+
+  sql=QString("select ")+
+    "`NUMBER`,"+  // 00
+    "`TYPE` "+    // 01
+    "from `CART` order by `NUMBER` limit ?";
+  q=new RDSqlQuery(sql,QVariantList()<<test_lines);
+  while(q->next()) {
+    cartnums.push_back(q->value(0).toUInt());
+    types.push_back((RDCart::Type)q->value(1).toInt());
+  }
+  delete q;
+  if(cartnums.size()==0) {
+    *err_msg="the library has no carts";
+    return false;
+  }
+  if(!RDLog::create(test_log_name,test_service_name,QDate::currentDate(),
+		    "log_load_test",err_msg,rda->config())) {
+    return false;
+  }
+
+  //
+  // Mostly carts, with a marker every 20 lines and a chain (to this
+  // same log) every 60
+  //
+  RDLogModel *model=new RDLogModel(test_log_name,false,this);
+  for(int i=0;i<test_lines;i++) {
+    model->insert(model->lineCount(),1,true);
+    ll=model->logLine(model->lineCount()-1);
+    ll->setStartTime(RDLogLine::Logged,QTime(0,0,0).
+		     addMSecs((int)((86400000.0*(double)i)/test_lines)));
+    ll->setTimeType(RDLogLine::Relative);
+    ll->setTransType(RDLogLine::Segue);
+    if((i%60)==59) {
+      ll->setType(RDLogLine::Chain);
+      ll->setMarkerLabel(test_log_name);
+    }
+    else {
+      if((i%20)==19) {
+	ll->setType(RDLogLine::Marker);
+	ll->setMarkerComment(QString::asprintf("Marker %d",i));
+      }
+      else {
+	unsigned cartnum=cartnums.at(i%cartnums.size());
+	if(types.at(i%cartnums.size())==RDCart::Macro) {
+	  ll->setType(RDLogLine::Macro);
+	}
+	else {
+	  ll->setType(RDLogLine::Cart);
+	}
+	ll->setCartNumber(cartnum);
+      }
+    }
+  }
+  model->save(rda->config(),false);
+  delete model;
+
+  return true;
+}
+
+
+bool MainObject::Load(bool track_ptrs)
+{
+  QElapsedTimer timer;
+  qint64 msecs=0;
+  uint64_t trips=0;
+  uint64_t max_trips=0;
+  bool ret=true;
+  QString first_xml;
+
+  for(int i=0;i<test_passes;i++) {
+    RDLogModel *model=new RDLogModel(test_log_name,false,this);
+    RDSqlQuery::resetRoundTrips();
+    timer.start();
+    model->load(track_ptrs);
+    msecs+=timer.elapsed();
+    trips=RDSqlQuery::roundTrips();
+    if(trips>max_trips) {
+      max_trips=trips;
+    }
+    if(model->lineCount()!=test_lines) {
+      fprintf(stderr,"log_load_test: loaded %d lines, expected %d\n",
+	      model->lineCount(),test_lines);
+      ret=false;
+    }
+
+    //
+    // Check the first load line by line, and the rest against the first
+    //
+    if(i==0) {
+      if(!Verify(model,track_ptrs)) {
+	ret=false;
+      }
+      first_xml=model->xml();
+    }
+    else {
+      if(model->xml()!=first_xml) {
+	fprintf(stderr,"log_load_test: load %d differs from the first\n",i+1);
+	ret=false;
+      }
+    }
+    delete model;
+  }
+  if(track_ptrs) {
+    printf("\nWith cut pointers\n");
+  }
+  else {
+    printf("\nWithout cut pointers\n");
+  }
+  printf("  Load time:   %9.1f ms mean\n",(double)msecs/(double)test_passes);
+  printf("  Round trips: %9lu\n",(unsigned long)max_trips);
+  if(max_trips>LOG_LOAD_TEST_MAX_QUERIES) {
+    fprintf(stderr,"log_load_test: load took %lu round trips, expected %s%d\n",
+	    (unsigned long)max_trips,"no more than ",LOG_LOAD_TEST_MAX_QUERIES);
+    ret=false;
+  }
+
+  return ret;
+}
+
+
+bool MainObject::Verify(RDLogModel *model,bool track_ptrs)
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  bool ret=true;
+
+  //
+  // Look each line up on its own, the way loads used to, and compare
+  //
+  for(int i=0;i<model->lineCount();i++) {
+    RDLogLine *ll=model->logLine(i);
+    if(ll->type()==RDLogLine::Chain) {
+      sql=QString("select `DESCRIPTION` from `LOGS` where `NAME`=?");
+      q=new RDSqlQuery(sql,QVariantList()<<ll->markerLabel());
+      if(q->first()) {
+	ret=Check(i,"chain description",ll->markerComment(),q->value(0))&&ret;
+      }
+      delete q;
+    }
+    if(track_ptrs&&(ll->cartType()==RDCart::Audio)) {
+      sql=QString("select ")+
+	"`START_POINT`,"+        // 00
+	"`END_POINT`,"+          // 01
+	"`SEGUE_START_POINT`,"+  // 02
+	"`SEGUE_END_POINT`,"+    // 03
+	"`TALK_START_POINT`,"+   // 04
+	"`TALK_END_POINT`,"+     // 05
+	"`HOOK_START_POINT`,"+   // 06
+	"`HOOK_END_POINT`,"+     // 07
+	"`FADEUP_POINT`,"+       // 08
+	"`FADEDOWN_POINT`,"+     // 09
+	"`CUT_NAME`,"+           // 10
+	"`ORIGIN_NAME`,"+        // 11
+	"`ORIGIN_DATETIME`,"+    // 12
+	"`DESCRIPTION`,"+        // 13
+	"`ISRC`,"+               // 14
+	"`ISCI`,"+               // 15
+	"`RECORDING_MBID`,"+     // 16
+	"`RELEASE_MBID` "+       // 17
+	"from `CUTS` where "+
+	"`CART_NUMBER`=? "+
+	"order by `CUT_NAME`";
+      q=new RDSqlQuery(sql,QVariantList()<<ll->cartNumber());
+      if(q->first()) {
+	ret=Check(i,"start point",ll->startPoint(RDLogLine::CartPointer),
+		  q->value(0).toInt())&&ret;
+	ret=Check(i,"end point",ll->endPoint(RDLogLine::CartPointer),
+		  q->value(1).toInt())&&ret;
+	ret=Check(i,"segue start point",
+		  ll->segueStartPoint(RDLogLine::CartPointer),
+		  q->value(2).toInt())&&ret;
+	ret=Check(i,"segue end point",
+		  ll->segueEndPoint(RDLogLine::CartPointer),
+		  q->value(3).toInt())&&ret;
+	ret=Check(i,"talk start point",ll->talkStartPoint(),
+		  q->value(4).toInt())&&ret;
+	ret=Check(i,"talk end point",ll->talkEndPoint(),
+		  q->value(5).toInt())&&ret;
+	ret=Check(i,"hook start point",ll->hookStartPoint(),
+		  q->value(6).toInt())&&ret;
+	ret=Check(i,"hook end point",ll->hookEndPoint(),
+		  q->value(7).toInt())&&ret;
+	ret=Check(i,"fadeup point",ll->fadeupPoint(RDLogLine::CartPointer),
+		  q->value(8).toInt())&&ret;
+	ret=Check(i,"fadedown point",ll->fadedownPoint(RDLogLine::CartPointer),
+		  q->value(9).toInt())&&ret;
+	ret=Check(i,"cut number",ll->cutNumber(),
+		  RDCut::cutNumber(q->value(10).toString()))&&ret;
+	ret=Check(i,"origin user",ll->originUser(),
+		  q->value(11).toString())&&ret;
+	ret=Check(i,"origin datetime",ll->originDateTime(),
+		  q->value(12).toDateTime())&&ret;
+	ret=Check(i,"description",ll->description(),
+		  q->value(13).toString())&&ret;
+	ret=Check(i,"ISRC",ll->isrc(),q->value(14).toString())&&ret;
+	ret=Check(i,"ISCI",ll->isci(),q->value(15).toString())&&ret;
+	ret=Check(i,"recording MBID",ll->recordingMbId(),
+		  q->value(16).toString())&&ret;
+	ret=Check(i,"release MBID",ll->releaseMbId(),
+		  q->value(17).toString())&&ret;
+      }
+      delete q;
+    }
+  }
+
+  return ret;
+}
+
+
+bool MainObject::Check(int line,const char *name,const QVariant &loaded,
+		       const QVariant &expected)
+{
+  if(loaded==expected) {
+    return true;
+  }
+  fprintf(stderr,"log_load_test: line %d: %s is \"%s\", expected \"%s\"\n",
+	  line,name,loaded.toString().toUtf8().constData(),
+	  expected.toString().toUtf8().constData());
+
+  return false;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,54 @@
+// log_load_test.h
+//
+// Benchmark the loading of a generated 24 hour log
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_LOAD_TEST_H
+#define LOG_LOAD_TEST_H
+
+#include <QObject>
+#include <QVariant>
+
+#include <rdlogmodel.h>
+
+//
+// Most queries that loading a log may take, whatever its length
+//
+#define LOG_LOAD_TEST_MAX_QUERIES 6
+
+#define LOG_LOAD_TEST_USAGE "--service=<name> [--lines=<num>] [--passes=<num>]\n\nGenerate a 24 hour log of the specified length for the specified\nservice, then load it repeatedly with and without voice tracker cut\npointers, reporting the time and the number of database round trips\ntaken.  The log is deleted afterward.  Exits non-zero if a load takes\nmore round trips than a log of any length should need, if the chain\ndescriptions or cut pointers differ from those found by looking up\neach line on its own, or if repeated loads differ.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Generate(QString *err_msg);
+  bool Load(bool track_ptrs);
+  bool Verify(RDLogModel *model,bool track_ptrs);
+  bool Check(int line,const char *name,const QVariant &loaded,
+	     const QVariant &expected);
+  QString test_service_name;
+  QString test_log_name;
+  int test_lines;
+  int test_passes;
+};
+
+
+#endif  // LOG_LOAD_TEST_H
@@ -0,0 +1,216 @@
+// log_save_test.cpp
+//
+// Count the rows written when saving an edited log
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdlog.h>
+
+#include "log_save_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  int line=0;
+  int grace_time=0;
+  bool ok=false;
+  int ret=0;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch("log_save_test",LOG_SAVE_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--log") {
+      test_log_name=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--line") {
+      line=cmd->value(i).toInt(&ok);
+      if((!ok)||(line<0)) {
+	fprintf(stderr,"log_save_test: invalid --line\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"log_save_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(test_log_name.isEmpty()) {
+    fprintf(stderr,"log_save_test: you must specify --log\n");
+    exit(1);
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("log_save_test",
+		       "log_save_test",LOG_SAVE_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"log_save_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+  if(!RDLog::exists(test_log_name)) {
+    fprintf(stderr,"log_save_test: no such log\n");
+    exit(1);
+  }
+
+  //
+  // Load the Log
+  //
+  RDLogModel *model=new RDLogModel(test_log_name,false,this);
+  model->load();
+  if(line>=model->lineCount()) {
+    fprintf(stderr,"log_save_test: log has only %d lines\n",
+	    model->lineCount());
+    exit(1);
+  }
+  printf("Log:   %s\n",test_log_name.toUtf8().constData());
+  printf("Lines: %d\n",model->lineCount());
+
+  //
+  // An unchanged log
+  //
+  if(!Save(model,"unchanged",0)) {
+    ret=1;
+  }
+
+  //
+  // One changed line
+  //
+  grace_time=model->logLine(line)->graceTime();
+  model->logLine(line)->setGraceTime(grace_time+1);
+  if(!Save(model,"one line changed",1)) {
+    ret=1;
+  }
+  if(!Compare(model,"one line changed")) {
+    ret=1;
+  }
+
+  //
+  // Put it back
+  //
+  model->logLine(line)->setGraceTime(grace_time);
+  if(!Save(model,"one line restored",1)) {
+    ret=1;
+  }
+  if(!Compare(model,"one line restored")) {
+    ret=1;
+  }
+
+  //
+  // A line inserted before the given one, then removed again.  The lines
+  // after it are moved with a single statement, rather than each being
+  // rewritten, and the new NEXT_ID is saved along with the line.
+  //
+  model->insert(line,1,true);
+  model->logLine(line)->setType(RDLogLine::Marker);
+  model->logLine(line)->setMarkerComment("log_save_test");
+  if(!Save(model,"line inserted",3)) {
+    ret=1;
+  }
+  if(!Compare(model,"line inserted")) {
+    ret=1;
+  }
+  model->remove(line,1,true);
+  if(!Save(model,"line removed",2)) {
+    ret=1;
+  }
+  if(!Compare(model,"line removed")) {
+    ret=1;
+  }
+  delete model;
+
+  exit(ret);
+}
+
+
+bool MainObject::Save(RDLogModel *model,const QString &label,
+		      uint64_t expected)
+{
+  uint64_t writes=RDSqlQuery::writeCount();
+
+  model->save(rda->config(),false);
+  writes=RDSqlQuery::writeCount()-writes;
+  printf("Saved %s: %lu statements written\n",label.toUtf8().constData(),
+	 (unsigned long)writes);
+  if(writes!=expected) {
+    fprintf(stderr,"log_save_test: %s: expected %lu statements, wrote %lu\n",
+	    label.toUtf8().constData(),(unsigned long)expected,
+	    (unsigned long)writes);
+    return false;
+  }
+
+  return true;
+}
+
+
+bool MainObject::Compare(RDLogModel *model,const QString &label)
+{
+  RDLogModel *saved=new RDLogModel(test_log_name,false,this);
+  bool ret=true;
+
+  saved->load();
+  if(saved->xml()!=model->xml()) {
+    fprintf(stderr,"log_save_test: %s: log read back differently\n",
+	    label.toUtf8().constData());
+    ret=false;
+  }
+  delete saved;
+
+  //
+  // Every row must be at its position, with no gaps or leftovers
+  //
+  QString sql=QString("select ")+
+    "count(*),"+        // 00
+    "min(`COUNT`),"+    // 01
+    "max(`COUNT`) "+    // 02
+    "from `LOG_LINES` where `LOG_NAME`=?";
+  RDSqlQuery *q=new RDSqlQuery(sql,QVariantList()<<test_log_name);
+  if(q->first()) {
+    if((q->value(0).toInt()!=model->lineCount())||
+       ((model->lineCount()>0)&&((q->value(1).toInt()!=0)||
+				 (q->value(2).toInt()!=
+				  (model->lineCount()-1))))) {
+      fprintf(stderr,
+	      "log_save_test: %s: %d rows numbered %d to %d, expected %d\n",
+	      label.toUtf8().constData(),q->value(0).toInt(),
+	      q->value(1).toInt(),q->value(2).toInt(),model->lineCount());
+      ret=false;
+    }
+  }
+  delete q;
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
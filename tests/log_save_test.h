@@ -0,0 +1,42 @@
+// log_save_test.h
+//
+// Count the rows written when saving an edited log
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef LOG_SAVE_TEST_H
+#define LOG_SAVE_TEST_H
+
+#include <QObject>
+
+#include <rdlogmodel.h>
+
+#define LOG_SAVE_TEST_USAGE "--log=<name> [--line=<num>]\n\nChange the grace time of one line of the specified log, save it, then\nput it back and save it again.  Then insert a line before it, save,\nremove the line and save again.  Reports the number of statements\nwritten by each save.  Exits non-zero if a save writes more than the\nrows it needs to, or if the log reads back differently.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool Save(RDLogModel *model,const QString &label,uint64_t expected);
+  bool Compare(RDLogModel *model,const QString &label);
+  QString test_log_name;
+};
+
+
+#endif  // LOG_SAVE_TEST_H
@@ -0,0 +1,189 @@
+// prepared_query_test.cpp
+//
+// Benchmark prepared against string-built database queries
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <QCoreApplication>
+
+#include <rd.h>
+#include <rdapplication.h>
+#include <rddb.h>
+
+#include "prepared_query_test.h"
+
+static double Now()
+{
+  struct timeval tv;
+
+  gettimeofday(&tv,NULL);
+
+  return (double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+}
+
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  QString sql;
+  RDSqlQuery *q=NULL;
+  QStringList string_titles;
+  QStringList prepared_titles;
+  double string_secs=0.0;
+  double prepared_secs=0.0;
+  bool ok=false;
+  int ret=0;
+
+  test_iterations=100;
+
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch("prepared_query_test",PREPARED_QUERY_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--cart-number") {
+      test_cart_numbers.push_back(cmd->value(i).toUInt(&ok));
+      if((!ok)||(test_cart_numbers.back()==0)||
+	 (test_cart_numbers.back()>RD_MAX_CART_NUMBER)) {
+	fprintf(stderr,"prepared_query_test: invalid --cart-number\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--iterations") {
+      test_iterations=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_iterations<=0)) {
+	fprintf(stderr,"prepared_query_test: invalid --iterations\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"prepared_query_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("prepared_query_test",
+		       "prepared_query_test",PREPARED_QUERY_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"prepared_query_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+
+  if(test_cart_numbers.size()==0) {
+    sql=QString("select `NUMBER` from `CART` order by `NUMBER` limit 100");
+    q=new RDSqlQuery(sql);
+    while(q->next()) {
+      test_cart_numbers.push_back(q->value(0).toUInt());
+    }
+    delete q;
+    if(test_cart_numbers.size()==0) {
+      fprintf(stderr,"prepared_query_test: no carts to look up\n");
+      exit(1);
+    }
+  }
+
+  //
+  // Run each once untimed, so that neither pays for warming the server
+  //
+  RunStrings(&string_titles);
+  RunPrepared(&prepared_titles);
+  if(string_titles!=prepared_titles) {
+    fprintf(stderr,
+	    "prepared_query_test: prepared queries returned different values\n");
+    ret=1;
+  }
+
+  string_secs=RunStrings(&string_titles);
+  prepared_secs=RunPrepared(&prepared_titles);
+
+  int queries=test_cart_numbers.size()*test_iterations;
+  printf("Carts: %d  Iterations: %d  Queries: %d\n",
+	 test_cart_numbers.size(),test_iterations,queries);
+  printf("\nString-built\n");
+  printf("  Elapsed: %9.3f s\n",string_secs);
+  printf("  Rate:    %9.1f queries/s\n",(double)queries/string_secs);
+  printf("\nPrepared\n");
+  printf("  Elapsed: %9.3f s\n",prepared_secs);
+  printf("  Rate:    %9.1f queries/s\n",(double)queries/prepared_secs);
+  printf("\nPrepared is %.2fx the rate of string-built\n",
+	 string_secs/prepared_secs);
+
+  exit(ret);
+}
+
+
+double MainObject::RunStrings(QStringList *titles) const
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  double start=Now();
+
+  titles->clear();
+  for(int i=0;i<test_iterations;i++) {
+    for(int j=0;j<test_cart_numbers.size();j++) {
+      sql=QString("select `TITLE` from `CART` where ")+
+	QString::asprintf("`NUMBER`=%u",test_cart_numbers.at(j));
+      q=new RDSqlQuery(sql);
+      if(q->first()&&(i==0)) {
+	titles->push_back(q->value(0).toString());
+      }
+      delete q;
+    }
+  }
+
+  return Now()-start;
+}
+
+
+double MainObject::RunPrepared(QStringList *titles) const
+{
+  QString sql;
+  RDSqlQuery *q=NULL;
+  double start=Now();
+
+  titles->clear();
+  sql=QString("select `TITLE` from `CART` where `NUMBER`=?");
+  for(int i=0;i<test_iterations;i++) {
+    for(int j=0;j<test_cart_numbers.size();j++) {
+      q=new RDSqlQuery(sql,QVariantList()<<test_cart_numbers.at(j));
+      if(q->first()&&(i==0)) {
+	titles->push_back(q->value(0).toString());
+      }
+      delete q;
+    }
+  }
+
+  return Now()-start;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
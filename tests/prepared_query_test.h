@@ -0,0 +1,43 @@
+// prepared_query_test.h
+//
+// Benchmark prepared against string-built database queries
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef PREPARED_QUERY_TEST_H
+#define PREPARED_QUERY_TEST_H
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+#define PREPARED_QUERY_TEST_USAGE "[options]\n\nBenchmark prepared, bound-parameter queries against string-built ones\n\n--cart-number=<num>\n     Cart to look up. May be given more than once. Default is the\n     first 100 carts in the library.\n\n--iterations=<n>\n     Number of passes over the carts for each kind of query. Default\n     is 100.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  double RunStrings(QStringList *titles) const;
+  double RunPrepared(QStringList *titles) const;
+  QList<unsigned> test_cart_numbers;
+  int test_iterations;
+};
+
+
+#endif  // PREPARED_QUERY_TEST_H
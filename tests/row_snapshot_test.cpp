@@ -0,0 +1,184 @@
+// row_snapshot_test.cpp
+//
+// Count the database round trips needed to read a cart's metadata
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+
+#include <rd.h>
+#include <rdapplication.h>
+#include <rddb.h>
+
+#include "row_snapshot_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  QList<unsigned> cartnums;
+  QList<RDCart *> carts;
+  QStringList plain;
+  QStringList snap;
+  uint64_t plain_trips=0;
+  uint64_t snap_trips=0;
+  uint64_t batch_trips=0;
+  bool ok=false;
+  int ret=0;
+
+  RDCmdSwitch *cmd=
+    new RDCmdSwitch("row_snapshot_test",ROW_SNAPSHOT_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--cart-number") {
+      cartnums.push_back(cmd->value(i).toUInt(&ok));
+      if((!ok)||(cartnums.back()==0)||(cartnums.back()>RD_MAX_CART_NUMBER)) {
+	fprintf(stderr,"row_snapshot_test: invalid --cart-number\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"row_snapshot_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(cartnums.size()==0) {
+    fprintf(stderr,"row_snapshot_test: you must specify --cart-number\n");
+    exit(1);
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("row_snapshot_test",
+		       "row_snapshot_test",ROW_SNAPSHOT_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"row_snapshot_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+
+  //
+  // One cart at a time, without and then with a snapshot
+  //
+  for(int i=0;i<cartnums.size();i++) {
+    RDCart *cart=new RDCart(cartnums.at(i));
+    RDSqlQuery::resetRoundTrips();
+    plain.push_back(ReadCart(cart));
+    plain_trips+=RDSqlQuery::roundTrips();
+    cart->setSnapshotEnabled(true);
+    RDSqlQuery::resetRoundTrips();
+    snap.push_back(ReadCart(cart));
+    snap_trips+=RDSqlQuery::roundTrips();
+    delete cart;
+  }
+
+  //
+  // All of the carts in one batch
+  //
+  for(int i=0;i<cartnums.size();i++) {
+    carts.push_back(new RDCart(cartnums.at(i)));
+  }
+  RDSqlQuery::resetRoundTrips();
+  RDCart::loadSnapshots(carts);
+  for(int i=0;i<carts.size();i++) {
+    if(ReadCart(carts.at(i))!=plain.at(i)) {
+      fprintf(stderr,
+	      "cart %06u: batched snapshot returned different values\n",
+	      cartnums.at(i));
+      ret=1;
+    }
+  }
+  batch_trips=RDSqlQuery::roundTrips();
+  for(int i=0;i<carts.size();i++) {
+    delete carts.at(i);
+  }
+
+  for(int i=0;i<cartnums.size();i++) {
+    if(plain.at(i)!=snap.at(i)) {
+      fprintf(stderr,"cart %06u: snapshot returned different values\n",
+	      cartnums.at(i));
+      ret=1;
+    }
+  }
+  printf("Carts:    %d\n",cartnums.size());
+  printf("Direct:   %lu round trips\n",(unsigned long)plain_trips);
+  printf("Snapshot: %lu round trips\n",(unsigned long)snap_trips);
+  printf("Batched:  %lu round trips\n",(unsigned long)batch_trips);
+  if(snap_trips>(uint64_t)cartnums.size()) {
+    fprintf(stderr,"row_snapshot_test: snapshot reads took more than one %s",
+	    "round trip per cart\n");
+    ret=1;
+  }
+  if(batch_trips>1) {
+    fprintf(stderr,
+	    "row_snapshot_test: batched reads took more than one round trip\n");
+    ret=1;
+  }
+
+  exit(ret);
+}
+
+
+QString MainObject::ReadCart(RDCart *cart) const
+{
+  QStringList f0;
+
+  f0.push_back(cart->groupName());
+  f0.push_back(QString::asprintf("%u",cart->type()));
+  f0.push_back(cart->title());
+  f0.push_back(cart->artist());
+  f0.push_back(cart->album());
+  f0.push_back(QString::asprintf("%d",cart->year()));
+  f0.push_back(cart->label());
+  f0.push_back(cart->conductor());
+  f0.push_back(cart->client());
+  f0.push_back(cart->agency());
+  f0.push_back(cart->publisher());
+  f0.push_back(cart->composer());
+  f0.push_back(cart->userDefined());
+  f0.push_back(cart->songId());
+  f0.push_back(QString::asprintf("%u",cart->beatsPerMinute()));
+  f0.push_back(QString::asprintf("%d",cart->usageCode()));
+  f0.push_back(cart->notes());
+  f0.push_back(QString::asprintf("%u",cart->forcedLength()));
+  f0.push_back(QString::asprintf("%u",cart->lengthDeviation()));
+  f0.push_back(QString::asprintf("%u",cart->averageLength()));
+  f0.push_back(QString::asprintf("%u",cart->averageSegueLength()));
+  f0.push_back(QString::asprintf("%u",cart->averageHookLength()));
+  f0.push_back(QString::asprintf("%u",cart->cutQuantity()));
+  f0.push_back(QString::asprintf("%u",cart->lastCutPlayed()));
+  f0.push_back(QString::asprintf("%u",cart->validity()));
+  f0.push_back(QString::asprintf("%u",cart->enforceLength()));
+  f0.push_back(QString::asprintf("%u",cart->useWeighting()));
+  f0.push_back(QString::asprintf("%u",cart->asyncronous()));
+  f0.push_back(QString::asprintf("%u",cart->useEventLength()));
+
+  return f0.join("|");
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,40 @@
+// row_snapshot_test.h
+//
+// Count the database round trips needed to read a cart's metadata
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef ROW_SNAPSHOT_TEST_H
+#define ROW_SNAPSHOT_TEST_H
+
+#include <QObject>
+
+#include <rdcart.h>
+
+#define ROW_SNAPSHOT_TEST_USAGE "--cart-number=<num> [--cart-number=<num>] ...\n\nRead the metadata of each cart with and without a row snapshot,\nreporting the number of database round trips taken.  Exits non-zero if\nthe snapshot reads take more than one round trip per cart.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  QString ReadCart(RDCart *cart) const;
+};
+
+
+#endif  // ROW_SNAPSHOT_TEST_H
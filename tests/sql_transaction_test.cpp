@@ -0,0 +1,189 @@
+// sql_transaction_test.cpp
+//
+// Exercise nested database transactions
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <rdapplication.h>
+#include <rddb.h>
+#include <rdsqltransaction.h>
+
+#include "sql_transaction_test.h"
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  QString err_msg;
+  int ret=0;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch("sql_transaction_test",
+				   SQL_TRANSACTION_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"sql_transaction_test: unknown option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+
+  //
+  // Open the Database
+  //
+  rda=static_cast<RDApplication *>(new RDApplication("sql_transaction_test",
+	    "sql_transaction_test",SQL_TRANSACTION_TEST_USAGE,false,this));
+  if(!rda->open(&err_msg,NULL,true,false)) {
+    fprintf(stderr,"sql_transaction_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+
+  //
+  // Rows written to tables using a non-transactional engine (such as the
+  // default MyISAM) can't be rolled back, so only report what we have
+  //
+  QStringList tables=RDSqlTransaction::nonTransactionalTables(QStringList()<<
+				 "CART"<<"CUTS"<<"LOGS"<<"LOG_LINES");
+  if(tables.size()>0) {
+    fprintf(stderr,"sql_transaction_test: warning: tables %s do not support "
+	    "transactions\n",
+	    tables.join(", ").toUtf8().constData());
+  }
+  QString engine=rda->config()->mysqlEngine().toLower();
+  if((engine!="innodb")&&(engine!="ndbcluster")) {
+    fprintf(stderr,"sql_transaction_test: configured engine \"%s\" does not "
+	    "support transactions, skipping\n",
+	    rda->config()->mysqlEngine().toUtf8().constData());
+    exit(0);
+  }
+
+  //
+  // A temporary table is private to this connection, and creating one
+  // doesn't commit an open transaction
+  //
+  if(!RDSqlQuery::apply(QString("create temporary table ")+
+			"`SQL_TRANSACTION_TEST` (`VALUE` int not null)"+
+			rda->config()->createTablePostfix(),&err_msg)) {
+    fprintf(stderr,"sql_transaction_test: %s\n",err_msg.toUtf8().constData());
+    exit(1);
+  }
+
+  //
+  // Inner rollback, outer commit
+  //
+  {
+    RDSqlTransaction outer;
+    Insert(1);
+    {
+      RDSqlTransaction inner;
+      if(inner.depth()!=2) {
+	fprintf(stderr,"sql_transaction_test: inner depth is %d, expected 2\n",
+		inner.depth());
+	ret=1;
+      }
+      Insert(2);
+      inner.rollback();
+    }
+    Insert(3);
+    outer.commit();
+  }
+  if(!Check("inner rolled back",QList<int>()<<1<<3)) {
+    ret=1;
+  }
+
+  //
+  // Inner commit, outer abandoned by leaving its scope
+  //
+  {
+    RDSqlTransaction outer;
+    Insert(4);
+    {
+      RDSqlTransaction inner;
+      Insert(5);
+      inner.commit();
+    }
+  }
+  if(!Check("outer abandoned",QList<int>()<<1<<3)) {
+    ret=1;
+  }
+
+  //
+  // Both committed
+  //
+  {
+    RDSqlTransaction outer;
+    {
+      RDSqlTransaction inner;
+      Insert(6);
+      inner.commit();
+    }
+    outer.commit();
+  }
+  if(!Check("both committed",QList<int>()<<1<<3<<6)) {
+    ret=1;
+  }
+
+  if(RDSqlTransaction::currentDepth()!=0) {
+    fprintf(stderr,"sql_transaction_test: depth %d left open\n",
+	    RDSqlTransaction::currentDepth());
+    ret=1;
+  }
+
+  exit(ret);
+}
+
+
+void MainObject::Insert(int value)
+{
+  RDSqlQuery::apply("insert into `SQL_TRANSACTION_TEST` set `VALUE`=?",
+		    QVariantList()<<value);
+}
+
+
+bool MainObject::Check(const QString &label,const QList<int> &expected)
+{
+  QList<int> values;
+  bool ret=true;
+
+  RDSqlQuery *q=new RDSqlQuery(QString("select `VALUE` from ")+
+				"`SQL_TRANSACTION_TEST` order by `VALUE`");
+  while(q->next()) {
+    values.push_back(q->value(0).toInt());
+  }
+  delete q;
+  if(values!=expected) {
+    fprintf(stderr,"sql_transaction_test: %s: wrong rows in table\n",
+	    label.toUtf8().constData());
+    ret=false;
+  }
+  printf("%s: %s\n",label.toUtf8().constData(),ret?"OK":"FAILED");
+
+  return ret;
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,40 @@
+// sql_transaction_test.h
+//
+// Exercise nested database transactions
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef SQL_TRANSACTION_TEST_H
+#define SQL_TRANSACTION_TEST_H
+
+#include <QList>
+#include <QObject>
+
+#define SQL_TRANSACTION_TEST_USAGE "\n\nRun a set of nested transactions against a temporary table, checking\nthat each savepoint commits and rolls back only its own rows.  Exits\nnon-zero if any check fails.\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  void Insert(int value);
+  bool Check(const QString &label,const QList<int> &expected);
+};
+
+
+#endif  // SQL_TRANSACTION_TEST_H
@@ -0,0 +1,284 @@
+// xport_rate_test.cpp
+//
+// Benchmark the request rate of the rdxport.cgi Web API
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <algorithm>
+
+#include <curl/curl.h>
+
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <rdcmd_switch.h>
+#include <rdformpost.h>
+#include <rdxport_interface.h>
+
+#include "xport_rate_test.h"
+
+//
+// State shared between the request threads
+//
+struct RateTestState
+{
+  QByteArray url;
+  QByteArray post_data;
+  int requests;
+  int next;
+  int failures;
+  QList<double> latencies;
+  pthread_mutex_t mutex;
+};
+
+
+static double Now()
+{
+  struct timeval tv;
+
+  gettimeofday(&tv,NULL);
+
+  return (double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+}
+
+
+size_t __XportRateTest_WriteCallback(char *ptr,size_t size,size_t nmemb,
+				     void *userdata)
+{
+  return size*nmemb;  // Discard the response body
+}
+
+
+void *__XportRateTest_ThreadCallback(void *priv)
+{
+  RateTestState *state=(RateTestState *)priv;
+  CURL *curl=NULL;
+  long resp_code=0;
+  double start;
+  double latency;
+  bool ok;
+
+  //
+  // One handle per thread, so that the connection to the web server is
+  // kept alive; what we want to measure is the cost of the request itself.
+  //
+  if((curl=curl_easy_init())==NULL) {
+    return NULL;
+  }
+  curl_easy_setopt(curl,CURLOPT_URL,state->url.constData());
+  curl_easy_setopt(curl,CURLOPT_POSTFIELDS,state->post_data.constData());
+  curl_easy_setopt(curl,CURLOPT_WRITEFUNCTION,__XportRateTest_WriteCallback);
+  curl_easy_setopt(curl,CURLOPT_NOSIGNAL,1L);
+
+  while(true) {
+    pthread_mutex_lock(&state->mutex);
+    if(state->next>=state->requests) {
+      pthread_mutex_unlock(&state->mutex);
+      break;
+    }
+    state->next++;
+    pthread_mutex_unlock(&state->mutex);
+
+    start=Now();
+    ok=curl_easy_perform(curl)==CURLE_OK;
+    latency=Now()-start;
+    if(ok) {
+      curl_easy_getinfo(curl,CURLINFO_RESPONSE_CODE,&resp_code);
+      ok=(resp_code>=200)&&(resp_code<300);
+    }
+
+    pthread_mutex_lock(&state->mutex);
+    state->latencies.push_back(latency);
+    if(!ok) {
+      state->failures++;
+    }
+    pthread_mutex_unlock(&state->mutex);
+  }
+  curl_easy_cleanup(curl);
+
+  return NULL;
+}
+
+
+MainObject::MainObject(QObject *parent)
+  : QObject(parent)
+{
+  bool ok=false;
+  QStringList urls;
+  QString login_name="user";
+  QString password="";
+  int command=RDXPORT_COMMAND_LISTSYSTEMSETTINGS;
+  QStringList fields;
+  double secs=0.0;
+  QList<double> latencies;
+  int failures=0;
+  QList<double> rates;
+
+  test_requests=1000;
+  test_concurrency=4;
+
+  RDCmdSwitch *cmd=new RDCmdSwitch("xport_rate_test",XPORT_RATE_TEST_USAGE);
+  for(unsigned i=0;i<cmd->keys();i++) {
+    if(cmd->key(i)=="--url") {
+      urls.push_back(cmd->value(i));
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--login-name") {
+      login_name=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--password") {
+      password=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--command") {
+      command=cmd->value(i).toInt(&ok);
+      if((!ok)||(command<0)) {
+	fprintf(stderr,"xport_rate_test: invalid --command\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--field") {
+      QStringList f0=cmd->value(i).split("=",QString::KeepEmptyParts);
+      if(f0.size()<2) {
+	fprintf(stderr,"xport_rate_test: invalid --field\n");
+	exit(1);
+      }
+      QString name=f0.takeFirst();
+      fields.push_back(name+"="+RDFormPost::urlEncode(f0.join("=")));
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--requests") {
+      test_requests=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_requests<=0)) {
+	fprintf(stderr,"xport_rate_test: invalid --requests\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--concurrency") {
+      test_concurrency=cmd->value(i).toInt(&ok);
+      if((!ok)||(test_concurrency<=0)) {
+	fprintf(stderr,"xport_rate_test: invalid --concurrency\n");
+	exit(1);
+      }
+      cmd->setProcessed(i,true);
+    }
+    if(!cmd->processed(i)) {
+      fprintf(stderr,"xport_rate_test: unrecognized option \"%s\"\n",
+	      cmd->key(i).toUtf8().constData());
+      exit(1);
+    }
+  }
+  if(urls.size()==0) {
+    urls.push_back("http://localhost/rd-bin/rdxport.cgi");
+  }
+  fields.push_front(QString::asprintf("COMMAND=%d",command));
+  fields.push_back("LOGIN_NAME="+RDFormPost::urlEncode(login_name));
+  fields.push_back("PASSWORD="+RDFormPost::urlEncode(password));
+  test_post_data=fields.join("&").toUtf8();
+
+  curl_global_init(CURL_GLOBAL_ALL);
+
+  printf("Command: %d  Requests: %d  Concurrency: %d\n",
+	 command,test_requests,test_concurrency);
+  for(int i=0;i<urls.size();i++) {
+    if(!RunUrl(urls.at(i),&secs,&latencies,&failures)) {
+      fprintf(stderr,"xport_rate_test: unable to start request threads\n");
+      exit(1);
+    }
+    std::sort(latencies.begin(),latencies.end());
+    double mean=0.0;
+    for(int j=0;j<latencies.size();j++) {
+      mean+=latencies.at(j);
+    }
+    mean/=(double)latencies.size();
+    rates.push_back((double)test_requests/secs);
+
+    printf("\n%s\n",urls.at(i).toUtf8().constData());
+    printf("  Elapsed: %9.3f s\n",secs);
+    printf("  Rate:    %9.1f requests/s\n",rates.back());
+    printf("  Latency: %9.2f ms mean, %.2f ms median, %.2f ms p95\n",
+	   1000.0*mean,1000.0*latencies.at(latencies.size()/2),
+	   1000.0*latencies.at((95*latencies.size())/100));
+    printf("  Failed:  %9d\n",failures);
+    if(failures==test_requests) {
+      fprintf(stderr,"xport_rate_test: every request to \"%s\" failed\n",
+	      urls.at(i).toUtf8().constData());
+    }
+  }
+  if(rates.size()>1) {
+    printf("\n");
+    for(int i=1;i<rates.size();i++) {
+      printf("%s is %.2fx the rate of %s\n",urls.at(i).toUtf8().constData(),
+	     rates.at(i)/rates.at(0),urls.at(0).toUtf8().constData());
+    }
+  }
+
+  curl_global_cleanup();
+
+  exit(0);
+}
+
+
+bool MainObject::RunUrl(const QString &url,double *secs,
+			QList<double> *latencies,int *failures)
+{
+  RateTestState state;
+  QList<pthread_t> threads;
+  pthread_t thread;
+  double start;
+
+  state.url=url.toUtf8();
+  state.post_data=test_post_data;
+  state.requests=test_requests;
+  state.next=0;
+  state.failures=0;
+  pthread_mutex_init(&state.mutex,NULL);
+
+  start=Now();
+  for(int i=0;i<test_concurrency;i++) {
+    if(pthread_create(&thread,NULL,__XportRateTest_ThreadCallback,&state)!=0) {
+      break;
+    }
+    threads.push_back(thread);
+  }
+  for(int i=0;i<threads.size();i++) {
+    pthread_join(threads.at(i),NULL);
+  }
+  *secs=Now()-start;
+  pthread_mutex_destroy(&state.mutex);
+
+  *latencies=state.latencies;
+  *failures=state.failures+(test_requests-state.latencies.size());
+
+  return (threads.size()>0)&&(latencies->size()>0);
+}
+
+
+int main(int argc,char *argv[])
+{
+  QCoreApplication a(argc,argv);
+  new MainObject();
+  return a.exec();
+}
@@ -0,0 +1,45 @@
+// xport_rate_test.h
+//
+// Benchmark the request rate of the rdxport.cgi Web API
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#ifndef XPORT_RATE_TEST_H
+#define XPORT_RATE_TEST_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#define XPORT_RATE_TEST_USAGE "[options]\n\nBenchmark the request rate of the rdxport.cgi Web API\n\n--url=<url>\n     URL of the Web API to test. May be given more than once (e.g.\n     once for the CGI and once for the persistent service), in which\n     case each is measured in turn. Default is\n     'http://localhost/rd-bin/rdxport.cgi'.\n\n--login-name=<name>\n     Rivendell user to authenticate as. Default is 'user'.\n\n--password=<passwd>\n     Password for --login-name. Default is ''.\n\n--command=<n>\n     Numeric Web API command to issue. Default is 33\n     (ListSystemSettings).\n\n--field=<name>=<value>\n     Add an extra form field to each request (e.g. --field=CART_NUMBER=1).\n     May be given more than once.\n\n--requests=<n>\n     Number of requests to make against each URL. Default is 1000.\n\n--concurrency=<n>\n     Number of requests to keep in flight at once. Default is 4.\n\n"
+
+class MainObject : public QObject
+{
+ public:
+  MainObject(QObject *parent=0);
+
+ private:
+  bool RunUrl(const QString &url,double *secs,QList<double> *latencies,
+	      int *failures);
+  QByteArray test_post_data;
+  int test_requests;
+  int test_concurrency;
+};
+
+
+#endif  // XPORT_RATE_TEST_H
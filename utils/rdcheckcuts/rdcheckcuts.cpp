@@ -21,12 +21,15 @@
 #include <stdlib.h>
 
 #include <qapplication.h>
+#include <qmap.h>
 
 #include <rdapplication.h>
 #include <rdaudioinfo.h>
 #include <rdcart.h>
 #include <rdcut.h>
 #include <rddb.h>
+#include <rdescape_string.h>
+#include <rdhashengine.h>
 
 #include <rdcheckcuts.h>
 
@@ -35,6 +38,8 @@ MainObject::MainObject(QObject *parent)
 {
   std::vector<QString> group_names;
   std::vector<QString> bad_cuts;
+  std::vector<QString> bad_hashes;
+  bool check_hashes=false;
   QString sql;
   RDSqlQuery *q;
   QString err_msg;
@@ -57,6 +62,14 @@ MainObject::MainObject(QObject *parent)
       group_names.push_back(rda->cmdSwitch()->value(i));
       rda->cmdSwitch()->setProcessed(i,true);
     }
+    if(rda->cmdSwitch()->key(i)=="--check-hashes") {
+      check_hashes=true;
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
+    if(rda->cmdSwitch()->key(i)=="--rehash-progress") {
+      check_rehash_progress=rda->cmdSwitch()->value(i);
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(!rda->cmdSwitch()->processed(i)) {
       fprintf(stderr,"rdcheckcuts: unknown command option \"%s\"\n",
 	      rda->cmdSwitch()->key(i).toUtf8().constData());
@@ -82,6 +95,9 @@ MainObject::MainObject(QObject *parent)
   for(unsigned i=0;i<group_names.size();i++) {
     ValidateGroup(group_names[i],&bad_cuts);
   }
+  if(check_hashes) {
+    CheckHashes(group_names,&bad_hashes);
+  }
 
   //
   // Render Output
@@ -89,6 +105,9 @@ MainObject::MainObject(QObject *parent)
   for(unsigned i=0;i<bad_cuts.size();i++) {
     RenderCut(bad_cuts[i]);
   }
+  for(unsigned i=0;i<bad_hashes.size();i++) {
+    RenderHash(bad_hashes[i]);
+  }
 
   exit(0);
 }
@@ -109,6 +128,21 @@ void MainObject::RenderCut(const QString &cutname)
 }
 
 
+void MainObject::RenderHash(const QString &cutname)
+{
+  RDCut *cut=new RDCut(cutname);
+  RDCart *cart=new RDCart(cut->cartNumber());
+
+  printf("Cut %03d [%s] in cart %06u [%s] has inconsistent SHA1 hash\n",
+	 cut->cutNumber(),
+	 cut->description().toUtf8().constData(),
+	 cart->number(),
+	 cart->title().toUtf8().constData());
+  delete cart;
+  delete cut;
+}
+
+
 bool MainObject::ValidateGroup(const QString &groupname,
 			       std::vector<QString> *cutnames)
 {
@@ -154,6 +188,52 @@ bool MainObject::ValidateGroup(const QString &groupname,
 }
 
 
+void MainObject::CheckHashes(const std::vector<QString> &groupnames,
+			     std::vector<QString> *cutnames)
+{
+  QString sql;
+  RDSqlQuery *q;
+  QMap<QString,QString> stored;
+  QString cutname;
+  QString hash;
+  RDHashEngine *engine=new RDHashEngine(rda->config());
+
+  engine->setProgressFile(check_rehash_progress);
+  for(unsigned i=0;i<groupnames.size();i++) {
+    sql=QString("select ")+
+      "`CUTS`.`CUT_NAME`,"+   // 00
+      "`CUTS`.`SHA1_HASH` "+  // 01
+      "from `CUTS` left join `CART` "+
+      "on `CUTS`.`CART_NUMBER`=`CART`.`NUMBER` "+
+      "where (`CART`.`GROUP_NAME`='"+RDEscapeString(groupnames[i])+"')&&"+
+      "(`CUTS`.`LENGTH`>0)&&(`CUTS`.`SHA1_HASH` is not null) "+
+      "order by `CUTS`.`CUT_NAME`";
+    q=new RDSqlQuery(sql);
+    while(q->next()) {
+      stored[q->value(0).toString()]=q->value(1).toString();
+      engine->addFile(q->value(0).toString(),
+		      RDCut::pathName(q->value(0).toString()));
+    }
+    delete q;
+  }
+  if(!engine->start()) {
+    fprintf(stderr,"rdcheckcuts: unable to start hashing\n");
+    exit(1);
+  }
+
+  //
+  // Unreadable audio shows up as missing, so only report real mismatches
+  //
+  while(engine->next(&cutname,&hash)) {
+    if((!hash.isEmpty())&&(!stored.value(cutname).isEmpty())&&
+       (hash!=stored.value(cutname))) {
+      cutnames->push_back(cutname);
+    }
+  }
+  delete engine;
+}
+
+
 int main(int argc,char *argv[])
 {
   QApplication a(argc,argv,false);
@@ -25,7 +25,7 @@
 
 #include <qobject.h>
 
-#define RDCHECKCUTS_USAGE "[options]\n\nCheck Rivendell cuts for valid audio\n\n--group=<group-name>\n     Name of group to scan.  This option may be given multiple times.\n     If no group is specified, then ALL groups will be scanned.\n"
+#define RDCHECKCUTS_USAGE "[options]\n\nCheck Rivendell cuts for valid audio\n\n--group=<group-name>\n     Name of group to scan.  This option may be given multiple times.\n     If no group is specified, then ALL groups will be scanned.\n\n--check-hashes\n     Also check the audio of each cut against its stored SHA1 hash.\n     The audio store must be readable from the local host.\n\n--rehash-progress=<file-name>\n     Record the cuts checked by --check-hashes in <file-name>, so that\n     an interrupted run can be resumed.\n"
 
 class MainObject : public QObject
 {
@@ -34,7 +34,11 @@ class MainObject : public QObject
 
  private:
   void RenderCut(const QString &cutname);
+  void RenderHash(const QString &cutname);
   bool ValidateGroup(const QString &groupname,std::vector<QString> *cutnames);
+  void CheckHashes(const std::vector<QString> &groupnames,
+		   std::vector<QString> *cutnames);
+  QString check_rehash_progress;
 };
 
 
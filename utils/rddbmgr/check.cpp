@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -29,10 +30,12 @@
 #include <QProcess>
 
 #include <dbversion.h>
+#include <rdaudiodedup.h>
 #include <rdconf.h>
 #include <rdescape_string.h>
 #include <rdhash.h>
 #include <rdlog.h>
+#include <rdsqltransaction.h>
 
 #include "rddbmgr.h"
 
@@ -153,6 +156,15 @@ bool MainObject::Check(QString *err_msg)
     printf("done.\n\n");
   }
 
+  //
+  // Deduplicate Audio
+  //
+  if(db_check_all&&db_dedup_audio) {
+    printf("Deduplicating audio (this may take some time)...\n");
+    DedupAudio();
+    printf("done.\n\n");
+  }
+
   //
   // Check Log Line IDs
   //
@@ -890,6 +902,8 @@ void MainObject::CheckLogLineIds(const QString &logname) const
 	      logname.toUtf8().constData(),q->value(1).toInt());
       printf("  Repair it (y/N)?");
       if(UserResponse()) {
+	RDSqlTransaction trans(QStringList()<<"LOG_LINES"<<"LOGS");
+
 	//
 	// Calculate next unused line ID
 	//
@@ -921,6 +935,7 @@ void MainObject::CheckLogLineIds(const QString &logname) const
 	  "`NAME`='"+RDEscapeString(logname)+"'";
 	RDSqlQuery::apply(sql);
 	next_line_id++;
+	trans.commit();
       }
     }
     prev_line_id=q->value(2).toInt();
@@ -965,32 +980,61 @@ void MainObject::Rehash(const QString &arg) const
   QSqlQuery *q;
   unsigned cartnum;
   bool ok=false;
+  QString cutname;
+  QString hash;
+  RDHashEngine *engine=new RDHashEngine(db_config);
+  RDAudioDedup *dedup=new RDAudioDedup(db_config);
 
+  engine->setProgressFile(db_rehash_progress);
   if(arg.toLower()=="all") {
-    sql=QString("select `NUMBER` from `CART` where ")+
-      QString::asprintf("`TYPE`=%d ",RDCart::Audio)+
-      "order by `NUMBER`";
+    sql=QString("select `CUTS`.`CUT_NAME` from `CUTS` left join `CART` ")+
+      "on `CUTS`.`CART_NUMBER`=`CART`.`NUMBER` where "+
+      QString::asprintf("`CART`.`TYPE`=%d ",RDCart::Audio)+
+      "order by `CUTS`.`CUT_NAME`";
     q=new QSqlQuery(sql);
     while(q->next()) {
-      RehashCart(q->value(0).toUInt());
+      engine->addFile(q->value(0).toString(),
+		      RDCut::pathName(q->value(0).toString()));
     }
     delete q;
-    return;
   }
-  cartnum=arg.toUInt(&ok);
-  if(ok&&(cartnum>0)&&(cartnum<=RD_MAX_CART_NUMBER)) {
-    RehashCart(cartnum);
+  else {
+    cartnum=arg.toUInt(&ok);
+    if(ok&&(cartnum>0)&&(cartnum<=RD_MAX_CART_NUMBER)) {
+      RehashCart(engine,cartnum);
+    }
+    else {
+      RDCut *cut=new RDCut(arg);
+      if(cut->exists()) {
+	engine->addFile(arg,RDCut::pathName(arg));
+      }
+      delete cut;
+    }
+  }
+  if(!engine->start()) {
+    printf("  Unable to start hashing [%s]\n",strerror(errno));
+    delete engine;
     return;
   }
-  RDCut *cut=new RDCut(arg);
-  if(cut->exists()) {
-    RehashCut(arg);
+  if(engine->skipped()>0) {
+    printf("  Skipping %d cuts checked by a previous run.\n",
+	   engine->skipped());
   }
-  delete cut;
+  while(engine->next(&cutname,&hash)) {
+    if(RehashCut(cutname,hash)&&dedup->isEnabled()) {
+      dedup->dedup(cutname,hash);
+    }
+  }
+  if(db_verbose) {
+    printf("  Read %lu MB of audio.\n",
+	   (unsigned long)(engine->bytesRead()/1048576));
+  }
+  delete dedup;
+  delete engine;
 }
 
 
-void MainObject::RehashCart(unsigned cartnum) const
+void MainObject::RehashCart(RDHashEngine *engine,unsigned cartnum) const
 {
   RDCart *cart=new RDCart(cartnum);
   if(cart->exists()) {
@@ -1000,7 +1044,8 @@ void MainObject::RehashCart(unsigned cartnum) const
 	"order by `CUT_NAME`";
       QSqlQuery *q=new QSqlQuery(sql);
       while(q->next()) {
-	RehashCut(q->value(0).toString());
+	engine->addFile(q->value(0).toString(),
+			RDCut::pathName(q->value(0).toString()));
       }
       delete q;
     }
@@ -1008,12 +1053,14 @@ void MainObject::RehashCart(unsigned cartnum) const
   else {
     printf("  Cart %06u does not exist.\n",cartnum);
   }
+  delete cart;
 }
 
 
-void MainObject::RehashCut(const QString &cutnum) const
+bool MainObject::RehashCut(const QString &cutnum,const QString &hash) const
 {
-  QString hash=RDSha1HashFile(RDCut::pathName(cutnum),true);
+  bool ret=false;
+
   if(hash.isEmpty()) {
     printf("  Unable to generate hash for \"%s\"\n",
 	   RDCut::pathName(cutnum).toUtf8().constData());
@@ -1023,9 +1070,11 @@ void MainObject::RehashCut(const QString &cutnum) const
     if(cut->exists()) {
       if(cut->sha1Hash().isEmpty()) {
 	cut->setSha1Hash(hash);
+	ret=true;
       }
       else {
-	if(cut->sha1Hash()!=hash) {
+	ret=cut->sha1Hash()==hash;
+	if(!ret) {
 	  RDCart *cart=new RDCart(RDCut::cartNumber(cutnum));
 	  printf("  Cut %d [%s] in cart %06u [%s] has inconsistent SHA1 hash.  Fix? (y/N) ",
 		 cut->cutNumber(),
@@ -1035,6 +1084,7 @@ void MainObject::RehashCut(const QString &cutnum) const
 	  fflush(NULL);
 	  if(UserResponse()) {
 	    cut->setSha1Hash(hash);
+	    ret=true;
 	  }
 	  delete cart;
 	}
@@ -1045,6 +1095,46 @@ void MainObject::RehashCut(const QString &cutnum) const
     }
     delete cut;
   }
+
+  return ret;
+}
+
+
+void MainObject::DedupAudio() const
+{
+  QString sql;
+  QSqlQuery *q;
+  RDAudioDedup *dedup=new RDAudioDedup(db_config);
+  RDAudioDedup::Method method;
+  uint64_t saved=0;
+  uint64_t total_saved=0;
+  int linked=0;
+
+  //
+  // Only cuts whose hash is shared with at least one other cut
+  //
+  sql=QString("select `CUT_NAME`,`SHA1_HASH` from `CUTS` where ")+
+    "`SHA1_HASH` in (select `SHA1_HASH` from `CUTS` "+
+    "where (`SHA1_HASH` is not null)&&(`SHA1_HASH`!='') "+
+    "group by `SHA1_HASH` having count(*)>1) "+
+    "order by `SHA1_HASH`,`CUT_NAME`";
+  q=new QSqlQuery(sql);
+  while(q->next()) {
+    method=dedup->dedup(q->value(0).toString(),q->value(1).toString(),
+			&saved);
+    if(method!=RDAudioDedup::None) {
+      linked++;
+      total_saved+=saved;
+      if(db_verbose) {
+	printf("  %s %s\n",q->value(0).toString().toUtf8().constData(),
+	       (method==RDAudioDedup::Reflink)?"reflinked":"hard linked");
+      }
+    }
+  }
+  delete q;
+  delete dedup;
+  printf("  Shared the audio of %d cuts, freeing %lu MB.\n",linked,
+	 (unsigned long)(total_saved/1048576));
 }
 
 
@@ -1130,6 +1220,7 @@ bool MainObject::CopyToAudioStore(const QString &destfile,
   }
   fstat(src_fd,&src_stat);
   mode_t mask=umask(S_IRWXO);
+  RDAudioDedup::unshare(destfile);
   if((dest_fd=open(destfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
 		   S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP))<0) {
     close(src_fd);
@@ -52,6 +52,7 @@ MainObject::MainObject(QObject *parent)
   db_no=false;
   db_relink_audio="";
   db_relink_audio_move=false;
+  db_dedup_audio=false;
 
   db_check_all=true;
   db_check_orphaned_audio=false;
@@ -216,6 +217,14 @@ MainObject::MainObject(QObject *parent)
       db_rehash=cmd->value(i);
       cmd->setProcessed(i,true);
     }
+    if(cmd->key(i)=="--rehash-progress") {
+      db_rehash_progress=cmd->value(i);
+      cmd->setProcessed(i,true);
+    }
+    if(cmd->key(i)=="--dedup-audio") {
+      db_dedup_audio=true;
+      cmd->setProcessed(i,true);
+    }
     if(cmd->key(i)=="--orphaned-audio") {
       db_check_all=false;
       db_check_orphaned_audio=true;
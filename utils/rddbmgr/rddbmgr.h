@@ -25,6 +25,7 @@
 
 #include <rdconfig.h>
 #include <rdfeed.h>
+#include <rdhashengine.h>
 #include <rdstation.h>
 
 #define RDDBMGR_USAGE "[options]\n"
@@ -66,8 +67,9 @@ class MainObject : public QObject
   void CheckLogLineIds(const QString &logname) const;
   void ValidateAudioLengths() const;
   void Rehash(const QString &arg) const;
-  void RehashCart(unsigned cartnum) const;
-  void RehashCut(const QString &cutnum) const;
+  void RehashCart(RDHashEngine *engine,unsigned cartnum) const;
+  bool RehashCut(const QString &cutnum,const QString &hash) const;
+  void DedupAudio() const;
   void SetCutLength(const QString &cutname,int len) const;
   void RemoveCart(unsigned cartnum);
   bool CopyToAudioStore(const QString &destfile,const QString &srcfile) const;
@@ -160,6 +162,8 @@ class MainObject : public QObject
   QString db_orphan_group_name;
   QString db_dump_cuts_dir;
   QString db_rehash;
+  QString db_rehash_progress;
+  bool db_dedup_audio;
   QString db_relink_audio;
   bool db_relink_audio_move;
   QDateTime db_start_datetime;
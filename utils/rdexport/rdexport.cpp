@@ -31,6 +31,7 @@
 #include <rdaudioexport.h>
 #include <rdaudioinfo.h>
 #include <rdcart.h>
+#include <rdcurlpool.h>
 #include <rdescape_string.h>
 #include <rdgroup.h>
 #include <rdschedcode.h>
@@ -319,6 +320,9 @@ void MainObject::userData()
   //
   // Clean Up and Exit
   //
+  Verbose(QString::asprintf("Web API requests: %llu, connections opened: %llu",
+			    (unsigned long long)RDCurlPool::requestsMade(),
+			    (unsigned long long)RDCurlPool::connectionsOpened()));
   exit(0);
 }
 
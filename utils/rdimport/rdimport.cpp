@@ -1417,6 +1417,13 @@ MainObject::Result MainObject::ImportFile(const QString &filename,
   settings->setAutotrimLevel(import_autotrim_level/100);
   conv->setDestinationSettings(settings);
   conv->setUseMetadata(import_update_metadata);
+
+  //
+  // The file is going away afterward anyway, so it can be moved straight
+  // into the audio store if it's already in the right format
+  //
+  conv->setMoveSource(import_delete_source||
+		      (!import_temp_fix_filename.isEmpty()));
   Log(LOG_INFO,QString().
       sprintf(" Importing file \"%s\" [%s] to cart %06u ... ",
 	      RDGetBasePart(filename).toUtf8().constData(),
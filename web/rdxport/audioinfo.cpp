@@ -59,7 +59,8 @@ void Xport::AudioInfo()
   //
   // Open Audio File
   //
-  RDWaveFile *wave=new RDWaveFile(RDCut::pathName(cartnum,cutnum));
+  QScopedPointer<RDWaveFile>
+    wave(new RDWaveFile(RDCut::pathName(cartnum,cutnum)));
   if(!wave->openWave()) {
     XmlExit("No such audio",404,"audioinfo.cpp",LINE_NUMBER);
   }
@@ -109,6 +110,5 @@ void Xport::AudioInfo()
   printf("  <frames>%u</frames>\n",wave->getSampleLength());
   printf("  <length>%u</length>\n",wave->getExtTimeLength());
   printf("</audioInfo>\n");
-  delete wave;
   Exit(0);
 }
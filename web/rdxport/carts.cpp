@@ -129,6 +129,12 @@ void Xport::ListCarts()
   RDCart::Type cart_type=RDCart::All;
   QString type;
   QStringList mlist;
+  unsigned after_cart=0;
+  int max_carts=0;
+  unsigned last_cart=0;
+  QString fields;
+  QStringList selected;
+  QString attrs;
 
   //
   // Verify Post
@@ -137,6 +143,12 @@ void Xport::ListCarts()
   xport_post->getValue("FILTER",&filter);
   xport_post->getValue("INCLUDE_CUTS",&include_cuts);
   xport_post->getValue("TYPE",&type);
+  xport_post->getValue("AFTER_CART",&after_cart);
+  xport_post->getValue("MAX_CARTS",&max_carts);
+  xport_post->getValue("FIELDS",&fields);
+  if(max_carts<0) {
+    XmlExit("Invalid MAX_CARTS",400,"carts.cpp",LINE_NUMBER);
+  }
   if(type.toLower()=="audio") {
     cart_type=RDCart::Audio;
   }
@@ -164,18 +176,41 @@ void Xport::ListCarts()
   if(cart_type!=RDCart::All) {
     where+=QString::asprintf("&&(`TYPE`=%u)",cart_type);
   }
-  sql=RDCart::xmlSql(include_cuts)+where+" order by `CART`.`NUMBER`";
-  q=new RDSqlQuery(sql);
+  if(after_cart>0) {
+    where+=QString::asprintf("&&(`CART`.`NUMBER`>%u)",after_cart);
+  }
+
+  //
+  // Find the end of the page by cart rather than by row, so that a cart
+  // is never split from its cuts
+  //
+  if(max_carts>0) {
+    sql=QString("select `CART`.`NUMBER` from `CART` ")+where+
+      " order by `CART`.`NUMBER` "+QString::asprintf("limit %d",max_carts+1);
+    q=new RDSqlQuery(sql,RDSqlQuery::Replica);
+    if(q->size()>max_carts) {
+      q->seek(max_carts-1);
+      last_cart=q->value(0).toUInt();
+      where+=QString::asprintf("&&(`CART`.`NUMBER`<=%u)",last_cart);
+      attrs=QString::asprintf(" nextAfterCart=\"%u\"",last_cart);
+    }
+    delete q;
+  }
+  selected=SelectedFields(fields);
+  sql=RDCart::xmlSql(include_cuts,selected)+where+
+    " order by `CART`.`NUMBER`";
+  q=new RDSqlQuery(sql,RDSqlQuery::Replica);
 
   //
   // Process Request
   //
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("<cartList>\n");
-  printf("%s\n",RDCart::xml(q,include_cuts,true).toUtf8().constData());
-  printf("</cartList>\n");
+  BeginXmlResponse();
+  WriteResponse("<cartList"+attrs+">\n");
+  while(q->next()) {
+    WriteResponse(RDCart::xmlRow(q,include_cuts,true,NULL,selected));
+  }
+  WriteResponse("</cartList>\n");
+  EndResponse();
   delete q;
   Exit(0);
 }
@@ -223,11 +258,74 @@ void Xport::ListCart()
 
 void Xport::EditCart()
 {
-  QString where="";
   RDCart *cart;
+  int include_cuts=0;
+
+  xport_post->getValue("INCLUDE_CUTS",&include_cuts);
+  cart=EditCartItem("");
+
+  printf("Content-type: application/xml; charset=utf-8\n");
+  printf("Status: 200\n\n");
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  printf("<cartList>\n");
+  printf("%s",(const char *)cart->xml(include_cuts,true).toUtf8());
+  SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
+		   QVariant(cart->number()));
+  delete cart;
+  printf("</cartList>\n");
+
+  Exit(0);
+}
+
+
+void Xport::EditCarts()
+{
+  RDCart *cart;
+  int include_cuts=0;
+  int items;
+  QStringList names=xport_post->names();
+  QList<unsigned> cartnums;
+  QString xml;
+
+  //
+  // Items are numbered from zero by a suffix on each field name
+  // (CART_NUMBER_0, TITLE_0, MACRO0_0 ...), and are applied in one
+  // transaction (see BeginTransaction()).
+  //
+  xport_post->getValue("INCLUDE_CUTS",&include_cuts);
+  for(items=0;names.contains(QString::asprintf("CART_NUMBER_%d",items));
+      items++);
+  BeginTransaction(QStringList()<<"CART"<<"CUTS",items);
+  for(int i=0;i<items;i++) {
+    cart=EditCartItem(QString::asprintf("_%d",i));
+    cartnums.push_back(cart->number());
+    delete cart;
+    ItemApplied();
+  }
+  CommitTransaction();
+
+  printf("Content-type: application/xml; charset=utf-8\n");
+  printf("Status: 200\n\n");
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  printf("<cartList>\n");
+  for(int i=0;i<cartnums.size();i++) {
+    cart=new RDCart(cartnums.at(i));
+    printf("%s",(const char *)cart->xml(include_cuts,true).toUtf8());
+    delete cart;
+    SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
+		     QVariant(cartnums.at(i)));
+  }
+  printf("</cartList>\n");
+
+  Exit(0);
+}
+
+
+RDCart *Xport::EditCartItem(const QString &sfx)
+{
+  QScopedPointer<RDCart> cart;
   RDGroup *group;
   int cart_number;
-  int include_cuts=0;
   QString group_name;
   QString value;
   int number;
@@ -239,34 +337,34 @@ void Xport::EditCart()
   //
   // Verify Post
   //
-  if(!xport_post->getValue("CART_NUMBER",&cart_number)) {
-    XmlExit("Missing CART_NUMBER",400,"carts.cpp",LINE_NUMBER);
+  if(!xport_post->getValue("CART_NUMBER"+sfx,&cart_number)) {
+    XmlExit("Missing CART_NUMBER"+sfx,400,"carts.cpp",LINE_NUMBER);
   }
-  xport_post->getValue("INCLUDE_CUTS",&include_cuts);
 
   //
   // Verify User Perms
   //
   if(!rda->user()->cartAuthorized(cart_number)) {
-    XmlExit("No such cart",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("No such cart",sfx),404,"carts.cpp",LINE_NUMBER);
   }
   if(!rda->user()->modifyCarts()) {
-    XmlExit("Unauthorized",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("Unauthorized",sfx),404,"carts.cpp",LINE_NUMBER);
   }
-  if(xport_post->getValue("GROUP_NAME",&group_name)) {
+  if(xport_post->getValue("GROUP_NAME"+sfx,&group_name)) {
     if(!rda->user()->groupAuthorized(group_name)) {
-      XmlExit("No such group",404,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("No such group",sfx),404,"carts.cpp",LINE_NUMBER);
     }
     group=new RDGroup(group_name);
     if(!group->exists()) {
       delete group;
-      XmlExit("No such group",404,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("No such group",sfx),404,"carts.cpp",LINE_NUMBER);
     }
     if(group->enforceCartRange()) {
       if(((unsigned)cart_number<group->defaultLowCart())||
 	 ((unsigned)cart_number>group->defaultHighCart())) {
 	delete group;
-	XmlExit("Invalid cart number for group",409,"carts.cpp",LINE_NUMBER);
+	XmlExit(ItemError("Invalid cart number for group",sfx),
+		409,"carts.cpp",LINE_NUMBER);
       }
     }
     delete group;
@@ -275,20 +373,19 @@ void Xport::EditCart()
   //
   // Process Request
   //
-  cart=new RDCart(cart_number);
+  cart.reset(new RDCart(cart_number));
   if(!cart->exists()) {
-    delete cart;
-    XmlExit("No such cart",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("No such cart",sfx),404,"carts.cpp",LINE_NUMBER);
   }
-  if(xport_post->getValue("FORCED_LENGTH",&value)) {
+  if(xport_post->getValue("FORCED_LENGTH"+sfx,&value)) {
     number=RDSetTimeLength(value);
     if(cart->type()==RDCart::Macro) {
-      delete cart;
-      XmlExit("Unsupported operation for cart type",400,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("Unsupported operation for cart type",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
     if(!cart->validateLengths(number)) {
-      delete cart;
-      XmlExit("Forced length out of range",400,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("Forced length out of range",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
   }
   switch(cart->type()) {
@@ -297,11 +394,12 @@ void Xport::EditCart()
 
   case RDCart::Macro:
     line=0;
-    while(xport_post->getValue(QString::asprintf("MACRO%d",line++),&value)) {
+    while(xport_post->getValue(QString::asprintf("MACRO%d",line++)+sfx,
+			       &value)) {
       value=value.trimmed();
       if(value.right(1)!="!") {
-	delete cart;
-	XmlExit("Invalid macro data",400,"carts.cpp",LINE_NUMBER);
+	XmlExit(ItemError("Invalid macro data",sfx),
+		400,"carts.cpp",LINE_NUMBER);
       }
       macro+=value;
     }
@@ -314,98 +412,89 @@ void Xport::EditCart()
   if(!group_name.isEmpty()) {
     cart->setGroupName(group_name);
   }
-  if(xport_post->getValue("TITLE",&value)) {
+  if(xport_post->getValue("TITLE"+sfx,&value)) {
     if((!rda->system()->allowDuplicateCartTitles())&&
        (!rda->system()->fixDuplicateCartTitles())&&
        (!RDCart::titleIsUnique(cart_number,value))) {
-      XmlExit("Duplicate Cart Title Not Allowed",404,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("Duplicate Cart Title Not Allowed",sfx),
+	      404,"carts.cpp",LINE_NUMBER);
     }
     cart->setTitle(value);
   }
-  if(xport_post->getValue("ARTIST",&value)) {
+  if(xport_post->getValue("ARTIST"+sfx,&value)) {
     cart->setArtist(value);
   }
-  if(xport_post->getValue("ALBUM",&value)) {
+  if(xport_post->getValue("ALBUM"+sfx,&value)) {
     cart->setAlbum(value);
   }
-  if(xport_post->getValue("YEAR",&value)) {
+  if(xport_post->getValue("YEAR"+sfx,&value)) {
     number=value.toInt(&ok);
     if((ok)&&(number>0)) {
       cart->setYear(number);
     }
   }
-  if(xport_post->getValue("SONG_ID",&value)) {
+  if(xport_post->getValue("SONG_ID"+sfx,&value)) {
     cart->setSongId(value);
   }
-  if(xport_post->getValue("LABEL",&value)) {
+  if(xport_post->getValue("LABEL"+sfx,&value)) {
     cart->setLabel(value);
   }
-  if(xport_post->getValue("CLIENT",&value)) {
+  if(xport_post->getValue("CLIENT"+sfx,&value)) {
     cart->setClient(value);
   }
-  if(xport_post->getValue("AGENCY",&value)) {
+  if(xport_post->getValue("AGENCY"+sfx,&value)) {
     cart->setAgency(value);
   }
-  if(xport_post->getValue("PUBLISHER",&value)) {
+  if(xport_post->getValue("PUBLISHER"+sfx,&value)) {
     cart->setPublisher(value);
   }
-  if(xport_post->getValue("COMPOSER",&value)) {
+  if(xport_post->getValue("COMPOSER"+sfx,&value)) {
     cart->setComposer(value);
   }
-  if(xport_post->getValue("CONDUCTOR",&value)) {
+  if(xport_post->getValue("CONDUCTOR"+sfx,&value)) {
     cart->setConductor(value);
   }
-  if(xport_post->getValue("USER_DEFINED",&value)) {
+  if(xport_post->getValue("USER_DEFINED"+sfx,&value)) {
     cart->setUserDefined(value);
   }
-  if(xport_post->getValue("USAGE_CODE",&value)) {
+  if(xport_post->getValue("USAGE_CODE"+sfx,&value)) {
     number=value.toInt(&ok);
     if((ok)&&(number>0)) {
       cart->setUsageCode((RDCart::UsageCode)number);
     }
   }
-  if(xport_post->getValue("ENFORCE_LENGTH",&value)) {
+  if(xport_post->getValue("ENFORCE_LENGTH"+sfx,&value)) {
     number=value.toInt(&ok);
     if((ok)&&(number>=0)&&(number<2)) {
       cart->setEnforceLength(number);
       length_changed=true;
     }
   }
-  if(xport_post->getValue("FORCED_LENGTH",&value)) {
+  if(xport_post->getValue("FORCED_LENGTH"+sfx,&value)) {
     cart->setForcedLength(RDSetTimeLength(value));
     length_changed=true;
   }
-  if(xport_post->getValue("ASYNCRONOUS",&value)) { 
+  if(xport_post->getValue("ASYNCRONOUS"+sfx,&value)) { 
     number=value.toInt(&ok);
     if((ok)&&(number>=0)&&(number<2)) {
       cart->setAsyncronous(number);
       length_changed=true;
     }
   }
-  if(xport_post->getValue("OWNER",&value)) {
+  if(xport_post->getValue("OWNER"+sfx,&value)) {
     cart->setOwner(value);
   }
-  if(xport_post->getValue("NOTES",&value)) {
+  if(xport_post->getValue("NOTES"+sfx,&value)) {
     cart->setNotes(value);
   }
-  if(xport_post->getValue("SCHED_CODES",&value)) {
+  if(xport_post->getValue("SCHED_CODES"+sfx,&value)) {
     cart->setSchedCodes(value);
   }
   if(length_changed) {
     cart->updateLength();
   }
 
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("<cartList>\n");
-  printf("%s",(const char *)cart->xml(include_cuts,true).toUtf8());
-  SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
-		   QVariant(cart->number()));
-  delete cart;
-  printf("</cartList>\n");
-
-  Exit(0);
+  return cart.take();
 }
 
 
@@ -510,6 +599,12 @@ void Xport::ListCuts()
   int cart_number;
   QString sql;
   RDSqlQuery *q;
+  int after_cut=0;
+  int max_cuts=0;
+  QString fields;
+  QStringList selected;
+  QString attrs;
+  QString last_cut;
 
   //
   // Verify Post
@@ -517,6 +612,12 @@ void Xport::ListCuts()
   if(!xport_post->getValue("CART_NUMBER",&cart_number)) {
     XmlExit("Missing CART_NUMBER",400,"carts.cpp",LINE_NUMBER);
   }
+  xport_post->getValue("AFTER_CUT",&after_cut);
+  xport_post->getValue("MAX_CUTS",&max_cuts);
+  xport_post->getValue("FIELDS",&fields);
+  if(max_cuts<0) {
+    XmlExit("Invalid MAX_CUTS",400,"carts.cpp",LINE_NUMBER);
+  }
 
   //
   // Verify User Perms
@@ -528,17 +629,31 @@ void Xport::ListCuts()
   //
   // Process Request
   //
-  sql=RDCart::xmlSql(true)+
-    QString::asprintf(" where `CART`.`NUMBER`=%u",cart_number);
-  q=new RDSqlQuery(sql);
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("<cutList>\n");
-  while(q->next()) {
-    printf("%s\n",(const char *)RDCut::xml(q,false).toUtf8());
+  selected=SelectedFields(fields);
+  sql=RDCart::xmlSql(true,selected)+
+    QString::asprintf(" where (`CART`.`NUMBER`=%u)",cart_number);
+  if(after_cut>0) {
+    sql+="&&(`CUTS`.`CUT_NAME`>'"+RDCut::cutName(cart_number,after_cut)+"')";
   }
-  printf("</cutList>\n");
+  sql+=" order by `CUTS`.`CUT_NAME`";
+  if(max_cuts>0) {
+    sql+=QString::asprintf(" limit %d",max_cuts+1);
+  }
+  q=new RDSqlQuery(sql);
+  if((max_cuts>0)&&(q->size()>max_cuts)) {
+    q->seek(max_cuts-1);
+    // Field 31 of RDCart::xmlSql() is CUTS.CUT_NAME
+    attrs=QString::asprintf(" nextAfterCut=\"%u\"",
+			    RDCut::cutNumber(q->value(31).toString()));
+    q->seek(-1);
+  }
+  BeginXmlResponse();
+  WriteResponse("<cutList"+attrs+">\n");
+  for(int i=0;q->next()&&((max_cuts==0)||(i<max_cuts));i++) {
+    WriteResponse(RDCut::xml(q,false,NULL,selected));
+  }
+  WriteResponse("</cutList>\n");
+  EndResponse();
   delete q;
 
   Exit(0);
@@ -589,8 +704,72 @@ void Xport::ListCut()
 
 
 void Xport::EditCut()
+{
+  RDCut *cut=EditCutItem("");
+
+  printf("Content-type: application/xml; charset=utf-8\n");
+  printf("Status: 200\n\n");
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  printf("<cutList>\n");
+  printf("%s",(const char *)RDCart::cutXml(cut->cartNumber(),cut->cutNumber(),
+					  true).toUtf8());
+  printf("</cutList>\n");
+  SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
+		   QVariant(cut->cartNumber()));
+  delete cut;
+
+  Exit(0);
+}
+
+
+void Xport::EditCuts()
 {
   RDCut *cut;
+  int items;
+  QStringList names=xport_post->names();
+  QList<unsigned> cartnums;
+  QList<unsigned> cutnums;
+
+  //
+  // Items are numbered from zero by a suffix on each field name
+  // (CART_NUMBER_0, CUT_NUMBER_0, DESCRIPTION_0 ...), and are applied in
+  // one transaction (see BeginTransaction()).
+  //
+  for(items=0;names.contains(QString::asprintf("CART_NUMBER_%d",items));
+      items++);
+  BeginTransaction(QStringList()<<"CUTS"<<"CART",items);
+  for(int i=0;i<items;i++) {
+    cut=EditCutItem(QString::asprintf("_%d",i));
+    cartnums.push_back(cut->cartNumber());
+    cutnums.push_back(cut->cutNumber());
+    delete cut;
+    ItemApplied();
+  }
+  CommitTransaction();
+
+  printf("Content-type: application/xml; charset=utf-8\n");
+  printf("Status: 200\n\n");
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  printf("<cutList>\n");
+  for(int i=0;i<cutnums.size();i++) {
+    printf("%s",(const char *)RDCart::cutXml(cartnums.at(i),cutnums.at(i),
+					    true).toUtf8());
+  }
+  printf("</cutList>\n");
+  for(int i=0;i<cartnums.size();i++) {
+    if(cartnums.indexOf(cartnums.at(i))==i) {
+      SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
+		       QVariant(cartnums.at(i)));
+    }
+  }
+
+  Exit(0);
+}
+
+
+RDCut *Xport::EditCutItem(const QString &sfx)
+{
+  QScopedPointer<RDCut> cut;
   int cart_number;
   int cut_number;
   QString str;
@@ -626,68 +805,67 @@ void Xport::EditCut()
   //
   // Verify Post
   //
-  if(!xport_post->getValue("CART_NUMBER",&cart_number)) {
-    XmlExit("Missing CART_NUMBER",400,"carts.cpp",LINE_NUMBER);
+  if(!xport_post->getValue("CART_NUMBER"+sfx,&cart_number)) {
+    XmlExit("Missing CART_NUMBER"+sfx,400,"carts.cpp",LINE_NUMBER);
   }
-  if(!xport_post->getValue("CUT_NUMBER",&cut_number)) {
-    XmlExit("Missing CUT_NUMBER",400,"carts.cpp",LINE_NUMBER);
+  if(!xport_post->getValue("CUT_NUMBER"+sfx,&cut_number)) {
+    XmlExit("Missing CUT_NUMBER"+sfx,400,"carts.cpp",LINE_NUMBER);
   }
 
   //
   // Verify User Perms
   //
   if(!rda->user()->cartAuthorized(cart_number)) {
-    XmlExit("No such cart",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("No such cart",sfx),404,"carts.cpp",LINE_NUMBER);
   }
   if(!rda->user()->editAudio()) {
-    XmlExit("Forbidden",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("Forbidden",sfx),404,"carts.cpp",LINE_NUMBER);
   }
 
   //
   // Check Date/Time Values for Validity
   //
   if((use_start_datetime=xport_post->
-      getValue("START_DATETIME",&start_datetime,&ok))) {
+      getValue("START_DATETIME"+sfx,&start_datetime,&ok))) {
     if(!ok) {
-      XmlExit("invalid START_DATETIME",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid START_DATETIME"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
   }
   if((use_end_datetime=xport_post->
-      getValue("END_DATETIME",&end_datetime,&ok))) {
+      getValue("END_DATETIME"+sfx,&end_datetime,&ok))) {
     if(!ok) {
-      XmlExit("invalid END_DATETIME",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid END_DATETIME"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
   }
   if(use_start_datetime!=use_end_datetime) {
-    XmlExit("both DATETIME values must be set together",400,"carts.cpp",
-	    LINE_NUMBER);
+    XmlExit(ItemError("both DATETIME values must be set together",sfx),
+	    400,"carts.cpp",LINE_NUMBER);
   }
   if(use_start_datetime&&(start_datetime>end_datetime)) {
-    XmlExit("START_DATETIME is later than END_DATETIME",400,"carts.cpp",
-	    LINE_NUMBER);
+    XmlExit(ItemError("START_DATETIME is later than END_DATETIME",sfx),
+	    400,"carts.cpp",LINE_NUMBER);
   }
 
   if((use_start_daypart=xport_post->
-      getValue("START_DAYPART",&start_daypart,&ok))) {
+      getValue("START_DAYPART"+sfx,&start_daypart,&ok))) {
     if(!ok) {
-      XmlExit("invalid START_DAYPART",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid START_DAYPART"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
   }
   if((use_end_daypart=xport_post->
-      getValue("END_DAYPART",&end_daypart,&ok))) {
+      getValue("END_DAYPART"+sfx,&end_daypart,&ok))) {
     if(!ok) {
-      XmlExit("invalid END_DAYPART",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid END_DAYPART"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
   }
   if(use_start_daypart!=use_end_daypart) {
-    XmlExit("both DAYPART values must be set together",400,"carts.cpp",
-	    LINE_NUMBER);
+    XmlExit(ItemError("both DAYPART values must be set together",sfx),
+	    400,"carts.cpp",LINE_NUMBER);
   }
 
-  cut=new RDCut(cart_number,cut_number);
+  cut.reset(new RDCut(cart_number,cut_number));
   if(!cut->exists()) {
-    delete cut;
-    XmlExit("No such cut",404,"carts.cpp",LINE_NUMBER);
+    XmlExit(ItemError("No such cut",sfx),404,"carts.cpp",LINE_NUMBER);
   }
 
   //
@@ -697,62 +875,65 @@ void Xport::EditCut()
   end_points[1]=cut->endPoint();
   fadeup_point=cut->fadeupPoint();
   fadedown_point=cut->fadedownPoint();
-  CheckPointerValidity(end_points,use_end_points,"",0);
-  CheckPointerValidity(talk_points,use_talk_points,"TALK_",end_points[1]);
-  CheckPointerValidity(segue_points,use_segue_points,"SEGUE_",end_points[1]);
-  CheckPointerValidity(hook_points,use_hook_points,"HOOK_",end_points[1]);
+  CheckPointerValidity(end_points,use_end_points,"",0,sfx);
+  CheckPointerValidity(talk_points,use_talk_points,"TALK_",end_points[1],
+		       sfx);
+  CheckPointerValidity(segue_points,use_segue_points,"SEGUE_",end_points[1],
+		       sfx);
+  CheckPointerValidity(hook_points,use_hook_points,"HOOK_",end_points[1],
+		       sfx);
   if((use_fadeup_point=xport_post->
-      getValue("FADEUP_POINT",&fadeup_point,&ok))) {
+      getValue("FADEUP_POINT"+sfx,&fadeup_point,&ok))) {
     if(!ok) {
-      XmlExit("invalid FADEUP_POINT",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid FADEUP_POINT"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
     if(fadeup_point>end_points[1]) {
-      XmlExit("FADEUP_POINT exceeds length of cart",400,"carts.cpp",
-	      LINE_NUMBER);
+      XmlExit(ItemError("FADEUP_POINT exceeds length of cart",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
   }
   if((use_fadedown_point=xport_post->
-      getValue("FADEDOWN_POINT",&fadedown_point,&ok))) {
+      getValue("FADEDOWN_POINT"+sfx,&fadedown_point,&ok))) {
     if(!ok) {
-      XmlExit("invalid FADEDOWN_POINT",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid FADEDOWN_POINT"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
     if(fadeup_point>end_points[1]) {
-      XmlExit("FADEDOWN_POINT exceeds length of cart",400,"carts.cpp",
-	      LINE_NUMBER);
+      XmlExit(ItemError("FADEDOWN_POINT exceeds length of cart",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
   }
   if(use_fadeup_point&&use_fadedown_point&&
      (fadeup_point>=0)&&(fadedown_point>=0)&&(fadeup_point>fadedown_point)) {
-    XmlExit("FADEUP_POINT is greater than FADEDOWN_POINT",400,"carts.cpp",
-	    LINE_NUMBER);
+    XmlExit(ItemError("FADEUP_POINT is greater than FADEDOWN_POINT",sfx),
+	    400,"carts.cpp",LINE_NUMBER);
   }
 
   //
   // Check Weight
   //
-  if((use_weight=xport_post->getValue("WEIGHT",&weight,&ok))) {
+  if((use_weight=xport_post->getValue("WEIGHT"+sfx,&weight,&ok))) {
     if((!ok)||(weight<0)) {
-      XmlExit("invalid WEIGHT",400,"carts.cpp",LINE_NUMBER);
+      XmlExit("invalid WEIGHT"+sfx,400,"carts.cpp",LINE_NUMBER);
     }
   }
 
   //
   // Process Request
   //
-  if(xport_post->getValue("EVERGREEN",&num)) {
+  if(xport_post->getValue("EVERGREEN"+sfx,&num)) {
     cut->setEvergreen(num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("DESCRIPTION",&str)) {
+  if(xport_post->getValue("DESCRIPTION"+sfx,&str)) {
     cut->setDescription(str);
   }
-  if(xport_post->getValue("OUTCUE",&str)) {
+  if(xport_post->getValue("OUTCUE"+sfx,&str)) {
     cut->setOutcue(str);
   }
-  if(xport_post->getValue("ISRC",&str)) {
+  if(xport_post->getValue("ISRC"+sfx,&str)) {
     cut->setIsrc(str);
   }
-  if(xport_post->getValue("ISCI",&str)) {
+  if(xport_post->getValue("ISCI"+sfx,&str)) {
     cut->setIsci(str);
   }
   if(use_start_datetime) {
@@ -765,31 +946,31 @@ void Xport::EditCut()
     length_changed=true;
     rotation_changed=true;
   }
-  if(xport_post->getValue("MON",&num)) {
+  if(xport_post->getValue("MON"+sfx,&num)) {
     cut->setWeekPart(1,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("TUE",&num)) {
+  if(xport_post->getValue("TUE"+sfx,&num)) {
     cut->setWeekPart(2,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("WED",&num)) {
+  if(xport_post->getValue("WED"+sfx,&num)) {
     cut->setWeekPart(3,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("THU",&num)) {
+  if(xport_post->getValue("THU"+sfx,&num)) {
     cut->setWeekPart(4,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("FRI",&num)) {
+  if(xport_post->getValue("FRI"+sfx,&num)) {
     cut->setWeekPart(5,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("SAT",&num)) {
+  if(xport_post->getValue("SAT"+sfx,&num)) {
     cut->setWeekPart(6,num);
     rotation_changed=true;
   }
-  if(xport_post->getValue("SUN",&num)) {
+  if(xport_post->getValue("SUN"+sfx,&num)) {
     cut->setWeekPart(7,num);
     rotation_changed=true;
   }
@@ -856,61 +1037,55 @@ void Xport::EditCut()
     delete cart;
   }
 
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("<cutList>\n");
-  printf("%s",(const char *)RDCart::cutXml(cart_number,cut_number,true).toUtf8());
-  printf("</cutList>\n");
-  SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
-		   QVariant(cut->cartNumber()));
-  delete cut;
-
-  Exit(0);
+  return cut.take();
 }
 
 
 void Xport::CheckPointerValidity(int ptr_values[2],bool use_ptrs[2],
-                                const QString &type,unsigned max_value)
+				 const QString &type,unsigned max_value,
+				 const QString &sfx)
 {
   bool start_ok=false;
   bool end_ok=false;
 
-  use_ptrs[0]=xport_post->getValue(type+"START_POINT",&ptr_values[0],&start_ok);
-  use_ptrs[1]=xport_post->getValue(type+"END_POINT",&ptr_values[1],&end_ok);
+  use_ptrs[0]=
+    xport_post->getValue(type+"START_POINT"+sfx,&ptr_values[0],&start_ok);
+  use_ptrs[1]=
+    xport_post->getValue(type+"END_POINT"+sfx,&ptr_values[1],&end_ok);
   if((!use_ptrs[0])&&(!use_ptrs[1])) {
     return;
   }
   if(!start_ok) {
-    XmlExit("invalid "+type+"START_POINT",400,"carts.cpp",LINE_NUMBER);
+    XmlExit("invalid "+type+"START_POINT"+sfx,400,"carts.cpp",LINE_NUMBER);
   }
   if(!end_ok) {
-    XmlExit("invalid "+type+"END_POINT",400,"carts.cpp",LINE_NUMBER);
+    XmlExit("invalid "+type+"END_POINT"+sfx,400,"carts.cpp",LINE_NUMBER);
   }
   if(use_ptrs[0]!=use_ptrs[1]) {
-    XmlExit("both "+type+"*_POINT values must be set together",400,"carts.cpp",
-	    LINE_NUMBER);
+    XmlExit(ItemError("both "+type+"*_POINT values must be set together",sfx),
+	    400,"carts.cpp",LINE_NUMBER);
   }
   if(use_ptrs[0]) {
     if(((ptr_values[0]<0)&&(ptr_values[1]>=0))||
        ((ptr_values[0]>=0)&&(ptr_values[1]<0))) {
-      XmlExit("inconsistent "+type+"*_POINT values",400,"carts.cpp",
-	      LINE_NUMBER);
+      XmlExit(ItemError("inconsistent "+type+"*_POINT values",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
   }
   if(ptr_values[0]>=0) {
     if(ptr_values[0]>ptr_values[1]) {
-      XmlExit(type+"START_POINT greater than "+type+"END_POINT",400,
-	      "carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError(type+"START_POINT greater than "+type+"END_POINT",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
     if((max_value>0)&&((unsigned)ptr_values[1]>max_value)) {
-      XmlExit(type+"END_POINT exceeds length of cut",400,"carts.cpp",
-	      LINE_NUMBER);
+      XmlExit(ItemError(type+"END_POINT exceeds length of cut",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
   }
   else {
     if(max_value==0) {
-      XmlExit("End markers cannot be removed",400,"carts.cpp",LINE_NUMBER);
+      XmlExit(ItemError("End markers cannot be removed",sfx),
+	      400,"carts.cpp",LINE_NUMBER);
     }
     else {
       ptr_values[0]=-1;
@@ -920,6 +1095,28 @@ void Xport::CheckPointerValidity(int ptr_values[2],bool use_ptrs[2],
 }
 
 
+QStringList Xport::SelectedFields(const QString &fields) const
+{
+  QStringList ret;
+
+  if(fields.trimmed().isEmpty()) {
+    return ret;  // Everything
+  }
+  ret=fields.split(",",Qt::SkipEmptyParts);
+  for(int i=0;i<ret.size();i++) {
+    ret[i]=ret.at(i).trimmed();
+  }
+
+  //
+  // Always identify each record
+  //
+  ret.push_back("number");
+  ret.push_back("cutName");
+
+  return ret;
+}
+
+
 void Xport::RemoveCut()
 {
   RDCart *cart;
@@ -32,6 +32,7 @@
 #include <rdconf.h>
 #include <rdformpost.h>
 #include <rdsettings.h>
+#include <rdtranscodecache.h>
 #include <rdweb.h>
 
 #include <rdxport.h>
@@ -77,6 +78,9 @@ void Xport::CopyAudio()
 	 RDCut::pathName(destination_cartnum,destination_cutnum).toUtf8())!=0) {
     XmlExit(strerror(errno),400,"copyaudio.cpp",LINE_NUMBER);
   }
+  RDTranscodeCache *cache=new RDTranscodeCache(rda->config());
+  cache->invalidate(destination_cartnum,destination_cutnum);
+  delete cache;
   SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		   QVariant(destination_cartnum));
   XmlExit("OK",200,"copyaudio.cpp",LINE_NUMBER);
@@ -29,6 +29,7 @@
 #include <rdcart.h>
 #include <rdconf.h>
 #include <rdformpost.h>
+#include <rdtranscodecache.h>
 #include <rdweb.h>
 
 #include <rdxport.h>
@@ -58,6 +59,9 @@ void Xport::DeleteAudio()
     delete cut;
     XmlExit("No such cut",404,"deleteaudio.cpp",LINE_NUMBER);
   }
+  //
+  // Cuts sharing this file (see RDAudioDedup) keep their own links to it
+  //
   unlink(RDCut::pathName(cartnum,cutnum).toUtf8());
   unlink((RDCut::pathName(cartnum,cutnum)+".energy").toUtf8());
   QString sql=QString("delete from `CUT_EVENTS` where ")+
@@ -69,6 +73,9 @@ void Xport::DeleteAudio()
   rda->syslog(LOG_DEBUG,"unlink(%s): %s",
 	      (const char *)RDCut::pathName(cartnum,cutnum).toUtf8(),
 	      strerror(errno));
+  RDTranscodeCache *cache=new RDTranscodeCache(rda->config());
+  cache->invalidate(cartnum,cutnum);
+  delete cache;
   delete cut;
   XmlExit("OK",200,"deleteaudio.cpp",LINE_NUMBER);
 }
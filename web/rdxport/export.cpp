@@ -18,20 +18,28 @@
 //   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 //
 
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
+#include <syslog.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <rdapplication.h>
 #include <rdaudioconvert.h>
 #include <rdcart.h>
 #include <rdconf.h>
 #include <rdformpost.h>
+#include <rdlocalxport.h>
 #include <rdsettings.h>
 #include <rdtempdirectory.h>
+#include <rdtranscodecache.h>
 #include <rdweb.h>
+#include <rdxport_interface.h>
 
 #include "rdxport.h"
 
@@ -104,7 +112,11 @@ void Xport::Export()
   //
   // Audio Settings
   //
-  RDSettings *settings=new RDSettings();
+  //
+  // Handler objects are scoped, as Exit() unwinds the stack when serving
+  // more than one request
+  //
+  QScopedPointer<RDSettings> settings(new RDSettings());
   settings->setFormat((RDSettings::Format)format);
   settings->setChannels(channels);
   settings->setSampleRate(sample_rate);
@@ -113,80 +125,193 @@ void Xport::Export()
   settings->setNormalizationLevel(normalization_level);
 
   //
-  // Generate Metadata
+  // Generate Metadata and Converter
   //
   RDWaveData *wavedata=NULL;
   QString rdxl;
   float speed_ratio=1.0;
-  if(enable_metadata!=0) {
-    wavedata=new RDWaveData();
-  }
-  if(wavedata!=NULL) {
-    RDCart *cart=new RDCart(cartnum);
-    RDCut *cut=new RDCut(cartnum,cutnum);
-    cart->getMetadata(wavedata);
-    cut->getMetadata(wavedata);
-    if(cart->enforceLength()) {
-      speed_ratio=(float)cut->length()/(float)cart->forcedLength();
-    }
-    rdxl=cart->xml(true,start_point<0,settings,cutnum);
-    delete cut;
-    delete cart;
-  }
+  QScopedPointer<RDAudioConvert> conv(
+    RDLocalXport::exportConverter(cartnum,cutnum,settings.data(),start_point,
+				  end_point,enable_metadata!=0,&wavedata,
+				  &rdxl,&speed_ratio));
+  QScopedPointer<RDWaveData> wavedata_owner(wavedata);
 
   //
   // Export Cut
   //
-  int fd;
-  ssize_t n;
-  uint8_t data[2048];
-  QString err_msg;
-  RDTempDirectory *tempdir=new RDTempDirectory("rdxport-export");
-  if(!tempdir->create(&err_msg)) {
-    XmlExit("unable to create temporary directory ["+err_msg+"]",500);
-  }
-  QString tmpfile=tempdir->path()+"/exported_audio";
-  RDAudioConvert *conv=new RDAudioConvert();
-  conv->setSourceFile(RDCut::pathName(cartnum,cutnum));
-  conv->setDestinationFile(tmpfile);
-  conv->setDestinationSettings(settings);
-  conv->setDestinationWaveData(wavedata);
-  conv->setDestinationRdxl(rdxl);
-  conv->setRange(start_point,end_point);
-  conv->setSpeedRatio(speed_ratio);
-  switch(conv_err=conv->convert()) {
-  case RDAudioConvert::ErrorOk:
-    switch(settings->format()) {
-    case RDSettings::Pcm16:
-    case RDSettings::Pcm24:
-      printf("Content-type: audio/x-wav\n\n");
-      break;
+  // Encoder output is streamed straight to the client as it is produced.
+  // The headers go out along with the first block of audio, so failures
+  // before that point still get a proper error response.
+  //
+  QString mimetype;
+  switch(settings->format()) {
+  case RDSettings::Pcm16:
+  case RDSettings::Pcm24:
+    mimetype="audio/x-wav";
+    break;
 
-    case RDSettings::MpegL1:
-    case RDSettings::MpegL2:
-    case RDSettings::MpegL2Wav:
-    case RDSettings::MpegL3:
-      printf("Content-type: audio/x-mpeg\n\n");
+  case RDSettings::MpegL1:
+  case RDSettings::MpegL2:
+  case RDSettings::MpegL2Wav:
+  case RDSettings::MpegL3:
+    mimetype="audio/x-mpeg";
+    break;
+
+  case RDSettings::OggVorbis:
+    mimetype="audio/ogg";
+    break;
+
+  case RDSettings::Flac:
+    mimetype="audio/flac";
+    break;
+  }
+  fflush(NULL);
+
+  //
+  // The cache key identifies both the audio and the conversion settings,
+  // so it serves as the entity tag as well
+  //
+  QString etag;
+  QString cache_key;
+  QString cache_file;
+  QString scratch_file;
+  QScopedPointer<RDTranscodeCache> cache(new RDTranscodeCache(rda->config()));
+  cache_key=cache->key(cartnum,cutnum,settings.data(),start_point,end_point,
+		       speed_ratio,rdxl);
+  if(!cache_key.isEmpty()) {
+    etag="\""+cache_key+"\"";
+  }
+  if(EtagMatches(etag)) {
+    printf("Status: 304\n");
+    printf("ETag: %s\n\n",etag.toUtf8().constData());
+    Exit(0);
+  }
+
+  //
+  // Serve from the transcode cache if we can, otherwise keep a copy of
+  // what we send for next time
+  //
+  if(cache->isEnabled()) {
+    if(!(cache_file=cache->lookup(cache_key)).isEmpty()) {
+      if(SendFile(cache_file,mimetype,etag)) {
+	Exit(0);
+      }
+    }
+    if(!cache_key.isEmpty()) {
+      scratch_file=cache->scratchFile(cache_key);
+    }
+  }
+  //
+  // A byte range of streamed PCM is cut straight out of the conversion, as
+  // its length and layout are known beforehand.  Where they aren't, the
+  // whole file is rendered to disk first and the range served from that.
+  // Both go through the same stream writer as a full GET, so all give the
+  // same bytes for the same entity tag.
+  //
+  bool pcm=(settings->format()==RDSettings::Pcm16)||
+    (settings->format()==RDSettings::Pcm24);
+  bool partial=false;
+  off_t size=-1;
+  off_t first=0;
+  off_t last=0;
+  if(pcm&&RangeRequested(etag)&&((size=conv->streamLength())>=0)) {
+    switch(ParseRange(getenv("HTTP_RANGE"),size,&first,&last)) {
+    case Xport::RangeValid:
+      partial=true;
       break;
 
-    case RDSettings::OggVorbis:
-      printf("Content-type: audio/ogg\n\n");
+    case Xport::RangeUnsatisfiable:
+      printf("Status: 416\n");
+      printf("Content-Range: bytes */%lld\n\n",(long long)size);
+      Exit(0);
       break;
 
-    case RDSettings::Flac:
-      printf("Content-type: audio/flac\n\n");
+    case Xport::RangeNone:
       break;
     }
-    fflush(NULL);
-    if((fd=open(tmpfile.toUtf8(),O_RDONLY))>=0) {
-      while((n=read(fd,data,2048))>0) {
-	RDCheckReturnCode("Export() write",write(1,data,n),n);
+  }
+  if(pcm&&RangeRequested(etag)&&(size<0)) {
+    QScopedPointer<RDTempDirectory> tempdir;
+    QString outfile=scratch_file;
+    if(outfile.isEmpty()) {
+      QString err_msg;
+      tempdir.reset(new RDTempDirectory("rdxport-export"));
+      if(!tempdir->create(&err_msg)) {
+	XmlExit("unable to create temporary directory ["+err_msg+"]",500);
       }
+      outfile=tempdir->path()+"/exported_audio";
+    }
+    int fd=open(outfile.toUtf8(),O_WRONLY|O_CREAT|O_TRUNC,
+		S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+    if(fd<0) {
+      XmlExit(QString("unable to create export file [")+strerror(errno)+"]",
+	      500);
     }
+    conv->setDestinationStream(fd);
+    conv_err=conv->convert();
     close(fd);
-    unlink(tmpfile.toUtf8());
-    //    rmdir(tmpdir);
-    delete tempdir;
+    if(conv_err==RDAudioConvert::ErrorOk) {
+      SendFile(outfile,mimetype,etag);
+      if(!scratch_file.isEmpty()) {
+	cache->insert(cache_key,scratch_file);
+      }
+    }
+    unlink(outfile.toUtf8());
+  }
+  else {
+    QByteArray preamble=("Content-type: "+mimetype+"\n").toUtf8();
+    if(pcm) {
+      preamble+="Accept-Ranges: bytes\n";
+    }
+    else {
+      preamble+="Accept-Ranges: none\n";
+    }
+    if(!etag.isEmpty()) {
+      preamble+=("ETag: "+etag+"\n").toUtf8();
+    }
+    if(partial) {
+      //
+      // Only part of the stream goes out, so there is nothing to cache
+      //
+      preamble+="Status: 206\n";
+      preamble+=QString::asprintf("Content-Range: bytes %lld-%lld/%lld\n",
+				  (long long)first,(long long)last,
+				  (long long)size).toUtf8();
+      preamble+=QString::asprintf("Content-Length: %lld\n",
+				  (long long)(last-first+1)).toUtf8();
+      conv->setDestinationByteRange(first,last);
+      scratch_file=QString();
+    }
+    preamble+="\n";
+    conv->setDestinationFile(scratch_file);
+    conv->setDestinationStream(1,preamble);
+    conv_err=conv->convert();
+    if(!scratch_file.isEmpty()) {
+      struct stat st;
+      memset(&st,0,sizeof(st));
+      if((conv_err==RDAudioConvert::ErrorOk)&&
+	 (stat(scratch_file.toUtf8(),&st)==0)&&
+	 ((uint64_t)st.st_size==conv->streamBytesWritten())) {
+	cache->insert(cache_key,scratch_file);
+      }
+      else {
+	unlink(scratch_file.toUtf8());
+      }
+    }
+    if((conv_err!=RDAudioConvert::ErrorOk)&&(conv->streamBytesWritten()>0)) {
+      //
+      // Too late for an HTTP error, so cut the connection off, so that
+      // the client sees a failed transfer rather than a short file
+      //
+      rda->syslog(LOG_WARNING,"export of %06u_%03d failed mid-stream: %s",
+		  cartnum,cutnum,
+		  (const char *)RDAudioConvert::errorText(conv_err).toUtf8());
+      AbortConnection();
+      Exit(0);
+    }
+  }
+  switch(conv_err) {
+  case RDAudioConvert::ErrorOk:
     Exit(0);
     break;
 
@@ -210,12 +335,6 @@ void Xport::Export()
     resp_code=500;
     break;
   }
-  delete conv;
-  delete settings;
-  if(wavedata!=NULL) {
-    delete wavedata;
-  }
-  delete tempdir;
   if(resp_code==200) {
     Exit(200);
   }
@@ -224,3 +343,151 @@ void Xport::Export()
 	    LINE_NUMBER,conv_err);
   }
 }
+
+
+bool Xport::SendFile(const QString &filename,const QString &mimetype,
+		     const QString &etag)
+{
+  int fd=-1;
+  ssize_t n;
+  struct stat st;
+  off_t first=0;
+  off_t last=0;
+  off_t left=0;
+  bool partial=false;
+  uint8_t data[2048];
+
+  if((fd=open(filename.toUtf8(),O_RDONLY))<0) {
+    return false;
+  }
+  memset(&st,0,sizeof(st));
+  if(fstat(fd,&st)!=0) {
+    close(fd);
+    return false;
+  }
+  last=st.st_size-1;
+  if(RangeRequested(etag)) {
+    switch(ParseRange(getenv("HTTP_RANGE"),st.st_size,&first,&last)) {
+    case Xport::RangeValid:
+      partial=true;
+      break;
+
+    case Xport::RangeUnsatisfiable:
+      close(fd);
+      printf("Status: 416\n");
+      printf("Content-Range: bytes */%lld\n\n",(long long)st.st_size);
+      fflush(NULL);
+      return true;
+
+    case Xport::RangeNone:
+      break;
+    }
+  }
+
+  printf("Content-type: %s\n",mimetype.toUtf8().constData());
+  printf("Accept-Ranges: bytes\n");
+  if(!etag.isEmpty()) {
+    printf("ETag: %s\n",etag.toUtf8().constData());
+  }
+  if(partial) {
+    printf("Status: 206\n");
+    printf("Content-Range: bytes %lld-%lld/%lld\n",(long long)first,
+	   (long long)last,(long long)st.st_size);
+  }
+  printf("Content-Length: %lld\n\n",(long long)(last-first+1));
+  fflush(NULL);
+  if(lseek(fd,first,SEEK_SET)!=first) {
+    close(fd);
+    return true;
+  }
+  left=last-first+1;
+  while((left>0)&&((n=read(fd,data,left<2048?left:2048))>0)) {
+    RDCheckReturnCode("SendFile() write",write(1,data,n),n);
+    left-=n;
+  }
+  close(fd);
+
+  return true;
+}
+
+
+bool Xport::EtagMatches(const QString &etag) const
+{
+  const char *match=getenv("HTTP_IF_NONE_MATCH");
+
+  if(etag.isEmpty()||(match==NULL)) {
+    return false;
+  }
+  QStringList f0=QString(match).split(",",Qt::SkipEmptyParts);
+  for(int i=0;i<f0.size();i++) {
+    QString tag=f0.at(i).trimmed();
+    if(tag.startsWith("W/")) {
+      tag=tag.right(tag.length()-2);
+    }
+    if((tag==etag)||(tag=="*")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool Xport::RangeRequested(const QString &etag) const
+{
+  const char *if_range=getenv("HTTP_IF_RANGE");
+
+  if(getenv("HTTP_RANGE")==NULL) {
+    return false;
+  }
+  return (if_range==NULL)||((!etag.isEmpty())&&(etag==QString(if_range)));
+}
+
+
+Xport::RangeResult Xport::ParseRange(const QString &range,off_t size,
+				     off_t *first,off_t *last) const
+{
+  bool ok1=false;
+  bool ok2=false;
+
+  //
+  // Only a single "bytes=" range is supported, anything else gets the
+  // whole entity (as permitted by RFC 7233)
+  //
+  if((!range.trimmed().startsWith("bytes="))||range.contains(",")) {
+    return Xport::RangeNone;
+  }
+  QStringList f0=range.trimmed().right(range.trimmed().length()-6).split("-");
+  if(f0.size()!=2) {
+    return Xport::RangeNone;
+  }
+  if(f0.at(0).trimmed().isEmpty()) {  // Suffix range
+    off_t suffix=f0.at(1).trimmed().toLongLong(&ok2);
+    if((!ok2)||(suffix<0)) {
+      return Xport::RangeNone;
+    }
+    if((suffix==0)||(size==0)) {
+      return Xport::RangeUnsatisfiable;
+    }
+    *first=suffix>size?0:size-suffix;
+    *last=size-1;
+    return Xport::RangeValid;
+  }
+  *first=f0.at(0).trimmed().toLongLong(&ok1);
+  if(f0.at(1).trimmed().isEmpty()) {
+    *last=size-1;
+    ok2=true;
+  }
+  else {
+    *last=f0.at(1).trimmed().toLongLong(&ok2);
+  }
+  if((!ok1)||(!ok2)||(*first<0)||(*last<*first)) {
+    return Xport::RangeNone;
+  }
+  if(*first>=size) {
+    return Xport::RangeUnsatisfiable;
+  }
+  if(*last>=size) {
+    *last=size-1;
+  }
+  return Xport::RangeValid;
+}
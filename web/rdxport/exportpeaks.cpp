@@ -29,7 +29,10 @@
 #include <rdcart.h>
 #include <rdconf.h>
 #include <rdformpost.h>
+#include <rdhash.h>
+#include <rdlocalxport.h>
 #include <rdsettings.h>
+#include <rdtranscodecache.h>
 #include <rdweb.h>
 
 #include "rdxport.h"
@@ -47,6 +50,13 @@ void Xport::ExportPeaks()
   if(!xport_post->getValue("CUT_NUMBER",&cutnum)) {
     XmlExit("Missing CUT_NUMBER",400,"exportpeaks.cpp",LINE_NUMBER);
   }
+  int start_point=-1;
+  xport_post->getValue("START_POINT",&start_point);
+  int end_point=-1;
+  xport_post->getValue("END_POINT",&end_point);
+  if((start_point>=0)&&(end_point>=0)&&(end_point<start_point)) {
+    XmlExit("Invalid range",400,"exportpeaks.cpp",LINE_NUMBER);
+  }
 
   //
   // Verify User Perms
@@ -55,10 +65,26 @@ void Xport::ExportPeaks()
     XmlExit("No such cart",404,"exportpeaks.cpp",LINE_NUMBER);
   }
 
+  //
+  // Check Entity Tag
+  //
+  QString etag;
+  QString tag=RDTranscodeCache::audioTag(cartnum,cutnum);
+  if(!tag.isEmpty()) {
+    tag+=QString::asprintf("|peaks|%d|%d",start_point,end_point);
+    etag="\""+RDSha1HashData(tag.toUtf8())+"\"";
+  }
+  if(EtagMatches(etag)) {
+    printf("Status: 304\n");
+    printf("ETag: %s\n\n",etag.toUtf8().constData());
+    Exit(0);
+  }
+
   //
   // Open Audio File
   //
-  RDWaveFile *wave=new RDWaveFile(RDCut::pathName(cartnum,cutnum));
+  QScopedPointer<RDWaveFile>
+    wave(new RDWaveFile(RDCut::pathName(cartnum,cutnum)));
   if(!wave->openWave()) {
     XmlExit("No such audio",404,"exportpeaks.cpp",LINE_NUMBER);
   }
@@ -66,15 +92,29 @@ void Xport::ExportPeaks()
     XmlExit("No peak data available",400,"exportpeaks.cpp",LINE_NUMBER);
   }
 
+  //
+  // Select Time Range
+  //
+  unsigned first=0;
+  unsigned last=0;
+  RDLocalXport::peakRange(wave.data(),start_point,end_point,&first,&last);
+
   //
   // Send Data
   //
-  printf("Content-type: application/octet-stream\n\n");
+  printf("Content-type: application/octet-stream\n");
+  printf("Accept-Ranges: none\n");
+  if(!etag.isEmpty()) {
+    printf("ETag: %s\n",etag.toUtf8().constData());
+  }
+  printf("Content-Length: %lu\n\n",sizeof(unsigned short)*(last-first));
   fflush(NULL);
-  unsigned short *peaks=new unsigned short[wave->energySize()];
-  wave->readEnergy(peaks,wave->energySize());
+  QScopedArrayPointer<unsigned short> peaks(new unsigned short[last-first+1]);
+  for(unsigned i=first;i<last;i++) {
+    peaks[i-first]=wave->energy(i);
+  }
   RDCheckReturnCode("ExportPeaks() write",
-		    write(1,peaks,sizeof(unsigned short)*wave->energySize()),
-		    sizeof(unsigned short)*wave->energySize());
+		    write(1,peaks.data(),sizeof(unsigned short)*(last-first)),
+		    sizeof(unsigned short)*(last-first));
   Exit(0);
 }
@@ -22,6 +22,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+
+#include <QHostAddress>
 
 #include <rdapplication.h>
 #include <rdaudioconvert.h>
@@ -29,8 +32,7 @@
 #include <rdconf.h>
 #include <rdformpost.h>
 #include <rdgroup.h>
-#include <rdhash.h>
-#include <rdlibrary_conf.h>
+#include <rdlocalxport.h>
 #include <rdsettings.h>
 #include <rdweb.h>
 
@@ -38,8 +40,6 @@
 
 void Xport::Import()
 {
-  unsigned length_deviation=0;
-  unsigned msecs=0;
   int resp_code=0;
   QString remote_host;
   QString err_msg;
@@ -92,11 +92,27 @@ void Xport::Import()
   QString title;
   xport_post->getValue("TITLE",&title);
   QString filename;
-  if(!xport_post->getValue("FILENAME",&filename)) {
-    XmlExit("Missing FILENAME",400,"import.cpp",LINE_NUMBER);
+  bool uploaded=true;
+  if(xport_post->getValue("SOURCE_PATH",&filename)) {
+    //
+    // Callers on this host can name a file for us to read in place
+    //
+    uploaded=false;
+    if((getenv("REMOTE_ADDR")==NULL)||
+       (!QHostAddress(getenv("REMOTE_ADDR")).isLoopback())) {
+      XmlExit("Forbidden",403,"import.cpp",LINE_NUMBER);
+    }
+    if((!filename.startsWith("/"))||(access(filename.toUtf8(),R_OK)!=0)) {
+      XmlExit("Unable to read SOURCE_PATH",403,"import.cpp",LINE_NUMBER);
+    }
   }
-  if(!xport_post->isFile("FILENAME")) {
-    XmlExit("Missing file data",400,"import.cpp",LINE_NUMBER);
+  else {
+    if(!xport_post->getValue("FILENAME",&filename)) {
+      XmlExit("Missing FILENAME",400,"import.cpp",LINE_NUMBER);
+    }
+    if(!xport_post->isFile("FILENAME")) {
+      XmlExit("Missing file data",400,"import.cpp",LINE_NUMBER);
+    }
   }
 
   //
@@ -138,31 +154,31 @@ void Xport::Import()
   //
   // Load Configuration
   //
-  RDCart *cart=NULL;
-  RDCut *cut=NULL;
+  // Scoped, as Exit() unwinds the stack when serving more than one request
+  //
+  QScopedPointer<RDCart> cart;
+  QScopedPointer<RDCut> cut;
   if(cartnum==0) {
-    RDGroup *group=new RDGroup(group_name);
+    QScopedPointer<RDGroup> group(new RDGroup(group_name));
     if(!group->exists()) {
       XmlExit("No such group",404,"import.cpp",LINE_NUMBER);
     }
     if((cartnum=group->nextFreeCart())==0) {
       XmlExit("No available carts for specified group",404,"import.cpp",LINE_NUMBER);
     }
-    cart=new RDCart(cartnum);
+    cart.reset(new RDCart(cartnum));
     if(RDCart::create(group_name,RDCart::Audio,&err_msg,cartnum)==0) {
-      delete cart;
       XmlExit("Unable to create cart ["+err_msg+"]",500,"import.cpp",
 	      LINE_NUMBER);
     }
     SendNotification(RDNotification::CartType,RDNotification::AddAction,
 		     QVariant(cartnum));
     cutnum=1;
-    cut=new RDCut(cartnum,cutnum,true);
-    delete group;
+    cut.reset(new RDCut(cartnum,cutnum,true));
   }
   else {
-    cart=new RDCart(cartnum);
-    cut=new RDCut(cartnum,cutnum);
+    cart.reset(new RDCart(cartnum));
+    cut.reset(new RDCut(cartnum,cutnum));
   }
   if(!RDCart::exists(cartnum)) {
     XmlExit("No such cart",404,"import.cpp",LINE_NUMBER);
@@ -170,25 +186,8 @@ void Xport::Import()
   if(!RDCut::exists(cartnum,cutnum)) {
     XmlExit("No such cut",404,"import.cpp",LINE_NUMBER);
   }
-  RDLibraryConf *conf=new RDLibraryConf(rda->config()->stationName());
-  RDSettings *settings=new RDSettings();
-  switch(conf->defaultFormat()) {
-  case 0:
-    settings->setFormat(RDSettings::Pcm16);
-    break;
-
-  case 1:
-    settings->setFormat(RDSettings::MpegL2Wav);
-    break;
-
-  case 2:
-    settings->setFormat(RDSettings::Pcm24);
-    break;
-  }
-  settings->setChannels(channels);
-  settings->setSampleRate(rda->system()->sampleRate());
-  settings->setBitRate(channels*conf->defaultBitrate());
-  settings->setNormalizationLevel(normalization_level);
+  QScopedPointer<RDSettings>
+    settings(RDLocalXport::importSettings(channels,normalization_level));
   RDWaveData wavedata;
   RDWaveFile *wave=new RDWaveFile(filename);
   if(!wave->openWave(&wavedata)) {
@@ -203,35 +202,12 @@ void Xport::Import()
       XmlExit("Duplicate Cart Title Not Allowed",404,"import.cpp",LINE_NUMBER);
     }
   }
-  RDAudioConvert *conv=new RDAudioConvert();
-  conv->setSourceFile(filename);
-  conv->setDestinationFile(RDCut::pathName(cartnum,cutnum));
-  conv->setDestinationSettings(settings);
-  RDAudioConvert::ErrorCode conv_err=conv->convert();
+  RDAudioConvert::ErrorCode conv_err=
+    RDLocalXport::importAudio(filename,cart.data(),cut.data(),settings.data(),
+			      use_metadata,autotrim_level,rda->user()->name(),
+			      remote_host,uploaded);
   switch(conv_err) {
   case RDAudioConvert::ErrorOk:
-    wave=new RDWaveFile(RDCut::pathName(cartnum,cutnum));
-    if(wave->openWave()) {
-      msecs=wave->getExtTimeLength();
-    }
-    else {
-      delete wave;
-      XmlExit("Unable to access imported file",500,"import.cpp",LINE_NUMBER);
-    }
-    delete wave;
-    cut->checkInRecording(rda->config()->stationName(),rda->user()->name(),
-			  remote_host,settings,msecs);
-    if(use_metadata>0) {
-      cart->setMetadata(conv->sourceWaveData());
-      cut->setMetadata(conv->sourceWaveData());
-    }
-    if(autotrim_level!=0) {
-      cut->autoTrim(RDCut::AudioBoth,100*autotrim_level);
-    }
-    cart->updateLength();
-    cart->resetRotation();
-    cart->calculateAverageLength(&length_deviation);
-    cart->setLengthDeviation(length_deviation);
     resp_code=200;
     break;
 
@@ -256,7 +232,6 @@ void Xport::Import()
     break;
   }
   if(resp_code==200) {
-    cut->setSha1Hash(RDSha1HashFile(RDCut::pathName(cut->cutName())));
     if(!title.isEmpty()) {
       cart->setTitle(title);
     }
@@ -271,9 +246,11 @@ void Xport::Import()
     printf("</RDWebResult>\r\n");
     SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		     QVariant(cartnum));
-    unlink(filename.toUtf8());
-    rmdir(xport_post->tempDir().toUtf8());
-    exit(0);
+    if(uploaded) {
+      unlink(filename.toUtf8());
+      rmdir(xport_post->tempDir().toUtf8());
+    }
+    Exit(0);
   }
   XmlExit(RDAudioConvert::errorText(conv_err),resp_code,"import.cpp",
 	  LINE_NUMBER,conv_err);
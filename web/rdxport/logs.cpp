@@ -121,7 +121,7 @@ void Xport::ListLogs()
   //
   xport_post->getValue("SERVICE_NAME",&service_name);
   if(!service_name.isEmpty()) {
-    GetLogService(service_name);
+    delete GetLogService(service_name);
   }
   xport_post->getValue("LOG_NAME",&log_name);
   xport_post->getValue("TRACKABLE",&trackable);
@@ -186,16 +186,15 @@ void Xport::ListLogs()
   //
   // Process Request
   //
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("<logList>\n");
+  BeginXmlResponse();
+  WriteResponse("<logList>\n");
   while(q->next()) {
     log=new RDLog(q->value(0).toString());
-    printf("%s",(const char *)log->xml().toUtf8());
+    WriteResponse(log->xml());
     delete log;
   }
-  printf("</logList>\n");
+  WriteResponse("</logList>\n");
+  EndResponse();
 
   delete q;
   Exit(0);
@@ -204,7 +203,6 @@ void Xport::ListLogs()
 
 void Xport::ListLog()
 {
-  RDLog *log;
   QString name="";
 
   //
@@ -215,25 +213,27 @@ void Xport::ListLog()
   //
   // Verify that log exists
   //
-  log=new RDLog(name);
+  QScopedPointer<RDLog> log(new RDLog(name));
   if((!ServiceUserValid(log->service()))||(!log->exists())) {
-    delete log;
     XmlExit("No such log",404,"logs.cpp",LINE_NUMBER);
   }
 
   //
   // Generate Log Listing
   //
-  RDLogModel *log_model=log->createLogEvent();
+  QScopedPointer<RDLogModel> log_model(log->createLogEvent());
   log_model->load(true);
 
   //
   // Process Request
   //
-  printf("Content-type: application/xml; charset=utf-8\n");
-  printf("Status: 200\n\n");
-  printf("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
-  printf("%s\n",log_model->xml().toUtf8().constData());
+  BeginXmlResponse();
+  WriteResponse("<logList>\n");
+  for(int i=0;i<log_model->lineCount();i++) {
+    WriteResponse(log_model->logLine(i)->xml(i));
+  }
+  WriteResponse("</logList>\n");
+  EndResponse();
 
   Exit(0);
 }
@@ -268,7 +268,7 @@ void Xport::SaveLog()
   if(!xport_post->getValue("SERVICE_NAME",&service_name)) {
     XmlExit("Missing SERVICE_NAME",400,"logs.cpp",LINE_NUMBER);
   }
-  GetLogService(service_name);
+  delete GetLogService(service_name);
   xport_post->getValue("LOCK_GUID",&lock_guid);
   if(!xport_post->getValue("DESCRIPTION",&description)) {
     XmlExit("Missing DESCRIPTION",400,"logs.cpp",LINE_NUMBER);
@@ -292,7 +292,7 @@ void Xport::SaveLog()
   //
   // Logline Data
   //
-  RDLogModel *logmodel=new RDLogModel(log_name,false,this);
+  QScopedPointer<RDLogModel> logmodel(new RDLogModel(log_name,false));
   for(int i=0;i<line_quantity;i++) {
     logmodel->insert(i,1);
     RDLogLine *ll=logmodel->logLine(i);
@@ -498,7 +498,7 @@ void Xport::SaveLog()
     ll->setExtAnncType(str);
   }
 
-  RDLog *log=new RDLog(log_name);
+  QScopedPointer<RDLog> log(new RDLog(log_name));
   if(!log->exists()) {
     if(!RDLog::create(log_name,service_name,QDate(),rda->user()->name(),
 		      &err_msg,rda->config())) {
@@ -553,7 +553,6 @@ void Xport::SaveLog()
 
 void Xport::LockLog()
 {
-  RDLog *log;
   QString log_name="";
   Xport::LockLogOperation op_type=Xport::LockLogClear;
   QString op_string;
@@ -594,9 +593,8 @@ void Xport::LockLog()
   //
   // Verify that log exists
   //
-  log=new RDLog(log_name);
+  QScopedPointer<RDLog> log(new RDLog(log_name));
   if((!ServiceUserValid(log->service()))||(!log->exists())) {
-    delete log;
     XmlExit("No such log",404,"logs.cpp",LINE_NUMBER);
   }
 
@@ -644,17 +642,16 @@ RDSvc *Xport::GetLogService(const QString &svc_name)
     "from `USER_SERVICE_PERMS` where "+
     "(`USER_NAME`='"+RDEscapeString(rda->user()->name())+"')&&"+
     "(`SERVICE_NAME`='"+RDEscapeString(svc_name)+"')";
-  RDSqlQuery *q=new RDSqlQuery(sql);
+  QScopedPointer<RDSqlQuery> q(new RDSqlQuery(sql));
   if(!q->first()) {
     XmlExit("No such service",404,"logs.cpp",LINE_NUMBER);
   }
-  delete q;
-  RDSvc *svc=new RDSvc(svc_name,rda->station(),rda->config());
+  QScopedPointer<RDSvc> svc(new RDSvc(svc_name,rda->station(),rda->config()));
   if(!svc->exists()) {
     XmlExit("No such service",404,"logs.cpp",LINE_NUMBER);
   }
 
-  return svc;
+  return svc.take();
 }
 
 
@@ -94,8 +94,8 @@ void Xport::SavePodcast()  // Save posted audio to the Rivendell audio store
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDPodcast *cast=NULL;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDPodcast> cast;
+  QScopedPointer<RDFeed> feed;
   QString filename;
   QString msg="OK";
 
@@ -110,32 +110,26 @@ void Xport::SavePodcast()  // Save posted audio to the Rivendell audio store
     XmlExit("Missing file data",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  cast=new RDPodcast(rda->config(),cast_id);
+  cast.reset(new RDPodcast(rda->config(),cast_id));
   if(!cast->exists()) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=cast->keyName();
   if(((!rda->user()->addPodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(keyname,rda->config(),this);
+  feed.reset(new RDFeed(keyname,rda->config(),this));
   destpath=QString(RD_AUDIO_ROOT)+"/"+cast->audioFilename();
 
   if(!RDCopy(filename,destpath)) {
-    delete feed;
-    delete cast;
     XmlExit("Internal server error [copy failed]",500,"podcasts.cpp",
 	    LINE_NUMBER);
   }
   if(chmod(destpath.toUtf8(),S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP)!=0) {
     err_msg=QString::asprintf("Internal server error [%s]",strerror(errno));
     unlink(destpath.toUtf8());
-    delete feed;
-    delete cast;
     XmlExit(err_msg.toUtf8(),500,"podcasts.cpp",LINE_NUMBER);
   }
   cast->setSha1Hash(RDSha1HashFile(destpath));
@@ -146,9 +140,6 @@ void Xport::SavePodcast()  // Save posted audio to the Rivendell audio store
 
   rda->syslog(LOG_DEBUG,"saved podcast \"%s\"",destpath.toUtf8().constData());
 
-  delete feed;
-  delete cast;
-
   Exit(0);
 }
 
@@ -159,7 +150,7 @@ void Xport::GetPodcast()  // Get posted podcast audio from the audio store
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDPodcast *cast=NULL;
+  QScopedPointer<RDPodcast> cast;
   QString msg="OK";
   int fd=-1;
   struct stat st;
@@ -170,29 +161,25 @@ void Xport::GetPodcast()  // Get posted podcast audio from the audio store
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  cast=new RDPodcast(rda->config(),cast_id);
+  cast.reset(new RDPodcast(rda->config(),cast_id));
   if(!cast->exists()) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=cast->keyName();
   if(((!rda->user()->addPodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   destpath=QString(RD_AUDIO_ROOT)+"/"+cast->audioFilename();
 
   if((fd=open(destpath.toUtf8(),O_RDONLY))<0) {
     err_msg=QString::asprintf("Internal server error [%s]",strerror(errno));
-    delete cast;
     XmlExit(err_msg.toUtf8(),500,"podcasts.cpp",LINE_NUMBER);
   }
   memset(&st,0,sizeof(st));
   if(fstat(fd,&st)!=0) {
     err_msg=QString::asprintf("Internal server error [%s]",strerror(errno));
-    delete cast;
     XmlExit(err_msg.toUtf8(),500,"podcasts.cpp",LINE_NUMBER);
   }
 
@@ -206,13 +193,11 @@ void Xport::GetPodcast()  // Get posted podcast audio from the audio store
     n=write(1,data,n);
     n=read(fd,data,st.st_blksize);
   }
-  delete data;
+  delete[] data;
   close(fd);
 
   rda->syslog(LOG_DEBUG,"served podcast \"%s\"",destpath.toUtf8().constData());
 
-  delete cast;
-
   Exit(0);
 }
 
@@ -223,23 +208,21 @@ void Xport::DeletePodcast() // Deleted posted podcast audio from the audio store
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDPodcast *cast=NULL;
+  QScopedPointer<RDPodcast> cast;
   QString msg="OK";
 
   if(!xport_post->getValue("ID",&cast_id)) {
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  cast=new RDPodcast(rda->config(),cast_id);
+  cast.reset(new RDPodcast(rda->config(),cast_id));
   if(!cast->exists()) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=cast->keyName();
   if(((!rda->user()->deletePodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   destpath=QString(RD_AUDIO_ROOT)+"/"+cast->audioFilename();
@@ -247,7 +230,6 @@ void Xport::DeletePodcast() // Deleted posted podcast audio from the audio store
   if(unlink(destpath.toUtf8())!=0) {
     if(errno!=ENOENT) {
       err_msg=QString::asprintf("Internal server error [%s]",strerror(errno));
-      delete cast;
       XmlExit(err_msg.toUtf8(),500,"podcasts.cpp",LINE_NUMBER);
     }
   }
@@ -259,8 +241,6 @@ void Xport::DeletePodcast() // Deleted posted podcast audio from the audio store
 
   rda->syslog(LOG_DEBUG,"deleted podcast \"%s\"",destpath.toUtf8().constData());
 
-  delete cast;
-
   Exit(0);
 }
 
@@ -272,8 +252,8 @@ void Xport::PostPodcast()  // Upload podcast audio from the audio store to
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDPodcast *cast=NULL;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDPodcast> cast;
+  QScopedPointer<RDFeed> feed;
   QString msg="OK";
   RDUpload::ErrorCode upload_err;
 
@@ -281,22 +261,20 @@ void Xport::PostPodcast()  // Upload podcast audio from the audio store to
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  cast=new RDPodcast(rda->config(),cast_id);
+  cast.reset(new RDPodcast(rda->config(),cast_id));
   if(!cast->exists()) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=cast->keyName();
   if(((!rda->user()->addPodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   destpath=QString(RD_AUDIO_ROOT)+"/"+cast->audioFilename();
-  feed=new RDFeed(keyname,rda->config(),this);
+  feed.reset(new RDFeed(keyname,rda->config(),this));
 
-  RDUpload *upload=new RDUpload(rda->config(),this);
+  QScopedPointer<RDUpload> upload(new RDUpload(rda->config(),this));
   upload->setSourceFile(destpath);
   QString desturl=feed->purgeUrl()+"/"+cast->audioFilename();
   upload->setDestinationUrl(desturl);
@@ -305,12 +283,8 @@ void Xport::PostPodcast()  // Upload podcast audio from the audio store to
 		rda->station()->sshIdentityFile(),feed->purgeUseIdFile(),
 		&err_msg,rda->config()->logXloadDebugData()))!=
      RDUpload::ErrorOk) {
-    delete upload;
-    delete feed;
-    delete cast;
     XmlExit(err_msg,500,"podcasts.cpp",LINE_NUMBER);
   }
-  delete upload;
 
   printf("Content-type: text/html; charset: UTF-8\n");
   printf("Status: 200\n\n");
@@ -319,9 +293,6 @@ void Xport::PostPodcast()  // Upload podcast audio from the audio store to
   rda->syslog(LOG_DEBUG,
 	      "posted podcast audio \"%s\"",destpath.toUtf8().constData());
 
-  delete feed;
-  delete cast;
-
   Exit(0);
 }
 
@@ -332,8 +303,8 @@ void Xport::RemovePodcast()  // Delete podcast audio from the remote archive
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDPodcast *cast=NULL;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDPodcast> cast;
+  QScopedPointer<RDFeed> feed;
   QString msg="OK";
   RDDelete::ErrorCode del_err;
 
@@ -341,34 +312,28 @@ void Xport::RemovePodcast()  // Delete podcast audio from the remote archive
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  cast=new RDPodcast(rda->config(),cast_id);
+  cast.reset(new RDPodcast(rda->config(),cast_id));
   if(!cast->exists()) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=cast->keyName();
   if(((!rda->user()->deletePodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete cast;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
   destpath=QString(RD_AUDIO_ROOT)+"/"+cast->audioFilename();
-  feed=new RDFeed(keyname,rda->config(),this);
+  feed.reset(new RDFeed(keyname,rda->config(),this));
 
-  RDDelete *del=new RDDelete(rda->config(),this);
+  QScopedPointer<RDDelete> del(new RDDelete(rda->config(),this));
   QString desturl=feed->purgeUrl()+"/"+cast->audioFilename();
   del->setTargetUrl(desturl);
   if((del_err=del->
       runDelete(feed->purgeUsername(),feed->purgePassword(),
 		rda->station()->sshIdentityFile(),feed->purgeUseIdFile(),
 		rda->config()->logXloadDebugData()))!=RDDelete::ErrorOk) {
-    delete del;
-    delete feed;
-    delete cast;
     XmlExit(RDDelete::errorText(del_err),500,"podcasts.cpp",LINE_NUMBER);
   }
-  delete del;
 
   printf("Content-type: text/html; charset: UTF-8\n");
   printf("Status: 200\n\n");
@@ -377,9 +342,6 @@ void Xport::RemovePodcast()  // Delete podcast audio from the remote archive
   rda->syslog(LOG_DEBUG,
 	      "delete podcast audio \"%s\"",destpath.toUtf8().constData());
 
-  delete feed;
-  delete cast;
-
   Exit(0);
 }
 
@@ -393,7 +355,7 @@ void Xport::DownloadRss()  // Download feed XML from the remote archive
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDFeed> feed;
   QString msg="OK";
 
   QDateTime now=QDateTime::currentDateTime();
@@ -401,7 +363,7 @@ void Xport::DownloadRss()  // Download feed XML from the remote archive
   if(!xport_post->getValue("ID",&feed_id)) {
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(feed_id,rda->config(),this);
+  feed.reset(new RDFeed(feed_id,rda->config(),this));
   if(!feed->exists()) {
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
@@ -410,7 +372,6 @@ void Xport::DownloadRss()  // Download feed XML from the remote archive
   if(((!rda->user()->editPodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete feed;
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
 
@@ -617,7 +578,7 @@ void Xport::PostRss()  // Post feed XML to the remote archive
   QString keyname;
   QString destpath;
   QString err_msg;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDFeed> feed;
   QString msg="OK";
   bool ret=false;
 
@@ -626,7 +587,7 @@ void Xport::PostRss()  // Post feed XML to the remote archive
   if(!xport_post->getValue("ID",&feed_id)) {
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(feed_id,rda->config(),this);
+  feed.reset(new RDFeed(feed_id,rda->config(),this));
   if(!feed->exists()) {
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
@@ -635,12 +596,10 @@ void Xport::PostRss()  // Post feed XML to the remote archive
   if(((!rda->user()->editPodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-    delete feed;
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
 
-  ret=PostRssElemental(feed,now,&err_msg);
-  delete feed;
+  ret=PostRssElemental(feed.data(),now,&err_msg);
 
   //
   // Update Enclosing Superfeeds
@@ -648,11 +607,11 @@ void Xport::PostRss()  // Post feed XML to the remote archive
   QStringList superfeeds=feed->isSubfeedOf();
   for(int i=0;i<superfeeds.size();i++) {
     QString err_msg2;
-    RDFeed *feed=new RDFeed(superfeeds.at(i),rda->config(),this);
-    if(!PostRssElemental(feed,now,&err_msg)) {
+    RDFeed *superfeed=new RDFeed(superfeeds.at(i),rda->config(),this);
+    if(!PostRssElemental(superfeed,now,&err_msg)) {
       err_msg+="\nRepost of XML failed";
     }
-    delete feed;
+    delete superfeed;
   }
 
   if(!ret) {
@@ -670,7 +629,7 @@ void Xport::PostRss()  // Post feed XML to the remote archive
 void Xport::RemoveRss()  // Delete feed XML from the remote archive
 {
   int feed_id=0;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDFeed> feed;
   QString keyname;
   QString destpath;
   QString err_msg;
@@ -682,7 +641,7 @@ void Xport::RemoveRss()  // Delete feed XML from the remote archive
     XmlExit("Missing ID",400,"podcasts.cpp",LINE_NUMBER);
   }
 
-  feed=new RDFeed(feed_id,rda->config(),this);
+  feed.reset(new RDFeed(feed_id,rda->config(),this));
   if(!feed->exists()) {
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
@@ -690,23 +649,18 @@ void Xport::RemoveRss()  // Delete feed XML from the remote archive
   if(((!rda->user()->deletePodcast())||
       (!rda->user()->feedAuthorized(keyname)))&&
      (!rda->user()->adminConfig())) {
-
-    delete feed;
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
 
-  RDDelete *del=new RDDelete(rda->config(),this);
+  QScopedPointer<RDDelete> del(new RDDelete(rda->config(),this));
   QString desturl=feed->feedUrl();
   del->setTargetUrl(desturl);
   if((del_err=del->
       runDelete(feed->purgeUsername(),feed->purgePassword(),
 		rda->station()->sshIdentityFile(),feed->purgeUseIdFile(),
 		rda->config()->logXloadDebugData()))!=RDDelete::ErrorOk) {
-    delete del;
-    delete feed;
     XmlExit(RDDelete::errorText(del_err),500,"podcasts.cpp",LINE_NUMBER);
   }
-  delete del;
 
   printf("Content-type: text/html; charset: UTF-8\n");
   printf("Status: 200\n\n");
@@ -715,8 +669,6 @@ void Xport::RemoveRss()  // Delete feed XML from the remote archive
   rda->syslog(LOG_DEBUG,
 	      "deleted podcast RSS \"%s\"",destpath.toUtf8().constData());
 
-  delete feed;
-
   Exit(0);
 }
 
@@ -728,11 +680,11 @@ void Xport::PostImage()  // Upload podcast image to the remote archive
   QString desturl;
   QString err_msg;
   unsigned feed_id=0;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDFeed> feed;
   QString file_ext;
   bool ret=false;
   QString sql;
-  RDSqlQuery *q=NULL;
+  QScopedPointer<RDSqlQuery> q;
   CURL *curl=NULL;
   CURLcode curl_err;
   char errstr[CURL_ERROR_SIZE];
@@ -747,25 +699,23 @@ void Xport::PostImage()  // Upload podcast image to the remote archive
     "`FILE_EXTENSION` "+  // 02
     "from FEED_IMAGES where "+
     QString::asprintf("ID=%d",img_id);
-  q=new RDSqlQuery(sql);
+  q.reset(new RDSqlQuery(sql));
   if(q->first()) {
     feed_id=q->value(0).toUInt();
     xport_curl_upload_data=q->value(1).toByteArray();
     xport_curl_upload_data_ptr=0;
     file_ext=q->value(2).toString();
   }
-  delete q;
   if(feed_id==0) {
     XmlExit("invalid image ID",400,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(feed_id,rda->config(),this);
+  feed.reset(new RDFeed(feed_id,rda->config(),this));
   if(!feed->exists()) {
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=feed->keyName();
 
   if(!rda->user()->adminConfig()) {
-    delete feed;
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
   desturl=feed->purgeUrl()+"/"+RDFeed::imageFilename(feed_id,img_id,file_ext);
@@ -853,11 +803,11 @@ void Xport::RemoveImage()  // Remove podcast image from the remote archive
   int img_id=0;
   QString keyname;
   unsigned feed_id=0;
-  RDFeed *feed=NULL;
+  QScopedPointer<RDFeed> feed;
   QString desturl;
   QString file_ext;
   QString sql;
-  RDSqlQuery *q=NULL;
+  QScopedPointer<RDSqlQuery> q;
   QDateTime now=QDateTime::currentDateTime();
   RDDelete::ErrorCode del_err;
 
@@ -869,38 +819,33 @@ void Xport::RemoveImage()  // Remove podcast image from the remote archive
     "`FILE_EXTENSION` "+  // 01
     "from `FEED_IMAGES` where "+
     QString::asprintf("`ID`=%d",img_id);
-  q=new RDSqlQuery(sql);
+  q.reset(new RDSqlQuery(sql));
   if(q->first()) {
     feed_id=q->value(0).toUInt();
     file_ext=q->value(1).toString();
   }
-  delete q;
   if(feed_id==0) {
     XmlExit("invalid image ID",400,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(feed_id,rda->config(),this);
+  feed.reset(new RDFeed(feed_id,rda->config(),this));
   if(!feed->exists()) {
     XmlExit("No such feed",404,"podcasts.cpp",LINE_NUMBER);
   }
   keyname=feed->keyName();
   if(!rda->user()->adminConfig()) {
-    delete feed;
     XmlExit("No such podcast",404,"podcasts.cpp",LINE_NUMBER);
   }
-  feed=new RDFeed(keyname,rda->config(),this);
+  feed.reset(new RDFeed(keyname,rda->config(),this));
   desturl=feed->purgeUrl()+"/"+RDFeed::imageFilename(feed_id,img_id,file_ext);
 
-  RDDelete *del=new RDDelete(rda->config(),this);
+  QScopedPointer<RDDelete> del(new RDDelete(rda->config(),this));
   del->setTargetUrl(desturl);
   if((del_err=del->
       runDelete(feed->purgeUsername(),feed->purgePassword(),
 		rda->station()->sshIdentityFile(),feed->purgeUseIdFile(),
 		rda->config()->logXloadDebugData()))!=RDDelete::ErrorOk) {
-    delete del;
-    delete feed;
     XmlExit(RDDelete::errorText(del_err),500,"podcasts.cpp",LINE_NUMBER);
   }
-  delete del;
 
   printf("Content-type: text/html; charset: UTF-8\n");
   printf("Status: 200\n\n");
@@ -909,8 +854,6 @@ void Xport::RemoveImage()  // Remove podcast image from the remote archive
   rda->syslog(LOG_DEBUG,
 	      "deleted image \"%s\"",desturl.toUtf8().constData());
 
-  delete feed;
-
   Exit(0);
 }
 
@@ -22,7 +22,9 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
+#include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -41,11 +43,22 @@
 
 #include "rdxport.h"
 
-Xport::Xport(QObject *parent)
+Xport::Xport(int listen_sock,QObject *parent)
   :QObject(parent)
 {
   QString err_msg;
 
+  xport_post=NULL;
+  xport_listen_sock=listen_sock;
+  xport_listen_notifier=NULL;
+  xport_null_fd=-1;
+  xport_served=0;
+  xport_in_request=false;
+  xport_transaction=NULL;
+  xport_items_applied=-1;
+  xport_response_gzip=false;
+  xport_response_pending=0;
+
   //
   // Open the Database
   //
@@ -63,6 +76,9 @@ Xport::Xport(QObject *parent)
   // Read Command Options
   //
   for(unsigned i=0;i<rda->cmdSwitch()->keys();i++) {
+    if(rda->cmdSwitch()->key(i)=="--service") {
+      rda->cmdSwitch()->setProcessed(i,true);
+    }
     if(!rda->cmdSwitch()->processed(i)) {
       printf("Content-type: text/html\n");
       printf("Status: 500\n");
@@ -87,9 +103,46 @@ Xport::Xport(QObject *parent)
 	    LINE_NUMBER);
   }
 
+  //
+  // In service mode, requests are read once ripcd(8) is connected
+  //
+  if(xport_listen_sock<0) {
+    ReadRequest();
+  }
+
+  //
+  // Connect to ripcd(8)
+  //
+  connect(rda->ripc(),SIGNAL(connected(bool)),
+	  this,SLOT(ripcConnectedData(bool)));
+  rda->ripc()->
+    connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
+}
+
+
+void Xport::ripcConnectedData(bool state)
+{
+  if(!state) {
+    XmlExit("unable to connect to ripc service",500,"rdxport.cpp",LINE_NUMBER);
+    Exit(0);
+  }
+  if(xport_listen_sock>=0) {
+    disconnect(rda->ripc(),SIGNAL(connected(bool)),
+	       this,SLOT(ripcConnectedData(bool)));
+    ServeRequests();
+    return;
+  }
+  Dispatch();
+}
+
+
+void Xport::ReadRequest()
+{
   //
   // Determine Connection Type
   //
+  xport_remote_address.clear();
+  xport_remote_hostname="";
   if(getenv("REQUEST_METHOD")==NULL) {
     printf("Content-type: text/html\n\n");
     printf("rdxport: missing REQUEST_METHOD\n");
@@ -130,24 +183,11 @@ Xport::Xport(QObject *parent)
   if(!Authenticate()) {
     XmlExit("Invalid User",403,"rdxport.cpp",LINE_NUMBER);
   }
-
-  //
-  // Connect to ripcd(8)
-  //
-  connect(rda->ripc(),SIGNAL(connected(bool)),
-	  this,SLOT(ripcConnectedData(bool)));
-  rda->ripc()->
-    connectHost("localhost",RIPCD_TCP_PORT,rda->config()->password());
 }
 
 
-void Xport::ripcConnectedData(bool state)
+void Xport::Dispatch()
 {
-  if(!state) {
-    XmlExit("unable to connect to ripc service",500,"rdxport.cpp",LINE_NUMBER);
-    Exit(0);
-  }
-
   //
   // Read Command Variable and Dispatch 
   //
@@ -379,6 +419,21 @@ void Xport::ripcConnectedData(bool state)
     RemoveImage();
     break;
 
+  case RDXPORT_COMMAND_EDITCARTS:
+    rda->syslog(LOG_DEBUG,"processing RDXPORT_COMMAND_EDITCARTS");
+    EditCarts();
+    break;
+
+  case RDXPORT_COMMAND_EDITCUTS:
+    rda->syslog(LOG_DEBUG,"processing RDXPORT_COMMAND_EDITCUTS");
+    EditCuts();
+    break;
+
+  case RDXPORT_COMMAND_ASSIGNSCHEDCODES:
+    rda->syslog(LOG_DEBUG,"processing RDXPORT_COMMAND_ASSIGNSCHEDCODES");
+    AssignSchedCodes();
+    break;
+
   default:
     printf("Content-type: text/html\n\n");
     printf("rdxport: missing/invalid command\n");
@@ -421,7 +476,7 @@ void Xport::TryCreateTicket(const QString &name)
 	printf("  %s\n",
 	       RDXmlField("expires",expire_datetime).toUtf8().constData());
 	printf("</ticketInfo>\n");
-	exit(0);
+	Exit(0);
       }
       else {
 	XmlExit("Ticket creation failed",500,"rdxport.cpp",LINE_NUMBER);
@@ -441,20 +496,232 @@ void Xport::SendNotification(RDNotification::Type type,
 }
 
 
+void Xport::BeginXmlResponse()
+{
+  //
+  // Start a response whose body is sent piecemeal by WriteResponse(), so
+  // that a large listing is never held in memory as one string.
+  //
+  // The query behind it is another matter: the Qt MySQL driver reads the
+  // whole result set into the client with mysql_store_result() whether
+  // or not the query is forward-only, so that still grows with the size
+  // of the list.  Callers bound it by paging (MAX_CARTS, MAX_CUTS).
+  //
+  printf("Content-type: application/xml; charset=utf-8\n");
+  if(AcceptsGzip()) {
+    memset(&xport_response_zstream,0,sizeof(xport_response_zstream));
+    if(deflateInit2(&xport_response_zstream,Z_DEFAULT_COMPRESSION,Z_DEFLATED,
+		    15+16,8,Z_DEFAULT_STRATEGY)==Z_OK) {
+      xport_response_gzip=true;
+      printf("Content-Encoding: gzip\n");
+    }
+  }
+  printf("Vary: Accept-Encoding\n");
+  printf("Status: 200\n\n");
+  xport_response_pending=0;
+  WriteResponse("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+}
+
+
+void Xport::WriteResponse(const QString &str)
+{
+  QByteArray data=str.toUtf8();
+
+  if(xport_response_gzip) {
+    DeflateResponse(data.constData(),data.size(),Z_NO_FLUSH);
+  }
+  else {
+    fwrite(data.constData(),1,data.size(),stdout);
+  }
+  if((xport_response_pending+=data.size())>=RDXPORT_RESPONSE_FLUSH_SIZE) {
+    if(xport_response_gzip) {
+      DeflateResponse(NULL,0,Z_SYNC_FLUSH);
+    }
+    fflush(stdout);
+    xport_response_pending=0;
+  }
+}
+
+
+void Xport::EndResponse()
+{
+  if(xport_response_gzip) {
+    DeflateResponse(NULL,0,Z_FINISH);
+    deflateEnd(&xport_response_zstream);
+    xport_response_gzip=false;
+  }
+  fflush(stdout);
+  xport_response_pending=0;
+}
+
+
+bool Xport::AcceptsGzip() const
+{
+  QStringList f0;
+  QStringList f1;
+  bool ok=false;
+
+  if(getenv("HTTP_ACCEPT_ENCODING")==NULL) {
+    return false;
+  }
+  f0=QString(getenv("HTTP_ACCEPT_ENCODING")).split(",");
+  for(int i=0;i<f0.size();i++) {
+    f1=f0.at(i).split(";");
+    if(f1.at(0).trimmed().toLower()=="gzip") {
+      for(int j=1;j<f1.size();j++) {
+	QString param=f1.at(j).trimmed().toLower();
+	if(param.startsWith("q=")&&(param.mid(2).toDouble(&ok)==0.0)&&ok) {
+	  return false;
+	}
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void Xport::DeflateResponse(const char *data,int len,int flush)
+{
+  char out[RDXPORT_RESPONSE_FLUSH_SIZE];
+
+  xport_response_zstream.next_in=(Bytef *)data;
+  xport_response_zstream.avail_in=len;
+  do {
+    xport_response_zstream.next_out=(Bytef *)out;
+    xport_response_zstream.avail_out=RDXPORT_RESPONSE_FLUSH_SIZE;
+    deflate(&xport_response_zstream,flush);
+    fwrite(out,1,RDXPORT_RESPONSE_FLUSH_SIZE-
+	   xport_response_zstream.avail_out,stdout);
+  } while(xport_response_zstream.avail_out==0);
+}
+
+
+void Xport::AbortResponse()
+{
+  if(xport_response_gzip) {
+    deflateEnd(&xport_response_zstream);
+    xport_response_gzip=false;
+  }
+  xport_response_pending=0;
+}
+
+
+void Xport::AbortConnection()
+{
+  struct linger lng;
+
+  //
+  // Reset the connection rather than closing it, so that the front end
+  // drops the client without ending the response (no terminating chunk
+  // or short Content-Length) and the client sees a truncated transfer.
+  // Under plain CGI stdout is a pipe and this does nothing, so the
+  // response just ends.
+  //
+  fflush(stdout);
+  memset(&lng,0,sizeof(lng));
+  lng.l_onoff=1;
+  lng.l_linger=0;
+  setsockopt(1,SOL_SOCKET,SO_LINGER,&lng,sizeof(lng));
+}
+
+
+void Xport::BeginTransaction(const QStringList &tables,int items)
+{
+  xport_transaction=new RDSqlTransaction(tables);
+  if(!xport_transaction->isActive()) {
+    XmlExit("Unable to start transaction",500,"rdxport.cpp",LINE_NUMBER);
+  }
+
+  //
+  // On a non-transactional engine a batch that fails part way through
+  // can't be undone, so keep count of the items applied in order to say
+  // how far it got
+  //
+  xport_items_applied=-1;
+  if((items>1)&&(!xport_transaction->isAtomic())) {
+    rda->syslog(LOG_DEBUG,
+		"batch of %d items applied without a transaction",items);
+    xport_items_applied=0;
+  }
+}
+
+
+void Xport::CommitTransaction()
+{
+  bool ok=xport_transaction->commit();
+  delete xport_transaction;
+  xport_transaction=NULL;
+  xport_items_applied=-1;
+  if(!ok) {
+    XmlExit("Unable to commit transaction",500,"rdxport.cpp",LINE_NUMBER);
+  }
+}
+
+
+void Xport::ItemApplied()
+{
+  if(xport_items_applied>=0) {
+    xport_items_applied++;
+  }
+}
+
+
+QString Xport::ItemError(const QString &msg,const QString &sfx) const
+{
+  if(sfx.isEmpty()) {
+    return msg;
+  }
+  return msg+" (item "+sfx.mid(1)+")";
+}
+
+
 void Xport::Exit(int code)
 {
+  AbortResponse();
+  if(xport_transaction!=NULL) {
+    delete xport_transaction;  // Rolls back
+    xport_transaction=NULL;
+  }
+  xport_items_applied=-1;
   if(xport_post!=NULL) {
     delete xport_post;
+    xport_post=NULL;
+  }
+  if(xport_in_request) {
+    throw XportExit(code);
   }
   exit(code);
 }
 
 
-void Xport::XmlExit(const QString &str,int code,const QString &srcfile,
+void Xport::XmlExit(const QString &msg,int code,const QString &srcfile,
 		    int srcline,RDAudioConvert::ErrorCode err)
 {
+  QString str=msg;
+
+  AbortResponse();
+  if(xport_transaction!=NULL) {
+    delete xport_transaction;  // Rolls back
+    xport_transaction=NULL;
+  }
+  if((code>=400)&&(xport_items_applied>0)) {
+    //
+    // Without a transaction, the items before this one have been kept
+    //
+    if(xport_items_applied==1) {
+      str+=" [item 0 was applied]";
+    }
+    else {
+      str+=QString::asprintf(" [items 0 to %d were applied]",
+			     xport_items_applied-1);
+    }
+  }
+  xport_items_applied=-1;
   if(xport_post!=NULL) {
     delete xport_post;
+    xport_post=NULL;
   }
   if(code>=400) {
     rda->syslog(LOG_WARNING,"%s '%s' %s",
@@ -473,6 +740,9 @@ void Xport::XmlExit(const QString &str,int code,const QString &srcfile,
 #else
   RDXMLResult(str.toUtf8(),code,err);
 #endif  // RDXPORT_DEBUG
+  if(xport_in_request) {
+    throw XportExit(0);
+  }
   exit(0);
 }
 
@@ -480,6 +750,11 @@ void Xport::XmlExit(const QString &str,int code,const QString &srcfile,
 int main(int argc,char *argv[])
 {
   QCoreApplication::setSetuidAllowed(true);
+  for(int i=1;i<argc;i++) {
+    if(!strcmp(argv[i],"--service")) {
+      return RunService(argc,argv);
+    }
+  }
   QCoreApplication a(argc,argv,false);
   new Xport();
   return a.exec();
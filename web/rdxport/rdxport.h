@@ -21,12 +21,20 @@
 #ifndef RDXPORT_H
 #define RDXPORT_H
 
+#include <sys/types.h>
+#include <zlib.h>
+
 #include <qobject.h>
+#include <QScopedPointer>
+#include <QSocketNotifier>
 
 #include <rdaudioconvert.h>
+#include <rdcart.h>
+#include <rdcut.h>
 #include <rdfeed.h>
 #include <rdformpost.h>
 #include <rdnotification.h>
+#include <rdsqltransaction.h>
 #include <rdsvc.h>
 
 #define RDXPORT_CGI_USAGE "\n"
@@ -34,33 +42,76 @@
 #define STRINGIZE2(x) #x
 #define LINE_NUMBER QString(STRINGIZE(__LINE__)).toInt()
 
+//
+// Maximum size of the SCGI header block accepted in service mode [bytes]
+//
+#define RDXPORT_SCGI_MAX_HEADER_SIZE 65536
+
+//
+// Amount of a streamed response to buffer before flushing it to the
+// client [bytes]
+//
+#define RDXPORT_RESPONSE_FLUSH_SIZE 65536
+
+//
+// Thrown by Exit() and XmlExit() to end a request in service mode
+//
+class XportExit
+{
+ public:
+  XportExit(int code) {exit_code=code;}
+  int exitCode() const {return exit_code;}
+
+ private:
+  int exit_code;
+};
+
+
 class Xport : public QObject
 {
-  Q_OBJECT;
+  Q_OBJECT
  public:
   enum LockLogOperation {LockLogCreate=0,LockLogUpdate=1,LockLogClear=2};
-  Xport(QObject *parent=0);
+  Xport(int listen_sock=-1,QObject *parent=0);
 
  private slots:
   void ripcConnectedData(bool state);
+  void listenActivatedData(int sock);
 
  private:
+  void ReadRequest();
+  void Dispatch();
+  void ServeRequests();
+  bool ReadScgiHeaders(int sock);
   bool Authenticate();
   void TryCreateTicket(const QString &name);
   void Export();
+  enum RangeResult {RangeNone=0,RangeValid=1,RangeUnsatisfiable=2};
+  bool SendFile(const QString &filename,const QString &mimetype,
+		const QString &etag);
+  bool EtagMatches(const QString &etag) const;
+  bool RangeRequested(const QString &etag) const;
+  Xport::RangeResult ParseRange(const QString &range,off_t size,
+				off_t *first,off_t *last) const;
   void Import();
   void DeleteAudio();
   void AddCart();
   void ListCarts();
   void ListCart();
   void EditCart();
+  void EditCarts();
+  RDCart *EditCartItem(const QString &sfx);
   void RemoveCart();
   void AddCut();
   void ListCuts();
   void ListCut();
   void EditCut();
+  void EditCuts();
+  RDCut *EditCutItem(const QString &sfx);
   void CheckPointerValidity(int ptr_values[2],bool use_ptrs[2],
-			    const QString &type,unsigned max_value);
+			    const QString &type,unsigned max_value,
+			    const QString &sfx);
+  QStringList SelectedFields(const QString &fields) const;
   void RemoveCut();
   void ListGroups();
   void ListGroup();
@@ -79,6 +130,8 @@ class Xport : public QObject
   void SaveLog();
   void ListSchedCodes();
   void AssignSchedCode();
+  void AssignSchedCodes();
+  void AssignSchedCodeItem(const QString &sfx);
   void UnassignSchedCode();
   void ListCartSchedCodes();
   void ListServices();
@@ -103,11 +156,33 @@ class Xport : public QObject
   void SaveFile();
   void SendNotification(RDNotification::Type type,RDNotification::Action action,
 			const QVariant &id);
+  void BeginXmlResponse();
+  void WriteResponse(const QString &str);
+  void EndResponse();
+  bool AcceptsGzip() const;
+  void DeflateResponse(const char *data,int len,int flush);
+  void AbortResponse();
+  void AbortConnection();
+  void BeginTransaction(const QStringList &tables,int items);
+  void CommitTransaction();
+  void ItemApplied();
+  QString ItemError(const QString &msg,const QString &sfx) const;
   void Exit(int code);
   void XmlExit(const QString &msg,int code,
 	       const QString &srcfile="",int line=-1,
 	       RDAudioConvert::ErrorCode err=RDAudioConvert::ErrorOk);
   RDFormPost *xport_post;
+  int xport_listen_sock;
+  QSocketNotifier *xport_listen_notifier;
+  int xport_null_fd;
+  int xport_served;
+  bool xport_in_request;
+  RDSqlTransaction *xport_transaction;
+  int xport_items_applied;
+  bool xport_response_gzip;
+  z_stream xport_response_zstream;
+  int xport_response_pending;
+  QStringList xport_scgi_variables;
   QString xport_remote_hostname;
   QHostAddress xport_remote_address;
   //  QByteArray xport_curl_data;
@@ -124,4 +199,7 @@ class Xport : public QObject
 };
 
 
+int RunService(int argc,char *argv[]);
+
+
 #endif  // RDXPORT_H
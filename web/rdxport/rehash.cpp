@@ -24,6 +24,8 @@
 #include <fcntl.h>
 #include <errno.h>
 
+#include <rdapplication.h>
+#include <rdaudiodedup.h>
 #include <rdformpost.h>
 #include <rdlog_line.h>
 #include <rdweb.h>
@@ -59,7 +61,13 @@ void Xport::Rehash()
     delete cut;
     XmlExit("No such cut",404,"rdhash.cpp",LINE_NUMBER);
   }
-  cut->setSha1Hash(RDSha1HashFile(RDCut::pathName(cart_number,cut_number)));
+  QString hash=RDSha1HashFile(RDCut::pathName(cart_number,cut_number));
+  cut->setSha1Hash(hash);
+  RDAudioDedup *dedup=new RDAudioDedup(rda->config());
+  if(dedup->isEnabled()) {
+    dedup->dedup(cut->cutName(),hash);
+  }
+  delete dedup;
   delete cut;
   XmlExit("OK",200,"rdhash.cpp",LINE_NUMBER);
 }
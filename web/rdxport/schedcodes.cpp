@@ -57,6 +57,35 @@ void Xport::ListSchedCodes()
 
 
 void Xport::AssignSchedCode()
+{
+  AssignSchedCodeItem("");
+  XmlExit("OK",200,"schedcodes.cpp",LINE_NUMBER);
+}
+
+
+void Xport::AssignSchedCodes()
+{
+  int items;
+  QStringList names=xport_post->names();
+
+  //
+  // Items are numbered from zero by a suffix on each field name
+  // (CART_NUMBER_0, CODE_0 ...), and are applied in one transaction (see
+  // BeginTransaction()).
+  //
+  for(items=0;names.contains(QString::asprintf("CART_NUMBER_%d",items));
+      items++);
+  BeginTransaction(QStringList()<<"CART_SCHED_CODES",items);
+  for(int i=0;i<items;i++) {
+    AssignSchedCodeItem(QString::asprintf("_%d",i));
+    ItemApplied();
+  }
+  CommitTransaction();
+  XmlExit("OK",200,"schedcodes.cpp",LINE_NUMBER);
+}
+
+
+void Xport::AssignSchedCodeItem(const QString &sfx)
 {
   int cart_number;
   QString sched_code;
@@ -67,18 +96,18 @@ void Xport::AssignSchedCode()
   //
   // Verify Post
   //
-  if(!xport_post->getValue("CART_NUMBER",&cart_number)) {
-    XmlExit("Missing CART_NUMBER",400,"schedcodes.cpp",LINE_NUMBER);
+  if(!xport_post->getValue("CART_NUMBER"+sfx,&cart_number)) {
+    XmlExit("Missing CART_NUMBER"+sfx,400,"schedcodes.cpp",LINE_NUMBER);
   }
-  if(!xport_post->getValue("CODE",&sched_code)) {
-    XmlExit("Missing CODE",400,"schedcodes.cpp",LINE_NUMBER);
+  if(!xport_post->getValue("CODE"+sfx,&sched_code)) {
+    XmlExit("Missing CODE"+sfx,400,"schedcodes.cpp",LINE_NUMBER);
   }
 
   //
   // Verify User Perms
   //
   if(!rda->user()->cartAuthorized(cart_number)) {
-    XmlExit("No such cart",404,"schedcodes.cpp",LINE_NUMBER);
+    XmlExit(ItemError("No such cart",sfx),404,"schedcodes.cpp",LINE_NUMBER);
   }
 
   //
@@ -87,17 +116,17 @@ void Xport::AssignSchedCode()
   cart=new RDCart(cart_number);
   code=new RDSchedCode(sched_code);
   if(!code->exists()) {
-    XmlExit("No such scheduler code",404,"schedcodes.cpp",LINE_NUMBER);
+    delete code;
+    delete cart;
+    XmlExit(ItemError("No such scheduler code",sfx),
+	    404,"schedcodes.cpp",LINE_NUMBER);
   }
+  delete code;
   codes=cart->schedCodesList();
-  for(int i=0;i<codes.size();i++) {
-    if(codes[i]==sched_code) {
-      delete cart;
-      XmlExit("OK",200,"schedcodes.cpp",LINE_NUMBER);
-    }
+  if(!codes.contains(sched_code)) {
+    cart->addSchedCode(sched_code);
   }
-  cart->addSchedCode(sched_code);
-  XmlExit("OK",200,"schedcodes.cpp",LINE_NUMBER);
+  delete cart;
 }
 
 
@@ -106,8 +135,6 @@ void Xport::UnassignSchedCode()
   int cart_number;
   QString sched_code;
   QStringList codes;
-  RDCart *cart=NULL;
-  RDSchedCode *code;
 
   //
   // Verify Post
@@ -129,14 +156,12 @@ void Xport::UnassignSchedCode()
   //
   // Process Request
   //
-  cart=new RDCart(cart_number);
-  code=new RDSchedCode(sched_code);
+  QScopedPointer<RDCart> cart(new RDCart(cart_number));
+  QScopedPointer<RDSchedCode> code(new RDSchedCode(sched_code));
   if(!code->exists()) {
     XmlExit("No such scheduler code",404,"schedcodes.cpp",LINE_NUMBER);
   }
   cart->removeSchedCode(sched_code);
-  delete cart;
-  delete code;
   XmlExit("OK",200,"schedcodes.cpp",LINE_NUMBER);
 }
 
@@ -144,7 +169,6 @@ void Xport::UnassignSchedCode()
 void Xport::ListCartSchedCodes()
 {
   int cart_number;
-  RDCart *cart;
   QStringList codes;
   RDSchedCode *schedcode;
 
@@ -164,7 +188,7 @@ void Xport::ListCartSchedCodes()
   //
   // Generate Scheduler Code List
   //
-  cart=new RDCart(cart_number);
+  QScopedPointer<RDCart> cart(new RDCart(cart_number));
   codes=cart->schedCodesList();
 
   //
@@ -0,0 +1,359 @@
+// service.cpp
+//
+// Rivendell web service portal -- Persistent SCGI service
+//
+//   (C) Copyright 2023 Fred Gleason <fredg@paravelsystems.com>
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public
+//   License along with this program; if not, write to the Free Software
+//   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QMap>
+
+#include <rdapplication.h>
+#include <rdconfig.h>
+
+#include <rdxport.h>
+
+static volatile bool service_exiting=false;
+
+static void SigHandler(int signo)
+{
+  service_exiting=true;
+}
+
+
+static bool ReadFully(int sock,char *data,size_t len)
+{
+  size_t done=0;
+  ssize_t n;
+
+  while(done<len) {
+    if((n=read(sock,data+done,len-done))<0) {
+      if(errno==EINTR) {
+	continue;
+      }
+      return false;
+    }
+    if(n==0) {
+      return false;
+    }
+    done+=n;
+  }
+
+  return true;
+}
+
+
+void Xport::ServeRequests()
+{
+  if((xport_null_fd=open("/dev/null",O_RDWR))<0) {
+    rda->syslog(LOG_ERR,"unable to open /dev/null [%s]",strerror(errno));
+    exit(1);
+  }
+  signal(SIGPIPE,SIG_IGN);
+
+  //
+  // Take connections from the event loop, so that ripcd(8) and database
+  // housekeeping keep running while we wait for one
+  //
+  xport_listen_notifier=
+    new QSocketNotifier(xport_listen_sock,QSocketNotifier::Read,this);
+  connect(xport_listen_notifier,SIGNAL(activated(int)),
+	  this,SLOT(listenActivatedData(int)));
+}
+
+
+void Xport::listenActivatedData(int sock)
+{
+  int conn=-1;
+  int max_requests=rda->config()->webServiceMaxRequests();
+
+  //
+  // Handlers can spin the event loop (as when sending notifications),
+  // which mustn't hand us another connection while this one has stdio
+  //
+  if(xport_in_request) {
+    return;
+  }
+
+  //
+  // The listening socket is non-blocking and shared with the other
+  // workers, so the connection may already have been taken
+  //
+  if((conn=accept4(sock,NULL,NULL,SOCK_CLOEXEC))<0) {
+    if((errno==EAGAIN)||(errno==EWOULDBLOCK)||(errno==EINTR)||
+       (errno==ECONNABORTED)) {
+      return;
+    }
+    rda->syslog(LOG_ERR,"accept() failed [%s]",strerror(errno));
+    exit(1);
+  }
+  if(ReadScgiHeaders(conn)) {
+    //
+    // The handlers talk CGI on stdin/stdout, so give them the connection
+    //
+    dup2(conn,0);
+    dup2(conn,1);
+    xport_in_request=true;
+    xport_listen_notifier->setEnabled(false);
+    try {
+      ReadRequest();
+      Dispatch();
+    }
+    catch(XportExit &e) {
+    }
+    xport_listen_notifier->setEnabled(true);
+    xport_in_request=false;
+    if(xport_post!=NULL) {
+      delete xport_post;
+      xport_post=NULL;
+    }
+    fflush(stdout);
+    clearerr(stdout);
+    dup2(xport_null_fd,0);
+    dup2(xport_null_fd,1);
+  }
+  close(conn);
+  if((max_requests>0)&&(++xport_served>=max_requests)) {
+    exit(0);
+  }
+}
+
+
+bool Xport::ReadScgiHeaders(int sock)
+{
+  char c;
+  size_t len=0;
+  int digits=0;
+  char *data=NULL;
+  QMap<QString,QString> vars;
+
+  //
+  // Netstring length
+  //
+  while(true) {
+    if(!ReadFully(sock,&c,1)) {
+      return false;
+    }
+    if(c==':') {
+      break;
+    }
+    if((c<'0')||(c>'9')||(++digits>8)) {
+      rda->syslog(LOG_WARNING,"malformed SCGI request");
+      return false;
+    }
+    len=10*len+(c-'0');
+  }
+  if((len==0)||(len>RDXPORT_SCGI_MAX_HEADER_SIZE)) {
+    rda->syslog(LOG_WARNING,"SCGI header block too large");
+    return false;
+  }
+
+  //
+  // Header block (NUL-separated name/value pairs) plus trailing comma
+  //
+  data=new char[len+1];
+  if((!ReadFully(sock,data,len+1))||(data[len]!=',')||(data[len-1]!=0)) {
+    rda->syslog(LOG_WARNING,"malformed SCGI request");
+    delete[] data;
+    return false;
+  }
+  size_t ptr=0;
+  while(ptr<len) {
+    QString name=QString::fromUtf8(data+ptr);
+    ptr+=strlen(data+ptr)+1;
+    if(ptr>=len) {
+      break;
+    }
+    vars[name]=QString::fromUtf8(data+ptr);
+    ptr+=strlen(data+ptr)+1;
+  }
+  delete[] data;
+  if((!vars.contains("CONTENT_LENGTH"))||(vars.value("SCGI")!="1")) {
+    rda->syslog(LOG_WARNING,"malformed SCGI request");
+    return false;
+  }
+
+  //
+  // Replace the previous request's environment
+  //
+  for(int i=0;i<xport_scgi_variables.size();i++) {
+    unsetenv(xport_scgi_variables.at(i).toUtf8());
+  }
+  xport_scgi_variables.clear();
+  for(QMap<QString,QString>::const_iterator it=vars.begin();it!=vars.end();
+      it++) {
+    setenv(it.key().toUtf8(),it.value().toUtf8(),1);
+    xport_scgi_variables.push_back(it.key());
+  }
+
+  return true;
+}
+
+
+static pid_t StartWorker(int sock,int argc,char *argv[])
+{
+  pid_t pid=fork();
+
+  if(pid==0) {
+    signal(SIGTERM,SIG_DFL);
+    signal(SIGINT,SIG_DFL);
+    int null_fd=open("/dev/null",O_RDWR);
+    dup2(null_fd,0);
+    dup2(null_fd,1);
+    close(null_fd);
+    QCoreApplication a(argc,argv,false);
+    new Xport(sock);
+    exit(a.exec());
+  }
+
+  return pid;
+}
+
+
+int RunService(int argc,char *argv[])
+{
+  RDConfig *config=new RDConfig();
+  int sock=-1;
+  int opt=1;
+  struct sockaddr_in sa;
+  struct sigaction act;
+  QMap<pid_t,time_t> workers;
+  pid_t pid;
+  int stat;
+
+  config->load();
+  openlog("rdxport.cgi",LOG_PID,config->syslogFacility());
+  if(config->webServicePort()<=0) {
+    fprintf(stderr,"rdxport.cgi: WebServicePort= is not set in rd.conf(5)\n");
+    return 1;
+  }
+
+  //
+  // Listen on the loopback interface only.  The workers wait for
+  // connections in their event loops, so accept() must not block.
+  //
+  if((sock=socket(AF_INET,SOCK_STREAM|SOCK_CLOEXEC|SOCK_NONBLOCK,0))<0) {
+    fprintf(stderr,"rdxport.cgi: unable to create socket [%s]\n",
+	    strerror(errno));
+    return 1;
+  }
+  setsockopt(sock,SOL_SOCKET,SO_REUSEADDR,&opt,sizeof(opt));
+  memset(&sa,0,sizeof(sa));
+  sa.sin_family=AF_INET;
+  sa.sin_port=htons(config->webServicePort());
+  sa.sin_addr.s_addr=htonl(INADDR_LOOPBACK);
+  if(bind(sock,(struct sockaddr *)&sa,sizeof(sa))<0) {
+    fprintf(stderr,"rdxport.cgi: unable to bind port %d [%s]\n",
+	    config->webServicePort(),strerror(errno));
+    return 1;
+  }
+  if(listen(sock,SOMAXCONN)<0) {
+    fprintf(stderr,"rdxport.cgi: unable to listen [%s]\n",strerror(errno));
+    return 1;
+  }
+
+  //
+  // Drop root permissions
+  //
+  if(setgid(config->gid())<0) {
+    fprintf(stderr,"rdxport.cgi: unable to set Rivendell group\n");
+    return 1;
+  }
+  if(setuid(config->uid())<0) {
+    fprintf(stderr,"rdxport.cgi: unable to set Rivendell user\n");
+    return 1;
+  }
+  if(getuid()==0) {
+    fprintf(stderr,"rdxport.cgi: Rivendell user should never be \"root\"!\n");
+    return 1;
+  }
+
+  memset(&act,0,sizeof(act));
+  act.sa_handler=SigHandler;
+  sigaction(SIGTERM,&act,NULL);
+  sigaction(SIGINT,&act,NULL);
+
+  //
+  // Start the workers
+  //
+  for(int i=0;i<config->webServiceWorkers();i++) {
+    if((pid=StartWorker(sock,argc,argv))>0) {
+      workers[pid]=time(NULL);
+    }
+  }
+  syslog(LOG_INFO,"web service started on port %d with %d workers",
+	 config->webServicePort(),workers.size());
+
+  //
+  // Replace workers as they exit
+  //
+  while(!service_exiting) {
+    if((pid=wait(&stat))<0) {
+      if(errno==ECHILD) {
+	sleep(1);
+      }
+    }
+    else {
+      if(workers.contains(pid)) {
+	if((!WIFEXITED(stat))||(WEXITSTATUS(stat)!=0)) {
+	  syslog(LOG_WARNING,"web service worker %d exited abnormally",pid);
+	  if((time(NULL)-workers.value(pid))<1) {
+	    sleep(1);  // Don't spin if the workers can't start
+	  }
+	}
+	workers.remove(pid);
+      }
+    }
+    while((!service_exiting)&&(workers.size()<config->webServiceWorkers())) {
+      if((pid=StartWorker(sock,argc,argv))<0) {
+	syslog(LOG_ERR,"unable to start web service worker [%s]",
+	       strerror(errno));
+	sleep(1);
+	break;
+      }
+      workers[pid]=time(NULL);
+    }
+  }
+
+  //
+  // Shut down
+  //
+  for(QMap<pid_t,time_t>::const_iterator it=workers.begin();
+      it!=workers.end();it++) {
+    kill(it.key(),SIGTERM);
+  }
+  while(wait(NULL)>0);
+  close(sock);
+  syslog(LOG_INFO,"web service stopped");
+  delete config;
+
+  return 0;
+}
@@ -33,7 +33,7 @@
 
 void Xport::ListSystemSettings()
 {
-  RDSystem *sys=new RDSystem();
+  QScopedPointer<RDSystem> sys(new RDSystem());
 
   //
   // Send Data
@@ -29,6 +29,7 @@
 #include <rdcart.h>
 #include <rdconf.h>
 #include <rdformpost.h>
+#include <rdlocalxport.h>
 #include <rdsettings.h>
 #include <rdweb.h>
 
@@ -36,7 +37,8 @@
 
 void Xport::TrimAudio()
 {
-  int point;
+  int start_point=-1;
+  int end_point=-1;
 
   //
   // Verify Post
@@ -65,7 +67,8 @@ void Xport::TrimAudio()
   //
   // Open Audio File
   //
-  RDWaveFile *wave=new RDWaveFile(RDCut::pathName(cartnum,cutnum));
+  QScopedPointer<RDWaveFile>
+    wave(new RDWaveFile(RDCut::pathName(cartnum,cutnum)));
   if(!wave->openWave()) {
     XmlExit("No such audio",404,"trimaudio.cpp",LINE_NUMBER);
   }
@@ -82,16 +85,9 @@ void Xport::TrimAudio()
   printf("  <cartNumber>%u</cartNumber>\n",cartnum);
   printf("  <cutNumber>%d</cutNumber>\n",cutnum);
   printf("  <trimLevel>%d</trimLevel>\n",trim_level);
-  point=wave->startTrim(REFERENCE_LEVEL-trim_level);
-  if(point>=0) {
-    point=(double)point*1000.0/(double)wave->getSamplesPerSec();
-  }
-  printf("  <startTrimPoint>%d</startTrimPoint>\n",point);
-  point=wave->endTrim(REFERENCE_LEVEL-trim_level);
-  if(point>=0) {
-    point=(double)point*1000.0/(double)wave->getSamplesPerSec();
-  }
-  printf("  <endTrimPoint>%d</endTrimPoint>\n",point);
+  RDLocalXport::trimPoints(wave.data(),trim_level,&start_point,&end_point);
+  printf("  <startTrimPoint>%d</startTrimPoint>\n",start_point);
+  printf("  <endTrimPoint>%d</endTrimPoint>\n",end_point);
   printf("</trimPoint>\n");
   SendNotification(RDNotification::CartType,RDNotification::ModifyAction,
 		   QVariant(cartnum));